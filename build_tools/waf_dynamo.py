@@ -305,6 +305,9 @@ def default_flags(self):
     if Options.options.ndebug:
         flags += [self.env.CXXDEFINES_ST % 'NDEBUG']
 
+    if Options.options.with_scalar_vmath:
+        flags += [self.env.CXXDEFINES_ST % 'DM_VMATH_SCALAR']
+
     for f in ['CCFLAGS', 'CXXFLAGS', 'LINKFLAGS']:
         self.env.append_value(f, [FLAG_ST % ('O%s' % opt_level)])
 
@@ -1857,3 +1860,4 @@ def set_options(opt):
     opt.add_option('--static-analyze', action='store_true', default=False, dest='static_analyze', help='Enables static code analyzer')
     opt.add_option('--with-valgrind', action='store_true', default=False, dest='with_valgrind', help='Enables usage of valgrind')
     opt.add_option('--with-vulkan', action='store_true', default=False, dest='with_vulkan', help='Enables Vulkan as graphics backend')
+    opt.add_option('--with-scalar-vmath', action='store_true', default=False, dest='with_scalar_vmath', help='Disables the SSE2/NEON vector math backend')
@@ -0,0 +1,239 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+package com.dynamo.bob.test.util;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.List;
+
+import javax.vecmath.AxisAngle4d;
+import javax.vecmath.Quat4d;
+
+import org.junit.Test;
+
+import com.dynamo.bob.util.RigUtil;
+import com.dynamo.rig.proto.Rig.AnimationSet;
+import com.dynamo.rig.proto.Rig.AnimationTrack;
+import com.dynamo.rig.proto.Rig.RigAnimation;
+import com.google.protobuf.ByteString;
+
+public class RigUtilTest {
+
+    private static final int SAMPLE_COUNT = 64;
+
+    // Quantization step of a stored quaternion component, 15 bits in [-1/sqrt(2), 1/sqrt(2)]
+    private static final float QUAT_STEP = (float)Math.sqrt(2.0) / 32767.0f;
+
+    // Slack for the single precision arithmetic in the decoder
+    private static final float FLOAT_EPSILON = 0.000001f;
+
+    private static int readUint16(ByteBuffer buffer, int offset) {
+        return buffer.getShort(offset) & 0xffff;
+    }
+
+    // Same decoding as DecodeVec3 in rig.cpp
+    private static float[] decodeVec3(ByteString data, List<Float> range, int sample) {
+        ByteBuffer buffer = data.asReadOnlyByteBuffer().order(ByteOrder.LITTLE_ENDIAN);
+        float[] v = new float[3];
+        for (int c = 0; c < 3; ++c) {
+            v[c] = range.get(c) + readUint16(buffer, sample * 6 + c * 2) * range.get(c + 3);
+        }
+        return v;
+    }
+
+    // Same decoding as DecodeQuat in rig.cpp
+    private static float[] decodeQuat(ByteString data, int sample) {
+        ByteBuffer buffer = data.asReadOnlyByteBuffer().order(ByteOrder.LITTLE_ENDIAN);
+        final float scale = (float)Math.sqrt(2.0) / 32767.0f;
+        final float offset = (float)Math.sqrt(0.5);
+        int v0 = readUint16(buffer, sample * 6 + 0);
+        int v1 = readUint16(buffer, sample * 6 + 2);
+        int v2 = readUint16(buffer, sample * 6 + 4);
+        int largest = ((v0 >> 15) << 1) | (v1 >> 15);
+        float a = (v0 & 0x7fff) * scale - offset;
+        float b = (v1 & 0x7fff) * scale - offset;
+        float c = (v2 & 0x7fff) * scale - offset;
+        float d = (float)Math.sqrt(Math.max(0.0f, 1.0f - a*a - b*b - c*c));
+        switch (largest) {
+            case 0:  return new float[] {d, a, b, c};
+            case 1:  return new float[] {a, d, b, c};
+            case 2:  return new float[] {a, b, d, c};
+            default: return new float[] {a, b, c, d};
+        }
+    }
+
+    private static AnimationTrack compress(AnimationTrack track) {
+        RigAnimation animation = RigAnimation.newBuilder()
+                .setId(1)
+                .setDuration(1.0f)
+                .setSampleRate(SAMPLE_COUNT)
+                .addTracks(track)
+                .build();
+        AnimationSet.Builder animSetBuilder = AnimationSet.newBuilder().addAnimations(animation);
+        RigUtil.compressAnimationSet(animSetBuilder);
+        return animSetBuilder.getAnimations(0).getTracks(0);
+    }
+
+    private static void assertVec3Track(List<Float> expected, ByteString data, List<Float> range) {
+        assertEquals(6, range.size());
+        assertEquals(expected.size() * 2, data.size());
+        for (int i = 0; i < expected.size() / 3; ++i) {
+            float[] v = decodeVec3(data, range, i);
+            for (int c = 0; c < 3; ++c) {
+                // Within half a step of the track's own range
+                float bound = range.get(c + 3) * 0.5f + FLOAT_EPSILON * Math.max(1.0f, Math.abs(expected.get(i*3+c)));
+                assertEquals(expected.get(i*3+c), v[c], bound);
+            }
+        }
+    }
+
+    private static List<Float> vec3Track(double scale, double offset) {
+        List<Float> values = new ArrayList<Float>();
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            double t = i / (double)(SAMPLE_COUNT - 1);
+            values.add((float)(offset + scale * Math.sin(t * 6.0)));
+            values.add((float)(offset - scale * t));
+            // Constant component in an otherwise animated track
+            values.add((float)offset);
+        }
+        return values;
+    }
+
+    @Test
+    public void testCompressPositions() throws Exception {
+        List<Float> positions = vec3Track(250.0, -12.5);
+        AnimationTrack track = compress(AnimationTrack.newBuilder().setBoneIndex(0).addAllPositions(positions).build());
+
+        assertEquals(0, track.getPositionsCount());
+        assertTrue(track.hasCompressedPositions());
+        assertVec3Track(positions, track.getCompressedPositions(), track.getPositionsRangeList());
+    }
+
+    @Test
+    public void testCompressScale() throws Exception {
+        List<Float> scale = vec3Track(0.5, 1.0);
+        AnimationTrack track = compress(AnimationTrack.newBuilder().setBoneIndex(0).addAllScale(scale).build());
+
+        assertEquals(0, track.getScaleCount());
+        assertTrue(track.hasCompressedScale());
+        assertVec3Track(scale, track.getCompressedScale(), track.getScaleRangeList());
+    }
+
+    @Test
+    public void testCompressRotations() throws Exception {
+        // Rotations around several axes, so that each component is the omitted one,
+        // with both signs of the omitted component.
+        double[][] axes = new double[][] {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, -2, 0.5}, {-0.3, 0.2, -1}};
+        List<Float> rotations = new ArrayList<Float>();
+        for (double[] axis : axes) {
+            for (int i = 0; i < SAMPLE_COUNT; ++i) {
+                double angle = -2.0 * Math.PI + 4.0 * Math.PI * i / (double)(SAMPLE_COUNT - 1);
+                Quat4d q = new Quat4d();
+                q.set(new AxisAngle4d(axis[0], axis[1], axis[2], angle));
+                rotations.add((float)q.x);
+                rotations.add((float)q.y);
+                rotations.add((float)q.z);
+                rotations.add((float)q.w);
+            }
+        }
+        AnimationTrack track = compress(AnimationTrack.newBuilder().setBoneIndex(0).addAllRotations(rotations).build());
+
+        assertEquals(0, track.getRotationsCount());
+        assertTrue(track.hasCompressedRotations());
+        ByteString data = track.getCompressedRotations();
+        int count = rotations.size() / 4;
+        assertEquals(count * 6, data.size());
+
+        // The stored components are within half a step. The omitted component is reconstructed
+        // from the other three and is at least 1/2, which bounds its error by three half steps.
+        float bound = QUAT_STEP * 1.5f + FLOAT_EPSILON;
+        for (int i = 0; i < count; ++i) {
+            float[] expected = new float[] {rotations.get(i*4+0), rotations.get(i*4+1), rotations.get(i*4+2), rotations.get(i*4+3)};
+            float[] q = decodeQuat(data, i);
+            // q and -q are the same rotation
+            float dot = 0.0f;
+            for (int c = 0; c < 4; ++c) {
+                dot += expected[c] * q[c];
+            }
+            float sign = dot < 0.0f ? -1.0f : 1.0f;
+            for (int c = 0; c < 4; ++c) {
+                assertEquals(expected[c], q[c] * sign, bound);
+            }
+        }
+    }
+
+    @Test
+    public void testCompressConstantTracks() throws Exception {
+        AnimationTrack.Builder builder = AnimationTrack.newBuilder().setBoneIndex(0);
+        Quat4d rotation = new Quat4d();
+        rotation.set(new AxisAngle4d(0.0, 0.0, 1.0, 0.75));
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            builder.addPositions(10.0f).addPositions(-20.0f).addPositions(30.0f);
+            builder.addRotations((float)rotation.x).addRotations((float)rotation.y).addRotations((float)rotation.z).addRotations((float)rotation.w);
+            builder.addScale(1.0f).addScale(2.0f).addScale(1.0f);
+        }
+        AnimationTrack track = compress(builder.build());
+
+        // Reduced to a single raw sample
+        assertFalse(track.hasCompressedPositions());
+        assertFalse(track.hasCompressedRotations());
+        assertFalse(track.hasCompressedScale());
+        assertEquals(0, track.getPositionsRangeCount());
+        assertEquals(0, track.getScaleRangeCount());
+
+        assertEquals(3, track.getPositionsCount());
+        assertEquals(10.0f, track.getPositions(0), 0.0f);
+        assertEquals(-20.0f, track.getPositions(1), 0.0f);
+        assertEquals(30.0f, track.getPositions(2), 0.0f);
+
+        assertEquals(4, track.getRotationsCount());
+        assertEquals((float)rotation.x, track.getRotations(0), 0.0f);
+        assertEquals((float)rotation.y, track.getRotations(1), 0.0f);
+        assertEquals((float)rotation.z, track.getRotations(2), 0.0f);
+        assertEquals((float)rotation.w, track.getRotations(3), 0.0f);
+
+        assertEquals(3, track.getScaleCount());
+        assertEquals(1.0f, track.getScale(0), 0.0f);
+        assertEquals(2.0f, track.getScale(1), 0.0f);
+        assertEquals(1.0f, track.getScale(2), 0.0f);
+    }
+
+    @Test
+    public void testCompressConstantComponent() throws Exception {
+        // A track where a single component changes is quantized, the constant components
+        // get a zero step and decode to their exact value.
+        List<Float> positions = new ArrayList<Float>();
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            positions.add(5.0f);
+            positions.add((float)i);
+            positions.add(-7.25f);
+        }
+        AnimationTrack track = compress(AnimationTrack.newBuilder().setBoneIndex(0).addAllPositions(positions).build());
+
+        assertTrue(track.hasCompressedPositions());
+        List<Float> range = track.getPositionsRangeList();
+        assertEquals(0.0f, range.get(3), 0.0f);
+        assertEquals(0.0f, range.get(5), 0.0f);
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            float[] v = decodeVec3(track.getCompressedPositions(), range, i);
+            assertEquals(5.0f, v[0], 0.0f);
+            assertEquals(-7.25f, v[2], 0.0f);
+        }
+        assertVec3Track(positions, track.getCompressedPositions(), range);
+    }
+}
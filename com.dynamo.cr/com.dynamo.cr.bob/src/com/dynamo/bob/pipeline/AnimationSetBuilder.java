@@ -29,6 +29,7 @@ import com.dynamo.bob.CompileExceptionError;
 import com.dynamo.bob.Project;
 import com.dynamo.bob.Task;
 import com.dynamo.bob.fs.IResource;
+import com.dynamo.bob.util.RigUtil;
 import com.dynamo.rig.proto.Rig.AnimationSet;
 import com.dynamo.rig.proto.Rig.AnimationSetDesc;
 import com.dynamo.rig.proto.Rig.AnimationInstanceDesc;
@@ -137,6 +138,9 @@ public class AnimationSetBuilder extends Builder<Void>  {
         animFiles = new ArrayList<String>();
         animFiles.add(task.input(0).getAbsPath());
         buildAnimations(task, animSetDescBuilder, animationSetBuilder, "");
+        if (project.getProjectProperties().getBooleanValue("model", "compress_animations", false)) {
+            RigUtil.compressAnimationSet(animationSetBuilder);
+        }
 
         // write merged animationset
         ByteArrayOutputStream out = new ByteArrayOutputStream(64 * 1024);
@@ -26,6 +26,7 @@ import com.dynamo.bob.BuilderParams;
 import com.dynamo.bob.CompileExceptionError;
 import com.dynamo.bob.Task;
 import com.dynamo.bob.fs.IResource;
+import com.dynamo.bob.util.RigUtil;
 
 import com.dynamo.rig.proto.Rig.AnimationSet;
 import com.dynamo.rig.proto.Rig.MeshSet;
@@ -90,6 +91,9 @@ public class ColladaModelBuilder extends Builder<Void>  {
         } catch (LoaderException e) {
             throw new CompileExceptionError(task.input(0), -1, "Failed to compile animation: " + e.getLocalizedMessage(), e);
         }
+        if (project.getProjectProperties().getBooleanValue("model", "compress_animations", false)) {
+            RigUtil.compressAnimationSet(animationSetBuilder);
+        }
         animationSetBuilder.build().writeTo(out);
         out.close();
         task.output(2).setContent(out.toByteArray());
@@ -12,6 +12,8 @@
 
 package com.dynamo.bob.util;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.List;
 import java.util.Map;
@@ -26,6 +28,7 @@ import javax.vecmath.Vector3d;
 import com.dynamo.bob.textureset.TextureSetGenerator.UVTransform;
 import com.dynamo.bob.util.RigUtil.AnimationCurve.CurveIntepolation;
 import com.dynamo.rig.proto.Rig.MeshAnimationTrack;
+import com.google.protobuf.ByteString;
 
 /**
  * Convenience class for loading spine json data.
@@ -768,4 +771,120 @@ public class RigUtil {
         // Create duplicate of last keyframe
         propertyBuilder.duplicateLast();
     }
+
+    private static final double QUAT_COMPONENT_RANGE = Math.sqrt(0.5);
+
+    private static boolean isConstantTrack(List<Float> values, int components) {
+        for (int i = components; i < values.size(); ++i) {
+            if (Math.abs(values.get(i) - values.get(i % components)) > EPSILON) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Quantizes each component to 16 bits within the range of the track, see AnimationTrack in rig_ddf.proto
+    private static ByteString quantizeVec3Track(List<Float> values, List<Float> rangeOut) {
+        float[] min = new float[] {Float.MAX_VALUE, Float.MAX_VALUE, Float.MAX_VALUE};
+        float[] max = new float[] {-Float.MAX_VALUE, -Float.MAX_VALUE, -Float.MAX_VALUE};
+        for (int i = 0; i < values.size(); ++i) {
+            int c = i % 3;
+            min[c] = Math.min(min[c], values.get(i));
+            max[c] = Math.max(max[c], values.get(i));
+        }
+        float[] step = new float[3];
+        for (int c = 0; c < 3; ++c) {
+            step[c] = (max[c] - min[c]) / 65535.0f;
+            rangeOut.add(min[c]);
+        }
+        for (int c = 0; c < 3; ++c) {
+            rangeOut.add(step[c]);
+        }
+        ByteBuffer buffer = ByteBuffer.allocate(values.size() * 2).order(ByteOrder.LITTLE_ENDIAN);
+        for (int i = 0; i < values.size(); ++i) {
+            int c = i % 3;
+            int q = step[c] > 0.0f ? (int)Math.round((values.get(i) - min[c]) / step[c]) : 0;
+            buffer.putShort((short)Math.max(0, Math.min(65535, q)));
+        }
+        return ByteString.copyFrom(buffer.array());
+    }
+
+    // Stores the three smallest components of each quaternion, see AnimationTrack in rig_ddf.proto
+    private static ByteString quantizeQuatTrack(List<Float> values) {
+        int count = values.size() / 4;
+        ByteBuffer buffer = ByteBuffer.allocate(count * 6).order(ByteOrder.LITTLE_ENDIAN);
+        for (int i = 0; i < count; ++i) {
+            Quat4d q = new Quat4d(values.get(i*4+0), values.get(i*4+1), values.get(i*4+2), values.get(i*4+3));
+            double length = Math.sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+            double[] c = length > 0.0 ? new double[] {q.x / length, q.y / length, q.z / length, q.w / length} : new double[] {0.0, 0.0, 0.0, 1.0};
+            int largest = 0;
+            for (int j = 1; j < 4; ++j) {
+                if (Math.abs(c[j]) > Math.abs(c[largest])) {
+                    largest = j;
+                }
+            }
+            // q and -q are the same rotation, make the omitted component positive
+            double sign = c[largest] < 0.0 ? -1.0 : 1.0;
+            int[] words = new int[3];
+            int w = 0;
+            for (int j = 0; j < 4; ++j) {
+                if (j != largest) {
+                    double v = (c[j] * sign + QUAT_COMPONENT_RANGE) / (2.0 * QUAT_COMPONENT_RANGE);
+                    words[w++] = Math.max(0, Math.min(32767, (int)Math.round(v * 32767.0)));
+                }
+            }
+            words[0] |= (largest >> 1) << 15;
+            words[1] |= (largest & 1) << 15;
+            for (int j = 0; j < 3; ++j) {
+                buffer.putShort((short)words[j]);
+            }
+        }
+        return ByteString.copyFrom(buffer.array());
+    }
+
+    public static com.dynamo.rig.proto.Rig.AnimationTrack compressAnimationTrack(com.dynamo.rig.proto.Rig.AnimationTrack track) {
+        com.dynamo.rig.proto.Rig.AnimationTrack.Builder builder = track.toBuilder();
+        if (track.getPositionsCount() > 0) {
+            builder.clearPositions();
+            if (isConstantTrack(track.getPositionsList(), 3)) {
+                builder.addAllPositions(track.getPositionsList().subList(0, 3));
+            } else {
+                List<Float> range = new ArrayList<Float>();
+                builder.setCompressedPositions(quantizeVec3Track(track.getPositionsList(), range));
+                builder.addAllPositionsRange(range);
+            }
+        }
+        if (track.getRotationsCount() > 0) {
+            builder.clearRotations();
+            if (isConstantTrack(track.getRotationsList(), 4)) {
+                builder.addAllRotations(track.getRotationsList().subList(0, 4));
+            } else {
+                builder.setCompressedRotations(quantizeQuatTrack(track.getRotationsList()));
+            }
+        }
+        if (track.getScaleCount() > 0) {
+            builder.clearScale();
+            if (isConstantTrack(track.getScaleList(), 3)) {
+                builder.addAllScale(track.getScaleList().subList(0, 3));
+            } else {
+                List<Float> range = new ArrayList<Float>();
+                builder.setCompressedScale(quantizeVec3Track(track.getScaleList(), range));
+                builder.addAllScaleRange(range);
+            }
+        }
+        return builder.build();
+    }
+
+    /**
+     * Replaces the sampled bone tracks of all animations with compressed tracks.
+     * Constant tracks are reduced to a single sample, rotations use smallest three
+     * quantization and positions and scale are quantized within their range.
+     */
+    public static void compressAnimationSet(com.dynamo.rig.proto.Rig.AnimationSet.Builder animSetBuilder) {
+        for (com.dynamo.rig.proto.Rig.RigAnimation.Builder animBuilder : animSetBuilder.getAnimationsBuilderList()) {
+            for (int i = 0; i < animBuilder.getTracksCount(); ++i) {
+                animBuilder.setTracks(i, compressAnimationTrack(animBuilder.getTracks(i)));
+            }
+        }
+    }
 }
@@ -20,6 +20,7 @@
 
 #define DDF_OFFSET_OF(T, F) (((uintptr_t) (&((T*) 16)->F)) - 16)
 #define DDF_MAX_FIELDS (128)
+#define DDF_INVALID_FIELD_INDEX (0xff)
 
 namespace dmDDF
 {
@@ -60,6 +61,8 @@ namespace dmDDF
         uint32_t         m_Size;
         FieldDescriptor* m_Fields;
         uint8_t          m_FieldCount;  // TODO: Where to check < 255...?
+        const uint8_t*   m_FieldIndices;        // Field number to index in m_Fields (DDF_INVALID_FIELD_INDEX if none). 0x0 if the field numbers are too sparse
+        uint16_t         m_FieldIndicesCount;   // Max field number + 1
         void*            m_NextDescriptor;
     };
 
@@ -127,6 +130,9 @@ namespace dmDDF
 
     /// Store pointers as offset from base address. Needed when serializing entire messages (copy)
     const uint32_t OPTION_OFFSET_POINTERS = (1 << 0);
+    /// Let bytes fields point into the input buffer instead of copying them. The input buffer must outlive the message.
+    /// Not compatible with OPTION_OFFSET_POINTERS
+    const uint32_t OPTION_BORROW_BYTES = (1 << 1);
 
     /**
      * Internal. Do not use.
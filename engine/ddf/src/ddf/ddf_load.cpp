@@ -113,20 +113,138 @@ namespace dmDDF
         }
     }
 
+    static uint32_t CalculateDefaultMessageSize(const Descriptor* desc);
+
+    static uint32_t CalculateDefaultFieldSize(const FieldDescriptor* f)
+    {
+        if (f->m_Label != LABEL_OPTIONAL)
+            return 0;
+
+        if (f->m_Type == TYPE_STRING && f->m_DefaultValue)
+        {
+            return strlen(f->m_DefaultValue) + 1;
+        }
+        else if (f->m_Type == TYPE_MESSAGE)
+        {
+            return CalculateDefaultMessageSize(f->m_MessageDescriptor);
+        }
+        return 0;
+    }
+
+    static uint32_t CalculateDefaultMessageSize(const Descriptor* desc)
+    {
+        uint32_t size = 0;
+        for (int i = 0; i < desc->m_FieldCount; ++i)
+        {
+            size += CalculateDefaultFieldSize(&desc->m_Fields[i]);
+        }
+        return size;
+    }
+
+    Result CalculateMessageSize(LoadContext* load_context, InputBuffer* input_buffer,
+                                const Descriptor* desc, uint32_t* size)
+    {
+        uint8_t read_fields[DDF_MAX_FIELDS];
+        memset(read_fields, 0, sizeof(read_fields));
+
+        uint32_t array_counts = load_context->AddArrayCounts(desc->m_FieldCount);
+
+        while (!input_buffer->Eof())
+        {
+            uint32_t tag;
+            if (!input_buffer->ReadVarInt32(&tag))
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t key = tag >> 3;
+            uint32_t type = tag & 0x7;
+
+            if (key == 0)
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t field_index;
+            const FieldDescriptor* field = FindField(desc, key, &field_index);
+            if (field)
+            {
+                assert(field_index < DDF_MAX_FIELDS);
+                read_fields[field_index] = 1;
+                if (field->m_Label == LABEL_REPEATED)
+                {
+                    load_context->IncreaseArrayCount(array_counts + field_index);
+                }
+            }
+
+            if (field && field->m_Type == TYPE_MESSAGE)
+            {
+                uint32_t length;
+                InputBuffer sub_buffer;
+                if (type != WIRETYPE_LENGTH_DELIMITED || !input_buffer->ReadVarInt32(&length) || !input_buffer->SubBuffer(length, &sub_buffer))
+                {
+                    return RESULT_WIRE_FORMAT_ERROR;
+                }
+
+                Result e = CalculateMessageSize(load_context, &sub_buffer, field->m_MessageDescriptor, size);
+                if (e != RESULT_OK)
+                {
+                    return e;
+                }
+            }
+            else if (field && (field->m_Type == TYPE_STRING || field->m_Type == TYPE_BYTES) && type == WIRETYPE_LENGTH_DELIMITED)
+            {
+                uint32_t length;
+                if (!input_buffer->ReadVarInt32(&length) || !input_buffer->Skip(length))
+                {
+                    return RESULT_WIRE_FORMAT_ERROR;
+                }
+                // Strings are null terminated, bytes are 16 byte aligned (unless borrowed from the input buffer)
+                if (field->m_Type == TYPE_STRING)
+                    *size += length + 1;
+                else if ((load_context->GetOptions() & OPTION_BORROW_BYTES) == 0)
+                    *size += length + 15;
+            }
+            else
+            {
+                Result e = SkipField(input_buffer, type);
+                if (e != RESULT_OK)
+                {
+                    return e;
+                }
+            }
+        }
+
+        for (int i = 0; i < desc->m_FieldCount; ++i)
+        {
+            const FieldDescriptor* f = &desc->m_Fields[i];
+            if (f->m_Label == LABEL_REPEATED)
+            {
+                // Arrays are 16 byte aligned
+                *size += load_context->GetArrayCount(array_counts + i) * RepeatedElementSize(f) + 15;
+            }
+            else if (read_fields[i] == 0)
+            {
+                *size += CalculateDefaultFieldSize(f);
+            }
+        }
+
+        return RESULT_OK;
+    }
+
     Result DoLoadMessage(LoadContext* load_context, InputBuffer* input_buffer,
                          const Descriptor* desc, Message* message)
     {
         uint8_t read_fields[DDF_MAX_FIELDS];
         memset(read_fields, 0, sizeof(read_fields));
 
+        uint32_t array_counts = load_context->NextArrayCounts(desc->m_FieldCount);
         for (int i = 0; i < desc->m_FieldCount; ++i)
         {
             const FieldDescriptor* f = &desc->m_Fields[i];
             if (f->m_Label == LABEL_REPEATED)
             {
-                // TODO: Verify buffer_pos!!!! Correct to use Tell()?
-                uint32_t buffer_pos = input_buffer->Tell();
-                message->AllocateRepeatedBuffer(load_context, f, load_context->GetArrayCount(buffer_pos, f->m_Number));
+                message->AllocateRepeatedBuffer(load_context, f, load_context->GetArrayCount(array_counts + i));
             }
         }
 
@@ -23,6 +23,14 @@ namespace dmDDF
 
     Result SkipField(InputBuffer* input_buffer, uint32_t type);
 
+    /**
+     * Calculate the number of elements in all repeated fields, and an upper bound of the memory
+     * needed for the message, excluding the top level message struct itself.
+     * The element counts are stored in the load context, in the order DoLoadMessage() needs them.
+     */
+    Result CalculateMessageSize(LoadContext* load_context, InputBuffer* input_buffer,
+                                const Descriptor* desc, uint32_t* size);
+
     Result DoLoadMessage(LoadContext* load_context, InputBuffer* input_buffer,
                               const Descriptor* desc, Message* message);
 }
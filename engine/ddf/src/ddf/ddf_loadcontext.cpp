@@ -12,7 +12,7 @@
 
 #include <string.h>
 #include <dlib/align.h>
-#include <dlib/hash.h>
+#include <dlib/math.h>
 #include "ddf_loadcontext.h"
 #include "ddf_util.h"
 
@@ -29,7 +29,7 @@ namespace dmDDF
         {
             memset(buffer, 0, buffer_size);
         }
-        m_ArrayCount.SetCapacity(2048, 2048);
+        m_ArrayCountsRead = 0;
     }
 
     Message LoadContext::AllocMessage(const Descriptor* desc)
@@ -44,22 +44,8 @@ namespace dmDDF
 
     void* LoadContext::AllocRepeated(const FieldDescriptor* field_desc, int count)
     {
-        Type type = (Type) field_desc->m_Type;
-
         m_Current = (char*) DM_ALIGN(m_Current, 16);
-        int element_size = 0;
-        if ( field_desc->m_Type == TYPE_MESSAGE )
-        {
-            element_size = field_desc->m_MessageDescriptor->m_Size;
-        }
-        else if ( field_desc->m_Type == TYPE_STRING )
-        {
-            element_size = sizeof(const char*);
-        }
-        else
-        {
-            element_size = ScalarTypeSize(type);
-        }
+        int element_size = RepeatedElementSize(field_desc);
 
         char* b = m_Current;
         m_Current += count * element_size;
@@ -112,27 +98,33 @@ namespace dmDDF
         return (int) (m_Current - m_Start);
     }
 
-    void LoadContext::IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number)
+    uint32_t LoadContext::AddArrayCounts(uint32_t count)
     {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        if(m_ArrayCount.Full())
-            m_ArrayCount.SetCapacity(2048, m_ArrayCount.Capacity() + 1024);
-        uint32_t* value_p = m_ArrayCount.Get(hash);
-        if(value_p) {
-            (*value_p)++;
-        }
-        else {
-            m_ArrayCount.Put(hash, 1);
+        uint32_t index = m_ArrayCounts.Size();
+        if (m_ArrayCounts.Remaining() < count)
+        {
+            m_ArrayCounts.OffsetCapacity(dmMath::Max(count, 256U));
         }
+        m_ArrayCounts.SetSize(index + count);
+        memset(m_ArrayCounts.Begin() + index, 0, count * sizeof(uint32_t));
+        return index;
     }
 
-    uint32_t LoadContext::GetArrayCount(uint32_t buffer_pos, uint32_t field_number)
+    void LoadContext::IncreaseArrayCount(uint32_t index)
     {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        uint32_t *value_p = m_ArrayCount.Get(hash);
-        return value_p == 0 ? 0 : *value_p;
+        m_ArrayCounts[index]++;
+    }
+
+    uint32_t LoadContext::NextArrayCounts(uint32_t count)
+    {
+        uint32_t index = m_ArrayCountsRead;
+        m_ArrayCountsRead += count;
+        assert(m_ArrayCountsRead <= m_ArrayCounts.Size());
+        return index;
     }
-}
 
+    uint32_t LoadContext::GetArrayCount(uint32_t index)
+    {
+        return m_ArrayCounts[index];
+    }
+}
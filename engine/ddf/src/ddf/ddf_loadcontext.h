@@ -14,7 +14,7 @@
 #define DDF_LOADCONTEXT_H
 
 #include <stdint.h>
-#include <dlib/hashtable.h>
+#include <dlib/array.h>
 #include "ddf.h"
 #include "ddf_message.h"
 
@@ -36,8 +36,12 @@ namespace dmDDF
         void        SetMemoryBuffer(char* buffer, int buffer_size, bool dry_run);
         int         GetMemoryUsage();
 
-        void        IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number);
-        uint32_t    GetArrayCount(uint32_t buffer_pos, uint32_t field_number);
+        // The element counts of the repeated fields are recorded with one slot per field and message,
+        // in the order the messages are visited. The same order is used when the message is loaded.
+        uint32_t    AddArrayCounts(uint32_t count);
+        void        IncreaseArrayCount(uint32_t index);
+        uint32_t    NextArrayCounts(uint32_t count);
+        uint32_t    GetArrayCount(uint32_t index);
 
         inline uint32_t GetOptions()
         {
@@ -45,7 +49,8 @@ namespace dmDDF
         }
 
     private:
-        dmHashTable32<uint32_t> m_ArrayCount;
+        dmArray<uint32_t> m_ArrayCounts;
+        uint32_t          m_ArrayCountsRead;
 
         char* m_Start;
         char* m_End;
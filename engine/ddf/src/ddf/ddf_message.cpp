@@ -346,6 +346,19 @@ namespace dmDDF
     {
         assert((Type) field->m_Type == TYPE_BYTES);
 
+        if (load_context->GetOptions() & OPTION_BORROW_BYTES)
+        {
+            assert((load_context->GetOptions() & OPTION_OFFSET_POINTERS) == 0);
+            if (!m_DryRun)
+            {
+                RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+                assert(repeated_field->m_ArrayCount == 0);
+                repeated_field->m_Array = (uintptr_t) buffer;
+                repeated_field->m_ArrayCount = buffer_len;
+            }
+            return;
+        }
+
         // Always alloc
         char* bytes_buf = load_context->AllocBytes(buffer_len);
 
@@ -51,6 +51,22 @@ namespace dmDDF
             return -1;
         }
     }
+
+    uint32_t RepeatedElementSize(const FieldDescriptor* field)
+    {
+        if (field->m_Type == TYPE_MESSAGE)
+        {
+            return field->m_MessageDescriptor->m_Size;
+        }
+        else if (field->m_Type == TYPE_STRING)
+        {
+            return sizeof(const char*);
+        }
+        else
+        {
+            return ScalarTypeSize(field->m_Type);
+        }
+    }
 }
 
 
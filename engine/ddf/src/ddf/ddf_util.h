@@ -33,8 +33,26 @@ namespace dmDDF
         return index;
     }
 
+    /**
+     * Calculates the size of an element in a repeated field
+     * @param field Field
+     * @return Element size
+     */
+    uint32_t RepeatedElementSize(const FieldDescriptor* field);
+
     static inline const FieldDescriptor* FindField(const Descriptor* desc, uint32_t key, uint32_t* index)
     {
+        if (desc->m_FieldIndices)
+        {
+            // All fields are in the table
+            uint32_t i = key < desc->m_FieldIndicesCount ? desc->m_FieldIndices[key] : DDF_INVALID_FIELD_INDEX;
+            if (i == DDF_INVALID_FIELD_INDEX)
+                return 0;
+            if (index)
+                *index = i;
+            return &desc->m_Fields[i];
+        }
+
         for (int i = 0; i < desc->m_FieldCount; ++i)
         {
             const FieldDescriptor* f = &desc->m_Fields[i];
@@ -51,6 +51,10 @@ DDF_MINOR_VERSION=0
 
 DDF_POINTER_SIZE = 4
 
+# Descriptors get a field number to field index lookup table, if the max field number is below this
+DDF_MAX_FIELD_INDICES = 256
+DDF_INVALID_FIELD_INDEX = 0xff
+
 type_to_ctype = { FieldDescriptor.TYPE_DOUBLE : "double",
                   FieldDescriptor.TYPE_FLOAT : "float",
                   FieldDescriptor.TYPE_INT64 : "int64_t",
@@ -345,6 +349,17 @@ def to_cxx_descriptor(context, pp_cpp, pp_h, message_type, namespace_lst):
     else:
         pp_cpp.p("dmDDF::FieldDescriptor* %s_%s_FIELDS_DESCRIPTOR = 0x0;", namespace, message_type.name)
 
+    # Lookup table from field number to field index, unless the numbers are too sparse
+    max_number = max([f.number for f in message_type.field] + [0])
+    if len(lst) > 0 and max_number < DDF_MAX_FIELD_INDICES:
+        indices = [DDF_INVALID_FIELD_INDEX] * (max_number + 1)
+        for i, f in enumerate(message_type.field):
+            indices[f.number] = i
+        pp_cpp.p('const uint8_t %s_%s_FIELD_INDICES[] = { %s };', namespace, message_type.name, ', '.join(map(str, indices)))
+        field_indices = ('%s_%s_FIELD_INDICES' % (namespace, message_type.name), len(indices))
+    else:
+        field_indices = ('0x0', 0)
+
     pp_cpp.begin("dmDDF::Descriptor %s_%s_DESCRIPTOR = ", namespace, message_type.name)
     pp_cpp.p('%d, %d,', DDF_MAJOR_VERSION, DDF_MINOR_VERSION)
     pp_cpp.p('"%s",', to_lower_case(message_type.name))
@@ -355,6 +370,8 @@ def to_cxx_descriptor(context, pp_cpp, pp_h, message_type, namespace_lst):
         pp_cpp.p('sizeof(%s_%s_FIELDS_DESCRIPTOR)/sizeof(dmDDF::FieldDescriptor),', namespace, message_type.name)
     else:
         pp_cpp.p('0,')
+    pp_cpp.p('%s,', field_indices[0])
+    pp_cpp.p('%d,', field_indices[1])
     pp_cpp.end()
 
     pp_cpp.p('dmDDF::Descriptor* %s::%s::m_DDFDescriptor = &%s_%s_DESCRIPTOR;' % ('::'.join(namespace_lst), message_type.name, namespace, message_type.name))
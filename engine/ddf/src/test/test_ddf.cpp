@@ -561,6 +561,35 @@ TEST(Bytes, Load)
     dmDDF::FreeMessage(message);
 }
 
+TEST(Bytes, Borrow)
+{
+    TestDDF::Bytes bytes;
+    bytes.set_pad("..");
+    bytes.set_data((void*) "foo", 3);
+    std::string msg_str = bytes.SerializeAsString();
+    const char* msg_buf = msg_str.c_str();
+    uint32_t msg_buf_size = msg_str.size();
+    void* message;
+
+    uint32_t size, borrowed_size;
+    dmDDF::Result e = dmDDF::LoadMessage((void*) msg_buf, msg_buf_size, &DUMMY::TestDDF_Bytes_DESCRIPTOR, &message, 0, &size);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+    dmDDF::FreeMessage(message);
+
+    e = dmDDF::LoadMessage((void*) msg_buf, msg_buf_size, &DUMMY::TestDDF_Bytes_DESCRIPTOR, &message, dmDDF::OPTION_BORROW_BYTES, &borrowed_size);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+    ASSERT_GT(size, borrowed_size);
+
+    DUMMY::TestDDF::Bytes* msg = (DUMMY::TestDDF::Bytes*) message;
+    ASSERT_EQ((uint32_t) 3, msg->m_Data.m_Count);
+    // The data points into the input buffer
+    ASSERT_GE((uintptr_t) msg->m_Data.m_Data, (uintptr_t) msg_buf);
+    ASSERT_LE((uintptr_t) (msg->m_Data.m_Data + 3), (uintptr_t) (msg_buf + msg_buf_size));
+    ASSERT_EQ(0, memcmp("foo", msg->m_Data.m_Data, 3));
+
+    dmDDF::FreeMessage(message);
+}
+
 TEST(Material, Load)
 {
     TestDDF::MaterialDesc material_desc;
@@ -763,6 +792,48 @@ TEST(PointerOffset, ResolvePointers)
     free(msg);
 }
 
+TEST(FieldLookup, Descriptor)
+{
+    const dmDDF::Descriptor& d = DUMMY::TestDDF_NestedArraySub1_DESCRIPTOR;
+    ASSERT_NE((const uint8_t*) 0, d.m_FieldIndices);
+    ASSERT_EQ(4, d.m_FieldIndicesCount);
+    ASSERT_EQ(DDF_INVALID_FIELD_INDEX, d.m_FieldIndices[0]);
+    for (uint32_t i = 0; i < d.m_FieldCount; ++i)
+    {
+        ASSERT_EQ(i, d.m_FieldIndices[d.m_Fields[i].m_Number]);
+    }
+
+    // Too sparse for a lookup table
+    ASSERT_EQ((const uint8_t*) 0, DUMMY::TestDDF_SparseFields_DESCRIPTOR.m_FieldIndices);
+}
+
+TEST(FieldLookup, LoadSparse)
+{
+    TestDDF::SparseFields pb_sparse;
+    pb_sparse.set_s("sparse");
+    pb_sparse.set_a(10);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        pb_sparse.add_array()->set_a(i);
+    }
+
+    std::string msg_str = pb_sparse.SerializeAsString();
+    void* message;
+    dmDDF::Result e = dmDDF::LoadMessage((void*) msg_str.c_str(), msg_str.size(), &DUMMY::TestDDF_SparseFields_DESCRIPTOR, &message);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+
+    DUMMY::TestDDF::SparseFields* sparse = (DUMMY::TestDDF::SparseFields*) message;
+    ASSERT_EQ(10u, sparse->m_A);
+    ASSERT_STREQ("sparse", sparse->m_S);
+    ASSERT_EQ(3u, sparse->m_Array.m_Count);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(i, sparse->m_Array.m_Data[i].m_A);
+    }
+
+    dmDDF::FreeMessage(message);
+}
+
 TEST(AlignmentTests, AlignStruct)
 {
     DM_STATIC_ASSERT(sizeof(DUMMY::TestDDF::TestMessageAlignment) % 16 == 0, Invalid_Struct_Size);
@@ -0,0 +1,467 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include "safe_windows.h"
+#else
+#include <unistd.h>
+#endif
+
+#include "job_system.h"
+#include "atomic.h"
+#include "condition_variable.h"
+#include "math.h"
+#include "mutex.h"
+#include "spinlock.h"
+#include "thread.h"
+#include "time.h"
+
+namespace dmJobSystem
+{
+    struct Job
+    {
+        FJobFunc        m_Func;
+        FJobRangeFunc   m_RangeFunc;
+        void*           m_Context;
+        void*           m_Data;
+        uint32_t        m_Start;
+        uint32_t        m_End;
+        Job*            m_Parent;
+        // The job itself + number of unfinished children
+        int32_atomic_t  m_UnfinishedCount;
+        // The pending Run() + number of unfinished dependencies
+        int32_atomic_t  m_DependencyCount;
+        int32_atomic_t  m_ContinuationCount;
+        Job*            m_Continuations[MAX_CONTINUATIONS];
+    };
+
+    // The deques are protected by a spinlock each. The owner pushes and pops at the bottom (LIFO,
+    // for cache locality) and thieves steal from the top (FIFO, oldest and typically largest job first).
+    struct Deque
+    {
+        dmSpinlock::lock_t  m_Lock;
+        Job**               m_Entries;
+        uint32_t            m_Top;
+        uint32_t            m_Bottom;
+    };
+
+    struct Worker
+    {
+        Context*            m_Context;
+        dmThread::Thread    m_Thread;
+        uint32_t            m_Index;
+    };
+
+    struct Context
+    {
+        Job*                                    m_Jobs;
+        uint32_t                                m_MaxJobs;
+        int32_atomic_t                          m_JobCount;
+        // Number of jobs scheduled but not yet finished
+        int32_atomic_t                          m_ActiveCount;
+
+        // Deque 0 is shared by all non-worker threads, worker N owns deque N+1
+        Deque*                                  m_Deques;
+        uint32_t                                m_DequeCount;
+        int32_atomic_t                          m_QueuedCount;
+
+        Worker                                  m_Workers[MAX_WORKER_COUNT];
+        uint32_t                                m_WorkerCount;
+        dmThread::TlsKey                        m_ThreadIndexKey;
+
+        dmMutex::HMutex                         m_Mutex;
+        dmConditionVariable::HConditionVariable m_WakeupCond;
+        int32_atomic_t                          m_SleepingCount;
+        int32_atomic_t                          m_Run;
+    };
+
+    NewContextParams::NewContextParams()
+    {
+        memset(this, 0, sizeof(*this));
+        m_WorkerCount = GetDefaultWorkerCount();
+        m_MaxJobs     = 4096;
+        m_StackSize   = 0x80000;
+    }
+
+    uint32_t GetDefaultWorkerCount()
+    {
+#if defined(__EMSCRIPTEN__)
+        return 0;
+#else
+    #if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        long core_count = (long) info.dwNumberOfProcessors;
+    #elif defined(_SC_NPROCESSORS_ONLN)
+        long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+        long core_count = 1;
+    #endif
+        if (core_count <= 1)
+            return 0;
+        return dmMath::Min((uint32_t) core_count - 1, MAX_WORKER_COUNT);
+#endif
+    }
+
+    static uint32_t GetDequeIndex(Context* context)
+    {
+        return (uint32_t) (uintptr_t) dmThread::GetTlsValue(context->m_ThreadIndexKey);
+    }
+
+    static void Push(Context* context, Job* job)
+    {
+        Deque* deque = &context->m_Deques[GetDequeIndex(context)];
+        {
+            DM_SPINLOCK_SCOPED_LOCK(deque->m_Lock);
+            assert(deque->m_Bottom - deque->m_Top < context->m_MaxJobs);
+            deque->m_Entries[deque->m_Bottom & (context->m_MaxJobs - 1)] = job;
+            deque->m_Bottom++;
+        }
+
+        // Full barrier, pairs with the barrier of the increment of m_SleepingCount in WorkerThread
+        dmAtomicIncrement32(&context->m_QueuedCount);
+        if (context->m_SleepingCount > 0)
+        {
+            DM_MUTEX_SCOPED_LOCK(context->m_Mutex);
+            dmConditionVariable::Signal(context->m_WakeupCond);
+        }
+    }
+
+    static Job* Pop(Context* context, Deque* deque)
+    {
+        DM_SPINLOCK_SCOPED_LOCK(deque->m_Lock);
+        if (deque->m_Bottom == deque->m_Top)
+            return 0;
+        deque->m_Bottom--;
+        return deque->m_Entries[deque->m_Bottom & (context->m_MaxJobs - 1)];
+    }
+
+    static Job* Steal(Context* context, Deque* deque)
+    {
+        DM_SPINLOCK_SCOPED_LOCK(deque->m_Lock);
+        if (deque->m_Bottom == deque->m_Top)
+            return 0;
+        Job* job = deque->m_Entries[deque->m_Top & (context->m_MaxJobs - 1)];
+        deque->m_Top++;
+        return job;
+    }
+
+    static Job* GetJob(Context* context)
+    {
+        if (context->m_QueuedCount <= 0)
+            return 0;
+
+        uint32_t index = GetDequeIndex(context);
+        Job* job = Pop(context, &context->m_Deques[index]);
+        for (uint32_t i = 1; job == 0 && i < context->m_DequeCount; ++i)
+        {
+            job = Steal(context, &context->m_Deques[(index + i) % context->m_DequeCount]);
+        }
+
+        if (job)
+        {
+            dmAtomicDecrement32(&context->m_QueuedCount);
+        }
+        return job;
+    }
+
+    static void Finish(Context* context, Job* job)
+    {
+        if (dmAtomicDecrement32(&job->m_UnfinishedCount) != 1)
+            return;
+
+        uint32_t continuation_count = (uint32_t) job->m_ContinuationCount;
+        for (uint32_t i = 0; i < continuation_count; ++i)
+        {
+            Job* continuation = job->m_Continuations[i];
+            if (dmAtomicDecrement32(&continuation->m_DependencyCount) == 1)
+            {
+                Push(context, continuation);
+            }
+        }
+
+        if (job->m_Parent)
+        {
+            Finish(context, job->m_Parent);
+        }
+
+        dmAtomicDecrement32(&context->m_ActiveCount);
+    }
+
+    static void Execute(Context* context, Job* job)
+    {
+        if (job->m_RangeFunc)
+        {
+            job->m_RangeFunc(job->m_Context, job->m_Data, job->m_Start, job->m_End);
+        }
+        else if (job->m_Func)
+        {
+            job->m_Func(job->m_Context, job->m_Data);
+        }
+        Finish(context, job);
+    }
+
+    static void WorkerThread(void* arg)
+    {
+        Worker* worker = (Worker*) arg;
+        Context* context = worker->m_Context;
+        dmThread::SetTlsValue(context->m_ThreadIndexKey, (void*) (uintptr_t) (worker->m_Index + 1));
+
+        while (context->m_Run)
+        {
+            Job* job = GetJob(context);
+            if (job)
+            {
+                Execute(context, job);
+                continue;
+            }
+
+            DM_MUTEX_SCOPED_LOCK(context->m_Mutex);
+            dmAtomicIncrement32(&context->m_SleepingCount);
+            while (context->m_QueuedCount <= 0 && context->m_Run)
+            {
+                dmConditionVariable::Wait(context->m_WakeupCond, context->m_Mutex);
+            }
+            dmAtomicDecrement32(&context->m_SleepingCount);
+        }
+    }
+
+    HContext NewContext(const NewContextParams& params)
+    {
+        Context* context = new Context;
+        memset(context, 0, sizeof(*context));
+
+        uint32_t max_jobs = 1;
+        while (max_jobs < params.m_MaxJobs)
+            max_jobs <<= 1;
+
+        context->m_MaxJobs = max_jobs;
+        context->m_Jobs = new Job[max_jobs];
+
+#if defined(__EMSCRIPTEN__)
+        context->m_WorkerCount = 0;
+#else
+        context->m_WorkerCount = dmMath::Min(params.m_WorkerCount, MAX_WORKER_COUNT);
+#endif
+        context->m_DequeCount = context->m_WorkerCount + 1;
+        context->m_Deques = new Deque[context->m_DequeCount];
+        for (uint32_t i = 0; i < context->m_DequeCount; ++i)
+        {
+            Deque* deque = &context->m_Deques[i];
+            dmSpinlock::Init(&deque->m_Lock);
+            deque->m_Entries = new Job*[max_jobs];
+            deque->m_Top = 0;
+            deque->m_Bottom = 0;
+        }
+
+        context->m_ThreadIndexKey = dmThread::AllocTls();
+        context->m_Mutex = dmMutex::New();
+        context->m_WakeupCond = dmConditionVariable::New();
+        context->m_Run = 1;
+
+        for (uint32_t i = 0; i < context->m_WorkerCount; ++i)
+        {
+            Worker* worker = &context->m_Workers[i];
+            worker->m_Context = context;
+            worker->m_Index = i;
+            worker->m_Thread = dmThread::New(WorkerThread, params.m_StackSize, worker, "jobworker");
+        }
+
+        return context;
+    }
+
+    void DeleteContext(HContext context)
+    {
+        NewFrame(context);
+
+        {
+            DM_MUTEX_SCOPED_LOCK(context->m_Mutex);
+            dmAtomicStore32(&context->m_Run, 0);
+            dmConditionVariable::Broadcast(context->m_WakeupCond);
+        }
+
+        for (uint32_t i = 0; i < context->m_WorkerCount; ++i)
+        {
+            dmThread::Join(context->m_Workers[i].m_Thread);
+        }
+
+        for (uint32_t i = 0; i < context->m_DequeCount; ++i)
+        {
+            delete [] context->m_Deques[i].m_Entries;
+        }
+        delete [] context->m_Deques;
+        delete [] context->m_Jobs;
+
+        dmConditionVariable::Delete(context->m_WakeupCond);
+        dmMutex::Delete(context->m_Mutex);
+        dmThread::FreeTls(context->m_ThreadIndexKey);
+        delete context;
+    }
+
+    uint32_t GetWorkerCount(HContext context)
+    {
+        return context->m_WorkerCount;
+    }
+
+    void NewFrame(HContext context)
+    {
+        assert(GetDequeIndex(context) == 0);
+        // Atomic read, to make sure the jobs' writes are visible before the pool is reused
+        while (dmAtomicAdd32(&context->m_ActiveCount, 0) > 0)
+        {
+            Job* job = GetJob(context);
+            if (job)
+                Execute(context, job);
+            else
+                dmTime::Sleep(0);
+        }
+        dmAtomicStore32(&context->m_JobCount, 0);
+    }
+
+    static Job* AllocJob(Context* context)
+    {
+        int32_t index = dmAtomicIncrement32(&context->m_JobCount);
+        if (index >= (int32_t) context->m_MaxJobs)
+        {
+            // Keep the counter from wrapping around if we keep trying
+            dmAtomicDecrement32(&context->m_JobCount);
+            return 0;
+        }
+
+        Job* job = &context->m_Jobs[index];
+        memset(job, 0, sizeof(*job));
+        job->m_UnfinishedCount = 1;
+        job->m_DependencyCount = 1;
+        return job;
+    }
+
+    HJob CreateJob(HContext context, FJobFunc func, void* user_context, void* user_data)
+    {
+        Job* job = AllocJob(context);
+        if (job)
+        {
+            job->m_Func = func;
+            job->m_Context = user_context;
+            job->m_Data = user_data;
+        }
+        return job;
+    }
+
+    HJob CreateChildJob(HContext context, HJob parent, FJobFunc func, void* user_context, void* user_data)
+    {
+        Job* job = CreateJob(context, func, user_context, user_data);
+        if (job)
+        {
+            job->m_Parent = parent;
+            dmAtomicIncrement32(&parent->m_UnfinishedCount);
+        }
+        return job;
+    }
+
+    Result AddDependency(HContext context, HJob job, HJob depends_on)
+    {
+        if (job == 0 || depends_on == 0 || job == depends_on)
+            return RESULT_INVALID_PARAM;
+
+        int32_t index = dmAtomicIncrement32(&depends_on->m_ContinuationCount);
+        if (index >= (int32_t) MAX_CONTINUATIONS)
+        {
+            dmAtomicDecrement32(&depends_on->m_ContinuationCount);
+            return RESULT_OUT_OF_RESOURCES;
+        }
+        depends_on->m_Continuations[index] = job;
+        dmAtomicIncrement32(&job->m_DependencyCount);
+        return RESULT_OK;
+    }
+
+    void Run(HContext context, HJob job)
+    {
+        dmAtomicIncrement32(&context->m_ActiveCount);
+        if (dmAtomicDecrement32(&job->m_DependencyCount) == 1)
+        {
+            Push(context, job);
+        }
+    }
+
+    bool IsFinished(HJob job)
+    {
+        // Atomic read, to make sure the job's writes are visible to the caller when it's finished
+        return dmAtomicAdd32(&job->m_UnfinishedCount, 0) <= 0;
+    }
+
+    void Wait(HContext context, HJob job)
+    {
+        while (!IsFinished(job))
+        {
+            Job* next = GetJob(context);
+            if (next)
+                Execute(context, next);
+            else
+                dmTime::Sleep(0);
+        }
+    }
+
+    void ParallelFor(HContext context, FJobRangeFunc func, void* user_context, void* user_data, uint32_t count, uint32_t min_batch_size)
+    {
+        if (count == 0)
+            return;
+
+        min_batch_size = dmMath::Max(min_batch_size, 1U);
+        uint32_t batch_count = 1;
+        if (context)
+        {
+            // A few batches per thread evens out the load when the items aren't equally expensive
+            batch_count = dmMath::Min(count / min_batch_size, (context->m_WorkerCount + 1) * 4);
+        }
+
+        if (batch_count <= 1)
+        {
+            func(user_context, user_data, 0, count);
+            return;
+        }
+
+        Job* root = CreateJob(context, 0, 0, 0);
+        if (!root)
+        {
+            func(user_context, user_data, 0, count);
+            return;
+        }
+
+        uint32_t batch_size = (count + batch_count - 1) / batch_count;
+        uint32_t start = 0;
+        while (start < count)
+        {
+            uint32_t end = dmMath::Min(start + batch_size, count);
+            Job* job = CreateChildJob(context, root, 0, user_context, user_data);
+            if (!job)
+                break;
+            job->m_RangeFunc = func;
+            job->m_Start = start;
+            job->m_End = end;
+            Run(context, job);
+            start = end;
+        }
+
+        Run(context, root);
+
+        // Out of jobs, process the remainder on this thread
+        if (start < count)
+        {
+            func(user_context, user_data, start, count);
+        }
+
+        Wait(context, root);
+    }
+}
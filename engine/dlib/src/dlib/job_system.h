@@ -0,0 +1,197 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_JOB_SYSTEM_H
+#define DM_JOB_SYSTEM_H
+
+#include <stdint.h>
+
+/**
+ * Work-stealing job system.
+ *
+ * A context owns a number of worker threads, each with its own job deque. A worker
+ * pops jobs from the bottom of its own deque and steals from the top of the others
+ * when it runs dry. Threads that are not workers (e.g. the main thread) share an
+ * additional deque, and participate in the work when they call Wait().
+ *
+ * Jobs are allocated from a frame scoped pool. The pool is reset with NewFrame(),
+ * after which all job handles from the previous frame are invalid. This makes
+ * building a per-frame task graph cheap: no individual job is ever freed.
+ *
+ * A job is finished when its function has returned and all of its children are finished.
+ * When a job is finished, all jobs depending on it (see AddDependency()) that have no other
+ * unfinished dependencies are scheduled.
+ */
+namespace dmJobSystem
+{
+    /**
+     * Job system context handle
+     */
+    typedef struct Context* HContext;
+
+    /**
+     * Job handle. Only valid until the next call to NewFrame()
+     */
+    typedef struct Job* HJob;
+
+    /**
+     * Job function
+     * @param context user context
+     * @param data user data
+     */
+    typedef void (*FJobFunc)(void* context, void* data);
+
+    /**
+     * Job function processing a range of items
+     * @param context user context
+     * @param data user data
+     * @param start first index (inclusive)
+     * @param end last index (exclusive)
+     */
+    typedef void (*FJobRangeFunc)(void* context, void* data, uint32_t start, uint32_t end);
+
+    /**
+     * Result enumeration
+     */
+    enum Result
+    {
+        RESULT_OK                   = 0,
+        RESULT_OUT_OF_RESOURCES     = -1,
+        RESULT_INVALID_PARAM        = -2,
+    };
+
+    /**
+     * Max number of jobs that can depend on a single job
+     */
+    const uint32_t MAX_CONTINUATIONS = 14;
+
+    /**
+     * Max number of worker threads in a context
+     */
+    const uint32_t MAX_WORKER_COUNT = 32;
+
+    /**
+     * Parameters passed to NewContext()
+     */
+    struct NewContextParams
+    {
+        /// Number of worker threads. Default is the number of logical cores minus one (for the calling thread)
+        uint32_t m_WorkerCount;
+        /// Max number of jobs created between two calls to NewFrame(). Rounded up to a power of two. Default is 4096
+        uint32_t m_MaxJobs;
+        /// Worker thread stack size. Default is 0x80000
+        uint32_t m_StackSize;
+
+        NewContextParams();
+    };
+
+    /**
+     * Get the default number of worker threads for this platform.
+     * @return number of logical cores minus one, or zero on platforms without thread support
+     */
+    uint32_t GetDefaultWorkerCount();
+
+    /**
+     * Create a new job system context and start its worker threads
+     * @param params parameters
+     * @return context handle
+     */
+    HContext NewContext(const NewContextParams& params);
+
+    /**
+     * Stop all worker threads and delete the context. All running jobs must be finished.
+     * @param context context handle
+     */
+    void DeleteContext(HContext context);
+
+    /**
+     * Get the number of worker threads
+     * @param context context handle
+     * @return number of worker threads
+     */
+    uint32_t GetWorkerCount(HContext context);
+
+    /**
+     * Wait for all scheduled jobs and reset the job pool. All job handles created
+     * since the previous call are invalidated. Must not be called from a job.
+     * @param context context handle
+     */
+    void NewFrame(HContext context);
+
+    /**
+     * Create a new job. The job isn't scheduled until Run() is called.
+     * @param context context handle
+     * @param func job function. May be 0x0, in which case the job is only used for grouping/synchronization
+     * @param user_context user context passed to the function
+     * @param user_data user data passed to the function
+     * @return job handle, or 0x0 if the frame pool is exhausted
+     */
+    HJob CreateJob(HContext context, FJobFunc func, void* user_context, void* user_data);
+
+    /**
+     * Create a new child job. The parent isn't finished until all of its children are finished.
+     * Must be called either before the parent is scheduled, or from within the parent job function.
+     * @param context context handle
+     * @param parent parent job
+     * @param func job function
+     * @param user_context user context passed to the function
+     * @param user_data user data passed to the function
+     * @return job handle, or 0x0 if the frame pool is exhausted
+     */
+    HJob CreateChildJob(HContext context, HJob parent, FJobFunc func, void* user_context, void* user_data);
+
+    /**
+     * Make a job depend on another job, i.e. the job is run as a continuation
+     * once the other job is finished. Must be called before any of the jobs are scheduled.
+     * @param context context handle
+     * @param job the job to delay
+     * @param depends_on the job that must finish first
+     * @return RESULT_OK on success, RESULT_OUT_OF_RESOURCES if depends_on has MAX_CONTINUATIONS continuations already
+     */
+    Result AddDependency(HContext context, HJob job, HJob depends_on);
+
+    /**
+     * Schedule a job. The job is executed as soon as all of its dependencies are finished.
+     * @param context context handle
+     * @param job job handle
+     */
+    void Run(HContext context, HJob job);
+
+    /**
+     * Check if a job is finished
+     * @param job job handle
+     * @return true if the job and all of its children are finished
+     */
+    bool IsFinished(HJob job);
+
+    /**
+     * Wait for a job to finish. The calling thread executes pending jobs while waiting.
+     * @param context context handle
+     * @param job job handle
+     */
+    void Wait(HContext context, HJob job);
+
+    /**
+     * Process the range [0, count) in batches spread over all worker threads, and wait for the result.
+     * The function is called directly on the calling thread if the context is 0x0, if the
+     * range is too small to split, or for the part of the range that doesn't fit in the job pool.
+     * @param context context handle. May be 0x0
+     * @param func range function
+     * @param user_context user context passed to the function
+     * @param user_data user data passed to the function
+     * @param count number of items
+     * @param min_batch_size the minimum number of items processed by one job
+     */
+    void ParallelFor(HContext context, FJobRangeFunc func, void* user_context, void* user_data, uint32_t count, uint32_t min_batch_size);
+}
+
+#endif // DM_JOB_SYSTEM_H
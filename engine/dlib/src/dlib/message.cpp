@@ -11,11 +11,11 @@
 // specific language governing permissions and limitations under the License.
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include "message.h"
 #include "atomic.h"
 #include "hash.h"
-#include "hashtable.h"
 #include "profile.h"
 #include "array.h"
 #include "condition_variable.h"
@@ -23,30 +23,52 @@
 #include <dlib/mutex.h>
 #include <dlib/static_assert.h>
 #include <dlib/spinlock.h>
+#include <dlib/thread.h>
 
 namespace dmMessage
 {
     // Alignment of allocations
     const uint32_t DM_MESSAGE_ALIGNMENT = 16U;
 
+    // Each message is preceded by the page it was allocated from,
+    // so that the dispatcher can release the page once all its messages are dispatched
+    const uint32_t DM_MESSAGE_HEADER_SIZE = DM_MESSAGE_ALIGNMENT;
+    // Added to the pending count while a page is the current page, so it can't reach zero
+    const int32_t DM_MESSAGE_CURRENT_PAGE_BIAS = 0x40000000;
+    // Number of posting threads that get a current page of their own in each socket.
+    // Any further threads share one current page under a spinlock.
+    const uint32_t DM_MESSAGE_MAX_THREAD_PAGES = 32;
+
     struct MemoryPage
     {
-        uint8_t     m_Memory[DM_MESSAGE_PAGE_SIZE];
-        uint32_t    m_Current;
-        MemoryPage* m_NextPage;
+        uint8_t         m_Memory[DM_MESSAGE_PAGE_SIZE + DM_MESSAGE_HEADER_SIZE];
+        uint32_t        m_Current;
+        // Messages allocated from the page, only updated while it is the current page
+        int32_t         m_Allocated;
+        // Messages not yet dispatched, see DM_MESSAGE_CURRENT_PAGE_BIAS
+        int32_atomic_t  m_Pending;
+        MemoryPage*     m_NextPage;
+        MemoryPage*     m_NextAllocated;
     };
 
     struct MemoryAllocator
     {
         MemoryAllocator()
         {
-            m_CurrentPage = 0;
+            memset(m_CurrentPages, 0, sizeof(m_CurrentPages));
             m_FreePages = 0;
-            m_FullPages = 0;
-        }
-        MemoryPage* m_CurrentPage;
-        MemoryPage* m_FreePages;
-        MemoryPage* m_FullPages;
+            m_AllocatedPages = 0;
+        }
+        // The current page of each posting thread, only touched by that thread.
+        // The last one is shared by the threads without a page of their own.
+        MemoryPage*     m_CurrentPages[DM_MESSAGE_MAX_THREAD_PAGES + 1];
+        // Pushed with a compare and swap, popped under m_Lock
+        void* volatile  m_FreePages;
+        MemoryPage*     m_AllocatedPages;
+        // Only held while taking a free page or allocating a new one
+        dmSpinlock::lock_t m_Lock;
+        // Guards the shared current page
+        dmSpinlock::lock_t m_SharedLock;
     };
 
     struct GlobalInit
@@ -58,80 +80,198 @@ namespace dmMessage
 
     } g_MessageInit;
 
-    static void AllocateNewPage(MemoryAllocator* allocator)
+    static void PushFreePage(MemoryAllocator* allocator, MemoryPage* page)
     {
-        if (allocator->m_CurrentPage)
+        void* head;
+        do
         {
-            // Link current page to full pages
-            allocator->m_CurrentPage->m_NextPage = allocator->m_FullPages;
-            allocator->m_FullPages = allocator->m_CurrentPage;
-        }
+            head = allocator->m_FreePages;
+            page->m_NextPage = (MemoryPage*) head;
+        } while (dmAtomicCompareStorePtr(&allocator->m_FreePages, page, head) != head);
+    }
 
-        MemoryPage* new_page = 0;
+    // Pops are serialized by the allocator lock, so the head can't be popped and pushed back between
+    // reading its next page and the compare and swap
+    static MemoryPage* PopFreePage(MemoryAllocator* allocator)
+    {
+        MemoryPage* page;
+        do
+        {
+            page = (MemoryPage*) allocator->m_FreePages;
+            if (page == 0)
+            {
+                return 0;
+            }
+        } while (dmAtomicCompareStorePtr(&allocator->m_FreePages, page->m_NextPage, page) != page);
+        return page;
+    }
 
-        if (allocator->m_FreePages)
+    // Replaces the current page of a posting thread
+    static MemoryPage* AllocateNewPage(MemoryAllocator* allocator, MemoryPage** current_page_slot)
+    {
+        MemoryPage* current_page = *current_page_slot;
+        if (current_page)
         {
-            // Free page to use
-            new_page = allocator->m_FreePages;
-            allocator->m_FreePages = new_page->m_NextPage;
+            // Replace the bias with the final number of allocated messages
+            int32_t delta = current_page->m_Allocated - DM_MESSAGE_CURRENT_PAGE_BIAS;
+            if (dmAtomicAdd32(&current_page->m_Pending, delta) + delta == 0)
+            {
+                // All messages in the page are already dispatched
+                PushFreePage(allocator, current_page);
+            }
         }
-        else
+
+        MemoryPage* new_page;
         {
-            // Allocate new page
-            new_page = new MemoryPage;
+            DM_SPINLOCK_SCOPED_LOCK(allocator->m_Lock);
+            new_page = PopFreePage(allocator);
+            if (new_page == 0)
+            {
+                // Allocate new page
+                new_page = new MemoryPage;
+                new_page->m_NextAllocated = allocator->m_AllocatedPages;
+                allocator->m_AllocatedPages = new_page;
+            }
         }
 
         new_page->m_Current = 0;
+        new_page->m_Allocated = 0;
+        new_page->m_Pending = DM_MESSAGE_CURRENT_PAGE_BIAS;
         new_page->m_NextPage = 0;
 
-        allocator->m_CurrentPage = new_page;
+        *current_page_slot = new_page;
+        return new_page;
     }
 
+    static uint32_t GetThreadPageIndex();
+
     static void* AllocateMessage(MemoryAllocator* allocator, uint32_t size)
     {
         // At least ALIGNMENT bytes alignment of size in order to ensure that the next allocation is aligned
-        size += DM_MESSAGE_ALIGNMENT-1;
+        size += DM_MESSAGE_HEADER_SIZE + DM_MESSAGE_ALIGNMENT-1;
         size &= ~(DM_MESSAGE_ALIGNMENT-1);
-        assert(size <= DM_MESSAGE_PAGE_SIZE);
+        assert(size <= DM_MESSAGE_PAGE_SIZE + DM_MESSAGE_HEADER_SIZE);
 
-        if (allocator->m_CurrentPage == 0 || (DM_MESSAGE_PAGE_SIZE-allocator->m_CurrentPage->m_Current) < size)
+        uint32_t index = GetThreadPageIndex();
+        bool shared = index == DM_MESSAGE_MAX_THREAD_PAGES;
+        if (shared)
+        {
+            dmSpinlock::Lock(&allocator->m_SharedLock);
+        }
+
+        MemoryPage** current_page_slot = &allocator->m_CurrentPages[index];
+        MemoryPage* page = *current_page_slot;
+        if (page == 0 || (sizeof(page->m_Memory)-page->m_Current) < size)
         {
             // No current page or allocation didn't fit.
-            AllocateNewPage(allocator);
+            page = AllocateNewPage(allocator, current_page_slot);
         }
 
-        MemoryPage* page = allocator->m_CurrentPage;
-        void* ret = (void*) ((uintptr_t) &page->m_Memory[0] + page->m_Current);
+        uint8_t* ret = &page->m_Memory[page->m_Current];
         page->m_Current += size;
-        return ret;
+        page->m_Allocated++;
+
+        if (shared)
+        {
+            dmSpinlock::Unlock(&allocator->m_SharedLock);
+        }
+
+        *(MemoryPage**) ret = page;
+        return ret + DM_MESSAGE_HEADER_SIZE;
+    }
+
+    static MemoryPage* GetMessagePage(Message* message)
+    {
+        return *(MemoryPage**) ((uint8_t*) message - DM_MESSAGE_HEADER_SIZE);
+    }
+
+    // Release a number of dispatched messages allocated from the page
+    static void ReleaseMessages(MemoryAllocator* allocator, MemoryPage* page, int32_t count)
+    {
+        if (dmAtomicSub32(&page->m_Pending, count) - count == 0)
+        {
+            // Last messages in a page that is no longer the current page
+            PushFreePage(allocator, page);
+        }
     }
 
     struct MessageSocket
     {
-        uint32_t        m_RefCount; // Is protected by "g_MessageContext->m_Spinlock"
+        // Zero once the socket is disposed. Lookups only take a reference while it is above zero.
+        int32_atomic_t  m_RefCount;
+        // Cleared when the socket is deleted, so that lookups that raced the delete can tell
         dmhash_t        m_NameHash;
-        Message*        m_Header;
-        Message*        m_Tail;
+        // Posted messages in reverse order. Producers push with a compare and swap,
+        // the dispatcher takes the whole list at once.
+        void* volatile  m_Messages;
         const char*     m_Name;
+        // Only used by DispatchBlocking to wait for the first message
+        int32_atomic_t  m_Waiting;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_Condition;
         MemoryAllocator m_Allocator;
     };
 
+    // Returns true if the socket had no messages
+    static bool PushMessage(MessageSocket* s, Message* message)
+    {
+        void* head;
+        do
+        {
+            head = s->m_Messages;
+            message->m_Next = (Message*) head;
+        } while (dmAtomicCompareStorePtr(&s->m_Messages, message, head) != head);
+        return head == 0;
+    }
+
+    // Takes all posted messages, in the order they were posted
+    static Message* TakeMessages(MessageSocket* s)
+    {
+        Message* message = (Message*) dmAtomicStorePtr(&s->m_Messages, 0);
+        Message* ordered = 0;
+        while (message)
+        {
+            Message* next = message->m_Next;
+            message->m_Next = ordered;
+            ordered = message;
+            message = next;
+        }
+        return ordered;
+    }
+
     const uint32_t MAX_SOCKETS = 256;
+    // Open addressing table of the live sockets, twice the size to keep the probes short
+    const uint32_t SOCKET_TABLE_SIZE = 2 * MAX_SOCKETS;
+    // Left in the table where a socket was deleted, so that probes continue past it
+    static MessageSocket* const DELETED_SOCKET = (MessageSocket*) 1;
 
     struct MessageContext
     {
-        dmHashTable64<MessageSocket> m_Sockets;
-        dmSpinlock::lock_t m_Spinlock;
+        // Sockets are never freed while the context lives, so a lookup may read a socket
+        // that is being deleted and check its reference count and name
+        MessageSocket       m_SocketPool[MAX_SOCKETS];
+        bool                m_SocketPoolUsed[MAX_SOCKETS];
+        // Read without locking, only written under m_Spinlock
+        void* volatile      m_SocketTable[SOCKET_TABLE_SIZE];
+        uint32_t            m_SocketCount;
+        // Index + 1 of the current page of a posting thread, see GetThreadPageIndex
+        dmThread::TlsKey    m_ThreadPageKey;
+        int32_atomic_t      m_ThreadPageCount;
+        // Guards socket creation and deletion, never taken when looking up or posting to a socket
+        dmSpinlock::lock_t  m_Spinlock;
     };
 
     MessageContext* g_MessageContext = 0;
 
-    static MessageContext* Create(uint32_t max_sockets)
+    static MessageContext* Create()
     {
         MessageContext* ctx = new MessageContext;
-        ctx->m_Sockets.SetCapacity(max_sockets, max_sockets);
+        memset((void*) ctx->m_SocketPool, 0, sizeof(ctx->m_SocketPool));
+        memset(ctx->m_SocketPoolUsed, 0, sizeof(ctx->m_SocketPoolUsed));
+        memset((void*) ctx->m_SocketTable, 0, sizeof(ctx->m_SocketTable));
+        ctx->m_SocketCount = 0;
+        ctx->m_ThreadPageKey = dmThread::AllocTls();
+        ctx->m_ThreadPageCount = 0;
         dmSpinlock::Init(&ctx->m_Spinlock);
         return ctx;
     }
@@ -144,48 +284,146 @@ namespace dmMessage
         {
             if (g_MessageContext)
             {
+                dmThread::FreeTls(g_MessageContext->m_ThreadPageKey);
                 delete g_MessageContext;
                 g_MessageContext = 0;
             }
         }
     } g_ContextDestroyer;
 
+    // Each posting thread gets its own current page in every socket, the first time it posts
+    static uint32_t GetThreadPageIndex()
+    {
+        uintptr_t index = (uintptr_t) dmThread::GetTlsValue(g_MessageContext->m_ThreadPageKey);
+        if (index == 0)
+        {
+            index = (uintptr_t) dmAtomicIncrement32(&g_MessageContext->m_ThreadPageCount);
+            if (index > DM_MESSAGE_MAX_THREAD_PAGES)
+            {
+                index = DM_MESSAGE_MAX_THREAD_PAGES;
+            }
+            index++;
+            dmThread::SetTlsValue(g_MessageContext->m_ThreadPageKey, (void*) index);
+        }
+        return (uint32_t) index - 1;
+    }
+
+    static bool TryAddRef(MessageSocket* s)
+    {
+        int32_t ref_count;
+        do
+        {
+            ref_count = s->m_RefCount;
+            if (ref_count == 0)
+            {
+                return false;
+            }
+        } while (dmAtomicCompareStore32(&s->m_RefCount, ref_count + 1, ref_count) != ref_count);
+        return true;
+    }
+
+    // Lock-free lookup of a live socket. The socket may be deleted as soon as it is returned,
+    // use AcquireSocket to keep it alive.
+    static MessageSocket* FindSocket(HSocket socket)
+    {
+        const uint32_t mask = SOCKET_TABLE_SIZE - 1;
+        uint32_t index = (uint32_t) socket & mask;
+        for (uint32_t i = 0; i < SOCKET_TABLE_SIZE; ++i)
+        {
+            MessageSocket* s = (MessageSocket*) g_MessageContext->m_SocketTable[(index + i) & mask];
+            if (s == 0)
+            {
+                return 0;
+            }
+            if (s != DELETED_SOCKET && s->m_NameHash == socket)
+            {
+                return s;
+            }
+        }
+        return 0;
+    }
+
+    // Returns the table slot of the socket, or the slot to insert it into if it isn't in the table.
+    // Called with the context spinlock held.
+    static uint32_t FindSocketSlot(HSocket socket)
+    {
+        const uint32_t mask = SOCKET_TABLE_SIZE - 1;
+        uint32_t index = (uint32_t) socket & mask;
+        uint32_t free_slot = SOCKET_TABLE_SIZE;
+        for (uint32_t i = 0; i < SOCKET_TABLE_SIZE; ++i)
+        {
+            uint32_t slot = (index + i) & mask;
+            MessageSocket* s = (MessageSocket*) g_MessageContext->m_SocketTable[slot];
+            if (s == 0)
+            {
+                return free_slot != SOCKET_TABLE_SIZE ? free_slot : slot;
+            }
+            if (s == DELETED_SOCKET)
+            {
+                if (free_slot == SOCKET_TABLE_SIZE)
+                {
+                    free_slot = slot;
+                }
+            }
+            else if (s->m_NameHash == socket)
+            {
+                return slot;
+            }
+        }
+        return free_slot;
+    }
+
     Result NewSocket(const char* name, HSocket* socket)
     {
         if (g_MessageContext == 0)
         {
-            g_MessageContext = Create(MAX_SOCKETS);
+            g_MessageContext = Create();
         }
         if (name == 0x0 || *name == 0 || strchr(name, '#') != 0x0 || strchr(name, ':') != 0x0)
         {
             return RESULT_INVALID_SOCKET_NAME;
         }
 
-        HSocket tmp;
-        if (GetSocket(name, &tmp) == RESULT_OK)
-        {
-            return RESULT_SOCKET_EXISTS;
-        }
-
         dmhash_t name_hash = dmHashString64(name);
 
         DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
 
-        if (g_MessageContext->m_Sockets.Full())
+        if (FindSocket(name_hash))
         {
-            return RESULT_SOCKET_OUT_OF_RESOURCES;
+            return RESULT_SOCKET_EXISTS;
         }
 
-        MessageSocket s;
-        s.m_RefCount = 1;
-        s.m_Header = 0;
-        s.m_Tail = 0;
-        s.m_NameHash = name_hash;
-        s.m_Name = strdup(name);
-        s.m_Mutex = dmMutex::New();
-        s.m_Condition = dmConditionVariable::New();
+        if (g_MessageContext->m_SocketCount == MAX_SOCKETS)
+        {
+            return RESULT_SOCKET_OUT_OF_RESOURCES;
+        }
 
-        g_MessageContext->m_Sockets.Put(name_hash, s);
+        uint32_t pool_index = 0;
+        while (g_MessageContext->m_SocketPoolUsed[pool_index])
+        {
+            ++pool_index;
+        }
+        g_MessageContext->m_SocketPoolUsed[pool_index] = true;
+        g_MessageContext->m_SocketCount++;
+
+        MessageSocket* s = &g_MessageContext->m_SocketPool[pool_index];
+        s->m_Messages = 0;
+        s->m_NameHash = name_hash;
+        s->m_Name = strdup(name);
+        s->m_Waiting = 0;
+        s->m_Mutex = dmMutex::New();
+        s->m_Condition = dmConditionVariable::New();
+        s->m_Allocator = MemoryAllocator();
+        dmSpinlock::Init(&s->m_Allocator.m_Lock);
+        dmSpinlock::Init(&s->m_Allocator.m_SharedLock);
+        // The socket is fully initialized before a lookup that read this pool entry earlier can take a reference
+        int32_t old_ref_count = dmAtomicCompareStore32(&s->m_RefCount, 1, 0);
+        assert(old_ref_count == 0);
+        (void) old_ref_count;
+
+        uint32_t slot = FindSocketSlot(name_hash);
+        void* old = g_MessageContext->m_SocketTable[slot];
+        dmAtomicCompareStorePtr(&g_MessageContext->m_SocketTable[slot], s, old);
         *socket = name_hash;
 
         return RESULT_OK;
@@ -193,7 +431,7 @@ namespace dmMessage
 
     static void DisposeSocket(MessageSocket* s)
     {
-        Message *message_object = s->m_Header;
+        Message *message_object = TakeMessages(s);
         while (message_object)
         {
             if (message_object->m_DestroyCallback)
@@ -205,61 +443,47 @@ namespace dmMessage
 
         free((void*) s->m_Name);
 
-        MemoryPage* p = s->m_Allocator.m_FreePages;
-        while (p)
-        {
-            MemoryPage* next = p->m_NextPage;
-            delete p;
-            p = next;
-        }
-        p = s->m_Allocator.m_FullPages;
+        MemoryPage* p = s->m_Allocator.m_AllocatedPages;
         while (p)
         {
-            MemoryPage* next = p->m_NextPage;
+            MemoryPage* next = p->m_NextAllocated;
             delete p;
             p = next;
         }
-        if (s->m_Allocator.m_CurrentPage)
-        {
-            delete s->m_Allocator.m_CurrentPage;
-        }
 
         dmConditionVariable::Delete(s->m_Condition);
 
         dmMutex::Delete(s->m_Mutex);
 
         memset(s, 0, sizeof(*s));
+
+        DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
+        g_MessageContext->m_SocketPoolUsed[s - g_MessageContext->m_SocketPool] = false;
+        g_MessageContext->m_SocketCount--;
     }
 
     static void ReleaseSocket(MessageSocket* s)
     {
+        if (dmAtomicDecrement32(&s->m_RefCount) == 1)
         {
-            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-            --s->m_RefCount;
-
-            if (s->m_RefCount > 0)
-            {
-                return;
-            }
+            DisposeSocket(s);
         }
-        DisposeSocket(s);
     }
 
     static MessageSocket* AcquireSocket(HSocket socket)
     {
-        DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-
-        MessageSocket* s = g_MessageContext->m_Sockets.Get(socket);
-
-        if (s == 0x0)
+        MessageSocket* s = FindSocket(socket);
+        if (s == 0x0 || !TryAddRef(s))
         {
             return 0x0;
         }
 
-        assert(s->m_RefCount >= 1);
-
-        ++s->m_RefCount;
-
+        // The socket may have been deleted, and the entry reused, before the reference was taken
+        if (s->m_NameHash != socket)
+        {
+            ReleaseSocket(s);
+            return 0x0;
+        }
         return s;
     }
 
@@ -268,22 +492,30 @@ namespace dmMessage
         MessageSocket* s = 0x0;
         {
             DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-            s = g_MessageContext->m_Sockets.Get(socket);
-            if (s == 0x0)
+            uint32_t slot = FindSocketSlot(socket);
+            if (slot == SOCKET_TABLE_SIZE || g_MessageContext->m_SocketTable[slot] == 0 || g_MessageContext->m_SocketTable[slot] == DELETED_SOCKET)
             {
                 return RESULT_SOCKET_NOT_FOUND;
             }
-
-            g_MessageContext->m_Sockets.Erase(s->m_NameHash);
-            --s->m_RefCount;
-
-            if(s->m_RefCount > 0)
+            s = (MessageSocket*) g_MessageContext->m_SocketTable[slot];
+            s->m_NameHash = 0;
+
+            // A deleted slot followed by an empty one ends every probe that reaches it, so it can be emptied,
+            // along with the deleted slots before it
+            const uint32_t mask = SOCKET_TABLE_SIZE - 1;
+            void* marker = g_MessageContext->m_SocketTable[(slot + 1) & mask] == 0 ? 0 : (void*) DELETED_SOCKET;
+            dmAtomicStorePtr(&g_MessageContext->m_SocketTable[slot], marker);
+            if (marker == 0)
             {
-                // Defer deletion
-                return RESULT_OK;
+                uint32_t prev = (slot - 1) & mask;
+                while (g_MessageContext->m_SocketTable[prev] == DELETED_SOCKET)
+                {
+                    dmAtomicStorePtr(&g_MessageContext->m_SocketTable[prev], 0);
+                    prev = (prev - 1) & mask;
+                }
             }
         }
-        DisposeSocket(s);
+        ReleaseSocket(s);
         return RESULT_OK;
     }
 
@@ -299,10 +531,7 @@ namespace dmMessage
         dmhash_t name_hash = dmHashString64(name);
         *out_socket = name_hash;
 
-        DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-
-        MessageSocket* message_socket = g_MessageContext->m_Sockets.Get(name_hash);
-        if (message_socket)
+        if (FindSocket(name_hash))
         {
             return RESULT_OK;
         }
@@ -311,9 +540,7 @@ namespace dmMessage
 
     const char* GetSocketName(HSocket socket)
     {
-        DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-
-        MessageSocket* message_socket = g_MessageContext->m_Sockets.Get(socket);
+        MessageSocket* message_socket = FindSocket(socket);
         if (message_socket != 0x0)
         {
             return message_socket->m_Name;
@@ -328,9 +555,7 @@ namespace dmMessage
     {
         if (socket != 0)
         {
-            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-            MessageSocket* message_socket = g_MessageContext->m_Sockets.Get(socket);
-            return message_socket != 0;
+            return FindSocket(socket) != 0;
         }
         return false;
     }
@@ -343,11 +568,7 @@ namespace dmMessage
         MessageSocket* s = AcquireSocket(socket);
         if (s != 0)
         {
-            bool has_messages;
-            {
-                DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
-                has_messages = s->m_Header != 0;
-            }
+            bool has_messages = s->m_Messages != 0;
             ReleaseSocket(s);
             return has_messages;
         }
@@ -411,11 +632,8 @@ namespace dmMessage
             return RESULT_SOCKET_NOT_FOUND;
         }
 
-        dmMutex::Lock(s->m_Mutex);
-
-        MemoryAllocator* allocator = &s->m_Allocator;
         uint32_t data_size = sizeof(Message) + message_data_size;
-        Message *new_message = (Message *) AllocateMessage(allocator, data_size);
+        Message *new_message = (Message *) AllocateMessage(&s->m_Allocator, data_size);
         if (sender != 0x0)
         {
             new_message->m_Sender = *sender;
@@ -434,24 +652,15 @@ namespace dmMessage
         new_message->m_DestroyCallback = destroy_callback;
         memcpy(&new_message->m_Data[0], message_data, message_data_size);
 
-        bool is_first_message = !s->m_Header;
-
-        if (!s->m_Header)
-        {
-            s->m_Header = new_message;
-            s->m_Tail = new_message;
-        }
-        else
-        {
-            s->m_Tail->m_Next = new_message;
-            s->m_Tail = new_message;
-        }
+        bool is_first_message = PushMessage(s, new_message);
 
-        if (is_first_message)
+        // The push is a full barrier, so either a blocking dispatch sees the message
+        // before it starts waiting, or we see that it is waiting here.
+        if (is_first_message && s->m_Waiting)
         {
+            DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
             dmConditionVariable::Signal(s->m_Condition);
         }
-        dmMutex::Unlock(s->m_Mutex);
 
         ReleaseSocket(s);
 
@@ -505,16 +714,17 @@ namespace dmMessage
             return 0;
         }
 
-        dmMutex::Lock(s->m_Mutex);
-
-        MemoryAllocator* allocator = &s->m_Allocator;
-
-        if (!s->m_Header)
+        if (!s->m_Messages)
         {
             if (blocking) {
-                dmConditionVariable::Wait(s->m_Condition, s->m_Mutex);
-            } else {
+                dmMutex::Lock(s->m_Mutex);
+                dmAtomicIncrement32(&s->m_Waiting);
+                if (!s->m_Messages) {
+                    dmConditionVariable::Wait(s->m_Condition, s->m_Mutex);
+                }
+                dmAtomicDecrement32(&s->m_Waiting);
                 dmMutex::Unlock(s->m_Mutex);
+            } else {
                 ReleaseSocket(s);
                 return 0;
             }
@@ -526,37 +736,37 @@ namespace dmMessage
 
         uint32_t dispatch_count = 0;
 
-        Message *message_object = s->m_Header;
-        s->m_Header = 0;
-        s->m_Tail = 0;
-
-        // Unlink full pages
-        MemoryPage* full_pages = allocator->m_FullPages;
-        allocator->m_FullPages = 0;
-
-        dmMutex::Unlock(s->m_Mutex);
+        // Messages posted during dispatch are left for the next dispatch
+        Message *message_object = TakeMessages(s);
 
+        // Consecutive messages are mostly from the same page, release them together
+        MemoryPage* page = 0;
+        int32_t page_message_count = 0;
         while (message_object)
         {
+            MemoryPage* message_page = GetMessagePage(message_object);
+            if (message_page != page)
+            {
+                if (page)
+                {
+                    ReleaseMessages(&s->m_Allocator, page, page_message_count);
+                }
+                page = message_page;
+                page_message_count = 0;
+            }
+
             dispatch_callback(message_object, user_ptr);
             if (message_object->m_DestroyCallback) {
                 message_object->m_DestroyCallback(message_object);
             }
             message_object = message_object->m_Next;
+            page_message_count++;
             dispatch_count++;
         }
-
-        // Reclaim all full pages active when dispatch started
-        dmMutex::Lock(s->m_Mutex);
-        MemoryPage* p = full_pages;
-        while (p)
+        if (page)
         {
-            MemoryPage* next = p->m_NextPage;
-            p->m_NextPage = allocator->m_FreePages;
-            allocator->m_FreePages = p;
-            p = next;
+            ReleaseMessages(&s->m_Allocator, page, page_message_count);
         }
-        dmMutex::Unlock(s->m_Mutex);
 
         ReleaseSocket(s);
 
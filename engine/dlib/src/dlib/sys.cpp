@@ -913,4 +913,52 @@ namespace dmSys
             return NativeToResult(errno);
         }
     }
+
+    Result LoadResourcePartial(const char* path, uint32_t offset, void* buffer, uint32_t buffer_size, uint32_t* nread)
+    {
+        *nread = 0;
+#ifdef __ANDROID__
+        const char* asset_path = FixAndroidResourcePath(path);
+
+        AAssetManager* am = g_AndroidApp->activity->assetManager;
+        AAsset* asset = AAssetManager_open(am, asset_path, AASSET_MODE_RANDOM);
+        if (asset) {
+            if (AAsset_seek(asset, offset, SEEK_SET) == (off_t) -1) {
+                AAsset_close(asset);
+                return RESULT_IO;
+            }
+            int r = AAsset_read(asset, buffer, buffer_size);
+            AAsset_close(asset);
+            if (r < 0) {
+                return RESULT_IO;
+            }
+            *nread = (uint32_t) r;
+            return RESULT_OK;
+        }
+#endif
+        struct stat file_stat;
+        if (stat(path, &file_stat) == 0) {
+            if (!S_ISREG(file_stat.st_mode)) {
+                return RESULT_NOENT;
+            }
+            FILE* f = fopen(path, "rb");
+            if (!f) {
+                return NativeToResult(errno);
+            }
+            if (fseek(f, offset, SEEK_SET) != 0) {
+                fclose(f);
+                return RESULT_IO;
+            }
+            size_t n = fread(buffer, 1, buffer_size, f);
+            bool error = ferror(f) != 0;
+            fclose(f);
+            if (error) {
+                return RESULT_IO;
+            }
+            *nread = (uint32_t) n;
+            return RESULT_OK;
+        } else {
+            return NativeToResult(errno);
+        }
+    }
 }
@@ -15,7 +15,7 @@
 
 #include <assert.h>
 #include <dmsdk/dlib/transform.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmTransform
 {
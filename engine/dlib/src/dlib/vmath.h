@@ -13,7 +13,7 @@
 #ifndef DM_VMATH_H
 #define DM_VMATH_H
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include "math.h"
 #include "trig_lookup.h"
 
@@ -0,0 +1,249 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DMSDK_SIMD_H
+#define DMSDK_SIMD_H
+
+#include <stdint.h>
+#include <math.h>
+
+// The SIMD backend is selected at build time. SSE2 or NEON is used when the target supports it,
+// unless DM_VMATH_SCALAR is defined (see --with-scalar-vmath), and plain C otherwise.
+#if !defined(DM_VMATH_SCALAR)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define DM_SIMD_SSE2
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #define DM_SIMD_NEON
+    #endif
+#endif
+
+#if defined(DM_SIMD_SSE2)
+    #include <emmintrin.h>
+#elif defined(DM_SIMD_NEON)
+    #include <arm_neon.h>
+#endif
+
+/**
+ * Four wide float operations, shared by the vector math matrix functions (see dmsdk/dlib/vmath.h)
+ * and the kernels that work on structure of arrays data. The operations are exact IEEE single precision,
+ * so a kernel gives the same result as its scalar equivalent when the operations are done in the same order.
+ *
+ * Load and Store require 16 byte aligned pointers, LoadU and StoreU do not.
+ */
+namespace dmSimd
+{
+    /// Number of floats in a vector
+    const uint32_t WIDTH = 4;
+
+#if defined(DM_SIMD_SSE2)
+
+    typedef __m128 Vec4f;
+    typedef __m128 Mask4;
+
+    inline Vec4f Load(const float* p)                   { return _mm_load_ps(p); }
+    inline Vec4f LoadU(const float* p)                  { return _mm_loadu_ps(p); }
+    inline void  Store(float* p, Vec4f v)               { _mm_store_ps(p, v); }
+    inline void  StoreU(float* p, Vec4f v)              { _mm_storeu_ps(p, v); }
+    inline Vec4f Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    inline Vec4f Splat(float f)                         { return _mm_set1_ps(f); }
+    inline Vec4f SplatX(Vec4f v)                        { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)); }
+    inline Vec4f SplatY(Vec4f v)                        { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)); }
+    inline Vec4f SplatZ(Vec4f v)                        { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)); }
+    inline Vec4f SplatW(Vec4f v)                        { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+    inline Vec4f Zero()                                 { return _mm_setzero_ps(); }
+    inline Vec4f Add(Vec4f a, Vec4f b)                  { return _mm_add_ps(a, b); }
+    inline Vec4f Sub(Vec4f a, Vec4f b)                  { return _mm_sub_ps(a, b); }
+    inline Vec4f Mul(Vec4f a, Vec4f b)                  { return _mm_mul_ps(a, b); }
+    inline Vec4f Div(Vec4f a, Vec4f b)                  { return _mm_div_ps(a, b); }
+    inline Vec4f Min(Vec4f a, Vec4f b)                  { return _mm_min_ps(a, b); }
+    inline Vec4f Max(Vec4f a, Vec4f b)                  { return _mm_max_ps(a, b); }
+    inline Vec4f Sqrt(Vec4f v)                          { return _mm_sqrt_ps(v); }
+    inline Vec4f Neg(Vec4f v)                           { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+    inline Vec4f Abs(Vec4f v)                           { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+    inline Mask4 CmpGe(Vec4f a, Vec4f b)                { return _mm_cmpge_ps(a, b); }
+    inline Mask4 CmpGt(Vec4f a, Vec4f b)                { return _mm_cmpgt_ps(a, b); }
+    inline Mask4 CmpEq(Vec4f a, Vec4f b)                { return _mm_cmpeq_ps(a, b); }
+    inline Vec4f Select(Mask4 m, Vec4f a, Vec4f b)      { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    inline uint32_t MaskBits(Mask4 m)                   { return (uint32_t)_mm_movemask_ps(m); }
+
+    /// Truncates the values towards zero and stores them as integers
+    inline void StoreInt(int32_t* p, Vec4f v)           { _mm_storeu_si128((__m128i*)p, _mm_cvttps_epi32(v)); }
+
+    /// Loads four 16 bit integers (no alignment requirement) and converts them to floats
+    inline Vec4f LoadInt16(const int16_t* p)
+    {
+        __m128i v = _mm_loadl_epi64((const __m128i*)p);
+        return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+    }
+
+    /// Sum of the lanes, added as (v0 + v2) + (v1 + v3)
+    inline float Sum(Vec4f v)
+    {
+        __m128 t = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+
+    /// Transposes the 4x4 matrix with the vectors as rows
+    inline void Transpose(Vec4f& a, Vec4f& b, Vec4f& c, Vec4f& d)
+    {
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+    }
+
+#elif defined(DM_SIMD_NEON)
+
+    typedef float32x4_t Vec4f;
+    typedef uint32x4_t  Mask4;
+
+    inline Vec4f Load(const float* p)                   { return vld1q_f32(p); }
+    inline Vec4f LoadU(const float* p)                  { return vld1q_f32(p); }
+    inline void  Store(float* p, Vec4f v)               { vst1q_f32(p, v); }
+    inline void  StoreU(float* p, Vec4f v)              { vst1q_f32(p, v); }
+    inline Vec4f Set(float x, float y, float z, float w) { const float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+    inline Vec4f Splat(float f)                         { return vdupq_n_f32(f); }
+    inline Vec4f SplatX(Vec4f v)                        { return vdupq_lane_f32(vget_low_f32(v), 0); }
+    inline Vec4f SplatY(Vec4f v)                        { return vdupq_lane_f32(vget_low_f32(v), 1); }
+    inline Vec4f SplatZ(Vec4f v)                        { return vdupq_lane_f32(vget_high_f32(v), 0); }
+    inline Vec4f SplatW(Vec4f v)                        { return vdupq_lane_f32(vget_high_f32(v), 1); }
+    inline Vec4f Zero()                                 { return vdupq_n_f32(0.0f); }
+    inline Vec4f Add(Vec4f a, Vec4f b)                  { return vaddq_f32(a, b); }
+    inline Vec4f Sub(Vec4f a, Vec4f b)                  { return vsubq_f32(a, b); }
+    inline Vec4f Mul(Vec4f a, Vec4f b)                  { return vmulq_f32(a, b); }
+    inline Vec4f Min(Vec4f a, Vec4f b)                  { return vminq_f32(a, b); }
+    inline Vec4f Max(Vec4f a, Vec4f b)                  { return vmaxq_f32(a, b); }
+    inline Vec4f Neg(Vec4f v)                           { return vnegq_f32(v); }
+    inline Vec4f Abs(Vec4f v)                           { return vabsq_f32(v); }
+    inline Mask4 CmpGe(Vec4f a, Vec4f b)                { return vcgeq_f32(a, b); }
+    inline Mask4 CmpGt(Vec4f a, Vec4f b)                { return vcgtq_f32(a, b); }
+    inline Mask4 CmpEq(Vec4f a, Vec4f b)                { return vceqq_f32(a, b); }
+    inline Vec4f Select(Mask4 m, Vec4f a, Vec4f b)      { return vbslq_f32(m, a, b); }
+    inline void StoreInt(int32_t* p, Vec4f v)           { vst1q_s32(p, vcvtq_s32_f32(v)); }
+    inline Vec4f LoadInt16(const int16_t* p)            { return vcvtq_f32_s32(vmovl_s16(vld1_s16(p))); }
+
+    inline float Sum(Vec4f v)
+    {
+        float32x2_t t = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(t, t), 0);
+    }
+
+    inline uint32_t MaskBits(Mask4 m)
+    {
+        const uint32_t bits_data[4] = { 1, 2, 4, 8 };
+        uint32x4_t bits = vandq_u32(m, vld1q_u32(bits_data));
+        uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        return vget_lane_u32(vpadd_u32(sum, sum), 0);
+    }
+
+    inline void Transpose(Vec4f& a, Vec4f& b, Vec4f& c, Vec4f& d)
+    {
+        float32x4x2_t ab = vtrnq_f32(a, b);
+        float32x4x2_t cd = vtrnq_f32(c, d);
+        a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+        b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+        c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+        d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+    }
+
+#if defined(__aarch64__)
+    inline Vec4f Div(Vec4f a, Vec4f b)                  { return vdivq_f32(a, b); }
+    inline Vec4f Sqrt(Vec4f v)                          { return vsqrtq_f32(v); }
+#else
+    // ARMv7 NEON only has estimates, use the exact scalar operations
+    inline Vec4f Div(Vec4f a, Vec4f b)
+    {
+        float fa[4], fb[4];
+        vst1q_f32(fa, a);
+        vst1q_f32(fb, b);
+        for (uint32_t i = 0; i < 4; ++i)
+            fa[i] /= fb[i];
+        return vld1q_f32(fa);
+    }
+
+    inline Vec4f Sqrt(Vec4f v)
+    {
+        float f[4];
+        vst1q_f32(f, v);
+        for (uint32_t i = 0; i < 4; ++i)
+            f[i] = sqrtf(f[i]);
+        return vld1q_f32(f);
+    }
+#endif
+
+#else
+
+    struct Vec4f { float m_V[4]; };
+    struct Mask4 { uint32_t m_V[4]; };
+
+#define DM_SIMD_OP1(expr) Vec4f r; for (uint32_t i = 0; i < 4; ++i) { r.m_V[i] = (expr); } return r;
+#define DM_SIMD_CMP(expr) Mask4 r; for (uint32_t i = 0; i < 4; ++i) { r.m_V[i] = (expr) ? 0xffffffff : 0; } return r;
+
+    inline Vec4f Load(const float* p)                   { DM_SIMD_OP1(p[i]) }
+    inline Vec4f LoadU(const float* p)                  { DM_SIMD_OP1(p[i]) }
+    inline void  Store(float* p, Vec4f v)               { for (uint32_t i = 0; i < 4; ++i) p[i] = v.m_V[i]; }
+    inline void  StoreU(float* p, Vec4f v)              { for (uint32_t i = 0; i < 4; ++i) p[i] = v.m_V[i]; }
+    inline Vec4f Set(float x, float y, float z, float w) { Vec4f r = { { x, y, z, w } }; return r; }
+    inline Vec4f Splat(float f)                         { DM_SIMD_OP1(f) }
+    inline Vec4f SplatX(Vec4f v)                        { DM_SIMD_OP1(v.m_V[0]) }
+    inline Vec4f SplatY(Vec4f v)                        { DM_SIMD_OP1(v.m_V[1]) }
+    inline Vec4f SplatZ(Vec4f v)                        { DM_SIMD_OP1(v.m_V[2]) }
+    inline Vec4f SplatW(Vec4f v)                        { DM_SIMD_OP1(v.m_V[3]) }
+    inline Vec4f Zero()                                 { DM_SIMD_OP1(0.0f) }
+    inline Vec4f Add(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] + b.m_V[i]) }
+    inline Vec4f Sub(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] - b.m_V[i]) }
+    inline Vec4f Mul(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] * b.m_V[i]) }
+    inline Vec4f Div(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] / b.m_V[i]) }
+    inline Vec4f Min(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] < b.m_V[i] ? a.m_V[i] : b.m_V[i]) }
+    inline Vec4f Max(Vec4f a, Vec4f b)                  { DM_SIMD_OP1(a.m_V[i] > b.m_V[i] ? a.m_V[i] : b.m_V[i]) }
+    inline Vec4f Sqrt(Vec4f v)                          { DM_SIMD_OP1(sqrtf(v.m_V[i])) }
+    inline Vec4f Neg(Vec4f v)                           { DM_SIMD_OP1(-v.m_V[i]) }
+    inline Vec4f Abs(Vec4f v)                           { DM_SIMD_OP1(fabsf(v.m_V[i])) }
+    inline Mask4 CmpGe(Vec4f a, Vec4f b)                { DM_SIMD_CMP(a.m_V[i] >= b.m_V[i]) }
+    inline Mask4 CmpGt(Vec4f a, Vec4f b)                { DM_SIMD_CMP(a.m_V[i] > b.m_V[i]) }
+    inline Mask4 CmpEq(Vec4f a, Vec4f b)                { DM_SIMD_CMP(a.m_V[i] == b.m_V[i]) }
+    inline Vec4f Select(Mask4 m, Vec4f a, Vec4f b)      { DM_SIMD_OP1(m.m_V[i] ? a.m_V[i] : b.m_V[i]) }
+    inline void StoreInt(int32_t* p, Vec4f v)           { for (uint32_t i = 0; i < 4; ++i) p[i] = (int32_t)v.m_V[i]; }
+    inline Vec4f LoadInt16(const int16_t* p)            { DM_SIMD_OP1((float)p[i]) }
+    inline float Sum(Vec4f v)                           { return (v.m_V[0] + v.m_V[2]) + (v.m_V[1] + v.m_V[3]); }
+
+    inline uint32_t MaskBits(Mask4 m)
+    {
+        return (m.m_V[0] & 1) | (m.m_V[1] & 2) | (m.m_V[2] & 4) | (m.m_V[3] & 8);
+    }
+
+    inline void Transpose(Vec4f& a, Vec4f& b, Vec4f& c, Vec4f& d)
+    {
+        Vec4f r[4] = { a, b, c, d };
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            a.m_V[i] = r[i].m_V[0];
+            b.m_V[i] = r[i].m_V[1];
+            c.m_V[i] = r[i].m_V[2];
+            d.m_V[i] = r[i].m_V[3];
+        }
+    }
+
+#undef DM_SIMD_OP1
+#undef DM_SIMD_CMP
+
+#endif
+
+    /// a * b + c, not fused
+    inline Vec4f MulAdd(Vec4f a, Vec4f b, Vec4f c)      { return Add(Mul(a, b), c); }
+
+    /// Same as dmMath::Clamp
+    inline Vec4f Clamp(Vec4f v, Vec4f min, Vec4f max)   { return Min(Max(v, min), max); }
+
+    /// Same as dmMath::Select, a when x >= 0, b otherwise
+    inline Vec4f SelectGe(Vec4f x, Vec4f a, Vec4f b)    { return Select(CmpGe(x, Zero()), a, b); }
+
+} // dmSimd
+
+#endif // DMSDK_SIMD_H
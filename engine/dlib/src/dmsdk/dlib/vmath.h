@@ -13,8 +13,31 @@
 #ifndef DMSDK_VMATH_H
 #define DMSDK_VMATH_H
 
+#include <dmsdk/dlib/simd.h>
+
+// The matrix functions use the SSE2 or NEON backend of dmsdk/dlib/simd.h when there is one.
+// The API is the same for all backends. If the package header was already included directly,
+// its scalar implementation is in use and is kept.
+#if !defined(_VECTORMATH_AOS_CPP_H)
+    #if defined(DM_SIMD_SSE2)
+        #define DM_VMATH_SSE2
+    #elif defined(DM_SIMD_NEON)
+        #define DM_VMATH_NEON
+    #endif
+#endif
+
+#if defined(DM_VMATH_SSE2) || defined(DM_VMATH_NEON)
+    #define DM_VMATH_SIMD
+    // Keep the package from pulling in its scalar matrix implementation, it is replaced by vmath_simd.h
+    #define _VECTORMATH_MAT_AOS_CPP_H
+#endif
+
 #include <dmsdk/vectormath/cpp/vectormath_aos.h>
 
+#if defined(DM_VMATH_SIMD)
+    #include <dmsdk/dlib/vmath_simd.h>
+#endif
+
 /*# SDK Vector Math API documentation
  * Vector Math functions.
  *
@@ -0,0 +1,265 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include <dlib/atomic.h>
+#include <dlib/job_system.h>
+#include <dlib/time.h>
+
+class dmJobSystemTest : public jc_test_params_class<uint32_t>
+{
+protected:
+    virtual void SetUp()
+    {
+        dmJobSystem::NewContextParams params;
+        params.m_WorkerCount = GetParam();
+        params.m_MaxJobs = 1024;
+        m_Context = dmJobSystem::NewContext(params);
+    }
+
+    virtual void TearDown()
+    {
+        dmJobSystem::DeleteContext(m_Context);
+    }
+
+    dmJobSystem::HContext m_Context;
+};
+
+static void IncrementJob(void* context, void* data)
+{
+    dmAtomicIncrement32((int32_atomic_t*) context);
+}
+
+TEST_P(dmJobSystemTest, RunAndWait)
+{
+    int32_atomic_t counter = 0;
+    dmJobSystem::HJob job = dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0);
+    ASSERT_NE((dmJobSystem::HJob) 0, job);
+    ASSERT_FALSE(dmJobSystem::IsFinished(job));
+    dmJobSystem::Run(m_Context, job);
+    dmJobSystem::Wait(m_Context, job);
+    ASSERT_TRUE(dmJobSystem::IsFinished(job));
+    ASSERT_EQ(1, counter);
+    dmJobSystem::NewFrame(m_Context);
+}
+
+TEST_P(dmJobSystemTest, Children)
+{
+    int32_atomic_t counter = 0;
+    dmJobSystem::HJob root = dmJobSystem::CreateJob(m_Context, 0, 0, 0);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        dmJobSystem::HJob child = dmJobSystem::CreateChildJob(m_Context, root, IncrementJob, (void*) &counter, 0);
+        ASSERT_NE((dmJobSystem::HJob) 0, child);
+        dmJobSystem::Run(m_Context, child);
+    }
+    dmJobSystem::Run(m_Context, root);
+    dmJobSystem::Wait(m_Context, root);
+    ASSERT_EQ(100, counter);
+    dmJobSystem::NewFrame(m_Context);
+}
+
+struct OrderContext
+{
+    int32_atomic_t  m_Counter;
+    int32_t         m_Order[3];
+};
+
+static void RecordOrderJob(void* context, void* data)
+{
+    OrderContext* ctx = (OrderContext*) context;
+    int32_t index = (int32_t) (uintptr_t) data;
+    ctx->m_Order[index] = dmAtomicIncrement32(&ctx->m_Counter);
+}
+
+TEST_P(dmJobSystemTest, Dependencies)
+{
+    for (uint32_t iter = 0; iter < 50; ++iter)
+    {
+        OrderContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+
+        // a -> b -> c
+        dmJobSystem::HJob a = dmJobSystem::CreateJob(m_Context, RecordOrderJob, &ctx, (void*) 0);
+        dmJobSystem::HJob b = dmJobSystem::CreateJob(m_Context, RecordOrderJob, &ctx, (void*) 1);
+        dmJobSystem::HJob c = dmJobSystem::CreateJob(m_Context, RecordOrderJob, &ctx, (void*) 2);
+        ASSERT_EQ(dmJobSystem::RESULT_OK, dmJobSystem::AddDependency(m_Context, b, a));
+        ASSERT_EQ(dmJobSystem::RESULT_OK, dmJobSystem::AddDependency(m_Context, c, b));
+        ASSERT_EQ(dmJobSystem::RESULT_INVALID_PARAM, dmJobSystem::AddDependency(m_Context, c, c));
+
+        // Schedule in reverse order, the dependencies must still be respected
+        dmJobSystem::Run(m_Context, c);
+        dmJobSystem::Run(m_Context, b);
+        dmJobSystem::Run(m_Context, a);
+        dmJobSystem::Wait(m_Context, c);
+
+        ASSERT_EQ(0, ctx.m_Order[0]);
+        ASSERT_EQ(1, ctx.m_Order[1]);
+        ASSERT_EQ(2, ctx.m_Order[2]);
+        dmJobSystem::NewFrame(m_Context);
+    }
+}
+
+TEST_P(dmJobSystemTest, Fan)
+{
+    // One job fanning out to many, joined by a single job
+    int32_atomic_t counter = 0;
+    dmJobSystem::HJob first = dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0);
+    dmJobSystem::HJob last = dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0);
+    dmJobSystem::HJob middle[dmJobSystem::MAX_CONTINUATIONS];
+    for (uint32_t i = 0; i < dmJobSystem::MAX_CONTINUATIONS; ++i)
+    {
+        middle[i] = dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0);
+        ASSERT_EQ(dmJobSystem::RESULT_OK, dmJobSystem::AddDependency(m_Context, middle[i], first));
+        ASSERT_EQ(dmJobSystem::RESULT_OK, dmJobSystem::AddDependency(m_Context, last, middle[i]));
+    }
+    ASSERT_EQ(dmJobSystem::RESULT_OUT_OF_RESOURCES, dmJobSystem::AddDependency(m_Context, last, first));
+
+    dmJobSystem::Run(m_Context, last);
+    for (uint32_t i = 0; i < dmJobSystem::MAX_CONTINUATIONS; ++i)
+    {
+        dmJobSystem::Run(m_Context, middle[i]);
+    }
+    ASSERT_FALSE(dmJobSystem::IsFinished(last));
+    dmJobSystem::Run(m_Context, first);
+    dmJobSystem::Wait(m_Context, last);
+    ASSERT_EQ((int32_t) dmJobSystem::MAX_CONTINUATIONS + 2, counter);
+    dmJobSystem::NewFrame(m_Context);
+}
+
+static void SpawnChildrenJob(void* context, void* data)
+{
+    dmJobSystem::HContext job_context = (dmJobSystem::HContext) ((void**) context)[0];
+    int32_atomic_t* counter = (int32_atomic_t*) ((void**) context)[1];
+    dmJobSystem::HJob parent = (dmJobSystem::HJob) data;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        dmJobSystem::HJob child = dmJobSystem::CreateChildJob(job_context, parent, IncrementJob, (void*) counter, 0);
+        dmJobSystem::Run(job_context, child);
+    }
+}
+
+TEST_P(dmJobSystemTest, NestedChildren)
+{
+    int32_atomic_t counter = 0;
+    void* context[] = { m_Context, (void*) &counter };
+    dmJobSystem::HJob root = dmJobSystem::CreateJob(m_Context, 0, 0, 0);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        // The spawner adds more children to its own parent while it is running
+        dmJobSystem::HJob group = dmJobSystem::CreateChildJob(m_Context, root, 0, 0, 0);
+        dmJobSystem::HJob spawner = dmJobSystem::CreateChildJob(m_Context, group, SpawnChildrenJob, context, group);
+        dmJobSystem::Run(m_Context, spawner);
+        dmJobSystem::Run(m_Context, group);
+    }
+    dmJobSystem::Run(m_Context, root);
+    dmJobSystem::Wait(m_Context, root);
+    ASSERT_EQ(16 * 8, counter);
+    dmJobSystem::NewFrame(m_Context);
+}
+
+TEST_P(dmJobSystemTest, OutOfJobs)
+{
+    int32_atomic_t counter = 0;
+    uint32_t created = 0;
+    while (dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0) != 0)
+    {
+        ++created;
+    }
+    ASSERT_EQ(1024u, created);
+    ASSERT_EQ((dmJobSystem::HJob) 0, dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0));
+
+    // Jobs that were never scheduled are simply dropped
+    dmJobSystem::NewFrame(m_Context);
+    ASSERT_EQ(0, counter);
+    ASSERT_NE((dmJobSystem::HJob) 0, dmJobSystem::CreateJob(m_Context, IncrementJob, (void*) &counter, 0));
+    dmJobSystem::NewFrame(m_Context);
+}
+
+static void SumRange(void* context, void* data, uint32_t start, uint32_t end)
+{
+    const uint32_t* values = (const uint32_t*) data;
+    uint64_t* sums = (uint64_t*) context;
+    for (uint32_t i = start; i < end; ++i)
+    {
+        // Each index is written exactly once, so no synchronization is needed
+        sums[i] = (uint64_t) values[i] * 2;
+    }
+}
+
+TEST_P(dmJobSystemTest, ParallelFor)
+{
+    const uint32_t count = 100000;
+    uint32_t* values = new uint32_t[count];
+    uint64_t* result = new uint64_t[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        values[i] = i;
+        result[i] = 0;
+    }
+
+    dmJobSystem::ParallelFor(m_Context, SumRange, result, values, count, 64);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ((uint64_t) i * 2, result[i]);
+    }
+
+    // No context, runs on the calling thread
+    memset(result, 0, sizeof(uint64_t) * count);
+    dmJobSystem::ParallelFor(0, SumRange, result, values, count, 64);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ((uint64_t) i * 2, result[i]);
+    }
+
+    dmJobSystem::NewFrame(m_Context);
+    delete [] values;
+    delete [] result;
+}
+
+static void EmptyJob(void* context, void* data)
+{
+}
+
+TEST_P(dmJobSystemTest, Bench)
+{
+    const uint32_t frame_count = 64;
+    const uint32_t job_count = 1000;
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t frame = 0; frame < frame_count; ++frame)
+    {
+        dmJobSystem::HJob root = dmJobSystem::CreateJob(m_Context, 0, 0, 0);
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            dmJobSystem::HJob job = dmJobSystem::CreateChildJob(m_Context, root, EmptyJob, 0, 0);
+            dmJobSystem::Run(m_Context, job);
+        }
+        dmJobSystem::Run(m_Context, root);
+        dmJobSystem::Wait(m_Context, root);
+        dmJobSystem::NewFrame(m_Context);
+    }
+    uint64_t end = dmTime::GetTime();
+    printf("Bench (%u workers) elapsed: %f ms (%f us per job)\n", GetParam(), (end-start) / 1000.0f, (end-start) / float(frame_count * job_count));
+}
+
+const uint32_t worker_counts[] = {0, 1, 3, 7};
+INSTANTIATE_TEST_CASE_P(dmJobSystemTest, dmJobSystemTest, jc_test_values_in(worker_counts));
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -161,6 +161,64 @@ TEST(dmMessage, Bench)
     ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
 }
 
+struct BenchPostContext
+{
+    dmMessage::URL* m_Receiver;
+    uint32_t        m_Count;
+};
+
+void BenchPostThread(void* arg)
+{
+    BenchPostContext* ctx = (BenchPostContext*) arg;
+    CustomMessageData1 message_data1;
+    message_data1.m_MyValue = 0;
+    for (uint32_t i = 0; i < ctx->m_Count; ++i)
+    {
+        dmMessage::Post(0x0, ctx->m_Receiver, m_HashMessage1, 0, 0x0, &message_data1, sizeof(CustomMessageData1), 0);
+    }
+}
+
+TEST(dmMessage, BenchThreads)
+{
+    const uint32_t max_thread_count = 8;
+    const uint32_t posts_per_thread = 1024 * 16;
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket));
+
+    BenchPostContext ctx;
+    ctx.m_Receiver = &receiver;
+    ctx.m_Count = posts_per_thread;
+
+    // Producer threads post while the main thread dispatches
+    for (uint32_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2)
+    {
+        dmThread::Thread threads[max_thread_count];
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            threads[i] = dmThread::New(&BenchPostThread, 0xf0000, (void*) &ctx, "post");
+        }
+
+        uint32_t count = 0;
+        while (count < thread_count * posts_per_thread)
+        {
+            count += dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0);
+        }
+        uint64_t end = dmTime::GetTime();
+
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            dmThread::Join(threads[i]);
+        }
+        ASSERT_EQ(thread_count * posts_per_thread, count);
+        printf("Bench %u producer threads: %f ms (%f posts per second)\n", thread_count, (end-start) / 1000.0f, count / ((end-start) / 1000000.0));
+    }
+
+    ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
 TEST(dmMessage, Exists)
 {
     dmMessage::HSocket socket1;
@@ -355,6 +413,74 @@ TEST(dmMessage, ThreadTest2)
     ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
 }
 
+// More posting threads than there are per thread pages, so that the last ones share a page
+TEST(dmMessage, ThreadTestSharedPage)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    dmMessage::Result r;
+    r = dmMessage::NewSocket("my_socket", &receiver.m_Socket);
+    ASSERT_EQ(dmMessage::RESULT_OK, r);
+
+    const uint32_t thread_count = 48;
+    dmThread::Thread threads[thread_count];
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        threads[i] = dmThread::New(&PostThread, 0x80000, (void*) &receiver, "post");
+    }
+
+    uint32_t count = 0;
+    while (count < 1024 * thread_count)
+    {
+        count += dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0);
+        dmTime::Sleep(1000);
+    }
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        dmThread::Join(threads[i]);
+    }
+
+    count += dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0);
+    ASSERT_EQ(1024U * thread_count, count);
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+// Sockets are looked up without locking, deleted sockets must not hide the ones created after them
+TEST(dmMessage, DeleteAndLookup)
+{
+    const uint32_t socket_count = 64;
+    dmMessage::HSocket sockets[socket_count];
+    char name[32];
+
+    for (uint32_t iter = 0; iter < 16; ++iter)
+    {
+        for (uint32_t i = 0; i < socket_count; ++i)
+        {
+            dmSnPrintf(name, sizeof(name), "socket_%d_%d", iter, i);
+            ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket(name, &sockets[i]));
+        }
+        for (uint32_t i = 0; i < socket_count; i += 2)
+        {
+            ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(sockets[i]));
+        }
+        for (uint32_t i = 0; i < socket_count; ++i)
+        {
+            dmSnPrintf(name, sizeof(name), "socket_%d_%d", iter, i);
+            dmMessage::HSocket socket;
+            bool deleted = (i % 2) == 0;
+            ASSERT_EQ(deleted ? dmMessage::RESULT_NAME_OK_SOCKET_NOT_FOUND : dmMessage::RESULT_OK, dmMessage::GetSocket(name, &socket));
+            ASSERT_EQ(!deleted, dmMessage::IsSocketValid(sockets[i]));
+        }
+        for (uint32_t i = 1; i < socket_count; i += 2)
+        {
+            ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(sockets[i]));
+            ASSERT_EQ(dmMessage::RESULT_SOCKET_NOT_FOUND, dmMessage::DeleteSocket(sockets[i]));
+        }
+    }
+}
+
 void HandleIntegrityMessage(dmMessage::Message *message_object, void *user_ptr)
 {
     dmhash_t hash = dmHashBuffer64(message_object->m_Data, message_object->m_DataSize);
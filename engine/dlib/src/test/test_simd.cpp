@@ -0,0 +1,138 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include <dlib/align.h>
+#include <dlib/math.h>
+#include "dlib/simd.h"
+
+using namespace dmSimd;
+
+static const float DM_ALIGNED(16) A[4] = { 1.5f, -2.0f, 0.0f, 7.25f };
+static const float DM_ALIGNED(16) B[4] = { 0.5f, 3.0f, -1.0f, 7.25f };
+
+TEST(dmSimd, Arithmetic)
+{
+    float DM_ALIGNED(16) r[4];
+    Vec4f a = Load(A);
+    Vec4f b = Load(B);
+
+    Store(r, Add(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i] + B[i], r[i]);
+    Store(r, Sub(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i] - B[i], r[i]);
+    Store(r, Mul(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i] * B[i], r[i]);
+    Store(r, Div(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i] / B[i], r[i]);
+    Store(r, MulAdd(a, b, a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i] * B[i] + A[i], r[i]);
+    Store(r, Min(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(dmMath::Min(A[i], B[i]), r[i]);
+    Store(r, Max(a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(dmMath::Max(A[i], B[i]), r[i]);
+    Store(r, Sqrt(Max(a, Zero())));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(sqrtf(dmMath::Max(A[i], 0.0f)), r[i]);
+    Store(r, Clamp(a, Splat(-1.0f), Splat(1.0f)));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(dmMath::Clamp(A[i], -1.0f, 1.0f), r[i]);
+}
+
+TEST(dmSimd, Select)
+{
+    float DM_ALIGNED(16) r[4];
+    Vec4f a = Load(A);
+    Vec4f b = Load(B);
+
+    Store(r, SelectGe(a, a, b));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(dmMath::Select(A[i], A[i], B[i]), r[i]);
+
+    ASSERT_EQ(0xdu, MaskBits(CmpGe(a, b)));
+    ASSERT_EQ(0x5u, MaskBits(CmpGt(a, b)));
+    ASSERT_EQ(0x8u, MaskBits(CmpEq(a, b)));
+}
+
+TEST(dmSimd, Unaligned)
+{
+    float data[5] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f };
+    StoreU(data, LoadU(data + 1));
+    ASSERT_EQ(1.0f, data[0]);
+    ASSERT_EQ(4.0f, data[3]);
+
+    int32_t ints[4];
+    StoreInt(ints, LoadU(A));
+    ASSERT_EQ(1, ints[0]);
+    ASSERT_EQ(-2, ints[1]);
+    ASSERT_EQ(0, ints[2]);
+    ASSERT_EQ(7, ints[3]);
+}
+
+TEST(dmSimd, Conversion)
+{
+    float DM_ALIGNED(16) r[4];
+    const int16_t shorts[5] = { 1, -32768, 32767, -5, 9 };
+    Store(r, LoadInt16(shorts + 1));
+    ASSERT_EQ(-32768.0f, r[0]);
+    ASSERT_EQ(32767.0f, r[1]);
+    ASSERT_EQ(-5.0f, r[2]);
+    ASSERT_EQ(9.0f, r[3]);
+
+    ASSERT_EQ((A[0] + A[2]) + (A[1] + A[3]), Sum(Load(A)));
+}
+
+TEST(dmSimd, Lanes)
+{
+    float DM_ALIGNED(16) r[4];
+    Vec4f a = Set(A[0], A[1], A[2], A[3]);
+
+    Store(r, a);
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[i], r[i]);
+    Store(r, SplatX(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[0], r[i]);
+    Store(r, SplatY(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[1], r[i]);
+    Store(r, SplatZ(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[2], r[i]);
+    Store(r, SplatW(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(A[3], r[i]);
+    Store(r, Neg(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(-A[i], r[i]);
+    Store(r, Abs(a));
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(fabsf(A[i]), r[i]);
+}
+
+TEST(dmSimd, Transpose)
+{
+    float DM_ALIGNED(16) m[16];
+    for (uint32_t i = 0; i < 16; ++i) m[i] = (float) i;
+
+    Vec4f a = Load(m + 0);
+    Vec4f b = Load(m + 4);
+    Vec4f c = Load(m + 8);
+    Vec4f d = Load(m + 12);
+    Transpose(a, b, c, d);
+
+    float DM_ALIGNED(16) r[16];
+    Store(r + 0, a);
+    Store(r + 4, b);
+    Store(r + 8, c);
+    Store(r + 12, d);
+    for (uint32_t row = 0; row < 4; ++row)
+        for (uint32_t col = 0; col < 4; ++col)
+            ASSERT_EQ(m[col * 4 + row], r[row * 4 + col]);
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
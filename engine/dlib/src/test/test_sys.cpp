@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <string>
@@ -221,6 +222,38 @@ TEST(dmSys, LoadResource)
     ASSERT_GT(size, 0);
 }
 
+TEST(dmSys, LoadResourcePartial)
+{
+    char path[128];
+    char buffer[1024 * 100];
+    char part[64];
+    dmSys::Result r;
+    uint32_t size;
+    uint32_t nread;
+
+    r = dmSys::LoadResourcePartial(MakeHostPath(path, sizeof(path), "does_not_exists"), 0, part, sizeof(part), &nread);
+    ASSERT_EQ(dmSys::RESULT_NOENT, r);
+
+    r = dmSys::LoadResource(MakeHostPath(path, sizeof(path), "wscript"), buffer, sizeof(buffer), &size);
+    ASSERT_EQ(dmSys::RESULT_OK, r);
+    ASSERT_GT(size, sizeof(part));
+
+    r = dmSys::LoadResourcePartial(MakeHostPath(path, sizeof(path), "wscript"), 0, part, sizeof(part), &nread);
+    ASSERT_EQ(dmSys::RESULT_OK, r);
+    ASSERT_EQ(sizeof(part), nread);
+    ASSERT_EQ(0, memcmp(buffer, part, sizeof(part)));
+
+    // Reading past the end returns the remaining bytes
+    r = dmSys::LoadResourcePartial(MakeHostPath(path, sizeof(path), "wscript"), size - 10, part, sizeof(part), &nread);
+    ASSERT_EQ(dmSys::RESULT_OK, r);
+    ASSERT_EQ(10u, nread);
+    ASSERT_EQ(0, memcmp(buffer + size - 10, part, 10));
+
+    r = dmSys::LoadResourcePartial(MakeHostPath(path, sizeof(path), "wscript"), size, part, sizeof(part), &nread);
+    ASSERT_EQ(dmSys::RESULT_OK, r);
+    ASSERT_EQ(0u, nread);
+}
+
 int main(int argc, char **argv)
 {
     g_Argc = argc;
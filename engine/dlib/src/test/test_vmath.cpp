@@ -13,6 +13,8 @@
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
 #include "dlib/vmath.h"
+#include "dlib/time.h"
+#include "dlib/transform.h"
 
 const float epsilon = 0.0001f;
 
@@ -128,6 +130,226 @@ TEST(dmMath, TestEulerToQuat)
     ASSERT_NEAR(quat.getW(), q.getW(), epsilon);
 }
 
+// Reference implementations of the matrix operations, used to check the SIMD backend (if enabled)
+// against plain float math. The matrices are column major, m[col * 4 + row].
+
+static void RefMatrix(const Matrix4& m, float out[16])
+{
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            out[c * 4 + r] = m.getElem(c, r);
+}
+
+static void RefMul(const float a[16], const float b[16], float out[16])
+{
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+static float RandomFloat(float min, float max)
+{
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+static Matrix4 RandomMatrix()
+{
+    Matrix4 m;
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            m.setElem(c, r, RandomFloat(-10.0f, 10.0f));
+    return m;
+}
+
+static Matrix4 RandomRigidMatrix()
+{
+    Quat q = normalize(Quat(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f)));
+    return Matrix4(q, Vector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f)));
+}
+
+#define ASSERT_MATRIX_NEAR(expected, m, eps) \
+    for (int c = 0; c < 4; ++c) \
+        for (int r = 0; r < 4; ++r) \
+            ASSERT_NEAR((expected)[c * 4 + r], (m).getElem(c, r), eps);
+
+static const uint32_t TEST_ITERATIONS = 256;
+
+TEST(dmVMath, Layout)
+{
+    // The SIMD backend loads and stores the columns directly
+    ASSERT_EQ(4 * sizeof(float), sizeof(Vector4));
+    ASSERT_EQ(16 * sizeof(float), sizeof(Matrix4));
+}
+
+TEST(dmVMath, Matrix4Mul)
+{
+    for (uint32_t i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        Matrix4 a = RandomMatrix();
+        Matrix4 b = RandomMatrix();
+        float ra[16], rb[16], expected[16];
+        RefMatrix(a, ra);
+        RefMatrix(b, rb);
+        RefMul(ra, rb, expected);
+        ASSERT_MATRIX_NEAR(expected, a * b, 0.001f);
+
+        // In place, where the result aliases an operand
+        a *= a;
+        RefMul(ra, ra, expected);
+        ASSERT_MATRIX_NEAR(expected, a, 0.001f);
+    }
+}
+
+TEST(dmVMath, Matrix4MulVector)
+{
+    for (uint32_t i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        Matrix4 m = RandomMatrix();
+        float rm[16];
+        RefMatrix(m, rm);
+
+        float v[4] = { RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f) };
+        Vector4 r4 = m * Vector4(v[0], v[1], v[2], v[3]);
+        Vector4 r3 = m * Vector3(v[0], v[1], v[2]);
+        Vector4 rp = m * Point3(v[0], v[1], v[2]);
+        for (int r = 0; r < 4; ++r)
+        {
+            float xyz = rm[0 * 4 + r] * v[0] + rm[1 * 4 + r] * v[1] + rm[2 * 4 + r] * v[2];
+            ASSERT_NEAR(xyz + rm[3 * 4 + r] * v[3], r4.getElem(r), 0.001f);
+            ASSERT_NEAR(xyz, r3.getElem(r), 0.001f);
+            ASSERT_NEAR(xyz + rm[3 * 4 + r], rp.getElem(r), 0.001f);
+        }
+    }
+}
+
+TEST(dmVMath, Matrix4ElementWise)
+{
+    for (uint32_t i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        Matrix4 a = RandomMatrix();
+        Matrix4 b = RandomMatrix();
+        Vector3 scale(RandomFloat(-2.0f, 2.0f), RandomFloat(-2.0f, 2.0f), RandomFloat(-2.0f, 2.0f));
+        float s = RandomFloat(-2.0f, 2.0f);
+
+        Matrix4 t = transpose(a);
+        Matrix4 sum = a + b;
+        Matrix4 diff = a - b;
+        Matrix4 neg = -a;
+        Matrix4 scaled = a * s;
+        Matrix4 mul = mulPerElem(a, b);
+        Matrix4 abs = absPerElem(a);
+        Matrix4 append = appendScale(a, scale);
+        Matrix4 prepend = prependScale(scale, a);
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                float ea = a.getElem(c, r);
+                float eb = b.getElem(c, r);
+                ASSERT_EQ(a.getElem(r, c), t.getElem(c, r));
+                ASSERT_EQ(ea + eb, sum.getElem(c, r));
+                ASSERT_EQ(ea - eb, diff.getElem(c, r));
+                ASSERT_EQ(-ea, neg.getElem(c, r));
+                ASSERT_EQ(ea * s, scaled.getElem(c, r));
+                ASSERT_EQ(ea * eb, mul.getElem(c, r));
+                ASSERT_EQ(fabsf(ea), abs.getElem(c, r));
+                ASSERT_EQ(c < 3 ? ea * scale.getElem(c) : ea, append.getElem(c, r));
+                ASSERT_EQ(r < 3 ? ea * scale.getElem(r) : ea, prepend.getElem(c, r));
+            }
+        }
+    }
+}
+
+TEST(dmVMath, Matrix4OrthoInverse)
+{
+    for (uint32_t i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        Matrix4 m = RandomRigidMatrix();
+        Matrix4 inv = orthoInverse(m);
+        float expected[16];
+        RefMatrix(inverse(m), expected);
+        ASSERT_MATRIX_NEAR(expected, inv, 0.001f);
+
+        RefMatrix(Matrix4::identity(), expected);
+        ASSERT_MATRIX_NEAR(expected, m * inv, 0.001f);
+    }
+}
+
+TEST(dmVMath, ToMatrix4)
+{
+    for (uint32_t i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        Quat q = normalize(Quat(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f)));
+        Vector3 t(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+        Vector3 s(RandomFloat(0.1f, 4.0f), RandomFloat(0.1f, 4.0f), RandomFloat(0.1f, 4.0f));
+        Matrix4 m = dmTransform::ToMatrix4(dmTransform::Transform(t, q, s));
+
+        float rot[16], scale[16], expected[16];
+        RefMatrix(Matrix4(q, t), rot);
+        RefMatrix(Matrix4::scale(s), scale);
+        RefMul(rot, scale, expected);
+        ASSERT_MATRIX_NEAR(expected, m, 0.0001f);
+    }
+}
+
+TEST(dmVMath, Benchmark)
+{
+#if defined(DM_VMATH_SSE2)
+    const char* backend = "sse2";
+#elif defined(DM_VMATH_NEON)
+    const char* backend = "neon";
+#else
+    const char* backend = "scalar";
+#endif
+    const uint32_t iter_count = 1000000;
+    float sink = 0.0f;
+
+    Matrix4 a = RandomRigidMatrix();
+    Matrix4 b = RandomRigidMatrix();
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iter_count; ++i)
+    {
+        a = a * b;
+    }
+    uint64_t end = dmTime::GetTime();
+    sink += a.getElem(3, 3);
+    printf("Matrix4 * Matrix4 (%s): %f ms (%f ns per call)\n", backend, (end - start) / 1000.0f, (end - start) * 1000.0f / iter_count);
+
+    Quat q0 = normalize(Quat(0.1f, 0.2f, 0.3f, 0.9f));
+    Quat q1 = normalize(Quat(-0.4f, 0.5f, 0.1f, 0.7f));
+    Quat q = q0;
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iter_count; ++i)
+    {
+        q = slerp(i / (float)iter_count, q, q1);
+    }
+    end = dmTime::GetTime();
+    sink += q.getW();
+    printf("Quat slerp (%s): %f ms (%f ns per call)\n", backend, (end - start) / 1000.0f, (end - start) * 1000.0f / iter_count);
+
+    dmTransform::Transform transform(Vector3(1.0f, 2.0f, 3.0f), q0, Vector3(2.0f, 2.0f, 2.0f));
+    Matrix4 m = Matrix4::identity();
+    start = dmTime::GetTime();
+    for (uint32_t i = 0; i < iter_count; ++i)
+    {
+        transform.SetTranslation(Vector3(i * 0.001f, 0.0f, 0.0f));
+        m = m + dmTransform::ToMatrix4(transform);
+    }
+    end = dmTime::GetTime();
+    sink += m.getElem(3, 0);
+    printf("dmTransform::ToMatrix4 (%s): %f ms (%f ns per call)\n", backend, (end - start) / 1000.0f, (end - start) * 1000.0f / iter_count);
+
+    // Keep the results alive
+    ASSERT_NE(-1.0f, sink);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -14,7 +14,7 @@
 
 #include "engine_private.h"
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include <sys/stat.h>
 
 #include <stdio.h>
@@ -195,6 +195,7 @@ namespace dmEngine
     : m_Config(0)
     , m_Alive(true)
     , m_MainCollection(0)
+    , m_JobContext(0x0)
     , m_LastReloadMTime(0)
     , m_MouseSensitivity(1.0f)
     , m_GraphicsContext(0)
@@ -279,6 +280,11 @@ namespace dmEngine
 
         dmGameObject::DeleteRegister(engine->m_Register);
 
+        if (engine->m_JobContext)
+        {
+            dmJobSystem::DeleteContext(engine->m_JobContext);
+        }
+
         UnloadBootstrapContent(engine);
 
         dmSound::Finalize();
@@ -791,6 +797,7 @@ namespace dmEngine
         const uint32_t max_resources = dmConfigFile::GetInt(engine->m_Config, dmResource::MAX_RESOURCES_KEY, 1024);
         dmResource::NewFactoryParams params;
         params.m_MaxResources = max_resources;
+        params.m_LoadWorkerCount = dmConfigFile::GetInt(engine->m_Config, dmResource::LOAD_WORKER_COUNT_KEY, 2);
         params.m_Flags = 0;
 
         dmResourceArchive::ClearArchiveLoaders(); // in case we've rebooted
@@ -879,6 +886,15 @@ namespace dmEngine
             dmLogWarning("Failed to initialize sound system.");
         }
 
+        dmJobSystem::NewContextParams job_params;
+        int32_t job_worker_count = dmConfigFile::GetInt(engine->m_Config, "engine.job_worker_count", -1);
+        if (job_worker_count >= 0)
+        {
+            job_params.m_WorkerCount = (uint32_t) job_worker_count;
+        }
+        engine->m_JobContext = dmJobSystem::NewContext(job_params);
+        dmGameObject::SetJobContext(engine->m_Register, engine->m_JobContext);
+
         dmGameObject::Result go_result = dmGameObject::SetCollectionDefaultCapacity(engine->m_Register, dmConfigFile::GetInt(engine->m_Config, dmGameObject::COLLECTION_MAX_INSTANCES_KEY, dmGameObject::DEFAULT_MAX_COLLECTION_CAPACITY));
         if(go_result != dmGameObject::RESULT_OK)
         {
@@ -905,6 +921,7 @@ namespace dmEngine
 
         engine->m_ParticleFXContext.m_Factory = engine->m_Factory;
         engine->m_ParticleFXContext.m_RenderContext = engine->m_RenderContext;
+        engine->m_ParticleFXContext.m_JobContext = engine->m_JobContext;
         engine->m_ParticleFXContext.m_MaxParticleFXCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_INSTANCE_COUNT_KEY, 64);
         engine->m_ParticleFXContext.m_MaxParticleCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_PARTICLE_COUNT_KEY, 1024);
         engine->m_ParticleFXContext.m_Debug = false;
@@ -969,6 +986,12 @@ namespace dmEngine
         }
         physics_params.m_ContactImpulseLimit = dmConfigFile::GetFloat(engine->m_Config, "physics.contact_impulse_limit", 0.0f);
         physics_params.m_AllowDynamicTransforms = dmConfigFile::GetInt(engine->m_Config, "physics.allow_dynamic_transforms", 1) ? 1 : 0;
+        physics_params.m_UpdateFrequency = dmConfigFile::GetInt(engine->m_Config, "physics.update_frequency", 0);
+        physics_params.m_MaxFixedTimesteps = dmConfigFile::GetInt(engine->m_Config, "physics.max_fixed_timesteps", 2);
+        physics_params.m_VelocityIterations = dmConfigFile::GetInt(engine->m_Config, "physics.velocity_iterations", 10);
+        physics_params.m_PositionIterations = dmConfigFile::GetInt(engine->m_Config, "physics.position_iterations", 10);
+        physics_params.m_Interpolate = dmConfigFile::GetInt(engine->m_Config, "physics.interpolate", 1) ? 1 : 0;
+        physics_params.m_JobContext = engine->m_JobContext;
         if (dmStrCaseCmp(physics_type, "3D") == 0)
         {
             engine->m_PhysicsContext.m_3D = true;
@@ -1011,6 +1034,7 @@ namespace dmEngine
 
         engine->m_ModelContext.m_RenderContext = engine->m_RenderContext;
         engine->m_ModelContext.m_Factory = engine->m_Factory;
+        engine->m_ModelContext.m_JobContext = engine->m_JobContext;
         engine->m_ModelContext.m_MaxModelCount = max_model_count;
 
         engine->m_MeshContext.m_RenderContext = engine->m_RenderContext;
@@ -1051,6 +1075,7 @@ namespace dmEngine
         component_create_ctx.m_Contexts.SetCapacity(3, 8);
         component_create_ctx.m_Contexts.Put(dmHashString64("graphics"), engine->m_GraphicsContext);
         component_create_ctx.m_Contexts.Put(dmHashString64("render"), engine->m_RenderContext);
+        component_create_ctx.m_Contexts.Put(dmHashString64("job_system"), engine->m_JobContext);
 
         dmResource::Result fact_result;
         dmGameSystem::ScriptLibContext script_lib_context;
@@ -1071,6 +1096,13 @@ namespace dmEngine
         if (fact_result != dmResource::RESULT_OK)
             goto bail;
 
+        // Ogg sounds are streamed from the archive while they play, only the start of them is loaded with the resource
+        if (dmConfigFile::GetInt(engine->m_Config, "sound.stream_enabled", 0))
+        {
+            uint32_t preload_size = (uint32_t) dmConfigFile::GetInt(engine->m_Config, "sound.stream_preload_size", 16 * 1024);
+            dmResource::SetTypePreloadSize(engine->m_Factory, "oggc", preload_size);
+        }
+
         go_result = dmGameSystem::RegisterComponentTypes(engine->m_Factory, engine->m_Register, engine->m_RenderContext, &engine->m_PhysicsContext, &engine->m_ParticleFXContext, &engine->m_GuiContext, &engine->m_SpriteContext,
                                                                                                 &engine->m_CollectionProxyContext, &engine->m_FactoryContext, &engine->m_CollectionFactoryContext,
                                                                                                 &engine->m_ModelContext, &engine->m_MeshContext, &engine->m_LabelContext, &engine->m_TilemapContext,
@@ -1438,6 +1470,9 @@ bail:
             {
                 DM_PROFILE(Engine, "Frame");
 
+                // Jobs never live across frames
+                dmJobSystem::NewFrame(engine->m_JobContext);
+
                 {
                     DM_PROFILE(Engine, "Sim");
 
@@ -1554,7 +1589,7 @@ bail:
                                                 (float)((engine->m_ClearColor>>16)&0xFF),
                                                 (float)((engine->m_ClearColor>>24)&0xFF),
                                                 1.0f, 0);
-                            dmRender::DrawRenderList(engine->m_RenderContext, 0x0, 0x0);
+                            dmRender::DrawRenderList(engine->m_RenderContext, 0x0, 0x0, 0x0);
                         }
                     }
 
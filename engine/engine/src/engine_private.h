@@ -17,6 +17,7 @@
 
 #include <dlib/configfile.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_system.h>
 #include <dlib/message.h>
 
 #include <resource/resource.h>
@@ -116,6 +117,7 @@ namespace dmEngine
 
         dmGameObject::HRegister                     m_Register;
         dmGameObject::HCollection                   m_MainCollection;
+        dmJobSystem::HContext                       m_JobContext;
         dmArray<dmGameObject::InputAction>          m_InputBuffer;
         dmHashTable64<void*>                        m_ResourceTypeContexts;
 
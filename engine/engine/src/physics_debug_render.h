@@ -14,7 +14,7 @@
 #define GAME_PHYSICS_DEBUG_RENDER_H
 
 #include <stdint.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace PhysicsDebugRender
 {
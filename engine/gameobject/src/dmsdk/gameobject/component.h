@@ -585,6 +585,28 @@ namespace dmGameObject
      */
     void ComponentTypeSetReadsTransforms(ComponentType* type, bool reads_transforms);
 
+    /*# set the component type transform modification flag
+     * Set the component type transform modification flag.
+     * Set this flag if the update function of the component type may modify the transforms of game objects.
+     * Such component types are never updated in parallel with other component types.
+     * @name ComponentTypeSetWritesTransforms
+     * @param type [type: ComponentType*] the type
+     * @param
+     */
+    void ComponentTypeSetWritesTransforms(ComponentType* type, bool writes_transforms);
+
+    /*# set the component type parallel update flag
+     * Set the component type parallel update flag. Defaults to false.
+     * If this flag is set, the update function may be called on a worker thread, concurrently with
+     * the update functions of the adjacent component types (in update order) that have the flag set.
+     * The update function must then only modify its own world, and must not modify any game object transforms.
+     * Messages posted during the update are dispatched once all the component types in the group are updated.
+     * @name ComponentTypeSetParallelUpdate
+     * @param type [type: ComponentType*] the type
+     * @param
+     */
+    void ComponentTypeSetParallelUpdate(ComponentType* type, bool parallel_update);
+
     /*# set the component type prio order
      * Set the component type prio order. Defines the update order of the component types.
      * @name ComponentTypeSetPrio
@@ -93,6 +93,8 @@ void ComponentTypeSetGetPropertyFn(ComponentType* type, ComponentGetProperty fn)
 void ComponentTypeSetSetPropertyFn(ComponentType* type, ComponentSetProperty fn)            { type->m_SetPropertyFunction = fn; }
 void ComponentTypeSetContext(ComponentType* type, void* context)                            { type->m_Context = context; }
 void ComponentTypeSetReadsTransforms(ComponentType* type, bool reads_transforms)            { type->m_ReadsTransforms = reads_transforms?1:0; }
+void ComponentTypeSetWritesTransforms(ComponentType* type, bool writes_transforms)          { type->m_WritesTransforms = writes_transforms?1:0; }
+void ComponentTypeSetParallelUpdate(ComponentType* type, bool parallel_update)              { type->m_ParallelUpdate = parallel_update?1:0; }
 void ComponentTypeSetPrio(ComponentType* type, uint16_t prio)                               { type->m_UpdateOrderPrio = prio; }
 void ComponentTypeSetHasUserData(ComponentType* type, bool has_user_data)                   { type->m_InstanceHasUserData = has_user_data; }
 void ComponentTypeSetChilldIteratorFn(ComponentType* type, FIteratorChildren fn)            { type->m_IterChildren = fn; }
@@ -52,7 +52,9 @@ namespace dmGameObject
         FIteratorProperties     m_IterProperties; // for debug/testing
         uint32_t                m_InstanceHasUserData : 1;
         uint32_t                m_ReadsTransforms : 1;
-        uint32_t                m_Reserved : 30;
+        uint32_t                m_WritesTransforms : 1;
+        uint32_t                m_ParallelUpdate : 1;
+        uint32_t                m_Reserved : 28;
         uint16_t                m_UpdateOrderPrio;
     };
 
@@ -156,6 +156,7 @@ namespace dmGameObject
         m_ComponentTypeCount = 0;
         m_DefaultCollectionCapacity = DEFAULT_MAX_COLLECTION_CAPACITY;
         m_DefaultInputStackCapacity = DEFAULT_MAX_INPUT_STACK_CAPACITY;
+        m_JobContext = 0;
         m_Mutex = dmMutex::New();
     }
 
@@ -189,6 +190,14 @@ namespace dmGameObject
         m_InstanceIndices.SetCapacity(max_instances);
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
+        m_PrevLocalTransforms.SetCapacity(max_instances);
+        m_PrevLocalTransforms.SetSize(max_instances);
+        m_TransformFlags.SetCapacity(max_instances);
+        m_TransformFlags.SetSize(max_instances);
+        m_WorldTransformVersions.SetCapacity(max_instances);
+        m_WorldTransformVersions.SetSize(max_instances);
+        m_InstanceGenerations.SetCapacity(max_instances);
+        m_InstanceGenerations.SetSize(max_instances);
         m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
         m_InputFocusStack.SetCapacity(max_input_stack_entries);
         m_NameHash = 0;
@@ -214,6 +223,10 @@ namespace dmGameObject
 
         memset(&m_Instances[0], 0, sizeof(Instance*) * max_instances);
         memset(&m_WorldTransforms[0], 0xcc, sizeof(dmTransform::Transform) * max_instances);
+        memset(&m_TransformFlags[0], TRANSFORM_FLAG_FORCE, sizeof(uint8_t) * max_instances);
+        memset(&m_WorldTransformVersions[0], 0, sizeof(uint32_t) * max_instances);
+        memset(&m_InstanceGenerations[0], 0, sizeof(uint32_t) * max_instances);
+        memset(&m_ReceiverCache[0], 0, sizeof(m_ReceiverCache));
         memset(&m_LevelIndices[0], 0, sizeof(m_LevelIndices));
         memset(&m_ComponentInstanceCount[0], 0, sizeof(uint32_t) * MAX_COMPONENT_TYPES);
     }
@@ -239,6 +252,12 @@ namespace dmGameObject
         regist->m_DefaultInputStackCapacity = capacity;
     }
 
+    void SetJobContext(HRegister regist, dmJobSystem::HContext job_context)
+    {
+        assert(regist != 0x0);
+        regist->m_JobContext = job_context;
+    }
+
     static uint32_t GetInputStackDefaultCapacity(HRegister regist)
     {
         assert(regist != 0x0);
@@ -544,12 +563,12 @@ namespace dmGameObject
          * Remove instance from m_LevelIndices using an erase-swap operation
          */
 
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<uint32_t>& level = collection->m_LevelIndices[instance->m_Depth];
         assert(level.Size() > 0);
         assert(instance->m_LevelIndex < level.Size());
 
-        uint16_t level_index = instance->m_LevelIndex;
-        uint16_t swap_in_index = level.EraseSwap(level_index);
+        uint32_t level_index = instance->m_LevelIndex;
+        uint32_t swap_in_index = level.EraseSwap(level_index);
         HInstance swap_in_instance = collection->m_Instances[swap_in_index];
         assert(swap_in_instance->m_Index == swap_in_index);
         swap_in_instance->m_LevelIndex = level_index;
@@ -561,7 +580,7 @@ namespace dmGameObject
      * ** 10 elements as min
      * ** Up to max_instances as max
      */
-    static void ExpandLevel(dmArray<uint16_t>& level, uint32_t max_instances)
+    static void ExpandLevel(dmArray<uint32_t>& level, uint32_t max_instances)
     {
         const uint32_t min_offset = 10;
         const uint32_t max_offset = max_instances - level.Capacity();
@@ -574,15 +593,18 @@ namespace dmGameObject
         /*
          * Insert instance in m_LevelIndices at level set in instance->m_Depth
          */
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<uint32_t>& level = collection->m_LevelIndices[instance->m_Depth];
         if (level.Full())
             ExpandLevel(level, collection->m_MaxInstances);
         assert(!level.Full());
 
-        uint16_t level_index = (uint16_t)level.Size();
+        uint32_t level_index = level.Size();
         level.SetSize(level_index + 1);
         level[level_index] = instance->m_Index;
         instance->m_LevelIndex = level_index;
+
+        // New or moved in the hierarchy, the cached local transform can't be trusted
+        collection->m_TransformFlags[instance->m_Index] |= TRANSFORM_FLAG_FORCE;
     }
 
     static HInstance AllocInstance(Prototype* proto, const char* prototype_name) {
@@ -629,10 +651,12 @@ namespace dmGameObject
         HInstance instance = AllocInstance(proto, prototype_name);
         instance->m_Collection = collection;
         instance->m_ScaleAlongZ = collection->m_ScaleAlongZ;
-        uint16_t instance_index = collection->m_InstanceIndices.Pop();
+        uint32_t instance_index = collection->m_InstanceIndices.Pop();
         instance->m_Index = instance_index;
         assert(collection->m_Instances[instance_index] == 0);
         collection->m_Instances[instance_index] = instance;
+        // Invalidates any cached message receivers referring to the previous instance in this slot
+        ++collection->m_InstanceGenerations[instance_index];
 
         InsertInstanceInLevelIndex(collection, instance);
 
@@ -654,7 +678,9 @@ namespace dmGameObject
             Unlink(collection, instance);
         }
 
-        uint16_t instance_index = instance->m_Index;
+        ReleaseCollectionPath(collection, instance);
+
+        uint32_t instance_index = instance->m_Index;
         operator delete ((void*)instance);
         collection->m_Instances[instance_index] = 0x0;
         collection->m_InstanceIndices.Push(instance_index);
@@ -665,6 +691,51 @@ namespace dmGameObject
         UndoNewInstance(hcollection->m_Collection, instance);
     }
 
+    void SetCollectionPath(Collection* collection, HInstance instance, const HashState64* path_hash_state)
+    {
+        ReleaseCollectionPath(collection, instance);
+
+        HashState64 tmp_state;
+        dmHashClone64(&tmp_state, path_hash_state, false);
+        dmhash_t key = dmHashFinal64(&tmp_state);
+
+        CollectionPath** shared_path = collection->m_CollectionPaths.Get(key);
+        if (shared_path)
+        {
+            (*shared_path)->m_RefCount++;
+            instance->m_CollectionPath = *shared_path;
+            return;
+        }
+
+        CollectionPath* path = new CollectionPath;
+        dmHashClone64(&path->m_HashState, path_hash_state, true);
+        path->m_Key = key;
+        path->m_RefCount = 1;
+        if (collection->m_CollectionPaths.Full())
+        {
+            uint32_t capacity = collection->m_CollectionPaths.Capacity() + 16;
+            collection->m_CollectionPaths.SetCapacity(dmMath::Max(1U, capacity / 3), capacity);
+        }
+        collection->m_CollectionPaths.Put(key, path);
+        instance->m_CollectionPath = path;
+    }
+
+    void ReleaseCollectionPath(Collection* collection, HInstance instance)
+    {
+        CollectionPath* path = instance->m_CollectionPath;
+        if (path == 0)
+            return;
+        instance->m_CollectionPath = 0;
+
+        assert(path->m_RefCount > 0);
+        if (--path->m_RefCount == 0)
+        {
+            collection->m_CollectionPaths.Erase(path->m_Key);
+            dmHashRelease64(&path->m_HashState);
+            delete path;
+        }
+    }
+
     bool CreateComponents(Collection* collection, HInstance instance) {
         DM_PROFILE(GameObject, "CreateComponents");
 
@@ -903,8 +974,8 @@ namespace dmGameObject
             return;
         }
         instance->m_ToBeAdded = 1;
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToAddTail;
+        uint32_t index = instance->m_Index;
+        uint32_t tail = collection->m_InstancesToAddTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToAdd = index;
@@ -963,7 +1034,7 @@ namespace dmGameObject
             dmLogError("Instances can not be added to update during the update.");
             return false;
         }
-        uint16_t index = collection->m_InstancesToAddHead;
+        uint32_t index = collection->m_InstancesToAddHead;
         bool result = true;
         while (index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[index];
@@ -1037,8 +1108,11 @@ namespace dmGameObject
         SetScale(instance, scale);
         collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(instance->m_Transform);
 
-        dmHashInit64(&instance->m_CollectionPathHashState, true);
-        dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, ID_SEPARATOR, strlen(ID_SEPARATOR));
+        HashState64 path_hash_state;
+        dmHashInit64(&path_hash_state, true);
+        dmHashUpdateBuffer64(&path_hash_state, ID_SEPARATOR, strlen(ID_SEPARATOR));
+        SetCollectionPath(collection, instance, &path_hash_state);
+        dmHashRelease64(&path_hash_state);
 
         Result result = SetIdentifier(collection, instance, id);
         if (result == RESULT_IDENTIFIER_IN_USE)
@@ -1123,15 +1197,18 @@ namespace dmGameObject
                     scale = Vector3(instance_desc.m_Scale, instance_desc.m_Scale, instance_desc.m_Scale);
 
             instance->m_Transform = dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale);
-            dmHashClone64(&instance->m_CollectionPathHashState, &prefixHashState, true);
+            HashState64 path_hash_state;
+            dmHashClone64(&path_hash_state, &prefixHashState, true);
 
             const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
             if (path_end == 0x0) {
                 dmLogError("The id of %s has an incorrect format, missing path specifier.", instance_desc.m_Id);
                 success = false;
             } else {
-                dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
+                dmHashUpdateBuffer64(&path_hash_state, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
             }
+            SetCollectionPath(collection, instance, &path_hash_state);
+            dmHashRelease64(&path_hash_state);
 
             // Construct the full new path id and store in the id mapping table (mapping from prefixless
             // to with the root_path added)
@@ -1729,8 +1806,8 @@ namespace dmGameObject
         // Delete instance
         instance->m_ToBeDeleted = 1;
 
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToDeleteTail;
+        uint32_t index = instance->m_Index;
+        uint32_t tail = collection->m_InstancesToDeleteTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToDelete = index;
@@ -1747,10 +1824,10 @@ namespace dmGameObject
 
     static void RemoveFromAddToUpdate(Collection* collection, HInstance instance)
     {
-        uint16_t index = instance->m_Index;
+        uint32_t index = instance->m_Index;
         assert(collection->m_InstancesToAddTail == index || instance->m_NextToAdd != INVALID_INSTANCE_INDEX);
-        uint16_t* prev_index_ptr = &collection->m_InstancesToAddHead;
-        uint16_t prev_index = *prev_index_ptr;
+        uint32_t* prev_index_ptr = &collection->m_InstancesToAddHead;
+        uint32_t prev_index = *prev_index_ptr;
         while (prev_index != index) {
             prev_index_ptr = &collection->m_Instances[prev_index]->m_NextToAdd;
             if (collection->m_InstancesToAddTail == *prev_index_ptr) {
@@ -1778,7 +1855,7 @@ namespace dmGameObject
         Prototype* prototype = instance->m_Prototype;
         DestroyComponents(collection, instance);
 
-        dmHashRelease64(&instance->m_CollectionPathHashState);
+        ReleaseCollectionPath(collection, instance);
         if(instance->m_Generated)
         {
             dmHashReverseErase64(instance->m_Identifier);
@@ -1905,7 +1982,10 @@ namespace dmGameObject
         {
             // Make a copy of the state.
             HashState64 tmp_state;
-            dmHashClone64(&tmp_state, &instance->m_CollectionPathHashState, false);
+            if (instance->m_CollectionPath)
+                dmHashClone64(&tmp_state, &instance->m_CollectionPath->m_HashState, false);
+            else
+                dmHashInit64(&tmp_state, false);
             dmHashUpdateBuffer64(&tmp_state, id, id_size);
             return dmHashFinal64(&tmp_state);
         }
@@ -1971,11 +2051,11 @@ namespace dmGameObject
         return instance->m_Bone;
     }
 
-    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, uint16_t first_index, dmTransform::Transform* transforms, uint32_t transform_count)
+    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, uint32_t first_index, dmTransform::Transform* transforms, uint32_t transform_count)
     {
         if (transform_count == 0)
             return 0;
-        uint16_t current_index = first_index;
+        uint32_t current_index = first_index;
         uint32_t count = 0;
         Collection* collection = hcollection->m_Collection;
         while (current_index != INVALID_INSTANCE_INDEX)
@@ -2006,8 +2086,8 @@ namespace dmGameObject
         return DoSetBoneTransforms(instance->m_Collection->m_HCollection, &component_transform, instance->m_Index, transforms, transform_count);
     }
 
-    static void DeleteBones(Collection* collection, uint16_t first_index) {
-        uint16_t current_index = first_index;
+    static void DeleteBones(Collection* collection, uint32_t first_index) {
+        uint32_t current_index = first_index;
         while (current_index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[current_index];
             if (instance->m_Bone && instance->m_ToBeDeleted == 0) {
@@ -2029,15 +2109,51 @@ namespace dmGameObject
         bool m_Success;
     };
 
+    static inline ReceiverCacheEntry* GetReceiverCacheEntry(Collection* collection, const dmMessage::URL* receiver)
+    {
+        return &collection->m_ReceiverCache[(uint32_t)(receiver->m_Path ^ receiver->m_Fragment) & (RECEIVER_CACHE_SIZE - 1)];
+    }
+
+    // Returns the cached entry for the receiver, or 0x0 if it isn't cached or the instance has been deleted since
+    static ReceiverCacheEntry* GetCachedReceiver(Collection* collection, const dmMessage::URL* receiver)
+    {
+        ReceiverCacheEntry* entry = GetReceiverCacheEntry(collection, receiver);
+        if (entry->m_Path != receiver->m_Path || entry->m_Fragment != receiver->m_Fragment)
+            return 0x0;
+        Instance* instance = collection->m_Instances[entry->m_InstanceIndex];
+        if (instance == 0x0 || collection->m_InstanceGenerations[entry->m_InstanceIndex] != entry->m_Generation || instance->m_Identifier != receiver->m_Path)
+            return 0x0;
+        return entry;
+    }
+
+    static void CacheReceiver(Collection* collection, const dmMessage::URL* receiver, Instance* instance, uint16_t component_index, uint16_t component_instance_data_index)
+    {
+        ReceiverCacheEntry* entry = GetReceiverCacheEntry(collection, receiver);
+        entry->m_Path = receiver->m_Path;
+        entry->m_Fragment = receiver->m_Fragment;
+        entry->m_InstanceIndex = instance->m_Index;
+        entry->m_Generation = collection->m_InstanceGenerations[instance->m_Index];
+        entry->m_ComponentIndex = component_index;
+        entry->m_ComponentInstanceDataIndex = component_instance_data_index;
+    }
+
     void DispatchMessagesFunction(dmMessage::Message* message, void* user_ptr)
     {
         DispatchMessagesContext* context = (DispatchMessagesContext*) user_ptr;
         Collection* collection = context->m_Collection;
 
+        // Receivers posted to repeatedly are resolved once, skipping the identifier and component lookups
+        ReceiverCacheEntry* cached_receiver = GetCachedReceiver(collection, &message->m_Receiver);
+
         Instance* instance = 0x0;
+        if (cached_receiver != 0x0)
+        {
+            instance = collection->m_Instances[cached_receiver->m_InstanceIndex];
+        }
         // Start by looking for the instance in the user-data,
         // which is the case when an instance sends to itself.
-        if (message->m_UserData1 != 0
+        if (instance == 0x0
+                && message->m_UserData1 != 0
                 && message->m_Sender.m_Socket == message->m_Receiver.m_Socket
                 && message->m_Sender.m_Path == message->m_Receiver.m_Path)
         {
@@ -2066,6 +2182,10 @@ namespace dmGameObject
             context->m_Success = false;
             return;
         }
+        if (cached_receiver == 0x0 && message->m_Receiver.m_Fragment == 0)
+        {
+            CacheReceiver(collection, &message->m_Receiver, instance, 0, 0);
+        }
         if (message->m_Descriptor != 0)
         {
             dmDDF::Descriptor* descriptor = (dmDDF::Descriptor*)message->m_Descriptor;
@@ -2161,8 +2281,25 @@ namespace dmGameObject
         if (message->m_Receiver.m_Fragment != 0)
         {
             uint16_t component_index;
-            Result result = GetComponentIndex(instance, message->m_Receiver.m_Fragment, &component_index);
-            if (result != RESULT_OK)
+            uint16_t component_instance_data_index;
+            if (cached_receiver != 0x0)
+            {
+                component_index = cached_receiver->m_ComponentIndex;
+                component_instance_data_index = cached_receiver->m_ComponentInstanceDataIndex;
+            }
+            else if (GetComponentIndex(instance, message->m_Receiver.m_Fragment, &component_index) == RESULT_OK)
+            {
+                component_instance_data_index = 0;
+                for (uint32_t i = 0; i < component_index; ++i)
+                {
+                    if (prototype->m_Components[i].m_Type->m_InstanceHasUserData)
+                    {
+                        component_instance_data_index++;
+                    }
+                }
+                CacheReceiver(collection, &message->m_Receiver, instance, component_index, component_instance_data_index);
+            }
+            else
             {
                 const dmMessage::URL* sender = &message->m_Sender;
                 const char* socket_name = dmMessage::GetSocketName(sender->m_Socket);
@@ -2183,22 +2320,10 @@ namespace dmGameObject
 
             if (component_type->m_OnMessageFunction)
             {
-                // TODO: Not optimal way to find index of component instance data
-                uint32_t next_component_instance_data = 0;
-                for (uint32_t i = 0; i < component_index; ++i)
-                {
-                    ComponentType* ct = prototype->m_Components[i].m_Type;
-                    assert(component_type);
-                    if (ct->m_InstanceHasUserData)
-                    {
-                        next_component_instance_data++;
-                    }
-                }
-
                 uintptr_t* component_instance_data = 0;
                 if (component_type->m_InstanceHasUserData)
                 {
-                    component_instance_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
+                    component_instance_data = &instance->m_ComponentInstanceUserData[component_instance_data_index];
                 }
                 {
                     DM_PROFILE(GameObject, "OnMessageFunction");
@@ -2312,64 +2437,95 @@ namespace dmGameObject
         }
     }
 
-    void UpdateTransforms(Collection* collection)
+    // Levels with fewer instances than this are not worth splitting over the job system workers
+    static const uint32_t PARALLEL_TRANSFORMS_MIN_LEVEL_SIZE = 1024;
+    static const uint32_t PARALLEL_TRANSFORMS_BATCH_SIZE = 256;
+
+    // Calculates the world transforms for the range [start, end) of a level. Instances with an unchanged
+    // local transform, and an unchanged parent, are skipped along with their entire subtree.
+    static void UpdateLevelTransforms(Collection* collection, const uint32_t* level, uint32_t start, uint32_t end, bool scale_along_z)
     {
-        DM_PROFILE(GameObject, "UpdateTransforms");
+        Instance** instances = collection->m_Instances.Begin();
+        Matrix4* world_transforms = collection->m_WorldTransforms.Begin();
+        dmTransform::Transform* prev_local_transforms = collection->m_PrevLocalTransforms.Begin();
+        uint8_t* flags = collection->m_TransformFlags.Begin();
+        uint32_t* versions = collection->m_WorldTransformVersions.Begin();
 
-        // Calculate world transforms
-        // First root-level instances
-        dmArray<uint16_t>& root_level = collection->m_LevelIndices[0];
-        uint32_t root_count = root_level.Size();
-        for (uint32_t i = 0; i < root_count; ++i)
+        for (uint32_t i = start; i < end; ++i)
         {
-            uint16_t index = root_level[i];
-            Instance* instance = collection->m_Instances[index];
+            uint32_t index = level[i];
+            Instance* instance = instances[index];
             CheckEuler(instance);
-            collection->m_WorldTransforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
-            uint16_t parent_index = instance->m_Parent;
-            assert(parent_index == INVALID_INSTANCE_INDEX);
-        }
-
 
-        if (collection->m_ScaleAlongZ) {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
+            uint32_t parent_index = instance->m_Parent;
+            bool changed = (flags[index] & TRANSFORM_FLAG_FORCE) != 0;
+            if (parent_index != INVALID_INSTANCE_INDEX)
+                changed = changed || (flags[parent_index] & TRANSFORM_FLAG_CHANGED) != 0;
+            changed = changed || memcmp(&prev_local_transforms[index], &instance->m_Transform, sizeof(dmTransform::Transform)) != 0;
+            if (!changed)
             {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+                flags[index] = 0;
+                continue;
+            }
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+            flags[index] = TRANSFORM_FLAG_CHANGED;
+            prev_local_transforms[index] = instance->m_Transform;
+            ++versions[index];
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = *parent_trans * own;
-                }
+            Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
+            if (parent_index == INVALID_INSTANCE_INDEX)
+            {
+                world_transforms[index] = own;
             }
-        } else {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
+            else if (scale_along_z)
             {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+                world_transforms[index] = world_transforms[parent_index] * own;
+            }
+            else
+            {
+                world_transforms[index] = dmTransform::MulNoScaleZ(world_transforms[parent_index], own);
+            }
+        }
+    }
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+    struct UpdateTransformsContext
+    {
+        Collection* m_Collection;
+        bool        m_ScaleAlongZ;
+    };
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, own);
-                }
+    static void UpdateLevelTransformsJob(void* context, void* data, uint32_t start, uint32_t end)
+    {
+        UpdateTransformsContext* ctx = (UpdateTransformsContext*) context;
+        UpdateLevelTransforms(ctx->m_Collection, (const uint32_t*) data, start, end, ctx->m_ScaleAlongZ);
+    }
+
+    void UpdateTransforms(Collection* collection)
+    {
+        DM_PROFILE(GameObject, "UpdateTransforms");
+
+        UpdateTransformsContext ctx;
+        ctx.m_Collection = collection;
+        ctx.m_ScaleAlongZ = collection->m_ScaleAlongZ;
+        dmJobSystem::HContext job_context = collection->m_Register->m_JobContext;
+
+        // Calculate world transforms, level by level starting with the root-level instances.
+        // The instances of a level only depend on the level above, so a level can be split over several threads.
+        for (uint32_t level_i = 0; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
+        {
+            dmArray<uint32_t>& level = collection->m_LevelIndices[level_i];
+            uint32_t instance_count = level.Size();
+            // Every instance has its parent on the level above, i.e. all levels below are empty as well
+            if (instance_count == 0)
+                break;
+
+            if (job_context && instance_count >= PARALLEL_TRANSFORMS_MIN_LEVEL_SIZE)
+            {
+                dmJobSystem::ParallelFor(job_context, UpdateLevelTransformsJob, &ctx, level.Begin(), instance_count, PARALLEL_TRANSFORMS_BATCH_SIZE);
+            }
+            else
+            {
+                UpdateLevelTransforms(collection, level.Begin(), 0, instance_count, ctx.m_ScaleAlongZ);
             }
         }
 
@@ -2381,6 +2537,95 @@ namespace dmGameObject
         UpdateTransforms(hcollection->m_Collection);
     }
 
+    static bool UpdateComponentType(Collection* collection, const UpdateContext* update_context, uint16_t update_index, bool* transforms_updated)
+    {
+        ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
+        DM_PROFILE_DYN(GameObject, component_type->m_Name, component_type->m_NameHash);
+        ComponentsUpdateParams params;
+        params.m_Collection = collection->m_HCollection;
+        params.m_UpdateContext = update_context;
+        params.m_World = collection->m_ComponentWorlds[update_index];
+        params.m_Context = component_type->m_Context;
+
+        ComponentsUpdateResult update_result;
+        update_result.m_TransformsUpdated = false;
+        UpdateResult res = component_type->m_UpdateFunction(params, update_result);
+        *transforms_updated = update_result.m_TransformsUpdated;
+        return res == UPDATE_RESULT_OK;
+    }
+
+    static inline bool CanUpdateInParallel(const ComponentType* component_type)
+    {
+        return component_type->m_ParallelUpdate && !component_type->m_WritesTransforms;
+    }
+
+    struct ComponentUpdateJob
+    {
+        Collection*             m_Collection;
+        const UpdateContext*    m_UpdateContext;
+        uint16_t                m_UpdateIndex;
+        bool                    m_Result;
+        bool                    m_TransformsUpdated;
+    };
+
+    static void ComponentUpdateJobFunc(void* context, void* data)
+    {
+        ComponentUpdateJob* job = (ComponentUpdateJob*) data;
+        job->m_Result = UpdateComponentType(job->m_Collection, job->m_UpdateContext, job->m_UpdateIndex, &job->m_TransformsUpdated);
+    }
+
+    // Updates the component types [start, end) in update order concurrently
+    static bool UpdateComponentTypesParallel(Collection* collection, const UpdateContext* update_context, uint32_t start, uint32_t end)
+    {
+        DM_PROFILE(GameObject, "UpdateParallel");
+        Register* regist = collection->m_Register;
+        dmJobSystem::HContext job_context = regist->m_JobContext;
+
+        ComponentUpdateJob jobs[MAX_COMPONENT_TYPES];
+        uint32_t job_count = 0;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            uint16_t update_index = regist->m_ComponentTypesOrder[i];
+            if (regist->m_ComponentTypes[update_index].m_UpdateFunction == 0)
+                continue;
+            ComponentUpdateJob& job = jobs[job_count++];
+            job.m_Collection = collection;
+            job.m_UpdateContext = update_context;
+            job.m_UpdateIndex = update_index;
+            job.m_Result = true;
+            job.m_TransformsUpdated = false;
+        }
+
+        dmJobSystem::HJob root = job_count > 1 ? dmJobSystem::CreateJob(job_context, 0, 0, 0) : 0;
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            // The last one, and any type that didn't fit in the job pool, is updated on this thread
+            dmJobSystem::HJob job = 0;
+            if (root && i < job_count - 1)
+            {
+                job = dmJobSystem::CreateChildJob(job_context, root, ComponentUpdateJobFunc, 0, &jobs[i]);
+            }
+            if (job)
+                dmJobSystem::Run(job_context, job);
+            else
+                ComponentUpdateJobFunc(0, &jobs[i]);
+        }
+
+        if (root)
+        {
+            dmJobSystem::Run(job_context, root);
+            dmJobSystem::Wait(job_context, root);
+        }
+
+        bool ret = true;
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            ret &= jobs[i].m_Result;
+            collection->m_DirtyTransforms |= jobs[i].m_TransformsUpdated;
+        }
+        return ret;
+    }
+
     static bool Update(Collection* collection, const UpdateContext* update_context)
     {
         DM_PROFILE(GameObject, "Update");
@@ -2395,41 +2640,56 @@ namespace dmGameObject
 
         bool ret = true;
 
-        uint32_t component_types = collection->m_Register->m_ComponentTypeCount;
-        for (uint32_t i = 0; i < component_types; ++i)
+        Register* regist = collection->m_Register;
+        uint32_t component_types = regist->m_ComponentTypeCount;
+        uint32_t i = 0;
+        while (i < component_types)
         {
-            uint16_t update_index = collection->m_Register->m_ComponentTypesOrder[i];
-            ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
+            // Adjacent component types (in update order) that can be updated in parallel are updated as a group.
+            // Updating transforms and dispatching messages are barriers between the groups.
+            uint32_t group_end = i + 1;
+            if (regist->m_JobContext && CanUpdateInParallel(&regist->m_ComponentTypes[regist->m_ComponentTypesOrder[i]]))
+            {
+                while (group_end < component_types && CanUpdateInParallel(&regist->m_ComponentTypes[regist->m_ComponentTypesOrder[group_end]]))
+                    ++group_end;
+            }
 
-            DM_COUNTER_DYN(collection->m_Register->m_ComponentProfileCounterIndex[update_index], collection->m_ComponentInstanceCount[update_index]);
+            bool reads_transforms = false;
+            for (uint32_t j = i; j < group_end; ++j)
+            {
+                uint16_t update_index = regist->m_ComponentTypesOrder[j];
+                DM_COUNTER_DYN(regist->m_ComponentProfileCounterIndex[update_index], collection->m_ComponentInstanceCount[update_index]);
+                reads_transforms |= regist->m_ComponentTypes[update_index].m_ReadsTransforms;
+            }
 
             // Avoid to call UpdateTransforms for each/all component types.
-            if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
+            if (reads_transforms && collection->m_DirtyTransforms) {
                 UpdateTransforms(collection);
             }
 
-            if (component_type->m_UpdateFunction)
+            if (group_end - i > 1)
             {
-                DM_PROFILE_DYN(GameObject, component_type->m_Name, component_type->m_NameHash);
-                ComponentsUpdateParams params;
-                params.m_Collection = collection->m_HCollection;
-                params.m_UpdateContext = update_context;
-                params.m_World = collection->m_ComponentWorlds[update_index];
-                params.m_Context = component_type->m_Context;
-
-                ComponentsUpdateResult update_result;
-                update_result.m_TransformsUpdated = false;
-                UpdateResult res = component_type->m_UpdateFunction(params, update_result);
-                if (res != UPDATE_RESULT_OK)
+                if (!UpdateComponentTypesParallel(collection, update_context, i, group_end))
                     ret = false;
-
-                // Mark the collections transforms as dirty if this component has updated
-                // them in its update function.
-                collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
+            }
+            else
+            {
+                uint16_t update_index = regist->m_ComponentTypesOrder[i];
+                if (regist->m_ComponentTypes[update_index].m_UpdateFunction)
+                {
+                    // Mark the collections transforms as dirty if this component has updated
+                    // them in its update function.
+                    bool transforms_updated = false;
+                    if (!UpdateComponentType(collection, update_context, update_index, &transforms_updated))
+                        ret = false;
+                    collection->m_DirtyTransforms |= transforms_updated;
+                }
             }
 
             if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
                 ret = false;
+
+            i = group_end;
         }
 
         collection->m_InUpdate = 0;
@@ -2524,11 +2784,11 @@ namespace dmGameObject
             while (collection->m_InstancesToDeleteHead != INVALID_INSTANCE_INDEX && pass_count < max_pass_count) {
                 ++pass_count;
                 // Save the list and clear the head and tail
-                uint16_t head = collection->m_InstancesToDeleteHead;
+                uint32_t head = collection->m_InstancesToDeleteHead;
                 collection->m_InstancesToDeleteHead = INVALID_INSTANCE_INDEX;
                 collection->m_InstancesToDeleteTail = INVALID_INSTANCE_INDEX;
 
-                uint16_t index = head;
+                uint32_t index = head;
                 while (index != INVALID_INSTANCE_INDEX) {
                     Instance* instance = collection->m_Instances[index];
 
@@ -2846,6 +3106,11 @@ namespace dmGameObject
         return instance->m_Collection->m_WorldTransforms[instance->m_Index];
     }
 
+    uint32_t GetWorldTransformVersion(HInstance instance)
+    {
+        return instance->m_Collection->m_WorldTransformVersions[instance->m_Index];
+    }
+
     Result SetParent(HInstance child, HInstance parent)
     {
         if (parent == 0 && child->m_Parent == INVALID_INSTANCE_INDEX)
@@ -3379,7 +3644,7 @@ namespace dmGameObject
     //  - patch data structures for identification and input stack
     //  - copy the rest of the fields
     // The old instance is destroyed.
-    static void RecreateInstance(Collection* collection, uint16_t index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
+    static void RecreateInstance(Collection* collection, uint32_t index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
         HInstance instance = collection->m_Instances[index];
         // We don't support recreating instances that are 'transitioning'
         assert(instance->m_ToBeAdded == 0);
@@ -3405,12 +3670,10 @@ namespace dmGameObject
         // id-related
         new_instance->m_Identifier = instance->m_Identifier;
         new_instance->m_IdentifierIndex = instance->m_IdentifierIndex;
-        dmHashClone64(&new_instance->m_CollectionPathHashState, &instance->m_CollectionPathHashState, true);
         new_instance->m_Generated = instance->m_Generated;
         HCollection hcollection = collection->m_HCollection;
         bool res = CreateComponents(hcollection, new_instance);
         if (!res) {
-            dmHashRelease64(&new_instance->m_CollectionPathHashState);
             DeallocInstance(new_instance);
             return;
         }
@@ -3424,8 +3687,12 @@ namespace dmGameObject
             FinalComponents(collection, instance);
         }
         DestroyComponents(collection, instance);
-        dmHashRelease64(&instance->m_CollectionPathHashState);
+        // The collection path reference is handed over to the new instance
+        new_instance->m_CollectionPath = instance->m_CollectionPath;
+        instance->m_CollectionPath = 0;
         collection->m_Instances[index] = new_instance;
+        // The new prototype can have other components, so invalidate any cached message receivers for this slot
+        ++collection->m_InstanceGenerations[index];
         collection->m_IDToInstance.Put(new_instance->m_Identifier, new_instance);
 
         dmArray<Instance*>& stack = collection->m_InputFocusStack;
@@ -3446,11 +3713,11 @@ namespace dmGameObject
         Collection* collection = (Collection*) params.m_UserData;
         for (uint32_t level_i = 0; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
         {
-            dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+            dmArray<uint32_t>& level = collection->m_LevelIndices[level_i];
             uint32_t instance_count = level.Size();
             for (uint32_t i = 0; i < instance_count; ++i)
             {
-                uint16_t index = level[i];
+                uint32_t index = level[i];
                 Instance* instance = collection->m_Instances[index];
                 if (instance->m_Prototype == params.m_Resource->m_Resource) {
                     RecreateInstance(collection, index, (Prototype*)params.m_Resource->m_PrevResource, (Prototype*)params.m_Resource->m_Resource, params.m_Name);
@@ -3493,7 +3760,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToAddHead;
+        uint32_t index = collection->m_InstancesToAddHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToAdd;
             ++count;
@@ -3505,7 +3772,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToDeleteHead;
+        uint32_t index = collection->m_InstancesToDeleteHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToDelete;
             ++count;
@@ -19,6 +19,7 @@
 
 #include <dlib/easing.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_system.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -69,7 +70,7 @@ namespace dmGameObject
     /**
      * Set default capacity of collections in this register. This does not affect existing collections.
      * @param regist Register
-     * @param capacity Default capacity of collections in this register (0-32766).
+     * @param capacity Default capacity of collections in this register (0-2147483646).
      * @return RESULT_OK on success or RESULT_INVALID_OPERATION if max_count is not within range
      */
     Result SetCollectionDefaultCapacity(HRegister regist, uint32_t capacity);
@@ -88,6 +89,14 @@ namespace dmGameObject
      */
     void SetInputStackDefaultCapacity(HRegister regist, uint32_t capacity);
 
+    /**
+     * Set the job system context used to update component types flagged with ComponentTypeSetParallelUpdate()
+     * concurrently. If no context is set, all component types are updated on the calling thread.
+     * @param regist Register
+     * @param job_context Job system context, or 0x0
+     */
+    void SetJobContext(HRegister regist, dmJobSystem::HContext job_context);
+
     /**
      * Creates a new gameobject collection
      * @param name Collection name, which must be unique and follow the same naming as for sockets
@@ -216,6 +225,14 @@ namespace dmGameObject
      */
     void SetInheritScale(HInstance instance, bool inherit_scale);
 
+    /**
+     * Returns a counter that is incremented each time the world transform of the instance is recalculated.
+     * Compare with a previously returned value to find out if the world transform might have changed since then.
+     * @param instance Instance
+     * @return world transform version
+     */
+    uint32_t GetWorldTransformVersion(HInstance instance);
+
     /**
      * Tells the collection that a transform was updated
      */
@@ -24,6 +24,7 @@ namespace dmGameObject
         ComponentTypeSetContext(type, ctx->m_Script);
         ComponentTypeSetHasUserData(type, true);
         ComponentTypeSetReadsTransforms(type, true);
+        ComponentTypeSetWritesTransforms(type, true);
 
         ComponentTypeSetNewWorldFn(type, CompScriptNewWorld);
         ComponentTypeSetDeleteWorldFn(type, CompScriptDeleteWorld);
@@ -48,6 +49,7 @@ namespace dmGameObject
     {
         ComponentTypeSetPrio(type, 250);
         ComponentTypeSetReadsTransforms(type, true);
+        ComponentTypeSetWritesTransforms(type, true);
         ComponentTypeSetNewWorldFn(type, CompAnimNewWorld);
         ComponentTypeSetDeleteWorldFn(type, CompAnimDeleteWorld);
         ComponentTypeSetAddToUpdateFn(type, CompAnimAddToUpdate);
@@ -83,8 +83,17 @@ namespace dmGameObject
         dmArray<void*> m_PropertyResources;
     };
 
-    // Invalid instance index. Implies that maximum number of instances is 32766 (ie 0x7fff - 1)
-    const uint32_t INVALID_INSTANCE_INDEX = 0x7fff;
+    // Invalid instance index. Implies that maximum number of instances is 2147483646 (ie 0x7fffffff - 1)
+    const uint32_t INVALID_INSTANCE_INDEX = 0x7fffffff;
+
+    // Hash-state for a collection path, e.g. "/level/enemies/". Used for calculating global identifiers.
+    // Shared among all instances in the collection with the same path and reference counted.
+    struct CollectionPath
+    {
+        HashState64     m_HashState;
+        dmhash_t        m_Key;
+        uint32_t        m_RefCount;
+    };
 
     // NOTE: Actual size of Instance is sizeof(Instance) + sizeof(uintptr_t) * m_UserDataCount
     struct Instance
@@ -98,7 +107,7 @@ namespace dmGameObject
             m_Prototype = prototype;
             m_IdentifierIndex = INVALID_INSTANCE_POOL_INDEX;
             m_Identifier = UNNAMED_IDENTIFIER;
-            dmHashInit64(&m_CollectionPathHashState, false);
+            m_CollectionPath = 0;
             m_Depth = 0;
             m_Initialized = 0;
             m_ScaleAlongZ = 0;
@@ -130,53 +139,53 @@ namespace dmGameObject
         struct Collection* m_Collection;
         Prototype*      m_Prototype;
 
-        uint32_t        m_IdentifierIndex;
         dmhash_t        m_Identifier;
-
-        // Collection path hash-state. Used for calculating global identifiers. Contains the hash-state for the collection-path to the instance.
-        // We might, in the future, for memory reasons, move this hash-state to a data-structure shared among all instances from the same collection.
-        HashState64     m_CollectionPathHashState;
+        uint32_t        m_IdentifierIndex;
 
         // Hierarchical depth
-        uint16_t        m_Depth : 8;
+        uint32_t        m_Depth : 8;
         // If the instance was initialized or not (Init())
-        uint16_t        m_Initialized : 1;
+        uint32_t        m_Initialized : 1;
         // If this game object should have the Z component of the position affected by scale
-        uint16_t        m_ScaleAlongZ : 1;
+        uint32_t        m_ScaleAlongZ : 1;
         // If this game object is part of a skeleton
-        uint16_t        m_Bone : 1;
+        uint32_t        m_Bone : 1;
         // If this is a generated instance, i.e. if the instance id is uniquely generated
-        uint16_t        m_Generated : 1;
+        uint32_t        m_Generated : 1;
         // Padding
-        uint16_t        m_Pad : 4;
+        uint32_t        m_Pad : 20;
+
+        // Collection path hash-state, or 0x0 if the instance isn't part of a collection path (i.e. created with New()).
+        // Contains the hash-state for the collection-path to the instance.
+        CollectionPath* m_CollectionPath;
 
         // Index to parent
-        uint16_t        m_Parent : 16;
+        uint32_t        m_Parent;
 
         // Index to Collection::m_Instances
-        uint16_t        m_Index : 15;
+        uint32_t        m_Index : 31;
         // Used for deferred deletion
-        uint16_t        m_ToBeDeleted : 1;
+        uint32_t        m_ToBeDeleted : 1;
 
         // Index to Collection::m_LevelIndex. Index is relative to current level (m_Depth), eg first object in level L always has level-index 0
         // Level-index is used to reorder Collection::m_LevelIndex entries in O(1). Given an instance we need to find where the
         // instance index is located in Collection::m_LevelIndex
-        uint16_t        m_LevelIndex : 15;
-        uint16_t        m_Pad2 : 1;
+        uint32_t        m_LevelIndex : 31;
+        uint32_t        m_Pad2 : 1;
 
         // Index to next instance to delete or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToDelete : 16;
+        uint32_t        m_NextToDelete;
 
         // Index to next instance to add-to-update or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToAdd;
+        uint32_t        m_NextToAdd;
 
         // Next sibling index. Index to Collection::m_Instances
-        uint16_t        m_SiblingIndex : 15;
-        uint16_t        m_ToBeAdded : 1;
+        uint32_t        m_SiblingIndex : 31;
+        uint32_t        m_ToBeAdded : 1;
 
         // First child index. Index to Collection::m_Instances
-        uint16_t        m_FirstChildIndex : 15;
-        uint16_t        m_Pad4 : 1;
+        uint32_t        m_FirstChildIndex : 31;
+        uint32_t        m_Pad4 : 1;
 
         uint32_t        m_ComponentInstanceUserDataCount;
         uintptr_t       m_ComponentInstanceUserData[0];
@@ -200,6 +209,8 @@ namespace dmGameObject
         // Default capacity of collections
         uint32_t                    m_DefaultCollectionCapacity;
         uint32_t                    m_DefaultInputStackCapacity;
+        // Used for updating component types in parallel
+        dmJobSystem::HContext       m_JobContext;
 
         Register();
         ~Register();
@@ -209,6 +220,29 @@ namespace dmGameObject
     // depth is interpreted as up to <depth> levels of child nodes including root-nodes
     // Must be greater than zero
     const uint32_t MAX_HIERARCHICAL_DEPTH = 128;
+
+    // The world transform was recalculated in the last UpdateTransforms(), i.e. the children must be recalculated too
+    const uint8_t TRANSFORM_FLAG_CHANGED = 1;
+    // The world transform must be recalculated in the next UpdateTransforms(), e.g. since the instance is new or moved in the hierarchy
+    const uint8_t TRANSFORM_FLAG_FORCE = 2;
+
+    // Number of entries in Collection::m_ReceiverCache, must be a power of two
+    const uint32_t RECEIVER_CACHE_SIZE = 64;
+
+    // A message receiver (path and fragment) resolved to an instance and component, see DispatchMessagesFunction.
+    // Only valid while the instance slot still has the same generation.
+    struct ReceiverCacheEntry
+    {
+        dmhash_t                 m_Path;
+        dmhash_t                 m_Fragment;
+        uint32_t                 m_InstanceIndex;
+        uint32_t                 m_Generation;
+        // Index into Prototype::m_Components, only used when m_Fragment is set
+        uint16_t                 m_ComponentIndex;
+        // Index into Instance::m_ComponentInstanceUserData, only used when m_Fragment is set
+        uint16_t                 m_ComponentInstanceDataIndex;
+    };
+
     struct Collection
     {
         Collection(dmResource::HFactory factory, HRegister regist, uint32_t max_instances, uint32_t max_input_stack_entries);
@@ -236,7 +270,7 @@ namespace dmGameObject
         dmArray<Instance*>       m_Instances;
 
         // Index pool for mapping Instance::m_Index to m_Instances
-        dmIndexPool16            m_InstanceIndices;
+        dmIndexPool32            m_InstanceIndices;
 
         // Resources referenced through property overrides inside the collection
         dmArray<void*>           m_PropertyResources;
@@ -246,14 +280,30 @@ namespace dmGameObject
         // Two dimensional table of indices with stride "max_instances"
         // Level 0 contains root-nodes in [0..m_LevelIndices[0].Size()-1]
         // Level 1 contains level 1 indices in [0..m_LevelIndices[1].Size()-1]
-        dmArray<uint16_t>        m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
+        dmArray<uint32_t>        m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
 
         // Array of world transforms. Calculated using m_LevelIndices above
         dmArray<Matrix4>         m_WorldTransforms;
 
+        // Local transforms used when the world transforms were last calculated, indexed as m_WorldTransforms.
+        // Instances whose local transform and parent are unchanged keep their world transform.
+        dmArray<dmTransform::Transform> m_PrevLocalTransforms;
+        // Per instance TRANSFORM_FLAG_* bits, indexed as m_WorldTransforms
+        dmArray<uint8_t>         m_TransformFlags;
+        // Per instance counter, incremented each time the world transform is recalculated. Indexed as m_WorldTransforms
+        dmArray<uint32_t>        m_WorldTransformVersions;
+
+        // Per instance slot counter, incremented each time the slot is assigned a new instance. Indexed as m_Instances
+        dmArray<uint32_t>        m_InstanceGenerations;
+        // Recently resolved message receivers, indexed by a hash of the receiver path and fragment
+        ReceiverCacheEntry       m_ReceiverCache[RECEIVER_CACHE_SIZE];
+
         // Identifier to Instance mapping
         dmHashTable64<Instance*> m_IDToInstance;
 
+        // Shared collection paths, keyed by the hash of the path
+        dmHashTable64<CollectionPath*> m_CollectionPaths;
+
         // Stack keeping track of which instance has the input focus
         dmArray<Instance*>       m_InputFocusStack;
 
@@ -273,14 +323,14 @@ namespace dmGameObject
         dmIndexPool32            m_InstanceIdPool;
 
         // Head of linked list of instances scheduled for deferred deletion
-        uint16_t                 m_InstancesToDeleteHead;
+        uint32_t                 m_InstancesToDeleteHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToDeleteTail;
+        uint32_t                 m_InstancesToDeleteTail;
 
         // Head of linked list of instances scheduled to be added to update
-        uint16_t                 m_InstancesToAddHead;
+        uint32_t                 m_InstancesToAddHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToAddTail;
+        uint32_t                 m_InstancesToAddTail;
 
         // Set to 1 if in update-loop
         uint32_t                 m_InUpdate : 1;
@@ -306,6 +356,8 @@ namespace dmGameObject
     Result SetIdentifier(Collection* collection, HInstance instance, const char* identifier);
     void ReleaseIdentifier(Collection* collection, HInstance instance);
     void UndoNewInstance(Collection* collection, HInstance instance);
+    void SetCollectionPath(Collection* collection, HInstance instance, const HashState64* path_hash_state);
+    void ReleaseCollectionPath(Collection* collection, HInstance instance);
     bool CreateComponents(Collection* collection, HInstance instance);
     void Delete(Collection* collection, HInstance instance, bool recursive);
     void UpdateTransforms(Collection* collection);
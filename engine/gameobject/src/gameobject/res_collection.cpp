@@ -76,7 +76,8 @@ namespace dmGameObject
 
                 instance->m_Transform = dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale);
 
-                dmHashInit64(&instance->m_CollectionPathHashState, true);
+                HashState64 path_hash_state;
+                dmHashInit64(&path_hash_state, true);
                 const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
                 if (path_end == 0x0)
                 {
@@ -84,8 +85,10 @@ namespace dmGameObject
                 }
                 else
                 {
-                    dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
+                    dmHashUpdateBuffer64(&path_hash_state, instance_desc.m_Id, path_end - instance_desc.m_Id + 1);
                 }
+                dmGameObject::SetCollectionPath(collection, instance, &path_hash_state);
+                dmHashRelease64(&path_hash_state);
 
                 if (dmGameObject::SetIdentifier(collection, instance, instance_desc.m_Id) != dmGameObject::RESULT_OK)
                 {
@@ -241,8 +244,11 @@ bail:
     static size_t CalcSize(Collection* collection)
     {
         size_t size = sizeof(Collection) + sizeof(CollectionHandle);
-        size += collection->m_InstanceIndices.Capacity()*sizeof(uint16_t);
+        size += collection->m_InstanceIndices.Capacity()*sizeof(uint32_t);
         size += collection->m_WorldTransforms.Capacity()*sizeof(Matrix4);
+        size += collection->m_PrevLocalTransforms.Capacity()*sizeof(dmTransform::Transform);
+        size += collection->m_TransformFlags.Capacity()*sizeof(uint8_t);
+        size += collection->m_WorldTransformVersions.Capacity()*sizeof(uint32_t);
         size += collection->m_IDToInstance.Capacity()*(sizeof(Instance*)+sizeof(dmhash_t));
         size += collection->m_InputFocusStack.Capacity()*sizeof(Instance*);
         size += collection->m_Instances.Capacity()*sizeof(Instance*);
@@ -300,6 +300,44 @@ TEST_F(CollectionTest, CollectionSpawningToFail)
     ASSERT_TRUE(true);
 }
 
+// More instances than can be addressed with 16-bit indices
+TEST_F(CollectionTest, CollectionLargeCapacity)
+{
+    const uint32_t max = 70000;
+
+    dmGameObject::HCollection coll;
+    coll = dmGameObject::NewCollection("TestCollection", m_Factory, m_Register, max);
+    ASSERT_NE((void*) 0, coll);
+
+    dmGameObject::HInstance parent = dmGameObject::New(coll, 0x0);
+    ASSERT_NE((void*) 0, parent);
+    dmGameObject::SetPosition(parent, Vectormath::Aos::Point3(1.0f, 0.0f, 0.0f));
+
+    dmGameObject::HInstance last = 0;
+    for (uint32_t i = 1; i < max; ++i)
+    {
+        last = dmGameObject::New(coll, 0x0);
+        ASSERT_NE((void*) 0, last);
+        dmGameObject::SetPosition(last, Vectormath::Aos::Point3(0.0f, 1.0f, 0.0f));
+    }
+    ASSERT_EQ((void*) 0, dmGameObject::New(coll, 0x0));
+
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(coll, last, "last"));
+    ASSERT_EQ(last, dmGameObject::GetInstanceFromIdentifier(coll, dmHashString64("last")));
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetParent(last, parent));
+    ASSERT_EQ(parent, dmGameObject::GetParent(last));
+
+    ASSERT_TRUE(dmGameObject::Init(coll));
+    ASSERT_TRUE(dmGameObject::Update(coll, &m_UpdateContext));
+
+    Vectormath::Aos::Point3 world = dmGameObject::GetWorldPosition(last);
+    ASSERT_EQ(1.0f, world.getX());
+    ASSERT_EQ(1.0f, world.getY());
+
+    dmGameObject::DeleteCollection(coll);
+    dmGameObject::PostUpdate(m_Register);
+}
+
 TEST_F(CollectionTest, PostCollection)
 {
     for (int i = 0; i < 10; ++i)
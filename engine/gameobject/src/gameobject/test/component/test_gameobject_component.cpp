@@ -17,6 +17,11 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
+#include <dlib/job_system.h>
+#include <dlib/atomic.h>
+#include <dlib/thread.h>
+#include <dlib/time.h>
+#include <dlib/math.h>
 
 #include <resource/resource.h>
 
@@ -26,12 +31,29 @@
 
 #include "gameobject/test/component/test_gameobject_component_ddf.h"
 
+// Per component type slots for the update state, since the types may be updated on different threads
+enum UpdateSlot
+{
+    UPDATE_SLOT_A,
+    UPDATE_SLOT_B,
+    UPDATE_SLOT_C,
+    UPDATE_SLOT_COUNT
+};
+
 class ComponentTest : public jc_test_base_class
 {
 protected:
     virtual void SetUp()
     {
         m_UpdateCount = 0;
+        m_UpdateOverlapCount = 0;
+        for (uint32_t i = 0; i < UPDATE_SLOT_COUNT; ++i)
+        {
+            m_ComponentUpdateCount[i] = 0;
+            m_ComponentUpdateOrder[i] = 0;
+            m_ComponentUpdateThread[i] = 0;
+            m_ComponentUpdatePeer[i] = -1;
+        }
         m_UpdateContext.m_DT = 1.0f / 60.0f;
 
         dmResource::NewFactoryParams params;
@@ -167,7 +189,7 @@ protected:
     static dmGameObject::ComponentsUpdate       CComponentsUpdate;
 
 public:
-    uint32_t                     m_UpdateCount;
+    int32_atomic_t               m_UpdateCount;
     std::map<uint64_t, uint32_t> m_CreateCountMap;
     std::map<uint64_t, uint32_t> m_DestroyCountMap;
 
@@ -175,11 +197,17 @@ public:
     std::map<uint64_t, uint32_t> m_ComponentInitCountMap;
     std::map<uint64_t, uint32_t> m_ComponentFinalCountMap;
     std::map<uint64_t, uint32_t> m_ComponentDestroyCountMap;
-    std::map<uint64_t, uint32_t> m_ComponentUpdateCountMap;
     std::map<uint64_t, uint32_t> m_ComponentAddToUpdateCountMap;
     std::map<uint64_t, uint32_t> m_MaxComponentCreateCountMap;
 
-    std::map<uint64_t, uint32_t> m_ComponentUpdateOrderMap;
+    // Indexed by UpdateSlot
+    int32_atomic_t               m_ComponentUpdateCount[UPDATE_SLOT_COUNT];
+    uint32_t                     m_ComponentUpdateOrder[UPDATE_SLOT_COUNT];
+    dmThread::Thread             m_ComponentUpdateThread[UPDATE_SLOT_COUNT];
+    // If set, the update waits for this slot to start updating the same frame
+    int32_t                      m_ComponentUpdatePeer[UPDATE_SLOT_COUNT];
+    // Number of updates that ran concurrently with their peer
+    int32_atomic_t               m_UpdateOverlapCount;
 
     std::map<uint64_t, int>      m_ComponentUserDataAcc;
 
@@ -267,12 +295,29 @@ static dmGameObject::CreateResult GenericComponentAddToUpdate(const dmGameObject
     return dmGameObject::CREATE_RESULT_OK;
 }
 
-template <typename T>
+template <typename T, UpdateSlot SLOT>
 static dmGameObject::UpdateResult GenericComponentsUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
 {
     ComponentTest* game_object_test = (ComponentTest*) params.m_Context;
-    game_object_test->m_ComponentUpdateCountMap[T::m_DDFHash]++;
-    game_object_test->m_ComponentUpdateOrderMap[T::m_DDFHash] = game_object_test->m_UpdateCount++;
+    int32_t update_count = dmAtomicIncrement32(&game_object_test->m_ComponentUpdateCount[SLOT]) + 1;
+
+    int32_t peer = game_object_test->m_ComponentUpdatePeer[SLOT];
+    if (peer >= 0)
+    {
+        // Only possible if the peer is updated at the same time on another thread
+        uint64_t timeout = dmTime::GetTime() + 1000000;
+        while (dmAtomicAdd32(&game_object_test->m_ComponentUpdateCount[peer], 0) < update_count && dmTime::GetTime() < timeout)
+        {
+            dmTime::Sleep(100);
+        }
+        if (dmAtomicAdd32(&game_object_test->m_ComponentUpdateCount[peer], 0) >= update_count)
+        {
+            dmAtomicIncrement32(&game_object_test->m_UpdateOverlapCount);
+        }
+    }
+
+    game_object_test->m_ComponentUpdateThread[SLOT] = dmThread::GetCurrentThread();
+    game_object_test->m_ComponentUpdateOrder[SLOT] = (uint32_t) dmAtomicIncrement32(&game_object_test->m_UpdateCount);
     return dmGameObject::UPDATE_RESULT_OK;
 }
 
@@ -297,7 +342,7 @@ dmGameObject::ComponentInit ComponentTest::AComponentInit               = Generi
 dmGameObject::ComponentFinal ComponentTest::AComponentFinal             = GenericComponentFinal<TestGameObjectDDF::AResource>;
 dmGameObject::ComponentDestroy ComponentTest::AComponentDestroy         = GenericComponentDestroy<TestGameObjectDDF::AResource>;
 dmGameObject::ComponentAddToUpdate ComponentTest::AComponentAddToUpdate = GenericComponentAddToUpdate<TestGameObjectDDF::AResource>;
-dmGameObject::ComponentsUpdate ComponentTest::AComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::AResource>;
+dmGameObject::ComponentsUpdate ComponentTest::AComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::AResource, UPDATE_SLOT_A>;
 
 dmResource::FResourceCreate ComponentTest::BCreate                      = GenericDDFCreate<TestGameObjectDDF::BResource>;
 dmResource::FResourceDestroy ComponentTest::BDestroy                    = GenericDDFDestory<TestGameObjectDDF::BResource>;
@@ -306,7 +351,7 @@ dmGameObject::ComponentInit ComponentTest::BComponentInit               = Generi
 dmGameObject::ComponentFinal ComponentTest::BComponentFinal             = GenericComponentFinal<TestGameObjectDDF::BResource>;
 dmGameObject::ComponentDestroy ComponentTest::BComponentDestroy         = GenericComponentDestroy<TestGameObjectDDF::BResource>;
 dmGameObject::ComponentAddToUpdate ComponentTest::BComponentAddToUpdate = GenericComponentAddToUpdate<TestGameObjectDDF::BResource>;
-dmGameObject::ComponentsUpdate ComponentTest::BComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::BResource>;
+dmGameObject::ComponentsUpdate ComponentTest::BComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::BResource, UPDATE_SLOT_B>;
 
 dmResource::FResourceCreate ComponentTest::CCreate                      = GenericDDFCreate<TestGameObjectDDF::CResource>;
 dmResource::FResourceDestroy ComponentTest::CDestroy                    = GenericDDFDestory<TestGameObjectDDF::CResource>;
@@ -315,7 +360,7 @@ dmGameObject::ComponentInit ComponentTest::CComponentInit               = Generi
 dmGameObject::ComponentFinal ComponentTest::CComponentFinal             = GenericComponentFinal<TestGameObjectDDF::CResource>;
 dmGameObject::ComponentDestroy ComponentTest::CComponentDestroy         = GenericComponentDestroy<TestGameObjectDDF::CResource>;
 dmGameObject::ComponentAddToUpdate ComponentTest::CComponentAddToUpdate = GenericComponentAddToUpdate<TestGameObjectDDF::CResource>;
-dmGameObject::ComponentsUpdate ComponentTest::CComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::CResource>;
+dmGameObject::ComponentsUpdate ComponentTest::CComponentsUpdate         = GenericComponentsUpdate<TestGameObjectDDF::CResource, UPDATE_SLOT_C>;
 
 TEST_F(ComponentTest, TestUpdate)
 {
@@ -335,7 +380,7 @@ TEST_F(ComponentTest, TestUpdate)
     ASSERT_EQ((uint32_t) 1, m_ComponentCreateCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
     ASSERT_EQ((uint32_t) 1, m_ComponentInitCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
     ASSERT_EQ((uint32_t) 1, m_ComponentAddToUpdateCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
-    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
+    ASSERT_EQ(1, m_ComponentUpdateCount[UPDATE_SLOT_A]);
     ASSERT_EQ((uint32_t) 1, m_ComponentFinalCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
     ASSERT_EQ((uint32_t) 1, m_ComponentDestroyCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
 }
@@ -422,12 +467,66 @@ TEST_F(ComponentTest, TestUpdateOrder)
     ASSERT_NE((void*) 0, (void*) go);
     bool ret = dmGameObject::Update(m_Collection, &m_UpdateContext);
     ASSERT_TRUE(ret);
-    ASSERT_EQ((uint32_t) 2, m_ComponentUpdateOrderMap[TestGameObjectDDF::AResource::m_DDFHash]);
-    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateOrderMap[TestGameObjectDDF::BResource::m_DDFHash]);
-    ASSERT_EQ((uint32_t) 0, m_ComponentUpdateOrderMap[TestGameObjectDDF::CResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 2, m_ComponentUpdateOrder[UPDATE_SLOT_A]);
+    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateOrder[UPDATE_SLOT_B]);
+    ASSERT_EQ((uint32_t) 0, m_ComponentUpdateOrder[UPDATE_SLOT_C]);
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+TEST_F(ComponentTest, TestParallelUpdate)
+{
+    dmJobSystem::NewContextParams job_params;
+    job_params.m_WorkerCount = 2;
+    dmJobSystem::HContext job_context = dmJobSystem::NewContext(job_params);
+    dmGameObject::SetJobContext(m_Register, job_context);
+
+    // A and B are adjacent in update order and are updated as one group
+    const char* parallel_types[] = {"a", "b"};
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(parallel_types); ++i)
+    {
+        dmResource::ResourceType resource_type;
+        ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, parallel_types[i], &resource_type));
+        uint32_t component_index;
+        dmGameObject::ComponentType* type = dmGameObject::FindComponentType(m_Register, resource_type, &component_index);
+        ASSERT_NE((void*) 0, (void*) type);
+        dmGameObject::ComponentTypeSetParallelUpdate(type, true);
+    }
+
+    // A and B each wait for the other to start, which only succeeds if they really run concurrently
+    m_ComponentUpdatePeer[UPDATE_SLOT_A] = UPDATE_SLOT_B;
+    m_ComponentUpdatePeer[UPDATE_SLOT_B] = UPDATE_SLOT_A;
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go1.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    const int32_t frame_count = 10;
+    for (int32_t i = 0; i < frame_count; ++i)
+    {
+        uint32_t prev_group_order = dmMath::Max(m_ComponentUpdateOrder[UPDATE_SLOT_A], m_ComponentUpdateOrder[UPDATE_SLOT_B]);
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        dmJobSystem::NewFrame(job_context);
+
+        // The whole group has finished when Update returns
+        ASSERT_EQ(i + 1, m_ComponentUpdateCount[UPDATE_SLOT_A]);
+        ASSERT_EQ(i + 1, m_ComponentUpdateCount[UPDATE_SLOT_B]);
+        ASSERT_EQ(i + 1, m_ComponentUpdateCount[UPDATE_SLOT_C]);
+
+        // The serial type C is still updated before the group, and after the previous frame's group
+        ASSERT_LT(m_ComponentUpdateOrder[UPDATE_SLOT_C], m_ComponentUpdateOrder[UPDATE_SLOT_A]);
+        ASSERT_LT(m_ComponentUpdateOrder[UPDATE_SLOT_C], m_ComponentUpdateOrder[UPDATE_SLOT_B]);
+        if (i > 0)
+        {
+            ASSERT_GT(m_ComponentUpdateOrder[UPDATE_SLOT_C], prev_group_order);
+        }
+
+        ASSERT_NE(m_ComponentUpdateThread[UPDATE_SLOT_A], m_ComponentUpdateThread[UPDATE_SLOT_B]);
+    }
+    ASSERT_EQ(2 * frame_count, m_UpdateOverlapCount);
+    dmGameObject::Delete(m_Collection, go, false);
+
+    dmGameObject::SetJobContext(m_Register, 0);
+    dmJobSystem::DeleteContext(job_context);
+}
+
 TEST_F(ComponentTest, TestDuplicatedIds)
 {
     dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go6.goc");
@@ -679,6 +679,65 @@ TEST_F(HierarchyTest, TestHierarchyInheritScale)
     dmGameObject::Delete(m_Collection, parent, false);
 }
 
+// Many children under a single parent, to get a level that is large enough to be split over the job system
+TEST_F(HierarchyTest, TestHierarchyLargeLevel)
+{
+    dmJobSystem::NewContextParams job_params;
+    job_params.m_WorkerCount = 3;
+    dmJobSystem::HContext job_context = dmJobSystem::NewContext(job_params);
+    dmGameObject::SetJobContext(m_Register, job_context);
+
+    const uint32_t child_count = 3000;
+    dmGameObject::HCollection collection = dmGameObject::NewCollection("large_collection", m_Factory, m_Register, child_count + 2);
+    dmGameObject::HInstance parent = dmGameObject::New(collection, "/go.goc");
+    dmGameObject::HInstance static_root = dmGameObject::New(collection, "/go.goc");
+    dmGameObject::SetPosition(static_root, Point3(5.0f, 0.0f, 0.0f));
+    dmGameObject::HInstance* children = new dmGameObject::HInstance[child_count];
+    for (uint32_t i = 0; i < child_count; ++i)
+    {
+        children[i] = dmGameObject::New(collection, "/go.goc");
+        ASSERT_NE((void*) 0, children[i]);
+        dmGameObject::SetPosition(children[i], Point3((float) i, 0.0f, 0.0f));
+        dmGameObject::SetParent(children[i], parent);
+    }
+
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        // Only the parent moves, the children must follow even though their local transforms are unchanged
+        dmGameObject::SetPosition(parent, Point3(0.0f, (float) frame, 0.0f));
+        ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+        for (uint32_t i = 0; i < child_count; ++i)
+        {
+            Point3 p = dmGameObject::GetWorldPosition(children[i]);
+            ASSERT_NEAR((float) i, p.getX(), EPSILON);
+            ASSERT_NEAR((float) frame, p.getY(), EPSILON);
+        }
+        ASSERT_NEAR(5.0f, dmGameObject::GetWorldPosition(static_root).getX(), EPSILON);
+        dmJobSystem::NewFrame(job_context);
+    }
+
+    // Only a single child moves
+    dmGameObject::SetPosition(children[10], Point3(10.0f, 0.0f, 1.0f));
+    ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+    ASSERT_NEAR(1.0f, dmGameObject::GetWorldPosition(children[10]).getZ(), EPSILON);
+    ASSERT_NEAR(0.0f, dmGameObject::GetWorldPosition(children[11]).getZ(), EPSILON);
+    dmJobSystem::NewFrame(job_context);
+
+    // Reparent a child under the static root, with an unchanged local transform
+    dmGameObject::SetParent(children[20], static_root);
+    ASSERT_TRUE(dmGameObject::Update(collection, &m_UpdateContext));
+    ASSERT_NEAR(25.0f, dmGameObject::GetWorldPosition(children[20]).getX(), EPSILON);
+    ASSERT_NEAR(0.0f, dmGameObject::GetWorldPosition(children[20]).getY(), EPSILON);
+    dmJobSystem::NewFrame(job_context);
+
+    delete [] children;
+    dmGameObject::DeleteCollection(collection);
+    dmGameObject::PostUpdate(m_Register);
+
+    dmGameObject::SetJobContext(m_Register, 0);
+    dmJobSystem::DeleteContext(job_context);
+}
+
 // Test depth-first order
 TEST_F(HierarchyTest, TestHierarchyBonesOrder)
 {
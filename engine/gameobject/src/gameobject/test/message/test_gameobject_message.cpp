@@ -17,8 +17,10 @@
 #include <stdint.h>
 #include <map>
 
+#include <dlib/dstrings.h>
 #include <dlib/hash.h>
 #include <dlib/message.h>
+#include <dlib/sys.h>
 
 #include <dlib/log.h>
 #include "../gameobject.h"
@@ -38,7 +40,7 @@ protected:
 
         dmResource::NewFactoryParams params;
         params.m_MaxResources = 16;
-        params.m_Flags = RESOURCE_FACTORY_FLAGS_EMPTY;
+        params.m_Flags = RESOURCE_FACTORY_FLAGS_RELOAD_SUPPORT;
         m_Factory = dmResource::NewFactory(&params, "build/default/src/gameobject/test/message");
         m_ScriptContext = dmScript::NewContext(0, 0, true);
         dmScript::Initialize(m_ScriptContext);
@@ -303,6 +305,92 @@ TEST_F(MessageTest, TestComponentMessageFail)
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+// Resolved receivers are cached by the collection, make sure they don't outlive the instance
+TEST_F(MessageTest, TestComponentMessageDeletedReceiver)
+{
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_message.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+
+    dmhash_t message_id = dmHashString64("inc");
+    dmMessage::URL receiver;
+    receiver.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    receiver.m_Path = dmGameObject::GetIdentifier(go);
+    receiver.m_Fragment = dmHashString64("mt");
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(1U, m_MessageTargetCounter);
+
+    dmGameObject::Delete(m_Collection, go, false);
+    dmGameObject::PostUpdate(m_Collection);
+
+    // Same identifier, but without the "mt" component
+    go = dmGameObject::New(m_Collection, "/test_onmessage.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_FALSE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(1U, m_MessageTargetCounter);
+
+    dmGameObject::Delete(m_Collection, go, false);
+}
+
+static void CreatePrototypeFile(const char* file_name, dmGameObjectDDF::ComponentDesc* components, uint32_t component_count)
+{
+    dmGameObjectDDF::PrototypeDesc prototype;
+    memset(&prototype, 0, sizeof(prototype));
+    prototype.m_Components.m_Data = components;
+    prototype.m_Components.m_Count = component_count;
+    dmDDF::Result r = dmDDF::SaveMessageToFile(&prototype, dmGameObjectDDF::PrototypeDesc::m_DDFDescriptor, file_name);
+    assert(r == dmDDF::RESULT_OK);
+    (void)r;
+}
+
+TEST_F(MessageTest, TestComponentMessageReloadedReceiver)
+{
+    const char* go_resource_name = "/__reload_receiver__.goc";
+    char go_file_name[512];
+    dmSnPrintf(go_file_name, sizeof(go_file_name), "build/default/src/gameobject/test/message%s", go_resource_name);
+
+    dmGameObjectDDF::ComponentDesc components[2];
+    memset(components, 0, sizeof(components));
+    components[0].m_Id = "script";
+    components[0].m_Component = "/test_onmessage.scriptc";
+    components[1].m_Id = "mt";
+    components[1].m_Component = "/message_target.mt";
+    CreatePrototypeFile(go_file_name, components, 2);
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, go_resource_name);
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmhash_t message_id = dmHashString64("inc");
+    dmMessage::URL receiver;
+    receiver.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    receiver.m_Path = dmGameObject::GetIdentifier(go);
+    receiver.m_Fragment = dmHashString64("mt");
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    ASSERT_EQ(1U, m_MessageTargetCounter);
+
+    // The instance is recreated in the same slot with the same identifier, but without the "mt" component
+    CreatePrototypeFile(go_file_name, components, 1);
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::ReloadResource(m_Factory, go_resource_name, 0));
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_FALSE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(1U, m_MessageTargetCounter);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmGameObject::Delete(m_Collection, dmGameObject::GetInstanceFromIdentifier(m_Collection, receiver.m_Path), false);
+    dmSys::Unlink(go_file_name);
+}
+
 TEST_F(MessageTest, TestBroadcastDDFMessage)
 {
     dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_broadcast_message.goc");
@@ -12,7 +12,7 @@
 
 #include <jc_test/jc_test.h>
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
 
@@ -22,7 +22,7 @@
 #include <dlib/log.h>
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include "../gamesys.h"
 #include "../gamesys_private.h"
@@ -15,7 +15,7 @@
 
 #include <string.h>
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/log.h>
 #include <dlib/hash.h>
@@ -91,6 +91,9 @@ namespace dmGameSystem
         /// Linked list of joints TO this component.
         JointEndPoint* m_JointEndPoints;
 
+        /// World transform version of the game object when the transform was last passed to the 2D physics
+        uint32_t m_WorldTransformVersion;
+
         uint16_t m_Mask;
         uint16_t m_ComponentIndex;
         // True if the physics is 3D
@@ -166,6 +169,8 @@ namespace dmGameSystem
         dmPhysics::NewWorldParams world_params;
         world_params.m_GetWorldTransformCallback = GetWorldTransform;
         world_params.m_SetWorldTransformCallback = SetWorldTransform;
+        // Only the collision objects of game objects that have moved are passed to the 2D physics, see CompCollisionObjectUpdate
+        world_params.m_TrackTransformChanges = 1;
 
         dmPhysics::HWorld2D world2D;
         dmPhysics::HWorld3D world3D;
@@ -423,6 +428,7 @@ namespace dmGameSystem
         component->m_JointEndPoints = 0x0;
         component->m_FlippedX = 0;
         component->m_FlippedY = 0;
+        component->m_WorldTransformVersion = 0;
 
         CollisionWorld* world = (CollisionWorld*)params.m_World;
         if (!CreateCollisionObject(physics_context, world, params.m_Instance, component, false))
@@ -947,6 +953,17 @@ namespace dmGameSystem
         }
         else
         {
+            uint32_t num_components = world->m_Components.Size();
+            for (uint32_t i = 0; i < num_components; ++i)
+            {
+                CollisionComponent* c = world->m_Components[i];
+                uint32_t version = dmGameObject::GetWorldTransformVersion(c->m_Instance);
+                if (version != c->m_WorldTransformVersion)
+                {
+                    c->m_WorldTransformVersion = version;
+                    dmPhysics::SetWorldTransformChanged2D(world->m_World2D, c->m_Object2D);
+                }
+            }
             dmPhysics::StepWorld2D(world->m_World2D, step_world_context);
         }
 
@@ -1264,6 +1281,19 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, uint32_t request_count, dmPhysics::RayCastResponse* responses)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, request_count, responses);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, request_count, responses);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
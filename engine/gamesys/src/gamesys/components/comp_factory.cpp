@@ -20,7 +20,7 @@
 #include <dlib/index_pool.h>
 #include <dlib/log.h>
 #include <gameobject/gameobject.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include "../resources/res_factory.h"
 
 #include "../gamesys.h"
@@ -1692,12 +1692,6 @@ namespace dmGameSystem
                     break;
             }
         }
-
-        dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
-                                        gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
-                                        gui_world->m_ClientVertexBuffer.Begin(),
-                                        dmGraphics::BUFFER_USAGE_STREAM_DRAW);
-        DM_COUNTER("Gui.VertexCount", gui_world->m_ClientVertexBuffer.Size());
     }
 
     static dmGraphics::TextureFormat ToGraphicsFormat(dmImage::Type type) {
@@ -1925,6 +1919,13 @@ namespace dmGameSystem
             dmRender::RenderListSubmit(gui_context->m_RenderContext, render_list, write_ptr);
         }
 
+        // The vertices of all scenes share one buffer, so it is uploaded once after all scenes have been rendered
+        dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
+                                        gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
+                                        gui_world->m_ClientVertexBuffer.Begin(),
+                                        dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        DM_COUNTER("Gui.VertexCount", gui_world->m_ClientVertexBuffer.Size());
+
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -21,7 +21,7 @@
 #include <dlib/dstrings.h>
 #include <render/render.h>
 #include <gameobject/gameobject.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmGameSystem
 {
@@ -82,6 +82,8 @@ namespace dmGameSystem
         dmArray<dmRig::RigModelVertex>* m_VertexBufferData;
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance> m_ScratchInstances;
+        // Temporary scratch array for the rig instances of a render batch
+        dmArray<dmRig::RigInstanceVertexData> m_ScratchRigInstances;
         dmRig::HRigContext              m_RigContext;
         uint32_t                        m_MaxElementsVertices;
         uint32_t                        m_VertexBufferSwapChainIndex;
@@ -115,9 +117,11 @@ namespace dmGameSystem
             dmLogFatal("Unable to create model rig context: %d", rr);
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        dmRig::SetJobContext(world->m_RigContext, context->m_JobContext);
 
         world->m_Components.SetCapacity(context->m_MaxModelCount);
         world->m_RenderObjects.SetCapacity(context->m_MaxModelCount);
+        world->m_ScratchRigInstances.SetCapacity(context->m_MaxModelCount);
 
         dmGraphics::VertexElement ve[] =
         {
@@ -530,16 +534,20 @@ namespace dmGameSystem
         dmGraphics::HVertexBuffer& gfx_vertex_buffer = world->m_VertexBuffers[batchIndex];
 
         // Fill in vertex buffer
-        dmRig::RigModelVertex *vb_begin = vertex_buffer.End();
-        dmRig::RigModelVertex *vb_end = vb_begin;
+        dmArray<dmRig::RigInstanceVertexData>& rig_instances = world->m_ScratchRigInstances;
+        rig_instances.SetSize(0);
         for (uint32_t *i=begin;i!=end;i++)
         {
             const ModelComponent* c = (ModelComponent*) buf[*i].m_UserData;
-            dmRig::HRigContext rig_context = world->m_RigContext;
-            Matrix4 normal_matrix = inverse(c->m_World);
-            normal_matrix = transpose(normal_matrix);
-            vb_end = (dmRig::RigModelVertex *)dmRig::GenerateVertexData(rig_context, c->m_RigInstance, c->m_World, normal_matrix, Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)vb_end);
+            dmRig::RigInstanceVertexData item;
+            item.m_Instance = c->m_RigInstance;
+            item.m_ModelMatrix = c->m_World;
+            item.m_NormalMatrix = transpose(inverse(c->m_World));
+            item.m_Color = Vector4(1.0);
+            rig_instances.Push(item);
         }
+        dmRig::RigModelVertex *vb_begin = vertex_buffer.End();
+        dmRig::RigModelVertex *vb_end = (dmRig::RigModelVertex *)dmRig::GenerateVertexData(world->m_RigContext, rig_instances.Begin(), rig_instances.Size(), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)vb_begin);
         vertex_buffer.SetSize(vb_end - vertex_buffer.Begin());
 
         // Ninja in-place writing of render object.
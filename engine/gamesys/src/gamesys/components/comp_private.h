@@ -17,7 +17,7 @@
 #include <dlib/math.h>
 #include <gameobject/gameobject.h>
 #include <render/render.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include <dmsdk/gamesys/render_constants.h>
 #include <dmsdk/gamesys/property.h>
 
@@ -18,6 +18,7 @@
 #include <dlib/index_pool.h>
 #include <dlib/log.h>
 #include <dlib/hash.h>
+#include <dlib/math.h>
 #include <dlib/object_pool.h>
 #include <sound/sound.h>
 
@@ -245,6 +246,7 @@ namespace dmGameSystem
      * @param [delay] [type:number] delay in seconds before the sound starts playing, default is 0.
      * @param [gain] [type:number] sound gain between 0 and 1, default is 1.
      * @param [play_id] [type:number] the identifier of the sound, can be used to distinguish between consecutive plays from the same component.
+     * @param [priority] [type:number] sound priority between 0 and 255, default is 0. When more sounds play than `sound.max_voices`, the sounds with the highest priority are mixed first.
      * @examples
      *
      * Assuming the script belongs to an instance with a sound-component with id "sound", this will make the component play its sound after 1 second:
@@ -391,6 +393,7 @@ namespace dmGameSystem
                     dmSound::SetParameter(entry.m_SoundInstance, dmSound::PARAMETER_GAIN, Vectormath::Aos::Vector4(gain, 0, 0, 0));
                     dmSound::SetParameter(entry.m_SoundInstance, dmSound::PARAMETER_PAN, Vectormath::Aos::Vector4(pan, 0, 0, 0));
                     dmSound::SetParameter(entry.m_SoundInstance, dmSound::PARAMETER_SPEED, Vectormath::Aos::Vector4(speed, 0, 0, 0));
+                    dmSound::SetPriority(entry.m_SoundInstance, (uint8_t) dmMath::Min(play_sound->m_Priority, 255u));
                     dmSound::SetLooping(entry.m_SoundInstance, sound->m_Looping, (sound->m_Looping && !sound->m_Loopcount) ? -1 : sound->m_Loopcount ); // loopcounter semantics differ a bit from loopcount. If -1, it means loopforever, otherwise it contains the # of loops remaining.
 
                     entry.m_Listener = params.m_Message->m_Sender;
@@ -67,6 +67,7 @@ namespace dmGameSystem
         dmResource::HFactory        m_Factory;
         dmRender::HRenderContext    m_RenderContext;
         dmGraphics::HContext        m_GraphicsContext;
+        dmJobSystem::HContext       m_JobContext;
         uint32_t                    m_MaxSpineModelCount;
     };
 
@@ -101,9 +102,11 @@ namespace dmGameSystem
             dmLogFatal("Unable to create spine rig context: %d", rr);
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        dmRig::SetJobContext(world->m_RigContext, context->m_JobContext);
 
         world->m_Components.SetCapacity(context->m_MaxSpineModelCount);
         world->m_RenderObjects.SetCapacity(context->m_MaxSpineModelCount);
+        world->m_ScratchRigInstances.SetCapacity(context->m_MaxSpineModelCount);
 
         dmGraphics::VertexElement ve[] =
         {
@@ -464,14 +467,20 @@ namespace dmGameSystem
             vertex_buffer.OffsetCapacity(vertex_count - vertex_buffer.Remaining());
 
         // Fill in vertex buffer
-        dmRig::RigSpineModelVertex *vb_begin = vertex_buffer.End();
-        dmRig::RigSpineModelVertex *vb_end = vb_begin;
-        dmRig::HRigContext rig_context = world->m_RigContext;
+        dmArray<dmRig::RigInstanceVertexData>& rig_instances = world->m_ScratchRigInstances;
+        rig_instances.SetSize(0);
         for (uint32_t *i=begin;i!=end;i++)
         {
             const SpineModelComponent* c = (SpineModelComponent*) buf[*i].m_UserData;
-            vb_end = (dmRig::RigSpineModelVertex*)dmRig::GenerateVertexData(rig_context, c->m_RigInstance, c->m_World, Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_SPINE, (void*)vb_end);
+            dmRig::RigInstanceVertexData item;
+            item.m_Instance = c->m_RigInstance;
+            item.m_ModelMatrix = c->m_World;
+            item.m_NormalMatrix = Matrix4::identity();
+            item.m_Color = Vector4(1.0);
+            rig_instances.Push(item);
         }
+        dmRig::RigSpineModelVertex *vb_begin = vertex_buffer.End();
+        dmRig::RigSpineModelVertex *vb_end = (dmRig::RigSpineModelVertex*)dmRig::GenerateVertexData(world->m_RigContext, rig_instances.Begin(), rig_instances.Size(), dmRig::RIG_VERTEX_FORMAT_SPINE, (void*)vb_begin);
         vertex_buffer.SetSize(vb_end - vertex_buffer.Begin());
 
         // Ninja in-place writing of render object.
@@ -973,6 +982,8 @@ namespace dmGameSystem
         spinemodelctx->m_Factory = ctx->m_Factory;
         spinemodelctx->m_GraphicsContext = *(dmGraphics::HContext*)ctx->m_Contexts.Get(dmHashString64("graphics"));
         spinemodelctx->m_RenderContext = *(dmRender::HRenderContext*)ctx->m_Contexts.Get(dmHashString64("render"));
+        dmJobSystem::HContext* job_context = (dmJobSystem::HContext*)ctx->m_Contexts.Get(dmHashString64("job_system"));
+        spinemodelctx->m_JobContext = job_context ? *job_context : 0x0;
 
         int32_t max_rig_instance = max_rig_instance = dmConfigFile::GetInt(ctx->m_Config, "rig.max_instance_count", 128);
         spinemodelctx->m_MaxSpineModelCount = dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.max_count", 128), max_rig_instance);
@@ -983,6 +994,7 @@ namespace dmGameSystem
         ComponentTypeSetContext(type, spinemodelctx);
         ComponentTypeSetHasUserData(type, true);
         ComponentTypeSetReadsTransforms(type, false);
+        ComponentTypeSetWritesTransforms(type, true);
 
         ComponentTypeSetNewWorldFn(type, CompSpineModelNewWorld);
         ComponentTypeSetDeleteWorldFn(type, CompSpineModelDeleteWorld);
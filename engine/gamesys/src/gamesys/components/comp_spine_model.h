@@ -86,6 +86,8 @@ namespace dmGameSystem
         dmArray<dmRig::RigSpineModelVertex> m_VertexBufferData;
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance>    m_ScratchInstances;
+        // Temporary scratch array for the rig instances of a render batch
+        dmArray<dmRig::RigInstanceVertexData> m_ScratchRigInstances;
         dmRig::HRigContext                  m_RigContext;
     };
 
@@ -47,6 +47,8 @@ namespace dmGameSystem
         Vector3                     m_Scale;
         Vector3                     m_Size;     // The current size of the animation frame (in texels)
         Matrix4                     m_World;
+        // World transform version of m_Instance when m_World was last calculated
+        uint32_t                    m_WorldTransformVersion;
         // Hash of the m_Resource-pointer. Hash is used to be compatible with 64-bit arch as a 32-bit value is used for sorting
         // See GenerateKeys
         uint32_t                    m_MixedHash;
@@ -75,7 +77,8 @@ namespace dmGameSystem
         uint16_t                    m_FlipVertical : 1;
         uint16_t                    m_AddedToUpdate : 1;
         uint16_t                    m_ReHash : 1;
-        uint16_t                    m_Padding : 7;
+        uint16_t                    m_DirtyTransform : 1; // Set when m_Size or m_Scale changed
+        uint16_t                    m_Padding : 6;
     };
 
     struct SpriteVertex
@@ -272,6 +275,7 @@ namespace dmGameSystem
         if (frame != frame_current)
         {
             component->m_Size = GetSize(component, texture_set_ddf, component->m_AnimationID);
+            component->m_DirtyTransform = 1;
         }
     }
 
@@ -293,6 +297,7 @@ namespace dmGameSystem
             component->m_AnimBackwards = animation->m_Playback == dmGameSystemDDF::PLAYBACK_ONCE_BACKWARD || animation->m_Playback == dmGameSystemDDF::PLAYBACK_LOOP_BACKWARD;
             component->m_Playing = animation->m_Playback != dmGameSystemDDF::PLAYBACK_NONE;
             component->m_Size = GetSize(component, texture_set->m_TextureSet, component->m_AnimationID);
+            component->m_DirtyTransform = 1;
 
             offset = dmMath::Clamp(offset, 0.0f, 1.0f);
             if (animation->m_Playback == dmGameSystemDDF::PLAYBACK_ONCE_BACKWARD || animation->m_Playback == dmGameSystemDDF::PLAYBACK_LOOP_BACKWARD) {
@@ -359,6 +364,7 @@ namespace dmGameSystem
         component->m_FunctionRef = 0;
 
         component->m_ReHash = 1;
+        component->m_DirtyTransform = 1;
 
         component->m_Size = Vector3(0.0f, 0.0f, 0.0f);
         component->m_AnimationID = 0;
@@ -513,30 +519,37 @@ namespace dmGameSystem
 
                 const int* tex_lookup = &tex_coord_order[flip_flag * 6];
 
+                // The corners are (+-0.5, +-0.5, 0) in sprite space, so instead of four full matrix-point
+                // transforms, each corner is the translation plus/minus the two half axes.
                 const Matrix4& w = component->m_World;
+                const Vector4 half_x = w.getCol0() * 0.5f;
+                const Vector4 half_y = w.getCol1() * 0.5f;
+                const Vector4 center = w.getCol3();
+                const Vector4 left = center - half_x;
+                const Vector4 right = center + half_x;
 
-                Vector4 p0 = w * Point3(-0.5f, -0.5f, 0.0f);
+                Vector4 p0 = left - half_y;
                 vertices[0].x = p0.getX();
                 vertices[0].y = p0.getY();
                 vertices[0].z = p0.getZ();
                 vertices[0].u = tc[tex_lookup[0] * 2];
                 vertices[0].v = tc[tex_lookup[0] * 2 + 1];
 
-                Vector4 p1 = w * Point3(-0.5f, 0.5f, 0.0f);
+                Vector4 p1 = left + half_y;
                 vertices[1].x = p1.getX();
                 vertices[1].y = p1.getY();
                 vertices[1].z = p1.getZ();
                 vertices[1].u = tc[tex_lookup[1] * 2];
                 vertices[1].v = tc[tex_lookup[1] * 2 + 1];
 
-                Vector4 p2 = w * Point3(0.5f, 0.5f, 0.0f);
+                Vector4 p2 = right + half_y;
                 vertices[2].x = p2.getX();
                 vertices[2].y = p2.getY();
                 vertices[2].z = p2.getZ();
                 vertices[2].u = tc[tex_lookup[2] * 2];
                 vertices[2].v = tc[tex_lookup[2] * 2 + 1];
 
-                Vector4 p3 = w * Point3(0.5f, -0.5f, 0.0f);
+                Vector4 p3 = right - half_y;
                 vertices[3].x = p3.getX();
                 vertices[3].y = p3.getY();
                 vertices[3].z = p3.getZ();
@@ -638,6 +651,31 @@ namespace dmGameSystem
         dmRender::AddToRender(render_context, &ro);
     }
 
+    static inline bool IsTransformDirty(SpriteComponent* c)
+    {
+        return c->m_DirtyTransform || c->m_WorldTransformVersion != dmGameObject::GetWorldTransformVersion(c->m_Instance);
+    }
+
+    static inline void UpdateTransform(SpriteComponent* c, bool scale_along_z, bool sub_pixels)
+    {
+        Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
+        Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
+        Matrix4 w = scale_along_z ? world * local : dmTransform::MulNoScaleZ(world, local);
+        Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
+        c->m_World = appendScale(w, size);
+
+        // The "sub_pixels" is set by default
+        if (!sub_pixels) {
+            Vector4 position = c->m_World.getCol3();
+            position.setX((int) position.getX());
+            position.setY((int) position.getY());
+            c->m_World.setCol3(position);
+        }
+
+        c->m_WorldTransformVersion = dmGameObject::GetWorldTransformVersion(c->m_Instance);
+        c->m_DirtyTransform = 0;
+    }
+
     static void UpdateTransforms(SpriteWorld* sprite_world, bool sub_pixels)
     {
         DM_PROFILE(Sprite, "UpdateTransforms");
@@ -651,40 +689,19 @@ namespace dmGameSystem
             scale_along_z = dmGameObject::ScaleAlongZ(dmGameObject::GetCollection(c->m_Instance));
         }
 
-        // Note: We update all sprites, even though they might be disabled, or not added to update
-
-        if (scale_along_z) {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = appendScale(world * local, size);
-            }
-        } else
+        // Only sprites that will be rendered, and that moved or changed size or scale since their last update, are recalculated.
+        // A sprite that is disabled keeps its dirty flag and is caught up by the version check once enabled again.
+        uint32_t updated = 0;
+        for (uint32_t i = 0; i < n; ++i)
         {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Matrix4 w = dmTransform::MulNoScaleZ(world, local);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = appendScale(w, size);
-            }
+            SpriteComponent* c = &components[i];
+            if (!c->m_Enabled || !c->m_AddedToUpdate || !IsTransformDirty(c))
+                continue;
+            UpdateTransform(c, scale_along_z, sub_pixels);
+            ++updated;
         }
 
-        // The "sub_pixels" is set by default
-        if (!sub_pixels) {
-            for (uint32_t i = 0; i < n; ++i) {
-                SpriteComponent* c = &components[i];
-                Vector4 position = c->m_World.getCol3();
-                position.setX((int) position.getX());
-                position.setY((int) position.getY());
-                c->m_World.setCol3(position);
-            }
-        }
+        DM_COUNTER("Sprite.TransformUpdates", updated);
     }
 
     static bool GetSender(SpriteComponent* component, dmMessage::URL* out_sender)
@@ -931,6 +948,9 @@ namespace dmGameSystem
 
             const Vector4 trans = component.m_World.getCol(3);
             write_ptr->m_WorldPosition = Point3(trans.getX(), trans.getY(), trans.getZ());
+            // The quad spans [-0.5, 0.5] in the (sized) local space
+            write_ptr->m_HasBounds = 1;
+            write_ptr->m_BoundingRadius = 0.5f * (length(component.m_World.getCol0().getXYZ()) + length(component.m_World.getCol1().getXYZ()));
             write_ptr->m_UserData = (uintptr_t) &component;
             write_ptr->m_BatchKey = component.m_MixedHash;
             write_ptr->m_TagListKey = dmRender::GetMaterialTagListKey(GetMaterial(&component, component.m_Resource));
@@ -1062,6 +1082,7 @@ namespace dmGameSystem
             {
                 dmGameSystemDDF::SetScale* ddf = (dmGameSystemDDF::SetScale*)params.m_Message->m_Data;
                 component->m_Scale = ddf->m_Scale;
+                component->m_DirtyTransform = 1;
             }
         }
 
@@ -1123,10 +1144,12 @@ namespace dmGameSystem
 
         if (IsReferencingProperty(SPRITE_PROP_SCALE, set_property))
         {
+            component->m_DirtyTransform = 1;
             return SetProperty(set_property, params.m_Value, component->m_Scale, SPRITE_PROP_SCALE);
         }
         else if (IsReferencingProperty(SPRITE_PROP_SIZE, set_property))
         {
+            component->m_DirtyTransform = 1;
             return SetProperty(set_property, params.m_Value, component->m_Size, SPRITE_PROP_SIZE);
         }
         else if (params.m_PropertyId == SPRITE_PROP_CURSOR)
@@ -26,7 +26,7 @@
 #include <render/render.h>
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <gamesys/tile_ddf.h>
 #include "../gamesys.h"
@@ -776,9 +776,19 @@ namespace dmGameSystem
                             continue;
                         }
 
-                        Vector4 trans = component->m_World * Point3(x * tile_width, y * tile_height, layer_ddf->m_Z);
+                        // Cull against the region bounds, centered in the region
+                        int32_t min_x = resource->m_MinCellX + x * TILEGRID_REGION_SIZE;
+                        int32_t min_y = resource->m_MinCellY + y * TILEGRID_REGION_SIZE;
+                        int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)resource->m_ColumnCount);
+                        int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)resource->m_RowCount);
+                        float half_width = (max_x - min_x) * (float)tile_width * 0.5f;
+                        float half_height = (max_y - min_y) * (float)tile_height * 0.5f;
+
+                        Vector4 trans = component->m_World * Point3(min_x * (float)tile_width + half_width, min_y * (float)tile_height + half_height, layer_ddf->m_Z);
 
                         write_ptr->m_WorldPosition = Point3(trans.getXYZ());
+                        write_ptr->m_HasBounds = 1;
+                        write_ptr->m_BoundingRadius = length(component->m_World.getCol0().getXYZ()) * half_width + length(component->m_World.getCol1().getXYZ()) * half_height;
                         write_ptr->m_UserData = EncodeRegionInfo(i, l, x, y);
                         write_ptr->m_TagListKey = dmRender::GetMaterialTagListKey(GetMaterial(component));
                         write_ptr->m_BatchKey = component->m_MixedHash;
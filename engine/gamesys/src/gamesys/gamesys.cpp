@@ -166,7 +166,7 @@ namespace dmGameSystem
                                 update_func, render_func, post_update_func, on_message_func, on_input_func, \
                                 on_reload_func, get_property_func, set_property_func, \
                                 iter_child_func, iter_property_func, \
-                                set_reads_transforms)\
+                                set_reads_transforms, set_writes_transforms, set_parallel_update)\
     factory_result = dmResource::GetTypeFromExtension(factory, extension, &type);\
     if (factory_result != dmResource::RESULT_OK)\
     {\
@@ -196,6 +196,8 @@ namespace dmGameSystem
     component_type.m_IterChildren = iter_child_func;\
     component_type.m_IterProperties = iter_property_func;\
     component_type.m_ReadsTransforms = set_reads_transforms;\
+    component_type.m_WritesTransforms = set_writes_transforms;\
+    component_type.m_ParallelUpdate = set_parallel_update;\
     component_type.m_InstanceHasUserData = (uint32_t)true;\
     component_type.m_UpdateOrderPrio = prio;\
     go_result = dmGameObject::RegisterComponentType(regist, component_type);\
@@ -205,6 +207,9 @@ namespace dmGameSystem
         /*
          * About update priority. Component types below have priority evenly spaced with increments by 100
          *
+         * The last three flags are reads transforms, writes transforms and parallel update.
+         * Adjacent component types (in update order) with the parallel update flag set are updated concurrently,
+         * which requires the update function to only touch its own world and not call into Lua.
          */
 
         REGISTER_COMPONENT_TYPE("collectionproxyc", 100, collection_proxy_context,
@@ -213,7 +218,7 @@ namespace dmGameSystem
                 &CompCollectionProxyUpdate, &CompCollectionProxyRender, &CompCollectionProxyPostUpdate, &CompCollectionProxyOnMessage, &CompCollectionProxyOnInput,
                 0, 0, 0,
                 &CompCollectionProxyIterChildren, 0,
-                0);
+                0, 0, 0);
 
         // See gameobject_comp.cpp for these two component types:
         // Priority 200 is reserved for scriptc (read+write transforms)
@@ -225,7 +230,7 @@ namespace dmGameSystem
                 CompGuiUpdate, CompGuiRender, 0, CompGuiOnMessage, CompGuiOnInput,
                 CompGuiOnReload, CompGuiGetProperty, CompGuiSetProperty,
                 CompGuiIterChildren, CompGuiIterProperties,
-                0);
+                0, 0, 0);
 
         REGISTER_COMPONENT_TYPE("collisionobjectc", 400, physics_context,
                 &CompCollisionObjectNewWorld, &CompCollisionObjectDeleteWorld,
@@ -233,7 +238,7 @@ namespace dmGameSystem
                 &CompCollisionObjectUpdate, 0, &CompCollisionObjectPostUpdate, &CompCollisionObjectOnMessage, 0,
                 &CompCollisionObjectOnReload, CompCollisionObjectGetProperty, CompCollisionObjectSetProperty,
                 0, 0,
-                1);
+                1, 1, 0);
 
         REGISTER_COMPONENT_TYPE("camerac", 500, render_context,
                 &CompCameraNewWorld, &CompCameraDeleteWorld,
@@ -241,7 +246,7 @@ namespace dmGameSystem
                 &CompCameraUpdate, 0, 0, &CompCameraOnMessage, 0,
                 &CompCameraOnReload, 0, 0,
                 0, 0,
-                1);
+                1, 0, 0);
 
         REGISTER_COMPONENT_TYPE("soundc", 600, sound_context,
                 CompSoundNewWorld, CompSoundDeleteWorld,
@@ -249,7 +254,7 @@ namespace dmGameSystem
                 CompSoundUpdate, 0, 0, CompSoundOnMessage, 0,
                 0, CompSoundGetProperty, CompSoundSetProperty,
                 0, 0,
-                0);
+                0, 0, 1);
 
         REGISTER_COMPONENT_TYPE("modelc", 700, model_context,
                 CompModelNewWorld, CompModelDeleteWorld,
@@ -257,7 +262,7 @@ namespace dmGameSystem
                 CompModelUpdate, CompModelRender, 0, CompModelOnMessage, 0,
                 0, CompModelGetProperty, CompModelSetProperty,
                 0, 0,
-                0);
+                0, 1, 0);
 
         REGISTER_COMPONENT_TYPE("meshc", 725, mesh_context,
                 CompMeshNewWorld, CompMeshDeleteWorld,
@@ -265,7 +270,7 @@ namespace dmGameSystem
                 CompMeshUpdate, CompMeshRender, 0, CompMeshOnMessage, 0,
                 0, CompMeshGetProperty, CompMeshSetProperty,
                 0, 0,
-                0);
+                0, 0, 1);
 
         REGISTER_COMPONENT_TYPE("emitterc", 750, 0x0,
                 &CompEmitterNewWorld, &CompEmitterDeleteWorld,
@@ -273,7 +278,7 @@ namespace dmGameSystem
                 0, 0, 0, CompEmitterOnMessage, 0,
                 0, 0, 0,
                 0, 0,
-                0);
+                0, 0, 0);
 
         REGISTER_COMPONENT_TYPE("particlefxc", 800, particlefx_context,
                 &CompParticleFXNewWorld, &CompParticleFXDeleteWorld,
@@ -281,7 +286,7 @@ namespace dmGameSystem
                 &CompParticleFXUpdate, &CompParticleFXRender, 0, &CompParticleFXOnMessage, 0,
                 &CompParticleFXOnReload, 0, 0,
                 0, 0,
-                1);
+                1, 0, 0);
 
         REGISTER_COMPONENT_TYPE("factoryc", 900, factory_context,
                 CompFactoryNewWorld, CompFactoryDeleteWorld,
@@ -289,7 +294,7 @@ namespace dmGameSystem
                 CompFactoryUpdate, 0, 0, CompFactoryOnMessage, 0,
                 0, 0, 0,
                 0, 0,
-                0);
+                0, 0, 0);
 
         REGISTER_COMPONENT_TYPE("collectionfactoryc", 950, collectionfactory_context,
                 CompCollectionFactoryNewWorld, CompCollectionFactoryDeleteWorld,
@@ -297,7 +302,7 @@ namespace dmGameSystem
                 CompCollectionFactoryUpdate, 0, 0, 0, 0,
                 0, 0, 0,
                 0, 0,
-                0);
+                0, 0, 0);
 
         REGISTER_COMPONENT_TYPE("lightc", 1000, render_context,
                 CompLightNewWorld, CompLightDeleteWorld,
@@ -305,7 +310,7 @@ namespace dmGameSystem
                 CompLightUpdate, 0, 0, CompLightOnMessage, 0,
                 0, 0, 0,
                 0, 0,
-                1);
+                1, 0, 1);
 
         REGISTER_COMPONENT_TYPE("spritec", 1100, sprite_context,
                 CompSpriteNewWorld, CompSpriteDeleteWorld,
@@ -313,7 +318,7 @@ namespace dmGameSystem
                 CompSpriteUpdate, CompSpriteRender, 0, CompSpriteOnMessage, 0,
                 CompSpriteOnReload, CompSpriteGetProperty, CompSpriteSetProperty,
                 0, CompSpriteIterProperties,
-                1);
+                1, 0, 1);
 
         REGISTER_COMPONENT_TYPE(TILE_MAP_EXT, 1200, tilemap_context,
                 CompTileGridNewWorld, CompTileGridDeleteWorld,
@@ -321,7 +326,7 @@ namespace dmGameSystem
                 CompTileGridUpdate, CompTileGridRender, 0, CompTileGridOnMessage, 0,
                 CompTileGridOnReload, CompTileGridGetProperty, CompTileGridSetProperty,
                 0, 0,
-                1);
+                1, 0, 1);
 
         REGISTER_COMPONENT_TYPE("labelc", 1400, label_context,
                 CompLabelNewWorld, CompLabelDeleteWorld,
@@ -329,7 +334,7 @@ namespace dmGameSystem
                 CompLabelUpdate, CompLabelRender, 0, CompLabelOnMessage, 0,
                 CompLabelOnReload, CompLabelGetProperty, CompLabelSetProperty,
                 0, 0,
-                1);
+                1, 0, 1);
 
         #undef REGISTER_COMPONENT_TYPE
 
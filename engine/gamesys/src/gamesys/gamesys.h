@@ -21,6 +21,7 @@
 
 #include <dmsdk/dlib/array.h>
 #include <dmsdk/dlib/hash.h>
+#include <dlib/job_system.h>
 #include <dmsdk/lua/lua.h>
 #include <dmsdk/gameobject/gameobject.h>
 
@@ -87,6 +88,7 @@ namespace dmGameSystem
         }
         dmResource::HFactory m_Factory;
         dmRender::HRenderContext m_RenderContext;
+        dmJobSystem::HContext m_JobContext;
         uint32_t m_MaxParticleFXCount;
         uint32_t m_MaxParticleCount;
         bool m_Debug;
@@ -133,6 +135,7 @@ namespace dmGameSystem
         }
         dmRender::HRenderContext    m_RenderContext;
         dmResource::HFactory        m_Factory;
+        dmJobSystem::HContext       m_JobContext;
         uint32_t                    m_MaxModelCount;
     };
 
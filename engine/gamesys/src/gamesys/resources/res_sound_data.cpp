@@ -11,11 +11,47 @@
 // specific language governing permissions and limitations under the License.
 
 #include <string.h>
+#include <stdlib.h>
+#include <dlib/log.h>
 #include <sound/sound.h>
 #include "res_sound_data.h"
 
 namespace dmGameSystem
 {
+    // Reads the part of a streamed sound that wasn't preloaded. Called from the sound thread
+    static dmSound::Result ReadSoundData(void* context, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread)
+    {
+        dmResource::Result r = dmResource::ReadResourceFile((dmResource::HResourceFile) context, offset, size, buffer, nread);
+        return r == dmResource::RESULT_OK ? dmSound::RESULT_OK : dmSound::RESULT_INVALID_STREAM_DATA;
+    }
+
+    // Creates the sound data from a buffer with only the first part of the file (see sound.stream_enabled).
+    // The sound data owns the file if it streams from it, otherwise the file is closed
+    static dmSound::Result NewSoundDataFromPart(const dmResource::ResourceCreateParams& params, dmResource::HResourceFile file, uint32_t file_size, dmSound::SoundDataType type, dmSound::HSoundData* sound_data)
+    {
+        dmSound::Result r = dmSound::NewSoundDataStreaming(params.m_Buffer, params.m_BufferSize, file_size, ReadSoundData, file, type, sound_data, params.m_Resource->m_NameHash);
+        if (r == dmSound::RESULT_OK)
+        {
+            return r;
+        }
+
+        if (r == dmSound::RESULT_UNSUPPORTED)
+        {
+            // The sound system can't stream, so read the rest of the file
+            uint8_t* data = (uint8_t*) malloc(file_size);
+            memcpy(data, params.m_Buffer, params.m_BufferSize);
+            uint32_t nread = 0;
+            dmResource::Result rr = dmResource::ReadResourceFile(file, params.m_BufferSize, file_size - params.m_BufferSize, data + params.m_BufferSize, &nread);
+            if (rr == dmResource::RESULT_OK && nread == file_size - params.m_BufferSize)
+                r = dmSound::NewSoundData(data, file_size, type, sound_data, params.m_Resource->m_NameHash);
+            else
+                r = dmSound::RESULT_INVALID_STREAM_DATA;
+            free(data);
+        }
+        dmResource::CloseResourceFile(file);
+        return r;
+    }
+
     dmResource::Result ResSoundDataCreate(const dmResource::ResourceCreateParams& params)
     {
         dmSound::HSoundData sound_data;
@@ -28,7 +64,31 @@ namespace dmGameSystem
             type = dmSound::SOUND_DATA_TYPE_OGG_VORBIS;
         }
 
-        dmSound::Result r = dmSound::NewSoundData(params.m_Buffer, params.m_BufferSize, type, &sound_data, params.m_Resource->m_NameHash);
+        // Data in a memory mapped archive outlives the resource, so there is no need to copy it
+        dmSound::Result r;
+        dmResource::HResourceFile file = 0;
+        uint32_t file_size = 0;
+        if (params.m_IsBufferMapped)
+        {
+            r = dmSound::NewSoundDataNoCopy(params.m_Buffer, params.m_BufferSize, type, &sound_data, params.m_Resource->m_NameHash);
+        }
+        else if (type == dmSound::SOUND_DATA_TYPE_OGG_VORBIS
+                && dmResource::OpenResourceFile(params.m_Factory, params.m_Filename, &file, &file_size) == dmResource::RESULT_OK
+                && file_size > params.m_BufferSize)
+        {
+            // Only the first part of the file was loaded, the sound instances stream the rest
+            r = NewSoundDataFromPart(params, file, file_size, type, &sound_data);
+            if (r != dmSound::RESULT_OK)
+            {
+                dmLogError("Failed to create streamed sound '%s' (%d)", params.m_Filename, r);
+            }
+        }
+        else
+        {
+            if (file)
+                dmResource::CloseResourceFile(file);
+            r = dmSound::NewSoundData(params.m_Buffer, params.m_BufferSize, type, &sound_data, params.m_Resource->m_NameHash);
+        }
         if (r != dmSound::RESULT_OK)
         {
             return dmResource::RESULT_OUT_OF_RESOURCES;
@@ -42,7 +102,11 @@ namespace dmGameSystem
     dmResource::Result ResSoundDataDestroy(const dmResource::ResourceDestroyParams& params)
     {
         dmSound::HSoundData sound_data = (dmSound::HSoundData) params.m_Resource->m_Resource;
+        // Delete the sound data first, its instances read from the file until then
+        dmResource::HResourceFile file = (dmResource::HResourceFile) dmSound::GetSoundDataReadContext(sound_data);
         dmSound::Result r = dmSound::DeleteSoundData(sound_data);
+        if (file)
+            dmResource::CloseResourceFile(file);
         if (r != dmSound::RESULT_OK)
         {
             return dmResource::RESULT_INVAL;
@@ -53,7 +117,11 @@ namespace dmGameSystem
     dmResource::Result ResSoundDataRecreate(const dmResource::ResourceRecreateParams& params)
     {
         dmSound::HSoundData sound_data = (dmSound::HSoundData) params.m_Resource->m_Resource;
+        // The new data is loaded as a whole, so the sound data no longer streams from the file
+        dmResource::HResourceFile file = (dmResource::HResourceFile) dmSound::GetSoundDataReadContext(sound_data);
         dmSound::Result r = dmSound::SetSoundData(sound_data, params.m_Buffer, params.m_BufferSize);
+        if (file && r == dmSound::RESULT_OK)
+            dmResource::CloseResourceFile(file);
         if (r != dmSound::RESULT_OK)
         {
             return dmResource::RESULT_INVAL;
@@ -228,8 +228,11 @@ namespace dmGameSystem
 
     dmResource::Result ResTexturePreload(const dmResource::ResourcePreloadParams& params)
     {
+        // The image data is kept until the (possibly async) upload has finished. If the buffer is memory mapped
+        // it outlives the message, and the image data can be used in place
         dmGraphics::TextureImage* texture_image;
-        dmDDF::Result e = dmDDF::LoadMessage<dmGraphics::TextureImage>(params.m_Buffer, params.m_BufferSize, (&texture_image));
+        uint32_t options = params.m_IsBufferMapped ? dmDDF::OPTION_BORROW_BYTES : 0;
+        dmDDF::Result e = dmDDF::LoadMessage(params.m_Buffer, params.m_BufferSize, dmGraphics::TextureImage::m_DDFDescriptor, (void**) &texture_image, options, 0);
         if ( e != dmDDF::RESULT_OK )
         {
             return dmResource::RESULT_FORMAT_ERROR;
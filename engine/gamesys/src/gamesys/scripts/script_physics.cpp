@@ -481,6 +481,111 @@ namespace dmGameSystem
         return 1;
     }
 
+    /*# performs several ray casts at once
+     *
+     * Performs a batch of ray casts synchronously, which is considerably cheaper than
+     * casting the rays one at a time when there are many of them. The rays are spread
+     * over the engine worker threads, and there is no limit on the number of rays.
+     * Only the closest hit of each ray is reported.
+     * Which collision objects to hit is filtered by their collision groups and can be configured
+     * through `groups`.
+     *
+     * @name physics.raycast_batch
+     * @param from [type:table] a list of world positions, [type:vector3], of the start of each ray
+     * @param to [type:table] a list of world positions, [type:vector3], of the end of each ray. Must have the same length as `from`
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] A list with one entry per ray. The entry is `false` if the ray missed, otherwise a table with the closest hit. See `ray_cast_response` for details on the values.
+     * @examples
+     *
+     * How to check the line of sight from several enemies to the player:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local from = {}
+     *     local to = {}
+     *     for i,enemy in ipairs(self.enemies) do
+     *         from[i] = go.get_position(enemy)
+     *         to[i] = self.player_position
+     *     end
+     *     local results = physics.raycast_batch(from, to, {hash("world")})
+     *     for i,result in ipairs(results) do
+     *         self.visible[i] = not result
+     *     end
+     * end
+     * ```
+     */
+    static int Physics_RayCastBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.raycast_batch");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        uint32_t count = lua_objlen(L, 1);
+        if (count != lua_objlen(L, 2))
+        {
+            return DM_LUA_ERROR("the from and to lists must have the same length (%d and %d)", count, (uint32_t)lua_objlen(L, 2));
+        }
+
+        uint32_t mask = 0;
+        luaL_checktype(L, 3, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, 3) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+
+        dmArray<dmPhysics::RayCastRequest> requests;
+        requests.SetCapacity(count);
+        requests.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::RayCastRequest& request = requests[i];
+            lua_rawgeti(L, 1, i + 1);
+            request.m_From = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            lua_rawgeti(L, 2, i + 1);
+            request.m_To = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            request.m_Mask = mask;
+        }
+
+        dmArray<dmPhysics::RayCastResponse> responses;
+        responses.SetCapacity(count);
+        responses.SetSize(count);
+        dmGameSystem::RayCastBatch(world, requests.Begin(), count, responses.Begin());
+
+        lua_createtable(L, count, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (responses[i].m_Hit)
+            {
+                lua_newtable(L);
+                PushRayCastResponse(L, world, responses[i]);
+            }
+            else
+            {
+                lua_pushboolean(L, 0);
+            }
+            lua_rawseti(L, -2, i + 1);
+        }
+
+        return 1;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1121,6 +1226,7 @@ namespace dmGameSystem
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_batch",   Physics_RayCastBatch},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
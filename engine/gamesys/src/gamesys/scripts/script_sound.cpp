@@ -290,6 +290,37 @@ namespace dmGameSystem
         return 0;
     }
 
+    /*# set mixer group voice limit
+     * Set the maximum number of sounds in the mixer group that are mixed at the same time.
+     * The sounds with the highest priority, and then the highest gain, are mixed. The other
+     * sounds continue playing silently, without being decoded, until a voice is free.
+     *
+     * @param group [type:string|hash] group name
+     * @param max_voices [type:number] maximum number of voices, 0 for no limit other than `sound.max_voices`
+     * @name sound.set_group_max_voices
+     * @examples
+     *
+     * Mix at most 4 footsteps at a time:
+     *
+     * ```lua
+     * sound.set_group_max_voices("footsteps", 4)
+     * ```
+     */
+    static int Sound_SetGroupMaxVoices(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        dmhash_t group_hash = CheckGroupName(L, 1);
+        int max_voices = luaL_checkinteger(L, 2);
+
+        dmSound::Result r = dmSound::SetGroupMaxVoices(group_hash, (uint32_t) dmMath::Max(max_voices, 0));
+        if (r != dmSound::RESULT_OK) {
+            dmLogWarning("Failed to set group max voices (%d)", r);
+        }
+
+        assert(top == lua_gettop(L));
+        return 0;
+    }
+
     /*# get mixer group gain
      * Get mixer group gain
      *
@@ -455,6 +486,10 @@ namespace dmGameSystem
      * `speed`
      * : [type:number] sound speed where 1.0 is normal speed, 0.5 is half speed and 2.0 is double speed. The final speed of the sound will be a multiplication of this speed and the sound speed.
      *
+     * `priority`
+     * : [type:number] sound priority between 0 and 255, default is 0. When more sounds play than there are voices (see `sound.max_voices` and [ref:sound.set_group_max_voices]),
+     * the sounds with the highest priority are mixed and the rest continue silently until a voice is free.
+     *
      * @param [complete_function] [type:function(self, message_id, message, sender))] function to call when the sound has finished playing.
      *
      * `self`
@@ -505,6 +540,7 @@ namespace dmGameSystem
         dmMessage::URL sender;
         dmScript::ResolveURL(L, 1, &receiver, &sender);
         float delay = 0.0f, gain = 1.0f, pan = 0.0f, speed = 1.0f;
+        uint32_t priority = 0;
         uint32_t play_id = dmSound::INVALID_PLAY_ID;
 
         if (top > 1 && !lua_isnil(L,2)) // table with args
@@ -528,6 +564,10 @@ namespace dmGameSystem
             speed = lua_isnil(L, -1) ? 1.0 : luaL_checknumber(L, -1);
             lua_pop(L, 1);
 
+            lua_getfield(L, -1, "priority");
+            priority = lua_isnil(L, -1) ? 0 : (uint32_t) dmMath::Clamp((int) luaL_checkinteger(L, -1), 0, 255);
+            lua_pop(L, 1);
+
             lua_pop(L, 1);
         }
 
@@ -549,6 +589,7 @@ namespace dmGameSystem
         msg.m_Pan    = pan;
         msg.m_Speed = speed;
         msg.m_PlayId = play_id;
+        msg.m_Priority = priority;
 
         dmMessage::Post(&sender, &receiver, dmGameSystemDDF::PlaySound::m_DDFDescriptor->m_NameHash, (uintptr_t)instance, (uintptr_t)functionref, (uintptr_t)dmGameSystemDDF::PlaySound::m_DDFDescriptor, &msg, sizeof(msg), 0);
 
@@ -708,6 +749,7 @@ namespace dmGameSystem
         {"get_peak", Sound_GetPeak},
         {"set_group_gain", Sound_SetGroupGain},
         {"get_group_gain", Sound_GetGroupGain},
+        {"set_group_max_voices", Sound_SetGroupMaxVoices},
         {"get_groups", Sound_GetGroups},
         {"get_group_name", Sound_GetGroupName},
         {"is_phone_call_active", Sound_IsPhoneCallActive},
@@ -857,6 +857,126 @@ TEST_P(CursorTest, Cursor)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+// Reads the world position and size of the sprite of an instance, from the world transform it calculated when last rendered
+static bool GetSpriteWorldTransform(dmGameObject::SceneNode* node, dmGameObject::HInstance instance, Vector3& position, Vector3& size)
+{
+    if (node->m_Type == dmGameObject::SCENE_NODE_TYPE_COMPONENT && node->m_Instance == instance)
+    {
+        bool found = false;
+        dmGameObject::SceneNodePropertyIterator pit = dmGameObject::TraverseIterateProperties(node);
+        while (dmGameObject::TraverseIteratePropertiesNext(&pit))
+        {
+            const float* v = pit.m_Property.m_Value.m_V4;
+            if (pit.m_Property.m_NameHash == dmHashString64("world_position"))
+            {
+                position = Vector3(v[0], v[1], v[2]);
+            }
+            else if (pit.m_Property.m_NameHash == dmHashString64("world_size"))
+            {
+                size = Vector3(v[0], v[1], v[2]);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    dmGameObject::SceneNodeIterator it = dmGameObject::TraverseIterateChildren(node);
+    while (dmGameObject::TraverseIterateNext(&it))
+    {
+        if (GetSpriteWorldTransform(&it.m_Node, instance, position, size))
+            return true;
+    }
+    return false;
+}
+
+static void UpdateAndRenderSprites(dmGameObject::HCollection collection, dmGameObject::UpdateContext* update_context, dmRender::HRenderContext render_context)
+{
+    ASSERT_TRUE(dmGameObject::Update(collection, update_context));
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+}
+
+#define ASSERT_SPRITE_WORLD_TRANSFORM(px, py, sx, sy) \
+    { \
+        dmGameObject::SceneNode root; \
+        ASSERT_TRUE(dmGameObject::TraverseGetRoot(m_Register, &root)); \
+        Vector3 position, size; \
+        ASSERT_TRUE(GetSpriteWorldTransform(&root, go, position, size)); \
+        ASSERT_NEAR(px, position.getX(), EPSILON); \
+        ASSERT_NEAR(py, position.getY(), EPSILON); \
+        ASSERT_NEAR(sx, size.getX(), EPSILON); \
+        ASSERT_NEAR(sy, size.getY(), EPSILON); \
+    }
+
+TEST_F(SpriteTest, WorldTransform)
+{
+    const float EPSILON = 0.0001f;
+    dmhash_t go_id = dmHashString64("/go");
+    dmhash_t sprite_comp_id = dmHashString64("sprite");
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/sprite/valid_sprite.goc", go_id, 0, 0, Point3(10, 20, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0x0, go);
+
+    dmMessage::URL msg_url;
+    dmMessage::ResetURL(&msg_url);
+    msg_url.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    msg_url.m_Path = go_id;
+    msg_url.m_Fragment = sprite_comp_id;
+
+    m_UpdateContext.m_DT = 1.0f / 60.0f;
+
+    // The 16x16 tile of the default animation, at the game object position
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(10.0f, 20.0f, 16.0f, 16.0f);
+
+    // A static sprite keeps its transform
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(10.0f, 20.0f, 16.0f, 16.0f);
+
+    // Moving the game object
+    dmGameObject::SetPosition(go, Point3(30, 40, 0));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(30.0f, 40.0f, 16.0f, 16.0f);
+
+    // Scaling the sprite
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go, sprite_comp_id, dmHashString64("scale"), dmGameObject::PropertyVar(Vector3(2, 2, 1))));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(30.0f, 40.0f, 32.0f, 32.0f);
+
+    // Resizing the sprite
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go, sprite_comp_id, dmHashString64("size"), dmGameObject::PropertyVar(Vector3(8, 4, 0))));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(30.0f, 40.0f, 16.0f, 8.0f);
+
+    // Playing an animation resets the size to that of its frame
+    dmGameSystemDDF::PlayAnimation play_animation;
+    play_animation.m_Id = dmHashString64("anim");
+    play_animation.m_Offset = 0.0f;
+    play_animation.m_PlaybackRate = 1.0f;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&msg_url, &msg_url, dmGameSystemDDF::PlayAnimation::m_DDFDescriptor->m_NameHash, (uintptr_t)go, (uintptr_t)dmGameSystemDDF::PlayAnimation::m_DDFDescriptor, &play_animation, sizeof(play_animation), 0));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(30.0f, 40.0f, 32.0f, 32.0f);
+
+    // A disabled sprite is not updated when the game object moves...
+    dmGameObjectDDF::Disable disable;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&msg_url, &msg_url, dmGameObjectDDF::Disable::m_DDFDescriptor->m_NameHash, (uintptr_t)go, (uintptr_t)dmGameObjectDDF::Disable::m_DDFDescriptor, &disable, sizeof(disable), 0));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    dmGameObject::SetPosition(go, Point3(50, 60, 0));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(30.0f, 40.0f, 32.0f, 32.0f);
+
+    // ...but catches up once enabled again
+    dmGameObjectDDF::Enable enable;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&msg_url, &msg_url, dmGameObjectDDF::Enable::m_DDFDescriptor->m_NameHash, (uintptr_t)go, (uintptr_t)dmGameObjectDDF::Enable::m_DDFDescriptor, &enable, sizeof(enable), 0));
+    UpdateAndRenderSprites(m_Collection, &m_UpdateContext, m_RenderContext);
+    ASSERT_SPRITE_WORLD_TRANSFORM(50.0f, 60.0f, 32.0f, 32.0f);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+#undef ASSERT_SPRITE_WORLD_TRANSFORM
+
 TEST_F(WindowEventTest, Test)
 {
     dmGameSystem::ScriptLibContext scriptlibcontext;
@@ -1316,7 +1436,7 @@ TEST_P(DrawCountTest, DrawCount)
     dmGameObject::Render(m_Collection);
 
     dmRender::RenderListEnd(m_RenderContext);
-    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
 
     ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
 
@@ -1359,7 +1479,7 @@ TEST_P(BoxRenderTest, BoxRender)
     dmGameObject::Render(m_Collection);
 
     dmRender::RenderListEnd(m_RenderContext);
-    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0);
+    dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
 
     ASSERT_EQ(world->m_ClientVertexBuffer.Size(), (uint32_t)p.m_ExpectedVerticesCount);
 
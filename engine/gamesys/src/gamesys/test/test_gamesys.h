@@ -196,6 +196,12 @@ public:
     virtual ~SpriteAnimTest() {}
 };
 
+class SpriteTest : public GamesysTest<const char*>
+{
+public:
+    virtual ~SpriteTest() {}
+};
+
 class ParticleFxTest : public GamesysTest<const char*>
 {
 public:
@@ -14,7 +14,7 @@
 #define DM_GRAPHICS_UTIL_H
 
 #include <dlib/endian.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmGraphics
 {
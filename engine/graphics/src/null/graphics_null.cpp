@@ -12,7 +12,7 @@
 
 #include <string.h>
 #include <assert.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/array.h>
 #include <dlib/dstrings.h>
@@ -15,7 +15,7 @@
 
 #include <dlib/math.h>
 #include <dlib/mutex.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmGraphics
 {
@@ -15,7 +15,7 @@
 #include <dlib/profile.h>
 #include <dlib/log.h>
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include "../graphics.h"
 #include "../graphics_private.h"
@@ -385,6 +385,7 @@ namespace dmGui
         scene->m_Nodes.SetCapacity(params->m_MaxNodes);
         scene->m_NodePool.SetCapacity(params->m_MaxNodes);
         scene->m_Animations.SetCapacity(params->m_MaxAnimations);
+        scene->m_NodeEnabledCache.SetCapacity(params->m_MaxNodes);
         scene->m_SpineAnimations.SetCapacity(params->m_MaxAnimations);
         scene->m_Textures.SetCapacity(params->m_MaxTextures*2, params->m_MaxTextures);
         scene->m_DynamicTextures.SetCapacity(params->m_MaxTextures*2, params->m_MaxTextures);
@@ -401,6 +402,7 @@ namespace dmGui
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NextVersionNumber = 0;
         scene->m_RenderOrder = 0;
+        scene->m_RenderListDirty = 1;
         scene->m_Width = context->m_DefaultProjectWidth;
         scene->m_Height = context->m_DefaultProjectHeight;
         scene->m_FetchTextureSetAnimCallback = params->m_FetchTextureSetAnimCallback;
@@ -811,6 +813,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        scene->m_RenderListDirty = 1;
         return RESULT_OK;
     }
 
@@ -1391,88 +1394,136 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         CollectRenderEntries(scene, scene->m_RenderHead, 0, 0x0, clippers, render_entries);
     }
 
-    void RenderScene(HScene scene, const RenderSceneParams& params, void* context)
+    /** Updates the cached world transform and opacity of a node, and of its parents first.
+     * The world transform is only recalculated when the local transform of the node changed or when a parent got a new world transform.
+     * The opacity is cheap and has no dirty tracking (e.g. color animations), so it is always recalculated.
+     */
+    static void UpdateNodeWorldTransform(HScene scene, InternalNode* n, uint32_t frame)
     {
-        Context* c = scene->m_Context;
+        if (n->m_RenderFrame == frame)
+            return;
+        n->m_RenderFrame = frame;
 
-        UpdateDynamicTextures(scene, params, context);
-        DeferredDeleteDynamicTextures(scene, params, context);
+        InternalNode* parent = 0x0;
+        if (n->m_ParentIndex != INVALID_INDEX)
+        {
+            parent = &scene->m_Nodes[n->m_ParentIndex];
+            UpdateNodeWorldTransform(scene, parent, frame);
+        }
 
-        c->m_RenderNodes.SetSize(0);
-        c->m_RenderTransforms.SetSize(0);
-        c->m_RenderOpacities.SetSize(0);
-        c->m_StencilClippingNodes.SetSize(0);
-        c->m_StencilScopes.SetSize(0);
-        c->m_StencilScopeIndices.SetSize(0);
-        uint32_t capacity = scene->m_NodePool.Size() * 2;
-        if (capacity > c->m_RenderNodes.Capacity())
+        Node& node = n->m_Node;
+        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
         {
-            c->m_RenderNodes.SetCapacity(capacity);
-            c->m_RenderTransforms.SetCapacity(capacity);
-            c->m_RenderOpacities.SetCapacity(capacity);
-            c->m_SceneTraversalCache.m_Data.SetCapacity(capacity);
-            c->m_SceneTraversalCache.m_Data.SetSize(capacity);
-            c->m_StencilClippingNodes.SetCapacity(capacity);
-            c->m_StencilScopes.SetCapacity(capacity);
-            c->m_StencilScopeIndices.SetCapacity(capacity);
+            UpdateLocalTransform(scene, n);
         }
 
-        c->m_SceneTraversalCache.m_NodeIndex = 0;
-        if(++c->m_SceneTraversalCache.m_Version == INVALID_INDEX)
+        n->m_WorldOpacity = node.m_Properties[dmGui::PROPERTY_COLOR].getW();
+        if (parent && node.m_InheritAlpha)
         {
-            c->m_SceneTraversalCache.m_Version = 0;
+            n->m_WorldOpacity *= parent->m_WorldOpacity;
         }
 
-        Matrix4 node_transform;
-        CollectNodes(scene, c->m_StencilClippingNodes, c->m_RenderNodes);
-        uint32_t node_count = c->m_RenderNodes.Size();
-        std::sort(c->m_RenderNodes.Begin(), c->m_RenderNodes.End(), RenderEntrySortPred(scene));
-        Matrix4 transform;
+        uint32_t parent_version = parent ? parent->m_WorldVersion : 0;
+        if (!n->m_RenderDirty && n->m_ParentWorldVersion == parent_version)
+            return;
 
-        if (c->m_RenderNodes.Capacity() > c->m_RenderTransforms.Capacity())
+        n->m_WorldTransform = node.m_LocalTransform;
+        if (parent)
         {
-            uint32_t new_capacity = c->m_RenderNodes.Capacity();
-            c->m_RenderTransforms.SetCapacity(new_capacity);
-            c->m_RenderOpacities.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetSize(new_capacity);
-            c->m_StencilClippingNodes.SetCapacity(new_capacity);
-            c->m_StencilScopes.SetCapacity(new_capacity);
-            c->m_StencilScopeIndices.SetCapacity(new_capacity);
+            n->m_WorldTransform = parent->m_WorldTransform * n->m_WorldTransform;
         }
+        n->m_ParentWorldVersion = parent_version;
+        ++n->m_WorldVersion;
+        n->m_RenderDirty = 0;
+    }
 
+    static void CollectStencilScopes(HScene scene)
+    {
+        uint32_t node_count = scene->m_RenderEntries.Size();
         for (uint32_t i = 0; i < node_count; ++i)
         {
-            const RenderEntry& entry = c->m_RenderNodes[i];
+            const RenderEntry& entry = scene->m_RenderEntries[i];
             uint16_t index = entry.m_Node & 0xffff;
             InternalNode* n = &scene->m_Nodes[index];
-            float opacity = 1.0f;
-            CalculateNodeSize(n);
-            CalculateNodeTransformAndAlphaCached(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform, opacity);
-            c->m_RenderTransforms.Push(transform);
-            c->m_RenderOpacities.Push(opacity);
             if (n->m_ClipperIndex != INVALID_INDEX) {
-                InternalClippingNode* clipper = &c->m_StencilClippingNodes[n->m_ClipperIndex];
+                InternalClippingNode* clipper = &scene->m_StencilClippingNodes[n->m_ClipperIndex];
                 if (clipper->m_NodeIndex == index) {
                     if (clipper->m_VisibleRenderKey == entry.m_RenderKey) {
                         StencilScope* scope = 0x0;
                         if (clipper->m_ParentIndex != INVALID_INDEX) {
-                            scope = &c->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
+                            scope = &scene->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
                         }
-                        c->m_StencilScopes.Push(scope);
+                        scene->m_StencilScopes.Push(scope);
                     } else {
-                        c->m_StencilScopes.Push(&clipper->m_Scope);
+                        scene->m_StencilScopes.Push(&clipper->m_Scope);
                     }
                 } else {
-                    c->m_StencilScopes.Push(&clipper->m_ChildScope);
+                    scene->m_StencilScopes.Push(&clipper->m_ChildScope);
                 }
             } else {
-                c->m_StencilScopes.Push(0x0);
+                scene->m_StencilScopes.Push(0x0);
             }
         }
+    }
+
+    void RenderScene(HScene scene, const RenderSceneParams& params, void* context)
+    {
+        UpdateDynamicTextures(scene, params, context);
+        DeferredDeleteDynamicTextures(scene, params, context);
+
+        // The render list only depends on the node hierarchy, layers, enabled state and clipping, which all flag the scene when changed.
+        // Particle emitters add render entries of their own each frame, so scenes with live particlefx rebuild the list every frame.
+        bool has_particlefx = scene->m_AliveParticlefxs.Size() > 0;
+        if (scene->m_RenderListDirty || has_particlefx)
+        {
+            scene->m_RenderEntries.SetSize(0);
+            scene->m_StencilClippingNodes.SetSize(0);
+            scene->m_StencilScopes.SetSize(0);
+            uint32_t capacity = scene->m_NodePool.Size() * 2;
+            if (capacity > scene->m_RenderEntries.Capacity())
+            {
+                scene->m_RenderEntries.SetCapacity(capacity);
+                scene->m_StencilClippingNodes.SetCapacity(capacity);
+            }
+
+            CollectNodes(scene, scene->m_StencilClippingNodes, scene->m_RenderEntries);
+            std::sort(scene->m_RenderEntries.Begin(), scene->m_RenderEntries.End(), RenderEntrySortPred(scene));
+
+            if (scene->m_RenderEntries.Size() > scene->m_StencilScopes.Capacity())
+            {
+                scene->m_StencilScopes.SetCapacity(scene->m_RenderEntries.Capacity());
+            }
+            CollectStencilScopes(scene);
+
+            // Keep the list dirty so that it is rebuilt once more when the last particlefx has died
+            scene->m_RenderListDirty = has_particlefx;
+        }
+
+        uint32_t node_count = scene->m_RenderEntries.Size();
+        if (node_count > scene->m_RenderTransforms.Capacity())
+        {
+            scene->m_RenderTransforms.SetCapacity(scene->m_RenderEntries.Capacity());
+            scene->m_RenderOpacities.SetCapacity(scene->m_RenderEntries.Capacity());
+        }
+        scene->m_RenderTransforms.SetSize(node_count);
+        scene->m_RenderOpacities.SetSize(node_count);
+
+        uint32_t frame = ++scene->m_RenderFrame;
+        for (uint32_t i = 0; i < node_count; ++i)
+        {
+            const RenderEntry& entry = scene->m_RenderEntries[i];
+            InternalNode* n = &scene->m_Nodes[entry.m_Node & 0xffff];
+            CalculateNodeSize(n);
+            UpdateNodeWorldTransform(scene, n, frame);
+            // The extents (size and pivot) are applied last, which gives the same result as applying them to the local transform
+            Matrix4& transform = scene->m_RenderTransforms[i];
+            transform = n->m_WorldTransform;
+            CalculateNodeExtents(n->m_Node, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+            scene->m_RenderOpacities[i] = n->m_WorldOpacity;
+        }
 
         scene->m_ResChanged = 0;
-        params.m_RenderNodes(scene, c->m_RenderNodes.Begin(), c->m_RenderTransforms.Begin(), c->m_RenderOpacities.Begin(), (const StencilScope**)c->m_StencilScopes.Begin(), c->m_RenderNodes.Size(), context);
+        params.m_RenderNodes(scene, scene->m_RenderEntries.Begin(), scene->m_RenderTransforms.Begin(), scene->m_RenderOpacities.Begin(), (const StencilScope**)scene->m_StencilScopes.Begin(), node_count, context);
     }
 
     void RenderScene(HScene scene, RenderNodes render_nodes, void* context)
@@ -1495,20 +1546,33 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         }
     }
 
-    #define OLD_VERSION false
+    static void ResetNodeEnabledCache(HScene scene)
+    {
+        dmArray<uint8_t>& cache = scene->m_NodeEnabledCache;
+        cache.SetSize(scene->m_Nodes.Size());
+        if (cache.Size() > 0)
+        {
+            memset(cache.Begin(), 0xff, cache.Size());
+        }
+    }
 
-    static bool AnimCompare(const Animation& lhs, const float* value)
+    // Same as IsNodeEnabledRecursive, but each node is only resolved once until the cache is reset
+    static bool IsNodeEnabledCached(HScene scene, uint16_t node_index)
     {
-        return lhs.m_Value < value;
+        uint8_t& enabled = scene->m_NodeEnabledCache[node_index];
+        if (enabled == 0xff)
+        {
+            InternalNode* node = &scene->m_Nodes[node_index];
+            enabled = node->m_Node.m_Enabled && (node->m_ParentIndex == INVALID_INDEX || IsNodeEnabledCached(scene, node->m_ParentIndex));
+        }
+        return enabled != 0;
     }
 
-    static inline void RemoveAnimation(dmArray<Animation>& animations, uint32_t i)
+    #define OLD_VERSION false
+
+    static bool AnimCompare(const Animation& lhs, const float* value)
     {
-        Animation* current = &animations[i];
-        Animation* end = animations.End();
-        // Move all one step to the "left"
-        memmove(current, current+1, sizeof(Animation) * (end-current-1));
-        animations.SetSize(animations.Size()-1);
+        return lhs.m_Value < value;
     }
 
     static inline uint32_t FindAnimation(dmArray<Animation>& animations, float* value)
@@ -1571,6 +1635,15 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
         uint32_t active_animations = 0;
 
+        ResetNodeEnabledCache(scene);
+
+        // Vector properties are animated as adjacent per-component animations sharing curve and time,
+        // so the last easing evaluation is reused when the next animation asks for the same value.
+        dmEasing::Curve last_easing;
+        float last_t = 0.0f;
+        float last_x = 0.0f;
+        bool has_last = false;
+
         for (uint32_t i = 0; i < animations->Size(); ++i)
         {
             Animation* anim = &(*animations)[i];
@@ -1584,7 +1657,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             {
                 continue;
             }
-            if (!IsNodeEnabledRecursive(scene, anim->m_Node & 0xffff))
+            if (!IsNodeEnabledCached(scene, anim->m_Node & 0xffff))
             {
                 continue;
             }
@@ -1624,7 +1697,20 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                     }
                 }
 
-                float x = dmEasing::GetValue(anim->m_Easing, t2);
+                float x;
+                if (has_last && last_t == t2 && last_easing.type == anim->m_Easing.type
+                    && (anim->m_Easing.type != dmEasing::TYPE_FLOAT_VECTOR || last_easing.vector == anim->m_Easing.vector))
+                {
+                    x = last_x;
+                }
+                else
+                {
+                    x = dmEasing::GetValue(anim->m_Easing, t2);
+                    last_easing = anim->m_Easing;
+                    last_t = t2;
+                    last_x = x;
+                    has_last = true;
+                }
 
                 *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
                 // Flag local transform as dirty for the node
@@ -1640,6 +1726,9 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                         }
                     } else {
                         CompleteAnimation(scene, anim, true);
+                        // The callback may have changed nodes or released the easing curve
+                        ResetNodeEnabledCache(scene);
+                        has_last = false;
                     }
                 }
             }
@@ -1649,10 +1738,16 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             }
         }
 
+        // Remove finished animations in a single pass, keeping the sort order.
+        // The remaining callbacks are invoked afterwards, since they may start new animations.
+        dmArray<AnimationCompleteCall>& complete_calls = scene->m_AnimationCompleteCalls;
+        complete_calls.SetSize(0);
         uint32_t n = animations->Size();
+        Animation* anims = animations->Begin();
+        uint32_t write = 0;
         for (uint32_t i = 0; i < n; ++i)
         {
-            Animation* anim = &(*animations)[i];
+            Animation* anim = &anims[i];
 
             if (anim->m_Elapsed >= anim->m_Duration || anim->m_Cancelled)
             {
@@ -1663,14 +1758,35 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 if (!anim->m_AnimationCompleteCalled && anim->m_AnimationComplete)
                 {
                     anim->m_AnimationCompleteCalled = 1;
-                    anim->m_AnimationComplete(scene, anim->m_Node, !anim->m_Cancelled, anim->m_Userdata1, anim->m_Userdata2);
+                    AnimationCompleteCall call;
+                    call.m_AnimationComplete = anim->m_AnimationComplete;
+                    call.m_Node = anim->m_Node;
+                    call.m_Userdata1 = anim->m_Userdata1;
+                    call.m_Userdata2 = anim->m_Userdata2;
+                    call.m_Finished = !anim->m_Cancelled;
+                    if (complete_calls.Full())
+                    {
+                        complete_calls.OffsetCapacity(16U);
+                    }
+                    complete_calls.Push(call);
                 }
-
-                RemoveAnimation(*animations, i);
-                i--;
-                n--;
                 continue;
             }
+
+            if (write != i)
+            {
+                anims[write] = *anim;
+            }
+            ++write;
+        }
+        animations->SetSize(write);
+        n = write;
+
+        uint32_t call_count = complete_calls.Size();
+        for (uint32_t i = 0; i < call_count; ++i)
+        {
+            const AnimationCompleteCall& call = complete_calls[i];
+            call.m_AnimationComplete(scene, call.m_Node, call.m_Finished, call.m_Userdata1, call.m_Userdata2);
         }
 
         DM_COUNTER("Gui.Animations", n);
@@ -2325,7 +2441,6 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         node->m_ParentIndex = INVALID_INDEX;
         node->m_ChildHead = INVALID_INDEX;
         node->m_ChildTail = INVALID_INDEX;
-        node->m_SceneTraversalCacheVersion = INVALID_INDEX;
         node->m_ClipperIndex = INVALID_INDEX;
         scene->m_NextVersionNumber = (version + 1) % ((1 << 16) - 1);
 
@@ -2418,6 +2533,8 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             tail = &parent_n->m_ChildTail;
         }
         n->m_ParentIndex = parent_index;
+        n->m_RenderDirty = 1;
+        scene->m_RenderListDirty = 1;
         if (prev_n != 0x0)
         {
             if (*tail == prev_n->m_Index)
@@ -2465,6 +2582,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             *head_ptr = n->m_NextIndex;
         if (*tail_ptr == n->m_Index)
             *tail_ptr = n->m_PrevIndex;
+        scene->m_RenderListDirty = 1;
     }
 
     static inline void ResetInternalNode(HScene scene, InternalNode* n)
@@ -2536,20 +2654,22 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             DeleteNode(scene, GetNodeHandle(child), delete_headless_pfx);
         }
 
+        // The animated values all live inside the node, so its animations form one range in the sorted array
         dmArray<Animation> *animations = &scene->m_Animations;
-        uint32_t n_anims = animations->Size();
-        for (uint32_t i = 0; i < n_anims; ++i)
+        float* node_begin = (float*) &n->m_Node;
+        float* node_end = (float*) (&n->m_Node + 1);
+        uint32_t first = (uint32_t) (std::lower_bound(animations->Begin(), animations->End(), node_begin, AnimCompare) - animations->Begin());
+        uint32_t last = first;
+        while (last < animations->Size() && (*animations)[last].m_Value < node_end)
         {
-            Animation* anim = &(*animations)[i];
-
-            if (anim->m_Node == node)
-            {
-                CompleteAnimation(scene, anim, false);
-                RemoveAnimation(*animations, i);
-                i--;
-                n_anims--;
-                continue;
-            }
+            CompleteAnimation(scene, &(*animations)[last], false);
+            ++last;
+        }
+        if (last != first)
+        {
+            Animation* begin = animations->Begin();
+            memmove(begin + first, begin + last, sizeof(Animation) * (animations->Size() - last));
+            animations->SetSize(animations->Size() - (last - first));
         }
 
         if (!delete_headless_pfx && n->m_Node.m_HasHeadlessPfx)
@@ -2571,6 +2691,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NodePool.Clear();
         scene->m_Animations.SetSize(0);
+        scene->m_RenderListDirty = 1;
     }
 
     static Vector4 ApplyAdjustOnReferenceScale(const Vector4& reference_scale, uint32_t adjust_mode)
@@ -2672,6 +2793,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         }
 
         node.m_DirtyLocal = 0;
+        n->m_RenderDirty = 1;
     }
 
     void ResetNodes(HScene scene)
@@ -2688,6 +2810,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             }
         }
         scene->m_Animations.SetSize(0);
+        scene->m_RenderListDirty = 1;
     }
 
     uint16_t GetRenderOrder(HScene scene)
@@ -3253,6 +3376,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            scene->m_RenderListDirty = 1;
             return RESULT_OK;
         }
         else
@@ -3556,6 +3680,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingMode = mode;
+        scene->m_RenderListDirty = 1;
     }
 
     ClippingMode GetNodeClippingMode(HScene scene, HNode node)
@@ -3568,6 +3693,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingVisible = (uint32_t) visible;
+        scene->m_RenderListDirty = 1;
     }
 
     bool GetNodeClippingVisible(HScene scene, HNode node)
@@ -3580,6 +3706,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingInverted = (uint32_t) inverted;
+        scene->m_RenderListDirty = 1;
     }
 
     bool GetNodeClippingInverted(HScene scene, HNode node)
@@ -3890,33 +4017,25 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         assert(n->m_Version == version);
 
         dmArray<Animation>* animations = &scene->m_Animations;
-        uint32_t n_animations = animations->Size();
 
         PropDesc* pd = GetPropertyDesc(property_hash);
         if (pd) {
-            for (uint32_t i = 0; i < n_animations; ++i)
-            {
-                Animation* anim = &(*animations)[i];
-
-                int from = 0;
-                int to = 4; // NOTE: Exclusive range
-                int expect = 4;
-                if (pd->m_Component != 0xff) {
-                    from = pd->m_Component;
-                    to = pd->m_Component + 1;
-                    expect = 1;
-                }
+            int from = 0;
+            int to = 4; // NOTE: Exclusive range
+            if (pd->m_Component != 0xff) {
+                from = pd->m_Component;
+                to = pd->m_Component + 1;
+            }
 
-                float* value = (float*) &n->m_Node.m_Properties[pd->m_Property];
-                int count = 0;
-                for (int j = from; j < to; ++j) {
-                    if (anim->m_Node == node && anim->m_Value == (value + j))
+            float* value = (float*) &n->m_Node.m_Properties[pd->m_Property];
+            for (int j = from; j < to; ++j) {
+                uint32_t animation_index = FindAnimation(*animations, value + j);
+                if (animation_index != 0xffffffff)
+                {
+                    Animation* anim = &(*animations)[animation_index];
+                    if (anim->m_Node == node)
                     {
                         anim->m_Cancelled = 1;
-                        ++count;
-                        if (count == expect) {
-                            return;
-                        }
                     }
                 }
             }
@@ -3933,12 +4052,11 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = &scene->m_Nodes[index];
         assert(n->m_Version == version);
 
-        dmArray<Animation>* animations = &scene->m_Animations;
-        uint32_t n_animations = animations->Size();
-        for (uint32_t i = 0; i < n_animations; ++i)
+        uint32_t animation_index = FindAnimation(scene->m_Animations, value);
+        if (animation_index != 0xffffffff)
         {
-            Animation* anim = &(*animations)[i];
-            if (anim->m_Node == node && anim->m_Value == value)
+            Animation* anim = &scene->m_Animations[animation_index];
+            if (anim->m_Node == node)
                 return anim;
         }
         return 0;
@@ -4171,6 +4289,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Enabled = enabled;
+        scene->m_RenderListDirty = 1;
         if(enabled)
         {
             SetDirtyLocalRecursive(scene, node);
@@ -4355,7 +4474,6 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             out_n->m_Node.m_Text = strdup(n->m_Node.m_Text);
         out_n->m_Version = version;
         out_n->m_Index = index;
-        out_n->m_SceneTraversalCacheVersion = INVALID_INDEX;
         out_n->m_PrevIndex = INVALID_INDEX;
         out_n->m_NextIndex = INVALID_INDEX;
         out_n->m_ParentIndex = INVALID_INDEX;
@@ -26,7 +26,7 @@
 
 #include <script/script.h>
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 using namespace Vectormath::Aos;
 
 /**
@@ -52,19 +52,6 @@ namespace dmGui
         CALCULATE_NODE_RESET_PIVOT  = (1<<2)    // ignore pivot in the resulting transform
     };
 
-    struct SceneTraversalCache
-    {
-        SceneTraversalCache() : m_NodeIndex(0), m_Version(0) {}
-        struct Data
-        {
-            Matrix4     m_Transform;
-            float     	m_Opacity;
-        };
-        dmArray<Data>   m_Data;
-        uint16_t        m_NodeIndex;
-        uint16_t        m_Version;
-    };
-
     struct InternalClippingNode
     {
         StencilScope            m_Scope;
@@ -88,17 +75,10 @@ namespace dmGui
         uint32_t                        m_DefaultProjectHeight;
         uint32_t                        m_Dpi;
         dmArray<HScene>                 m_Scenes;
-        dmArray<RenderEntry>            m_RenderNodes;
-        dmArray<Matrix4>                m_RenderTransforms;
-        dmArray<float>                	m_RenderOpacities;
-        dmArray<InternalClippingNode>   m_StencilClippingNodes;
-        dmArray<StencilScope*>          m_StencilScopes;
-        dmArray<uint16_t>               m_StencilScopeIndices;
         dmArray<HNode>                  m_ScratchBoneNodes;
         dmHID::HContext                 m_HidContext;
         void*                           m_DefaultFont;
         void*                           m_DisplayProfiles;
-        SceneTraversalCache             m_SceneTraversalCache;
     };
 
     struct Node
@@ -168,6 +148,12 @@ namespace dmGui
     struct InternalNode
     {
         Node            m_Node;
+        // World transform and opacity from the last render, reused while neither the node nor its parents change
+        Matrix4         m_WorldTransform;
+        float           m_WorldOpacity;
+        uint32_t        m_WorldVersion;
+        uint32_t        m_ParentWorldVersion;
+        uint32_t        m_RenderFrame;
         dmhash_t        m_NameHash;
         uint16_t        m_Version;
         uint16_t        m_Index;
@@ -176,11 +162,10 @@ namespace dmGui
         uint16_t        m_ParentIndex;
         uint16_t        m_ChildHead;
         uint16_t        m_ChildTail;
-        uint16_t        m_SceneTraversalCacheIndex;
-        uint16_t        m_SceneTraversalCacheVersion;
         uint16_t        m_ClipperIndex;
         uint16_t        m_Deleted : 1; // Set to true for deferred deletion
-        uint16_t        m_Padding : 15;
+        uint16_t        m_RenderDirty : 1; // Set when m_WorldTransform needs to be recalculated
+        uint16_t        m_Padding : 14;
     };
 
     struct NodeProxy
@@ -210,6 +195,16 @@ namespace dmGui
         uint16_t m_Backwards : 1;
     };
 
+    // Deferred completion callback of an animation removed in UpdateAnimations
+    struct AnimationCompleteCall
+    {
+        AnimationComplete m_AnimationComplete;
+        HNode    m_Node;
+        void*    m_Userdata1;
+        void*    m_Userdata2;
+        bool     m_Finished;
+    };
+
     struct SpineAnimation
     {
         HNode    m_Node;
@@ -278,7 +273,9 @@ namespace dmGui
         Script*                 m_Script;
         dmIndexPool16           m_NodePool;
         dmArray<InternalNode>   m_Nodes;
-        dmArray<Animation>      m_Animations;
+        dmArray<Animation>      m_Animations; // Sorted on m_Value
+        dmArray<AnimationCompleteCall> m_AnimationCompleteCalls;
+        dmArray<uint8_t>        m_NodeEnabledCache; // Per node index, 0xff when not yet resolved
         dmArray<SpineAnimation> m_SpineAnimations;
         dmHashTable64<void*>    m_Fonts;
         dmHashTable64<TextureInfo>    m_Textures;
@@ -288,6 +285,12 @@ namespace dmGui
         dmParticle::HParticleContext m_ParticlefxContext;
         dmHashTable64<dmParticle::HPrototype>    m_Particlefxs;
         dmArray<ParticlefxComponent> m_AliveParticlefxs;
+        // Render list kept between frames, only rebuilt when m_RenderListDirty is set
+        dmArray<RenderEntry>    m_RenderEntries;
+        dmArray<Matrix4>        m_RenderTransforms;
+        dmArray<float>          m_RenderOpacities;
+        dmArray<InternalClippingNode> m_StencilClippingNodes;
+        dmArray<StencilScope*>  m_StencilScopes;
         dmHashTable64<uint16_t> m_Layers;
         dmArray<dmhash_t>       m_Layouts;
         dmArray<void*>          m_LayoutsNodeDescs;
@@ -302,6 +305,8 @@ namespace dmGui
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
+        uint16_t                m_RenderListDirty : 1;
+        uint32_t                m_RenderFrame;
         uint32_t                m_Width;
         uint32_t                m_Height;
         dmScript::ScriptWorld*  m_ScriptWorld;
@@ -413,112 +418,6 @@ namespace dmGui
         }
     }
 
-    /** calculates the transform of a parent node
-     *
-     * @param scene scene of the node
-     * @param node node for which to calculate the transform
-     * @param flags CalculateNodeTransformFlags enumerated behaviour flags
-     * @param out_transform [out] out-parameter to write the calculated transform to
-     * @param out_opacity [out] out-parameter to write the calculated opacity
-     * @param traversal_cache [in, out] a helper cache to store/retrieve properties during traversal
-     */
-    inline void CalculateParentNodeTransformAndAlphaCached(HScene scene, InternalNode* n, Matrix4& out_transform, float& out_opacity, SceneTraversalCache& traversal_cache)
-    {
-        const Node& node = n->m_Node;
-        uint16_t cache_index;
-        bool cached;
-        uint16_t cache_version = n->m_SceneTraversalCacheVersion;
-        if(cache_version != traversal_cache.m_Version)
-        {
-            n->m_SceneTraversalCacheVersion = traversal_cache.m_Version;
-            cache_index = n->m_SceneTraversalCacheIndex = traversal_cache.m_NodeIndex++;
-            cached = false;
-        }
-        else
-        {
-            cache_index = n->m_SceneTraversalCacheIndex;
-            cached = true;
-        }
-        SceneTraversalCache::Data& cache_data = traversal_cache.m_Data[cache_index];
-
-        Matrix4 parent_trans;
-        float parent_opacity;
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
-            CalculateParentNodeTransformAndAlphaCached(scene, parent, parent_trans, parent_opacity, traversal_cache);
-        }
-
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
-        else if(cached)
-        {
-            out_transform = cache_data.m_Transform;
-            out_opacity = cache_data.m_Opacity;
-            return;
-        }
-        out_transform = node.m_LocalTransform;
-        out_opacity = n->m_Node.m_Properties[dmGui::PROPERTY_COLOR].getW();
-
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            out_transform = parent_trans * out_transform;
-
-            if (node.m_InheritAlpha)
-            {
-                out_opacity *= parent_opacity;
-            }
-        }
-
-        cache_data.m_Transform = out_transform;
-        cache_data.m_Opacity = out_opacity;
-    }
-
-    /** calculates the transform of a node
-     * A boundary transform maps the local rectangle (0,1),(0,1) to screen space such that it inclusively encapsulates the node boundaries in screen space.
-     * Box nodes are rendered in boundary space (quad with dimensions (0,1),(0,1)), so the same transform is calculated whether or not the CALCULATE_NODE_BOUNDARY flag is set.
-     * Text nodes are rendered in a transform where the origin is located at the left edge of the base line, excluding the text size, since it's implicitly spanned by glyph quads.
-     * Their boundary transform is analogue to the box boundary transform.
-     * This is complicated and could be simplified by supporting different pivots when rendering text.
-     *
-     * @param scene scene of the node
-     * @param node node for which to calculate the transform
-     * @param flags CalculateNodeTransformFlags enumerated behaviour flags
-     * @param out_transform [out] out-parameter to write the calculated transform to
-     * @param out_opacity [out] out-parameter to write the calculated opacity
-     */
-    inline void CalculateNodeTransformAndAlphaCached(HScene scene, InternalNode* n, const CalculateNodeTransformFlags flags, Matrix4& out_transform, float& out_opacity)
-    {
-        Matrix4 parent_trans;
-        float parent_opacity;
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            InternalNode* parent = &scene->m_Nodes[n->m_ParentIndex];
-            CalculateParentNodeTransformAndAlphaCached(scene, parent, parent_trans, parent_opacity, scene->m_Context->m_SceneTraversalCache);
-        }
-
-        const Node& node = n->m_Node;
-        if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
-        {
-            UpdateLocalTransform(scene, n);
-        }
-        out_transform = node.m_LocalTransform;
-        CalculateNodeExtents(node, flags, out_transform);
-
-        out_opacity = node.m_Properties[dmGui::PROPERTY_COLOR].getW();
-        if (n->m_ParentIndex != INVALID_INDEX)
-        {
-            out_transform = parent_trans * out_transform;
-            if (node.m_InheritAlpha)
-            {
-                out_opacity *= parent_opacity;
-            }
-        }
-    }
-
-
     /** calculates the reference scale for a node
      * The reference scale is defined as scaling from the predefined screen space to the actual screen space.
      *
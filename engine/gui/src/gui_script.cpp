@@ -2036,7 +2036,8 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int clipping_mode = (int) luaL_checknumber(L, 2);
-        n->m_Node.m_ClippingMode = (ClippingMode) clipping_mode;
+        (void)n;
+        dmGui::SetNodeClippingMode(GetScene(L), hnode, (ClippingMode) clipping_mode);
         return 0;
     }
 
@@ -2067,7 +2068,8 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int visible = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingVisible = visible;
+        (void)n;
+        dmGui::SetNodeClippingVisible(GetScene(L), hnode, visible != 0);
         return 0;
     }
 
@@ -2098,7 +2100,8 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int inverted = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingInverted = inverted;
+        (void)n;
+        dmGui::SetNodeClippingInverted(GetScene(L), hnode, inverted != 0);
         return 0;
     }
 
@@ -263,8 +263,6 @@ public:
         context_params.m_DefaultProjectHeight = 1;
 
         m_Context = dmGui::NewContext(&context_params);
-        m_Context->m_SceneTraversalCache.m_Data.SetCapacity(MAX_NODES);
-        m_Context->m_SceneTraversalCache.m_Data.SetSize(MAX_NODES);
 
         dmRig::NewContextParams rig_params = {0};
         rig_params.m_Context = &m_RigContext;
@@ -495,7 +493,7 @@ private:
         anim1.m_MeshTracks.m_Count  = 0;
 
         uint32_t bone_track_count = 2;
-        anim0.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[bone_track_count];
+        anim0.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[bone_track_count]();
         anim0.m_Tracks.m_Count = bone_track_count;
         dmRigDDF::AnimationTrack& anim_track0 = anim0.m_Tracks.m_Data[0];
         dmRigDDF::AnimationTrack& anim_track1 = anim0.m_Tracks.m_Data[1];
@@ -1628,6 +1626,55 @@ TEST_F(dmGuiTest, AnimateNodeDelete)
     dmGui::DeleteNode(m_Scene, node2, true);
 }
 
+TEST_F(dmGuiTest, AnimateManyNodesDeleteAndCancel)
+{
+    const uint32_t node_count = 16;
+    dmhash_t property = dmGui::GetPropertyHash(dmGui::PROPERTY_POSITION);
+    dmGui::HNode nodes[node_count];
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        nodes[i] = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX);
+        dmGui::AnimateNodeHash(m_Scene, nodes[i], property, Vector4(1,2,3,0), dmEasing::Curve(dmEasing::TYPE_LINEAR), dmGui::PLAYBACK_ONCE_FORWARD, 1.0f, 0, 0, 0, 0);
+    }
+    ASSERT_EQ(node_count * 4, m_Scene->m_Animations.Size());
+
+    for (int i = 0; i < 30; ++i)
+    {
+        dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+    }
+
+    // Removes the four component animations of the node, and only those
+    dmGui::DeleteNode(m_Scene, nodes[5], true);
+    ASSERT_EQ((node_count - 1) * 4, m_Scene->m_Animations.Size());
+
+    dmGui::CancelAnimationHash(m_Scene, nodes[7], property);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+    }
+    ASSERT_EQ(0U, m_Scene->m_Animations.Size());
+
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        if (i == 5)
+            continue;
+        Point3 position = dmGui::GetNodePosition(m_Scene, nodes[i]);
+        if (i == 7)
+        {
+            ASSERT_NEAR(0.5f, position.getX(), 0.0001f);
+            ASSERT_NEAR(1.0f, position.getY(), 0.0001f);
+        }
+        else
+        {
+            ASSERT_NEAR(1.0f, position.getX(), EPSILON);
+            ASSERT_NEAR(2.0f, position.getY(), EPSILON);
+            ASSERT_NEAR(3.0f, position.getZ(), EPSILON);
+        }
+        dmGui::DeleteNode(m_Scene, nodes[i], true);
+    }
+}
+
 uint32_t MyAnimationCompleteCount = 0;
 void MyAnimationComplete(dmGui::HScene scene,
                          dmGui::HNode node,
@@ -2963,6 +3010,51 @@ TEST_F(dmGuiTest, ScriptAnchoring)
     ASSERT_NEAR(physical_height - 10.0f * ref_scale.getY(), pos2.getY() + ref_factor * 0.5f * (TEXT_MAX_DESCENT + TEXT_MAX_ASCENT), EPSILON);
 }
 
+TEST_F(dmGuiTest, RenderCachedWorldTransform)
+{
+    dmGui::HNode parent = dmGui::NewNode(m_Scene, Point3(10, 10, 0), Vector3(2, 2, 0), dmGui::NODE_TYPE_BOX);
+    dmGui::SetNodeText(m_Scene, parent, "parent");
+    dmGui::HNode child = dmGui::NewNode(m_Scene, Point3(5, 0, 0), Vector3(2, 2, 0), dmGui::NODE_TYPE_BOX);
+    dmGui::SetNodeText(m_Scene, child, "child");
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::SetNodeParent(m_Scene, child, parent, false));
+
+    const float EPSILON = 0.0001f;
+
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_NEAR(14.0f, m_NodeTextToRenderedPosition["child"].getX(), EPSILON);
+    ASSERT_NEAR(9.0f, m_NodeTextToRenderedPosition["child"].getY(), EPSILON);
+
+    // Moving the parent moves the unchanged child
+    dmGui::SetNodePosition(m_Scene, parent, Point3(20, 10, 0));
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_NEAR(19.0f, m_NodeTextToRenderedPosition["parent"].getX(), EPSILON);
+    ASSERT_NEAR(24.0f, m_NodeTextToRenderedPosition["child"].getX(), EPSILON);
+    ASSERT_NEAR(9.0f, m_NodeTextToRenderedPosition["child"].getY(), EPSILON);
+
+    // Moving the child leaves the parent as is
+    dmGui::SetNodePosition(m_Scene, child, Point3(0, 5, 0));
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_NEAR(19.0f, m_NodeTextToRenderedPosition["parent"].getX(), EPSILON);
+    ASSERT_NEAR(19.0f, m_NodeTextToRenderedPosition["child"].getX(), EPSILON);
+    ASSERT_NEAR(14.0f, m_NodeTextToRenderedPosition["child"].getY(), EPSILON);
+
+    // Rendering without changes gives the same result
+    m_NodeTextToRenderedPosition.clear();
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_NEAR(19.0f, m_NodeTextToRenderedPosition["child"].getX(), EPSILON);
+    ASSERT_NEAR(14.0f, m_NodeTextToRenderedPosition["child"].getY(), EPSILON);
+
+    // The child is rendered in its new place after being moved to the root while its parent is disabled
+    dmGui::SetNodeEnabled(m_Scene, parent, false);
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::SetNodeParent(m_Scene, child, dmGui::INVALID_HANDLE, false));
+    m_NodeTextToRenderedPosition.clear();
+    dmGui::RenderScene(m_Scene, &RenderNodes, this);
+    ASSERT_EQ(0u, m_NodeTextToRenderedPosition.count("parent"));
+    ASSERT_NEAR(-1.0f, m_NodeTextToRenderedPosition["child"].getX(), EPSILON);
+    ASSERT_NEAR(4.0f, m_NodeTextToRenderedPosition["child"].getY(), EPSILON);
+}
+
 TEST_F(dmGuiTest, ScriptPivot)
 {
     const char* s = "function init(self)\n"
@@ -3293,7 +3385,7 @@ TEST_F(dmGuiTest, CalculateNodeTransform)
 
 TEST_F(dmGuiTest, CalculateNodeTransformCached)
 {
-    // Tests for the same bug as CalculateNodeTransform does, just in the sibling function CalculateNodeTransformAndAlphaCached
+    // Tests for the same bug as CalculateNodeTransform does, just through the world transforms cached when rendering
     uint32_t physical_width = 200;
     uint32_t physical_height = 100;
     float ref_scale_width = 0.25f;
@@ -3309,16 +3401,19 @@ TEST_F(dmGuiTest, CalculateNodeTransformCached)
     Vector3 size(20, 20, 0);
     dmGui::HNode n1 = dmGui::NewNode(m_Scene, pos, size, dmGui::NODE_TYPE_BOX);
     dmGui::SetNodeId(m_Scene, n1, 0x1);
+    dmGui::SetNodeText(m_Scene, n1, "n1");
 
     pos = Point3(20, 20, 0);
     size = Vector3(15, 15, 0);
     dmGui::HNode n2 = dmGui::NewNode(m_Scene, pos, size, dmGui::NODE_TYPE_BOX);
     dmGui::SetNodeId(m_Scene, n2, 0x2);
+    dmGui::SetNodeText(m_Scene, n2, "n2");
 
     pos = Point3(30, 30, 0);
     size = Vector3(10, 10, 0);
     dmGui::HNode n3 = dmGui::NewNode(m_Scene, pos, size, dmGui::NODE_TYPE_BOX);
     dmGui::SetNodeId(m_Scene, n3, 0x3);
+    dmGui::SetNodeText(m_Scene, n3, "n3");
 
     dmGui::SetNodeParent(m_Scene, n2, n1, false);
     dmGui::SetNodeParent(m_Scene, n3, n2, false);
@@ -3327,43 +3422,33 @@ TEST_F(dmGuiTest, CalculateNodeTransformCached)
     dmGui::InternalNode* nn2 = dmGui::GetNode(m_Scene, n2);
     dmGui::InternalNode* nn3 = dmGui::GetNode(m_Scene, n3);
 
-    Matrix4 transform;
-    float opacity;
-    (void)transform;
-    (void)opacity;
-
-    //
-    dmGui::SetNodeAdjustMode(m_Scene, n1, dmGui::ADJUST_MODE_STRETCH);
-    dmGui::SetNodeAdjustMode(m_Scene, n2, dmGui::ADJUST_MODE_STRETCH);
-    dmGui::SetNodeAdjustMode(m_Scene, n3, dmGui::ADJUST_MODE_STRETCH);
-
-    dmGui::CalculateNodeTransformAndAlphaCached(m_Scene, nn3, dmGui::CalculateNodeTransformFlags(dmGui::CALCULATE_NODE_BOUNDARY | dmGui::CALCULATE_NODE_INCLUDE_SIZE | dmGui::CALCULATE_NODE_RESET_PIVOT), transform, opacity);
-
-    ASSERT_EQ( Vector4(4, 2, 1, 1), nn1->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(4, 2, 1, 1), nn2->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(4, 2, 1, 1), nn3->m_Node.m_LocalAdjustScale );
-
-    //
-    dmGui::SetNodeAdjustMode(m_Scene, n1, dmGui::ADJUST_MODE_FIT);
-    dmGui::SetNodeAdjustMode(m_Scene, n2, dmGui::ADJUST_MODE_FIT);
-    dmGui::SetNodeAdjustMode(m_Scene, n3, dmGui::ADJUST_MODE_FIT);
-
-    dmGui::CalculateNodeTransformAndAlphaCached(m_Scene, nn3, dmGui::CalculateNodeTransformFlags(dmGui::CALCULATE_NODE_BOUNDARY | dmGui::CALCULATE_NODE_INCLUDE_SIZE | dmGui::CALCULATE_NODE_RESET_PIVOT), transform, opacity);
-
-    ASSERT_EQ( Vector4(2, 2, 1, 1), nn1->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(2, 2, 1, 1), nn2->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(2, 2, 1, 1), nn3->m_Node.m_LocalAdjustScale );
-
-    //
-    dmGui::SetNodeAdjustMode(m_Scene, n1, dmGui::ADJUST_MODE_ZOOM);
-    dmGui::SetNodeAdjustMode(m_Scene, n2, dmGui::ADJUST_MODE_ZOOM);
-    dmGui::SetNodeAdjustMode(m_Scene, n3, dmGui::ADJUST_MODE_ZOOM);
-
-    dmGui::CalculateNodeTransformAndAlphaCached(m_Scene, nn3, dmGui::CalculateNodeTransformFlags(dmGui::CALCULATE_NODE_BOUNDARY | dmGui::CALCULATE_NODE_INCLUDE_SIZE | dmGui::CALCULATE_NODE_RESET_PIVOT), transform, opacity);
-
-    ASSERT_EQ( Vector4(4, 4, 1, 1), nn1->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(4, 4, 1, 1), nn2->m_Node.m_LocalAdjustScale );
-    ASSERT_EQ( Vector4(4, 4, 1, 1), nn3->m_Node.m_LocalAdjustScale );
+    const dmGui::AdjustMode adjust_modes[] = { dmGui::ADJUST_MODE_STRETCH, dmGui::ADJUST_MODE_FIT, dmGui::ADJUST_MODE_ZOOM };
+    const Vector4 adjust_scales[] = { Vector4(4, 2, 1, 1), Vector4(2, 2, 1, 1), Vector4(4, 4, 1, 1) };
+    const float EPSILON = 0.0001f;
+    for (uint32_t i = 0; i < sizeof(adjust_modes) / sizeof(adjust_modes[0]); ++i)
+    {
+        dmGui::SetNodeAdjustMode(m_Scene, n1, adjust_modes[i]);
+        dmGui::SetNodeAdjustMode(m_Scene, n2, adjust_modes[i]);
+        dmGui::SetNodeAdjustMode(m_Scene, n3, adjust_modes[i]);
+
+        // The adjust scale is applied when the resolution changes
+        dmGui::SetPhysicalResolution(m_Context, physical_width, physical_height);
+        dmGui::RenderScene(m_Scene, &RenderNodes, this);
+
+        ASSERT_EQ( adjust_scales[i], nn1->m_Node.m_LocalAdjustScale );
+        ASSERT_EQ( adjust_scales[i], nn2->m_Node.m_LocalAdjustScale );
+        ASSERT_EQ( adjust_scales[i], nn3->m_Node.m_LocalAdjustScale );
+
+        // The cached world transform gives the same result as the uncached one
+        Matrix4 transform;
+        dmGui::CalculateNodeTransform(m_Scene, nn3, dmGui::CalculateNodeTransformFlags(dmGui::CALCULATE_NODE_INCLUDE_SIZE | dmGui::CALCULATE_NODE_RESET_PIVOT), transform);
+        Vector4 origin = transform * Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+        Vector4 unit = transform * Vector4(1.0f, 1.0f, 0.0f, 1.0f);
+        ASSERT_NEAR(origin.getX(), m_NodeTextToRenderedPosition["n3"].getX(), EPSILON);
+        ASSERT_NEAR(origin.getY(), m_NodeTextToRenderedPosition["n3"].getY(), EPSILON);
+        ASSERT_NEAR((unit - origin).getX(), m_NodeTextToRenderedSize["n3"].getX(), EPSILON);
+        ASSERT_NEAR((unit - origin).getY(), m_NodeTextToRenderedSize["n3"].getY(), EPSILON);
+    }
 }
 
 // Helper LUT to get readable form of adjustment mode.
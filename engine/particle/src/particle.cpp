@@ -15,8 +15,11 @@
 #include <float.h>
 #include <algorithm>
 #include <dlib/hash.h>
+#include <dlib/align.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/memory.h>
+#include <dlib/simd.h>
 #include <dlib/vmath.h>
 #include <dlib/profile.h>
 #include <dlib/time.h>
@@ -48,6 +51,9 @@ namespace dmParticle
     /// Simulate motion blur at 60 fps with a 180 deg shutter
     const static float STRETCH_SCALING = (1.0f/60.0f) * 0.5f;
 
+    /// With fewer particles than this, the emitters are processed on the calling thread even if there is a job context
+    const static uint32_t PARALLEL_MIN_PARTICLE_COUNT = 512;
+
     AnimationData::AnimationData()
     {
         memset(this, 0, sizeof(*this));
@@ -97,6 +103,11 @@ namespace dmParticle
         context->m_MaxParticleCount = max_particle_count;
     }
 
+    void SetJobContext(HParticleContext context, dmJobSystem::HContext job_context)
+    {
+        context->m_JobContext = job_context;
+    }
+
     static Instance* GetInstance(HParticleContext context, HInstance instance)
     {
         if (instance == INVALID_INSTANCE)
@@ -173,11 +184,129 @@ namespace dmParticle
         }
     }
 
+    void SetCapacity(ParticleBuffer* buffer, uint32_t capacity)
+    {
+        if (capacity == buffer->m_Capacity)
+            return;
+
+        ParticleBuffer old = *buffer;
+        memset(buffer, 0, sizeof(ParticleBuffer));
+        if (capacity > 0)
+        {
+            // One extra array for the scratch area, and two for the 64 bit keys
+            uint32_t stride = (uint32_t)DM_ALIGN(capacity, dmSimd::WIDTH);
+            uint32_t size = (PARTICLE_STREAM_COUNT + 3) * stride * sizeof(float);
+            dmMemory::Result r = dmMemory::AlignedMalloc(&buffer->m_Memory, 16, size);
+            assert(r == dmMemory::RESULT_OK);
+            (void)r;
+            memset(buffer->m_Memory, 0, size);
+
+            float* memory = (float*)buffer->m_Memory;
+            for (uint32_t i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+            {
+                buffer->m_Streams[i] = memory + i * stride;
+            }
+            buffer->m_Scratch = memory + PARTICLE_STREAM_COUNT * stride;
+            buffer->m_SortKeys = (uint64_t*)(memory + (PARTICLE_STREAM_COUNT + 1) * stride);
+            buffer->m_Capacity = capacity;
+            buffer->m_Size = dmMath::Min(old.m_Size, capacity);
+            if (buffer->m_Size > 0)
+            {
+                for (uint32_t i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+                {
+                    memcpy(buffer->m_Streams[i], old.m_Streams[i], buffer->m_Size * sizeof(float));
+                }
+            }
+        }
+        if (old.m_Memory)
+        {
+            dmMemory::AlignedFree(old.m_Memory);
+        }
+    }
+
+    void PushParticle(ParticleBuffer* buffer, const Particle& particle)
+    {
+        assert(buffer->m_Size < buffer->m_Capacity);
+        uint32_t i = buffer->m_Size++;
+        float** s = buffer->m_Streams;
+        s[PARTICLE_STREAM_POSITION_X][i] = particle.m_Position.getX();
+        s[PARTICLE_STREAM_POSITION_Y][i] = particle.m_Position.getY();
+        s[PARTICLE_STREAM_POSITION_Z][i] = particle.m_Position.getZ();
+        s[PARTICLE_STREAM_VELOCITY_X][i] = particle.m_Velocity.getX();
+        s[PARTICLE_STREAM_VELOCITY_Y][i] = particle.m_Velocity.getY();
+        s[PARTICLE_STREAM_VELOCITY_Z][i] = particle.m_Velocity.getZ();
+        s[PARTICLE_STREAM_SOURCE_ROTATION_X][i] = particle.m_SourceRotation.getX();
+        s[PARTICLE_STREAM_SOURCE_ROTATION_Y][i] = particle.m_SourceRotation.getY();
+        s[PARTICLE_STREAM_SOURCE_ROTATION_Z][i] = particle.m_SourceRotation.getZ();
+        s[PARTICLE_STREAM_SOURCE_ROTATION_W][i] = particle.m_SourceRotation.getW();
+        s[PARTICLE_STREAM_ROTATION_X][i] = particle.m_Rotation.getX();
+        s[PARTICLE_STREAM_ROTATION_Y][i] = particle.m_Rotation.getY();
+        s[PARTICLE_STREAM_ROTATION_Z][i] = particle.m_Rotation.getZ();
+        s[PARTICLE_STREAM_ROTATION_W][i] = particle.m_Rotation.getW();
+        s[PARTICLE_STREAM_SCALE_X][i] = particle.m_Scale.getX();
+        s[PARTICLE_STREAM_SCALE_Y][i] = particle.m_Scale.getY();
+        s[PARTICLE_STREAM_SCALE_Z][i] = particle.m_Scale.getZ();
+        s[PARTICLE_STREAM_SOURCE_COLOR_R][i] = particle.m_SourceColor.getX();
+        s[PARTICLE_STREAM_SOURCE_COLOR_G][i] = particle.m_SourceColor.getY();
+        s[PARTICLE_STREAM_SOURCE_COLOR_B][i] = particle.m_SourceColor.getZ();
+        s[PARTICLE_STREAM_SOURCE_COLOR_A][i] = particle.m_SourceColor.getW();
+        s[PARTICLE_STREAM_COLOR_R][i] = particle.m_Color.getX();
+        s[PARTICLE_STREAM_COLOR_G][i] = particle.m_Color.getY();
+        s[PARTICLE_STREAM_COLOR_B][i] = particle.m_Color.getZ();
+        s[PARTICLE_STREAM_COLOR_A][i] = particle.m_Color.getW();
+        s[PARTICLE_STREAM_TIME_LEFT][i] = particle.m_TimeLeft;
+        s[PARTICLE_STREAM_MAX_LIFE_TIME][i] = particle.m_MaxLifeTime;
+        s[PARTICLE_STREAM_OO_MAX_LIFE_TIME][i] = particle.m_ooMaxLifeTime;
+        s[PARTICLE_STREAM_SPREAD_FACTOR][i] = particle.m_SpreadFactor;
+        s[PARTICLE_STREAM_SOURCE_SIZE][i] = particle.m_SourceSize;
+        s[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_X][i] = particle.m_SourceStretchFactorX;
+        s[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_Y][i] = particle.m_SourceStretchFactorY;
+        s[PARTICLE_STREAM_STRETCH_FACTOR_X][i] = particle.m_StretchFactorX;
+        s[PARTICLE_STREAM_STRETCH_FACTOR_Y][i] = particle.m_StretchFactorY;
+        s[PARTICLE_STREAM_SOURCE_ANGULAR_VELOCITY][i] = particle.m_SourceAngularVelocity;
+    }
+
+    void EraseSwapParticle(ParticleBuffer* buffer, uint32_t index)
+    {
+        assert(index < buffer->m_Size);
+        uint32_t last = --buffer->m_Size;
+        for (uint32_t i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+        {
+            float* s = buffer->m_Streams[i];
+            s[index] = s[last];
+        }
+    }
+
+    void GetParticle(const ParticleBuffer* buffer, uint32_t index, Particle* particle)
+    {
+        assert(index < buffer->m_Size);
+        uint32_t i = index;
+        float* const* s = buffer->m_Streams;
+        memset(particle, 0, sizeof(Particle));
+        particle->m_Position = buffer->GetPosition(i);
+        particle->m_Velocity = buffer->GetVelocity(i);
+        particle->m_SourceRotation = buffer->GetSourceRotation(i);
+        particle->m_Rotation = buffer->GetRotation(i);
+        particle->m_Scale = buffer->GetScale(i);
+        particle->m_SourceColor = Vector4(s[PARTICLE_STREAM_SOURCE_COLOR_R][i], s[PARTICLE_STREAM_SOURCE_COLOR_G][i], s[PARTICLE_STREAM_SOURCE_COLOR_B][i], s[PARTICLE_STREAM_SOURCE_COLOR_A][i]);
+        particle->m_Color = buffer->GetColor(i);
+        particle->m_TimeLeft = s[PARTICLE_STREAM_TIME_LEFT][i];
+        particle->m_MaxLifeTime = s[PARTICLE_STREAM_MAX_LIFE_TIME][i];
+        particle->m_ooMaxLifeTime = s[PARTICLE_STREAM_OO_MAX_LIFE_TIME][i];
+        particle->m_SpreadFactor = s[PARTICLE_STREAM_SPREAD_FACTOR][i];
+        particle->m_SourceSize = s[PARTICLE_STREAM_SOURCE_SIZE][i];
+        particle->m_SourceStretchFactorX = s[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_X][i];
+        particle->m_SourceStretchFactorY = s[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_Y][i];
+        particle->m_StretchFactorX = s[PARTICLE_STREAM_STRETCH_FACTOR_X][i];
+        particle->m_StretchFactorY = s[PARTICLE_STREAM_STRETCH_FACTOR_Y][i];
+        particle->m_SourceAngularVelocity = s[PARTICLE_STREAM_SOURCE_ANGULAR_VELOCITY][i];
+    }
+
     static void InitEmitter(Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, uint32_t original_seed)
     {
         emitter->m_Id = dmHashString64(emitter_ddf->m_Id);
         uint32_t particle_count = emitter_ddf->m_MaxParticleCount;
-        emitter->m_Particles.SetCapacity(particle_count);
+        SetCapacity(&emitter->m_Particles, particle_count);
         emitter->m_OriginalSeed = original_seed;
 
         uint32_t seed = original_seed;
@@ -253,12 +382,30 @@ namespace dmParticle
         for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
         {
             Emitter* emitter = &i->m_Emitters[emitter_i];
-            emitter->m_Particles.SetCapacity(0);
+            SetCapacity(&emitter->m_Particles, 0);
             emitter->m_RenderConstants.SetCapacity(0);
         }
         delete i;
     }
 
+    static void ReportEmitterStateChanged(Instance* instance, Emitter* emitter, EmitterState state)
+    {
+        if(state == EMITTER_STATE_PRESPAWN)
+        {
+            instance->m_NumAwakeEmitters += 1;
+        }
+        else if(state == EMITTER_STATE_SLEEPING)
+        {
+            instance->m_NumAwakeEmitters -= 1;
+        }
+
+        instance->m_EmitterStateChangedData.m_StateChangedCallback(
+            instance->m_NumAwakeEmitters,
+            emitter->m_Id,
+            state,
+            instance->m_EmitterStateChangedData.m_UserData);
+    }
+
     void SetEmitterState(Instance* instance, Emitter* emitter, EmitterState state)
     {
         EmitterState old_emitter_state = emitter->m_State;
@@ -266,20 +413,25 @@ namespace dmParticle
 
         if(state != old_emitter_state && instance->m_EmitterStateChangedData.m_UserData != 0x0)
         {
-            if(state == EMITTER_STATE_PRESPAWN)
-            {
-                instance->m_NumAwakeEmitters += 1;
-            }
-            else if(state == EMITTER_STATE_SLEEPING)
+            if (emitter->m_DeferStateChanges)
             {
-                instance->m_NumAwakeEmitters -= 1;
+                // Updated on a worker thread, the callback is called from FlushEmitterStateChanges
+                assert(emitter->m_DeferredStateCount < MAX_DEFERRED_STATE_COUNT);
+                emitter->m_DeferredStates[emitter->m_DeferredStateCount++] = state;
+                return;
             }
 
-            instance->m_EmitterStateChangedData.m_StateChangedCallback(
-                instance->m_NumAwakeEmitters,
-                emitter->m_Id,
-                emitter->m_State,
-                instance->m_EmitterStateChangedData.m_UserData);
+            ReportEmitterStateChanged(instance, emitter, state);
+        }
+    }
+
+    static void FlushEmitterStateChanges(Instance* instance, Emitter* emitter)
+    {
+        uint32_t count = emitter->m_DeferredStateCount;
+        emitter->m_DeferredStateCount = 0;
+        for (uint32_t i = 0; i < count && instance->m_EmitterStateChangedData.m_UserData != 0x0; ++i)
+        {
+            ReportEmitterStateChanged(instance, emitter, emitter->m_DeferredStates[i]);
         }
     }
 
@@ -359,7 +511,7 @@ namespace dmParticle
             {
                 for (uint32_t emitter_i = prototype_emitter_count; emitter_i < emitter_count; ++emitter_i)
                 {
-                    emitters[emitter_i].m_Particles.SetCapacity(0);
+                    SetCapacity(&emitters[emitter_i].m_Particles, 0);
                 }
             }
             emitters.SetCapacity(prototype_emitter_count);
@@ -468,8 +620,7 @@ namespace dmParticle
     static void ResetEmitter(Emitter* emitter)
     {
         // Save particles array and id
-        dmArray<Particle> tmp;
-        tmp.Swap(emitter->m_Particles);
+        ParticleBuffer tmp = emitter->m_Particles;
         dmhash_t id = emitter->m_Id;
         uint32_t original_seed = emitter->m_OriginalSeed;
         float duration = emitter->m_Duration;
@@ -480,11 +631,11 @@ namespace dmParticle
         memset(emitter, 0, sizeof(Emitter));
 
         // Restore particles and id
-        tmp.Swap(emitter->m_Particles);
+        emitter->m_Particles = tmp;
         emitter->m_Id = id;
 
         // Remove living particles
-        emitter->m_Particles.SetSize(0);
+        emitter->m_Particles.m_Size = 0;
 
         // Restore values
         emitter->m_OriginalSeed = original_seed;
@@ -654,10 +805,211 @@ namespace dmParticle
         context->m_Stats.m_Particles = vertex_index / 6; // Debug data for editor playback
     }
 
+    struct GenerateVertexDataContext
+    {
+        HParticleContext    m_Context;
+        Vector4             m_Color;
+        void*               m_VertexBuffer;
+        uint32_t            m_VertexBufferSize;
+        float               m_DT;
+        ParticleVertexFormat m_VertexFormat;
+    };
+
+    static void GenerateVertexDataJob(void* context, void* data, uint32_t start, uint32_t end)
+    {
+        GenerateVertexDataContext* ctx = (GenerateVertexDataContext*) context;
+        EmitterWorkItem* items = (EmitterWorkItem*) data;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            Instance* inst = items[i].m_Instance;
+            uint32_t emitter_index = items[i].m_EmitterIndex;
+            Emitter* emitter = &inst->m_Emitters[emitter_index];
+            dmParticleDDF::Emitter* emitter_ddf = &inst->m_Prototype->m_DDF->m_Emitters[emitter_index];
+            UpdateRenderData(ctx->m_Context, inst, emitter, emitter_ddf, ctx->m_Color, items[i].m_VertexIndex, ctx->m_VertexBuffer, ctx->m_VertexBufferSize, ctx->m_DT, ctx->m_VertexFormat);
+        }
+    }
+
+    void GenerateVertexData(HParticleContext context, float dt, const EmitterRenderData* const* emitters, uint32_t emitter_count, const Vector4& color, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format)
+    {
+        DM_PROFILE(Particle, "GenerateVertexData");
+
+        uint32_t vertex_size = sizeof(Vertex);
+
+        if (vertex_format == PARTICLE_GUI)
+        {
+            vertex_size = sizeof(ParticleGuiVertex);
+        }
+
+        uint32_t vertex_index = *out_vertex_buffer_size / vertex_size;
+        if (vertex_buffer != 0x0 && vertex_buffer_size > 0)
+        {
+            // Reserve the vertices of each emitter before any are written. An emitter gets the range it would
+            // get from UpdateRenderData, with the same truncation when the buffer is full, so the emitters can
+            // be written in any order.
+            uint32_t max_vertex_count = vertex_buffer_size / vertex_size;
+            uint32_t particle_count = 0;
+            dmArray<EmitterWorkItem>& items = context->m_WorkItems;
+            items.SetSize(0);
+            if (items.Capacity() < emitter_count)
+            {
+                items.SetCapacity(emitter_count);
+            }
+            for (uint32_t i = 0; i < emitter_count; ++i)
+            {
+                Instance* inst = GetInstance(context, emitters[i]->m_Instance);
+                if (inst == 0x0 || IsSleeping(inst))
+                    continue;
+
+                EmitterWorkItem item;
+                item.m_Instance = inst;
+                item.m_InstanceHandle = emitters[i]->m_Instance;
+                item.m_EmitterIndex = emitters[i]->m_EmitterIndex;
+                item.m_VertexIndex = vertex_index;
+                items.Push(item);
+
+                uint32_t room = vertex_index + 6 <= max_vertex_count ? (max_vertex_count - vertex_index) / 6 : 0;
+                uint32_t count = dmMath::Min(inst->m_Emitters[item.m_EmitterIndex].m_Particles.Size(), room);
+                vertex_index += count * 6;
+                particle_count += count;
+            }
+
+            GenerateVertexDataContext ctx;
+            ctx.m_Context = context;
+            ctx.m_Color = color;
+            ctx.m_VertexBuffer = vertex_buffer;
+            ctx.m_VertexBufferSize = vertex_buffer_size;
+            ctx.m_DT = dt;
+            ctx.m_VertexFormat = vertex_format;
+            if (context->m_JobContext && particle_count >= PARALLEL_MIN_PARTICLE_COUNT)
+            {
+                dmJobSystem::ParallelFor(context->m_JobContext, GenerateVertexDataJob, &ctx, items.Begin(), items.Size(), 1);
+            }
+            else
+            {
+                GenerateVertexDataJob(&ctx, items.Begin(), 0, items.Size());
+            }
+        }
+
+        *out_vertex_buffer_size = vertex_index * vertex_size;
+
+        context->m_Stats.m_Particles = vertex_index / 6; // Debug data for editor playback
+    }
+
+    static void UpdateEmittersJob(void* context, void* data, uint32_t start, uint32_t end)
+    {
+        float dt = *(float*) context;
+        EmitterWorkItem* items = (EmitterWorkItem*) data;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            Instance* instance = items[i].m_Instance;
+            uint32_t emitter_i = items[i].m_EmitterIndex;
+            Prototype* prototype = instance->m_Prototype;
+            Emitter* emitter = &instance->m_Emitters[emitter_i];
+            EmitterPrototype* emitter_prototype = &prototype->m_Emitters[emitter_i];
+            dmParticleDDF::Emitter* emitter_ddf = &prototype->m_DDF->m_Emitters[emitter_i];
+
+            UpdateEmitterVelocity(instance, emitter, emitter_ddf, dt);
+            UpdateEmitter(prototype, instance, emitter_prototype, emitter, emitter_ddf, dt);
+        }
+    }
+
+    // Same as the serial update, but with the simulation of the emitters done by the job system.
+    // The emitters only depend on their own state (and seed), the callbacks into the user code
+    // and the render data are done afterwards on this thread, in the same order as the serial update.
+    static void UpdateParallel(HParticleContext context, float dt, FetchAnimationCallback fetch_animation_callback)
+    {
+        dmArray<EmitterWorkItem>& items = context->m_WorkItems;
+        items.SetSize(0);
+
+        uint32_t size = context->m_Instances.Size();
+        uint32_t particle_count = 0;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            Instance* instance = context->m_Instances[i];
+
+            // empty slot
+            if (instance == 0x0) continue;
+            uint32_t emitter_count = instance->m_Emitters.Size();
+            // don't update sleeping instances
+            if (IsSleeping(instance))
+            {
+                // update velocity and clear vertex count (don't render)
+                for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
+                {
+                    Emitter* emitter = &instance->m_Emitters[emitter_i];
+                    emitter->m_VertexCount = 0;
+                    dmParticleDDF::Emitter* emitter_ddf = &instance->m_Prototype->m_DDF->m_Emitters[emitter_i];
+                    UpdateEmitterVelocity(instance, emitter, emitter_ddf, dt);
+                }
+                continue;
+            }
+            instance->m_PlayTime += dt;
+            if (items.Remaining() < emitter_count)
+            {
+                items.OffsetCapacity(dmMath::Max(emitter_count, 16U));
+            }
+            for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
+            {
+                Emitter* emitter = &instance->m_Emitters[emitter_i];
+                emitter->m_DeferStateChanges = 1;
+                particle_count += emitter->m_Particles.Size();
+
+                EmitterWorkItem item;
+                item.m_Instance = instance;
+                item.m_InstanceHandle = instance->m_VersionNumber << 16 | i;
+                item.m_EmitterIndex = emitter_i;
+                item.m_VertexIndex = 0;
+                items.Push(item);
+            }
+        }
+
+        dmJobSystem::HContext job_context = particle_count >= PARALLEL_MIN_PARTICLE_COUNT ? context->m_JobContext : 0;
+        dmJobSystem::ParallelFor(job_context, UpdateEmittersJob, &dt, items.Begin(), items.Size(), 1);
+
+        // State changes made by the callbacks below are reported directly
+        uint32_t item_count = items.Size();
+        for (uint32_t i = 0; i < item_count; ++i)
+        {
+            items[i].m_Instance->m_Emitters[items[i].m_EmitterIndex].m_DeferStateChanges = 0;
+        }
+
+        uint32_t TotalAliveParticles = 0;
+        for (uint32_t i = 0; i < item_count; ++i)
+        {
+            EmitterWorkItem& item = items[i];
+            // The instance might have been destroyed or reloaded by a callback
+            uint32_t emitter_i = item.m_EmitterIndex;
+            Instance* instance = context->m_Instances[item.m_InstanceHandle & 0xffff];
+            if (instance != item.m_Instance || instance->m_VersionNumber != (item.m_InstanceHandle >> 16) || emitter_i >= instance->m_Emitters.Size())
+                continue;
+
+            Prototype* prototype = instance->m_Prototype;
+            Emitter* emitter = &instance->m_Emitters[emitter_i];
+            EmitterPrototype* emitter_prototype = &prototype->m_Emitters[emitter_i];
+            dmParticleDDF::Emitter* emitter_ddf = &prototype->m_DDF->m_Emitters[emitter_i];
+
+            FlushEmitterStateChanges(instance, emitter);
+            TotalAliveParticles += (uint32_t)emitter->m_Particles.Size();
+            FetchAnimation(emitter, emitter_prototype, fetch_animation_callback);
+            UpdateEmitterRenderData(item.m_InstanceHandle, emitter_i, instance, emitter, emitter_ddf);
+
+            if (emitter->m_ReHash)
+                ReHashEmitter(emitter);
+        }
+
+        DM_COUNTER("Particles alive", TotalAliveParticles);
+    }
+
     void Update(HParticleContext context, float dt, FetchAnimationCallback fetch_animation_callback)
     {
         DM_PROFILE(Particle, "Update");
 
+        if (context->m_JobContext)
+        {
+            UpdateParallel(context, dt, fetch_animation_callback);
+            return;
+        }
+
         uint32_t size = context->m_Instances.Size();
         uint32_t TotalAliveParticles = 0;
         for (uint32_t i = 0; i < size; i++)
@@ -731,17 +1083,24 @@ namespace dmParticle
     {
         DM_PROFILE(Particle, "UpdateParticles");
 
-        // Step particle life, prune dead particles
-        uint32_t particle_count = emitter->m_Particles.Size();
+        // Step particle life
+        ParticleBuffer& particles = emitter->m_Particles;
+        float* time_left = particles.Stream(PARTICLE_STREAM_TIME_LEFT);
+        uint32_t particle_count = particles.Size();
+        dmSimd::Vec4f v_dt = dmSimd::Splat(dt);
+        for (uint32_t i = 0; i < particle_count; i += dmSimd::WIDTH)
+        {
+            dmSimd::Store(&time_left[i], dmSimd::Sub(dmSimd::Load(&time_left[i]), v_dt));
+        }
+
+        // Prune dead particles
         uint32_t j = 0;
         while (j < particle_count)
         {
-            Particle* p = &emitter->m_Particles[j];
-            p->SetTimeLeft(p->GetTimeLeft() - dt);
-            if (p->GetTimeLeft() < 0.0f)
+            if (time_left[j] < 0.0f)
             {
                 // TODO Handle death-action
-                emitter->m_Particles.EraseSwap(j);
+                EraseSwapParticle(&particles, j);
                 --particle_count;
             } else {
                 ++j;
@@ -749,7 +1108,7 @@ namespace dmParticle
         }
     }
 
-    static void SpawnParticle(dmArray<Particle>& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt);
+    static void SpawnParticle(ParticleBuffer& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt);
 
     static void UpdateEmitterState(Instance* instance, Emitter* emitter, EmitterPrototype* emitter_prototype, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
@@ -828,13 +1187,13 @@ namespace dmParticle
         return particle_count * vertices_per_particle;
     }
 
-    static void SpawnParticle(dmArray<Particle>& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt)
+    static void SpawnParticle(ParticleBuffer& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt)
     {
         DM_PROFILE(Particle, "Spawn");
 
-        uint32_t particle_count = particles.Size();
-        particles.SetSize(particle_count + 1);
-        Particle *particle = &particles[particle_count];
+        // The particle is set up as a record and then scattered to the streams
+        Particle spawned;
+        Particle* particle = &spawned;
         memset(particle, 0, sizeof(Particle));
 
         // TODO Handle birth-action
@@ -998,6 +1357,8 @@ namespace dmParticle
         particle->m_SourceStretchFactorY = emitter_properties[EMITTER_KEY_PARTICLE_STRETCH_FACTOR_Y];
         particle->m_StretchFactorY = particle->m_SourceStretchFactorY;
         particle->m_SourceAngularVelocity = emitter_properties[EMITTER_KEY_PARTICLE_ANGULAR_VELOCITY];
+
+        PushParticle(&particles, spawned);
     }
 
     static float unit_tex_coords[] =
@@ -1084,19 +1445,24 @@ namespace dmParticle
             height_factor *= 0.5f;
         }
 
+        const ParticleBuffer& particles = emitter->m_Particles;
+        const float* max_life_times = particles.m_Streams[PARTICLE_STREAM_MAX_LIFE_TIME];
+        const float* oo_max_life_times = particles.m_Streams[PARTICLE_STREAM_OO_MAX_LIFE_TIME];
+        const float* times_left = particles.m_Streams[PARTICLE_STREAM_TIME_LEFT];
+        const float* source_sizes = particles.m_Streams[PARTICLE_STREAM_SOURCE_SIZE];
+
         for (j = 0; j < particle_count && vertex_index + 6 <= max_vertex_count; j++)
         {
-            Particle* particle = &emitter->m_Particles[j];
             // Evaluate anim frame
             uint32_t tile = 0;
             Vector3 size;
             if (anim_playing)
             {
-                float anim_cursor = particle->GetMaxLifeTime() - particle->GetTimeLeft() - half_dt;
+                float anim_cursor = max_life_times[j] - times_left[j] - half_dt;
                 float anim_t = 0.0f;
                 if (anim_once) // stretch over particle life
                 {
-                    anim_t = anim_cursor * particle->GetooMaxLifeTime();
+                    anim_t = anim_cursor * oo_max_life_times[j];
                 }
                 else // use anim FPS
                 {
@@ -1110,7 +1476,7 @@ namespace dmParticle
                 if (anim_bwd)
                     tile = tile_count - tile - 1;
 
-                size = particle->GetScale();
+                size = particles.GetScale(j);
                 if(anim_auto_size)
                 {
                     const float* td = &tex_dims[(start_tile + tile) << 1];
@@ -1119,18 +1485,18 @@ namespace dmParticle
                 }
                 else
                 {
-                    size *= particle->GetSourceSize();
+                    size *= source_sizes[j];
                 }
             }
             else
             {
-                size = particle->GetScale() * particle->GetSourceSize();
+                size = particles.GetScale(j) * source_sizes[j];
             }
             tile += start_tile;
             float* tex_coord = &tex_coords[tile << 3];
 
-            particle_transform.SetTranslation(Vector3(particle->GetPosition()));
-            particle_transform.SetRotation(particle->GetRotation());
+            particle_transform.SetTranslation(Vector3(particles.GetPosition(j)));
+            particle_transform.SetRotation(particles.GetRotation(j));
             particle_transform.SetScale(size);
             particle_transform.SetRotation(emission_transform.GetRotation() * particle_transform.GetRotation());
             particle_transform.SetTranslation(Vector3(Apply(emission_transform, Point3(particle_transform.GetTranslation()))));
@@ -1155,7 +1521,7 @@ namespace dmParticle
             }
             const int* tex_lookup = &tex_coord_order[flip_flag * 6];
 
-            Vector4 c = particle->GetColor();
+            Vector4 c = particles.GetColor(j);
             c = Vector4(mulPerElem(c.getXYZ(), color.getXYZ()), c.getW() * color.getW());
 
             if (format == PARTICLE_GO)
@@ -1235,35 +1601,22 @@ namespace dmParticle
         return emitter->m_VertexCount;
     }
 
-    struct SortPred
-    {
-        inline bool operator () (const Particle& p1, const Particle& p2)
-        {
-            return p1.GetSortKey().m_Key < p2.GetSortKey().m_Key;
-        }
-
-    };
-
     void GenerateKeys(Emitter* emitter, float max_particle_life_time)
     {
-        dmArray<Particle>& particles = emitter->m_Particles;
+        ParticleBuffer& particles = emitter->m_Particles;
         uint32_t n = particles.Size();
+        const float* time_left = particles.Stream(PARTICLE_STREAM_TIME_LEFT);
+        uint64_t* keys = particles.m_SortKeys;
 
         float range = 1.0f / max_particle_life_time;
 
-        Particle* first = particles.Begin();
         for (uint32_t i = 0; i < n; ++i)
         {
-            Particle* p = &particles[i];
-            uint32_t index = p - first;
-
-            float life_time = (1.0f - p->GetTimeLeft() * range) * 65535;
+            float life_time = (1.0f - time_left[i] * range) * 65535;
             life_time = dmMath::Clamp(life_time, 0.0f, 65535.0f);
             uint16_t lt = (uint16_t) life_time;
-            SortKey key;
-            key.m_LifeTime = lt;
-            key.m_Index = index;
-            p->SetSortKey(key);
+            // Index is used to ensure stable sort
+            keys[i] = ((uint64_t)lt << 32) | i;
         }
     }
 
@@ -1271,7 +1624,31 @@ namespace dmParticle
     {
         DM_PROFILE(Particle, "Sort");
 
-        std::sort(emitter->m_Particles.Begin(), emitter->m_Particles.End(), SortPred());
+        ParticleBuffer& particles = emitter->m_Particles;
+        uint32_t n = particles.Size();
+        uint64_t* keys = particles.m_SortKeys;
+
+        // Particles are spawned in order of life time, so the buffer is mostly sorted already
+        uint32_t i = 1;
+        while (i < n && keys[i - 1] < keys[i])
+            ++i;
+        if (i >= n)
+            return;
+
+        std::sort(keys, keys + n);
+
+        // Reorder each stream through the scratch array
+        for (uint32_t s = 0; s < PARTICLE_STREAM_COUNT; ++s)
+        {
+            const float* src = particles.m_Streams[s];
+            float* dst = particles.m_Scratch;
+            for (uint32_t j = 0; j < n; ++j)
+            {
+                dst[j] = src[(uint32_t)keys[j]];
+            }
+            particles.m_Scratch = particles.m_Streams[s];
+            particles.m_Streams[s] = dst;
+        }
     }
 
 #define SAMPLE_PROP(segment, x, target)\
@@ -1280,6 +1657,31 @@ namespace dmParticle
         target = (x - s->m_X) * s->m_K + s->m_Y;\
     }\
 
+    // Same as SAMPLE_PROP, for four particles with individual segments
+    static inline dmSimd::Vec4f SampleProperty(const Property& property, const uint32_t segment_indices[dmSimd::WIDTH], dmSimd::Vec4f x)
+    {
+        float seg_x[dmSimd::WIDTH];
+        float seg_k[dmSimd::WIDTH];
+        float seg_y[dmSimd::WIDTH];
+        for (uint32_t i = 0; i < dmSimd::WIDTH; ++i)
+        {
+            const LinearSegment* s = &property.m_Segments[segment_indices[i]];
+            seg_x[i] = s->m_X;
+            seg_k[i] = s->m_K;
+            seg_y[i] = s->m_Y;
+        }
+        return dmSimd::MulAdd(dmSimd::Sub(x, dmSimd::LoadU(seg_x)), dmSimd::LoadU(seg_k), dmSimd::LoadU(seg_y));
+    }
+
+    // Relative life time [0,1] of a particle
+    static inline float ParticleLifeTime(const ParticleBuffer& particles, uint32_t i)
+    {
+        float max_life_time = particles.m_Streams[PARTICLE_STREAM_MAX_LIFE_TIME][i];
+        float time_left = particles.m_Streams[PARTICLE_STREAM_TIME_LEFT][i];
+        float oo_max_life_time = particles.m_Streams[PARTICLE_STREAM_OO_MAX_LIFE_TIME][i];
+        return dmMath::Select(-max_life_time, 0.0f, 1.0f - time_left * oo_max_life_time);
+    }
+
     void EvaluateEmitterProperties(Emitter* emitter, Property* emitter_properties, float duration, float properties[EMITTER_KEY_COUNT])
     {
         float x = dmMath::Select(-duration, 0.0f, emitter->m_Timer / duration);
@@ -1292,185 +1694,313 @@ namespace dmParticle
 
     void EvaluateParticleProperties(Emitter* emitter, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
-        float properties[PARTICLE_KEY_COUNT];
-        // TODO Optimize this
-        dmArray<Particle>& particles = emitter->m_Particles;
+        using namespace dmSimd;
+
+        ParticleBuffer& particles = emitter->m_Particles;
         uint32_t count = particles.Size();
-        for (uint32_t i = 0; i < count; ++i)
+        float* const* streams = particles.m_Streams;
+
+        const Vec4f zero = Zero();
+        const Vec4f one = Splat(1.0f);
+        const Vec4f sample_count = Splat((float)PROPERTY_SAMPLE_COUNT);
+        for (uint32_t i = 0; i < count; i += WIDTH)
         {
-            Particle* particle = &particles[i];
-            float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
-            uint32_t segment_index = dmMath::Min((uint32_t)(x * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
-
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_SCALE].m_Segments[segment_index], x, properties[PARTICLE_KEY_SCALE])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_RED].m_Segments[segment_index], x, properties[PARTICLE_KEY_RED])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_GREEN].m_Segments[segment_index], x, properties[PARTICLE_KEY_GREEN])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_BLUE].m_Segments[segment_index], x, properties[PARTICLE_KEY_BLUE])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_ALPHA].m_Segments[segment_index], x, properties[PARTICLE_KEY_ALPHA])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_X].m_Segments[segment_index], x, properties[PARTICLE_KEY_STRETCH_FACTOR_X])
-            SAMPLE_PROP(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_Y].m_Segments[segment_index], x, properties[PARTICLE_KEY_STRETCH_FACTOR_Y])
-            Vector4 c = particle->GetSourceColor();
-            particle->SetScale(Vector3(properties[PARTICLE_KEY_SCALE]));
-            particle->SetColor(Vector4(dmMath::Clamp(c.getX() * properties[PARTICLE_KEY_RED], 0.0f, 1.0f),
-                    dmMath::Clamp(c.getY() * properties[PARTICLE_KEY_GREEN], 0.0f, 1.0f),
-                    dmMath::Clamp(c.getZ() * properties[PARTICLE_KEY_BLUE], 0.0f, 1.0f),
-                    dmMath::Clamp(c.getW() * properties[PARTICLE_KEY_ALPHA], 0.0f, 1.0f)));
-            particle->m_StretchFactorX = particle->m_SourceStretchFactorX + (properties[PARTICLE_KEY_STRETCH_FACTOR_X]);
-            particle->m_StretchFactorY = particle->m_SourceStretchFactorY + (properties[PARTICLE_KEY_STRETCH_FACTOR_Y]);
+            Vec4f max_life_time = Load(&streams[PARTICLE_STREAM_MAX_LIFE_TIME][i]);
+            Vec4f life_time = Sub(one, Mul(Load(&streams[PARTICLE_STREAM_TIME_LEFT][i]), Load(&streams[PARTICLE_STREAM_OO_MAX_LIFE_TIME][i])));
+            Vec4f x = SelectGe(Sub(zero, max_life_time), zero, life_time);
+
+            int32_t segments[WIDTH];
+            StoreInt(segments, Mul(x, sample_count));
+            uint32_t segment_indices[WIDTH];
+            for (uint32_t j = 0; j < WIDTH; ++j)
+            {
+                segment_indices[j] = dmMath::Min((uint32_t)segments[j], PROPERTY_SAMPLE_COUNT - 1);
+            }
+
+            Vec4f scale = SampleProperty(particle_properties[PARTICLE_KEY_SCALE], segment_indices, x);
+            Store(&streams[PARTICLE_STREAM_SCALE_X][i], scale);
+            Store(&streams[PARTICLE_STREAM_SCALE_Y][i], scale);
+            Store(&streams[PARTICLE_STREAM_SCALE_Z][i], scale);
+
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                Vec4f prop = SampleProperty(particle_properties[PARTICLE_KEY_RED + c], segment_indices, x);
+                Vec4f color = Mul(Load(&streams[PARTICLE_STREAM_SOURCE_COLOR_R + c][i]), prop);
+                Store(&streams[PARTICLE_STREAM_COLOR_R + c][i], Clamp(color, zero, one));
+            }
+
+            Vec4f stretch_x = SampleProperty(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_X], segment_indices, x);
+            Vec4f stretch_y = SampleProperty(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_Y], segment_indices, x);
+            Store(&streams[PARTICLE_STREAM_STRETCH_FACTOR_X][i], Add(Load(&streams[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_X][i]), stretch_x));
+            Store(&streams[PARTICLE_STREAM_STRETCH_FACTOR_Y][i], Add(Load(&streams[PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_Y][i]), stretch_y));
         }
 
+        float property;
         if (emitter_ddf->m_ParticleOrientation == PARTICLE_ORIENTATION_MOVEMENT_DIRECTION) {
             for (uint32_t i = 0; i < count; ++i)
             {
-                Particle* particle = &particles[i];
-                float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
+                float x = ParticleLifeTime(particles, i);
                 uint32_t segment_index = dmMath::Min((uint32_t)(x * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
-                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ROTATION].m_Segments[segment_index], x, properties[PARTICLE_KEY_ROTATION])
-                particle->SetRotation(particle->GetSourceRotation() * dmVMath::QuatFromAngle(2, DEG_RAD * properties[PARTICLE_KEY_ROTATION]));
-                if (lengthSqr(particle->m_Velocity) > EPSILON)
+                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ROTATION].m_Segments[segment_index], x, property)
+                Quat rotation = particles.GetSourceRotation(i) * dmVMath::QuatFromAngle(2, DEG_RAD * property);
+                Vector3 velocity = particles.GetVelocity(i);
+                if (lengthSqr(velocity) > EPSILON)
                 {
-                    Vector3 vel_norm = normalize(particle->m_Velocity);
+                    Vector3 vel_norm = normalize(velocity);
                     float y_dot = dot(Vector3::yAxis(), vel_norm);
                     // Corner case, https://gamedev.stackexchange.com/questions/61672/align-a-rotation-to-a-direction
                     Quat q_vel = (dmMath::Abs(y_dot + 1.0f) > EPSILON) ? Quat::rotation(Vector3::yAxis(), vel_norm) : Quat(0.0, 0.0, 1.0, 0.0);
-                    Quat q = particle->GetRotation() * q_vel;
-                    particle->SetRotation(q);
+                    rotation = rotation * q_vel;
                 }
+                particles.SetRotation(i, rotation);
             }
 
         } else if (emitter_ddf->m_ParticleOrientation == PARTICLE_ORIENTATION_ANGULAR_VELOCITY) {
+            const float* angular_velocities = streams[PARTICLE_STREAM_SOURCE_ANGULAR_VELOCITY];
             for (uint32_t i = 0; i < count; ++i)
             {
-                Particle* particle = &particles[i];
-                float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
+                float x = ParticleLifeTime(particles, i);
                 uint32_t segment_index = dmMath::Min((uint32_t)(x * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
-                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ANGULAR_VELOCITY].m_Segments[segment_index], x, properties[PARTICLE_KEY_ANGULAR_VELOCITY])
-                particle->SetRotation(particle->GetRotation() * Quat::rotationZ(DEG_RAD * (particle->m_SourceAngularVelocity * (properties[PARTICLE_KEY_ANGULAR_VELOCITY])) * dt));
+                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ANGULAR_VELOCITY].m_Segments[segment_index], x, property)
+                particles.SetRotation(i, particles.GetRotation(i) * Quat::rotationZ(DEG_RAD * (angular_velocities[i] * (property)) * dt));
             }
 
         } else {
             for (uint32_t i = 0; i < count; ++i)
             {
-                Particle* particle = &particles[i];
-                float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
+                float x = ParticleLifeTime(particles, i);
                 uint32_t segment_index = dmMath::Min((uint32_t)(x * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
-                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ROTATION].m_Segments[segment_index], x, properties[PARTICLE_KEY_ROTATION])
-                particle->SetRotation(particle->GetSourceRotation() * dmVMath::QuatFromAngle(2, DEG_RAD * properties[PARTICLE_KEY_ROTATION]));
+                SAMPLE_PROP(particle_properties[PARTICLE_KEY_ROTATION].m_Segments[segment_index], x, property)
+                particles.SetRotation(i, particles.GetSourceRotation(i) * dmVMath::QuatFromAngle(2, DEG_RAD * property));
             }
         }
 
     }
 
-    void ApplyAcceleration(dmArray<Particle>& particles, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
+    // The modifiers below process four particles at a time, with the operations in the same order
+    // as the vector math library so the result is the same as when simulating one particle at a time.
+
+    void ApplyAcceleration(ParticleBuffer& particles, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
     {
+        using namespace dmSimd;
+
         uint32_t particle_count = particles.Size();
         Vector3 acc_step = rotate(rotation, ACCELERATION_LOCAL_DIR) * dt * scale;
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
-        float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
+
+        float* vx = particles.Stream(PARTICLE_STREAM_VELOCITY_X);
+        float* vy = particles.Stream(PARTICLE_STREAM_VELOCITY_Y);
+        float* vz = particles.Stream(PARTICLE_STREAM_VELOCITY_Z);
+        const float* spread = particles.Stream(PARTICLE_STREAM_SPREAD_FACTOR);
+        Vec4f acc_x = Splat(acc_step.getX());
+        Vec4f acc_y = Splat(acc_step.getY());
+        Vec4f acc_z = Splat(acc_step.getZ());
+        Vec4f mag = Splat(magnitude);
+        Vec4f mag_spread = Splat(magnitude_property.m_Spread);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
         {
-            Particle* particle = &particles[i];
-            particle->SetVelocity(particle->GetVelocity() + acc_step * (magnitude + mag_spread * particle->GetSpreadFactor()));
+            Vec4f a = MulAdd(mag_spread, Load(&spread[i]), mag);
+            Store(&vx[i], MulAdd(acc_x, a, Load(&vx[i])));
+            Store(&vy[i], MulAdd(acc_y, a, Load(&vy[i])));
+            Store(&vz[i], MulAdd(acc_z, a, Load(&vz[i])));
         }
     }
 
-    void ApplyDrag(dmArray<Particle>& particles, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
+    void ApplyDrag(ParticleBuffer& particles, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
     {
+        using namespace dmSimd;
+
         uint32_t particle_count = particles.Size();
         Vector3 direction = rotate(rotation, DRAG_LOCAL_DIR);
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
-        float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
-        {
-            Particle* particle = &particles[i];
-            Vector3 v = particle->GetVelocity();
-            if (modifier_ddf->m_UseDirection)
-                v = projection(Point3(particle->GetVelocity()), direction) * direction;
+
+        float* vx = particles.Stream(PARTICLE_STREAM_VELOCITY_X);
+        float* vy = particles.Stream(PARTICLE_STREAM_VELOCITY_Y);
+        float* vz = particles.Stream(PARTICLE_STREAM_VELOCITY_Z);
+        const float* spread = particles.Stream(PARTICLE_STREAM_SPREAD_FACTOR);
+        Vec4f dir_x = Splat(direction.getX());
+        Vec4f dir_y = Splat(direction.getY());
+        Vec4f dir_z = Splat(direction.getZ());
+        Vec4f mag = Splat(magnitude);
+        Vec4f mag_spread = Splat(magnitude_property.m_Spread);
+        Vec4f v_dt = Splat(dt);
+        Vec4f one = Splat(1.0f);
+        bool use_direction = modifier_ddf->m_UseDirection;
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
+        {
+            Vec4f x = Load(&vx[i]);
+            Vec4f y = Load(&vy[i]);
+            Vec4f z = Load(&vz[i]);
+            Vec4f drag_x = x;
+            Vec4f drag_y = y;
+            Vec4f drag_z = z;
+            if (use_direction)
+            {
+                Vec4f p = MulAdd(z, dir_z, MulAdd(y, dir_y, Mul(x, dir_x)));
+                drag_x = Mul(p, dir_x);
+                drag_y = Mul(p, dir_y);
+                drag_z = Mul(p, dir_z);
+            }
             // Applied drag > 1 means the particle would travel in the reverse direction
-            float applied_drag = dmMath::Min((magnitude + mag_spread * particle->GetSpreadFactor()) * dt, 1.0f);
-            particle->SetVelocity(particle->GetVelocity() - v * applied_drag);
+            Vec4f applied_drag = Min(Mul(MulAdd(mag_spread, Load(&spread[i]), mag), v_dt), one);
+            Store(&vx[i], Sub(x, Mul(drag_x, applied_drag)));
+            Store(&vy[i], Sub(y, Mul(drag_y, applied_drag)));
+            Store(&vz[i], Sub(z, Mul(drag_z, applied_drag)));
         }
     }
 
-    static Vector3 GetParticleDir(Particle* particle)
+    static Vector3 GetParticleDir(const ParticleBuffer& particles, uint32_t i)
     {
-        return rotate(particle->GetRotation(), PARTICLE_LOCAL_BASE_DIR);
+        return rotate(particles.GetRotation(i), PARTICLE_LOCAL_BASE_DIR);
     }
 
-    static Vector3 NonZeroVector3(Vector3 v, float sq_length, Vector3 fallback)
+    void ApplyRadial(ParticleBuffer& particles, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
     {
-        Vector3 result;
-        float neg_sq_length = -sq_length;
-        result.setX(dmMath::Select(neg_sq_length, fallback.getX(), v.getX()));
-        result.setY(dmMath::Select(neg_sq_length, fallback.getY(), v.getY()));
-        result.setZ(dmMath::Select(neg_sq_length, fallback.getZ(), v.getZ()));
-        return result;
-    }
+        using namespace dmSimd;
 
-    void ApplyRadial(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
-    {
         uint32_t particle_count = particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
-        float mag_spread = magnitude_property.m_Spread;
         // We temporarily only sample the first frame until we have decided what to animate over
         float max_distance = max_distance_property.m_Segments[0].m_Y * scale;
-        float max_sq_distance = max_distance * max_distance;
-        float applied_factor = dt * scale;
-        for (uint32_t i = 0; i < particle_count; ++i)
-        {
-            Particle* particle = &particles[i];
-            Vector3 delta = particle->GetPosition() - position;
-            float delta_sq_len = lengthSqr(delta);
-            float applied_magnitude = magnitude + mag_spread * particle->GetSpreadFactor();
+
+        const float* px = particles.Stream(PARTICLE_STREAM_POSITION_X);
+        const float* py = particles.Stream(PARTICLE_STREAM_POSITION_Y);
+        const float* pz = particles.Stream(PARTICLE_STREAM_POSITION_Z);
+        float* vx = particles.Stream(PARTICLE_STREAM_VELOCITY_X);
+        float* vy = particles.Stream(PARTICLE_STREAM_VELOCITY_Y);
+        float* vz = particles.Stream(PARTICLE_STREAM_VELOCITY_Z);
+        const float* spread = particles.Stream(PARTICLE_STREAM_SPREAD_FACTOR);
+        Vec4f pos_x = Splat(position.getX());
+        Vec4f pos_y = Splat(position.getY());
+        Vec4f pos_z = Splat(position.getZ());
+        Vec4f mag = Splat(magnitude);
+        Vec4f mag_spread = Splat(magnitude_property.m_Spread);
+        Vec4f max_sq_distance = Splat(max_distance * max_distance);
+        Vec4f applied_factor = Splat(dt * scale);
+        Vec4f zero = Zero();
+        Vec4f one = Splat(1.0f);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
+        {
+            Vec4f dx = Sub(Load(&px[i]), pos_x);
+            Vec4f dy = Sub(Load(&py[i]), pos_y);
+            Vec4f dz = Sub(Load(&pz[i]), pos_z);
+            Vec4f delta_sq_len = MulAdd(dz, dz, MulAdd(dy, dy, Mul(dx, dx)));
+            Vec4f applied_magnitude = MulAdd(mag_spread, Load(&spread[i]), mag);
             // 0 acc delta lies outside max dist
-            float a = dmMath::Select(max_sq_distance - delta_sq_len, applied_magnitude, 0.0f);
-            Vector3 dir = normalize(NonZeroVector3(delta, delta_sq_len, GetParticleDir(particle)));
-            particle->SetVelocity(particle->GetVelocity() + dir * a * applied_factor);
+            Vec4f a = SelectGe(Sub(max_sq_distance, delta_sq_len), applied_magnitude, zero);
+            Vec4f len_inv = Div(one, Sqrt(delta_sq_len));
+            Vec4f dir_x = Mul(dx, len_inv);
+            Vec4f dir_y = Mul(dy, len_inv);
+            Vec4f dir_z = Mul(dz, len_inv);
+
+            // Particles at the center are pushed along their own direction
+            uint32_t lane_count = dmMath::Min(particle_count - i, WIDTH);
+            uint32_t at_center = MaskBits(CmpGe(zero, delta_sq_len)) & ((1 << lane_count) - 1);
+            if (at_center)
+            {
+                float fx[WIDTH], fy[WIDTH], fz[WIDTH];
+                StoreU(fx, dir_x);
+                StoreU(fy, dir_y);
+                StoreU(fz, dir_z);
+                for (uint32_t j = 0; j < lane_count; ++j)
+                {
+                    if (at_center & (1 << j))
+                    {
+                        Vector3 dir = normalize(GetParticleDir(particles, i + j));
+                        fx[j] = dir.getX();
+                        fy[j] = dir.getY();
+                        fz[j] = dir.getZ();
+                    }
+                }
+                dir_x = LoadU(fx);
+                dir_y = LoadU(fy);
+                dir_z = LoadU(fz);
+            }
+
+            Store(&vx[i], MulAdd(Mul(dir_x, a), applied_factor, Load(&vx[i])));
+            Store(&vy[i], MulAdd(Mul(dir_y, a), applied_factor, Load(&vy[i])));
+            Store(&vz[i], MulAdd(Mul(dir_z, a), applied_factor, Load(&vz[i])));
         }
     }
 
-    void ApplyVortex(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
+    void ApplyVortex(ParticleBuffer& particles, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
     {
+        using namespace dmSimd;
+
         uint32_t particle_count = particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
-        float mag_spread = magnitude_property.m_Spread;
         // We temporarily only sample the first frame until we have decided what to animate over
         float max_distance = max_distance_property.m_Segments[0].m_Y * scale;
-        float max_sq_distance = max_distance * max_distance;
         Vector3 axis = rotate(rotation, VORTEX_LOCAL_AXIS);
         Vector3 start = rotate(rotation, VORTEX_LOCAL_START_DIR);
-        float applied_factor = dt * scale;
-        for (uint32_t i = 0; i < particle_count; ++i)
+
+        const float* px = particles.Stream(PARTICLE_STREAM_POSITION_X);
+        const float* py = particles.Stream(PARTICLE_STREAM_POSITION_Y);
+        const float* pz = particles.Stream(PARTICLE_STREAM_POSITION_Z);
+        float* vx = particles.Stream(PARTICLE_STREAM_VELOCITY_X);
+        float* vy = particles.Stream(PARTICLE_STREAM_VELOCITY_Y);
+        float* vz = particles.Stream(PARTICLE_STREAM_VELOCITY_Z);
+        const float* spread = particles.Stream(PARTICLE_STREAM_SPREAD_FACTOR);
+        Vec4f pos_x = Splat(position.getX());
+        Vec4f pos_y = Splat(position.getY());
+        Vec4f pos_z = Splat(position.getZ());
+        Vec4f axis_x = Splat(axis.getX());
+        Vec4f axis_y = Splat(axis.getY());
+        Vec4f axis_z = Splat(axis.getZ());
+        Vec4f start_x = Splat(start.getX());
+        Vec4f start_y = Splat(start.getY());
+        Vec4f start_z = Splat(start.getZ());
+        Vec4f mag = Splat(magnitude);
+        Vec4f mag_spread = Splat(magnitude_property.m_Spread);
+        Vec4f max_sq_distance = Splat(max_distance * max_distance);
+        Vec4f applied_factor = Splat(dt * scale);
+        Vec4f zero = Zero();
+        Vec4f one = Splat(1.0f);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
         {
-            Particle* particle = &particles[i];
             // delta from vortex position
-            Vector3 delta = particle->GetPosition() - position;
+            Vec4f dx = Sub(Load(&px[i]), pos_x);
+            Vec4f dy = Sub(Load(&py[i]), pos_y);
+            Vec4f dz = Sub(Load(&pz[i]), pos_z);
             // normal from vortex axis (non-unit)
-            Vector3 normal = delta - projection(Point3(delta), axis) * axis;
+            Vec4f p = MulAdd(dz, axis_z, MulAdd(dy, axis_y, Mul(dx, axis_x)));
+            Vec4f nx = Sub(dx, Mul(p, axis_x));
+            Vec4f ny = Sub(dy, Mul(p, axis_y));
+            Vec4f nz = Sub(dz, Mul(p, axis_z));
             // tangent is the direction of the vortex acceleration
-            Vector3 tangent = cross(axis, normal);
+            Vec4f tx = Sub(Mul(axis_y, nz), Mul(axis_z, ny));
+            Vec4f ty = Sub(Mul(axis_z, nx), Mul(axis_x, nz));
+            Vec4f tz = Sub(Mul(axis_x, ny), Mul(axis_y, nx));
             // In case the particle is directed along the axis, give it a guaranteed orthogonal start
-            tangent = NonZeroVector3(tangent, lengthSqr(tangent), start);
+            Mask4 along_axis = CmpGe(zero, MulAdd(tz, tz, MulAdd(ty, ty, Mul(tx, tx))));
+            tx = Select(along_axis, start_x, tx);
+            ty = Select(along_axis, start_y, ty);
+            tz = Select(along_axis, start_z, tz);
             // tangent is now guaranteed to be non-zero
-            tangent = normalize(tangent);
+            Vec4f len_inv = Div(one, Sqrt(MulAdd(tz, tz, MulAdd(ty, ty, Mul(tx, tx)))));
+            tx = Mul(tx, len_inv);
+            ty = Mul(ty, len_inv);
+            tz = Mul(tz, len_inv);
             // use normal for max distance test
-            float normal_sq_len = lengthSqr(normal);
-            float acceleration = dmMath::Select(max_sq_distance - normal_sq_len, magnitude + mag_spread * particle->GetSpreadFactor(), 0.0f);
-            particle->SetVelocity(particle->GetVelocity() + tangent * acceleration * applied_factor);
+            Vec4f normal_sq_len = MulAdd(nz, nz, MulAdd(ny, ny, Mul(nx, nx)));
+            Vec4f acceleration = SelectGe(Sub(max_sq_distance, normal_sq_len), MulAdd(mag_spread, Load(&spread[i]), mag), zero);
+            Store(&vx[i], MulAdd(Mul(tx, acceleration), applied_factor, Load(&vx[i])));
+            Store(&vy[i], MulAdd(Mul(ty, acceleration), applied_factor, Load(&vy[i])));
+            Store(&vz[i], MulAdd(Mul(tz, acceleration), applied_factor, Load(&vz[i])));
         }
     }
 
@@ -1499,7 +2029,7 @@ namespace dmParticle
     {
         DM_PROFILE(Particle, "Simulate");
 
-        dmArray<Particle>& particles = emitter->m_Particles;
+        ParticleBuffer& particles = emitter->m_Particles;
         EvaluateParticleProperties(emitter, prototype->m_ParticleProperties, ddf, dt);
         float emitter_t = dmMath::Select(-ddf->m_Duration, 0.0f, emitter->m_Timer / ddf->m_Duration);
         float scale = 1.0f;
@@ -1541,18 +2071,32 @@ namespace dmParticle
             }
         }
         uint32_t particle_count = particles.Size();
-        for (uint32_t i = 0; i < particle_count; ++i)
-        {
-            Particle* p = &particles[i];
+        float* const* s = particles.m_Streams;
+        dmSimd::Vec4f v_dt = dmSimd::Splat(dt);
+        dmSimd::Vec4f stretch_scaling = dmSimd::Splat(STRETCH_SCALING);
+        bool stretch_with_velocity = ddf->m_StretchWithVelocity;
+        for (uint32_t i = 0; i < particle_count; i += dmSimd::WIDTH)
+        {
+            using namespace dmSimd;
+            Vec4f vx = Load(&s[PARTICLE_STREAM_VELOCITY_X][i]);
+            Vec4f vy = Load(&s[PARTICLE_STREAM_VELOCITY_Y][i]);
+            Vec4f vz = Load(&s[PARTICLE_STREAM_VELOCITY_Z][i]);
             // NOTE This velocity integration has a larger error than normal since we don't use the velocity at the
             // beginning of the frame, but it's ok since particle movement does not need to be very exact
-            p->SetPosition(p->GetPosition() + p->m_Velocity * dt);
-
-            p->m_Scale[0] += p->m_Scale[0] * p->m_StretchFactorX;
-            if (!ddf->m_StretchWithVelocity)
-                p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY;
-            else
-                p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY * length(p->m_Velocity) * STRETCH_SCALING;
+            Store(&s[PARTICLE_STREAM_POSITION_X][i], MulAdd(vx, v_dt, Load(&s[PARTICLE_STREAM_POSITION_X][i])));
+            Store(&s[PARTICLE_STREAM_POSITION_Y][i], MulAdd(vy, v_dt, Load(&s[PARTICLE_STREAM_POSITION_Y][i])));
+            Store(&s[PARTICLE_STREAM_POSITION_Z][i], MulAdd(vz, v_dt, Load(&s[PARTICLE_STREAM_POSITION_Z][i])));
+
+            Vec4f scale_x = Load(&s[PARTICLE_STREAM_SCALE_X][i]);
+            Store(&s[PARTICLE_STREAM_SCALE_X][i], MulAdd(scale_x, Load(&s[PARTICLE_STREAM_STRETCH_FACTOR_X][i]), scale_x));
+            Vec4f scale_y = Load(&s[PARTICLE_STREAM_SCALE_Y][i]);
+            Vec4f stretch_y = Mul(scale_y, Load(&s[PARTICLE_STREAM_STRETCH_FACTOR_Y][i]));
+            if (stretch_with_velocity)
+            {
+                Vec4f speed = Sqrt(MulAdd(vz, vz, MulAdd(vy, vy, Mul(vx, vx))));
+                stretch_y = Mul(Mul(stretch_y, speed), stretch_scaling);
+            }
+            Store(&s[PARTICLE_STREAM_SCALE_Y][i], Add(scale_y, stretch_y));
         }
     }
 
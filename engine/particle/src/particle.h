@@ -13,9 +13,10 @@
 #ifndef DM_PARTICLE_H
 #define DM_PARTICLE_H
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include <dlib/configfile.h>
 #include <dlib/hash.h>
+#include <dlib/job_system.h>
 #include <ddf/ddf.h>
 #include "particle/particle_ddf.h"
 
@@ -235,6 +236,30 @@ namespace dmParticle
     // For tests
     Vector3 GetPosition(HParticleContext context, HInstance instance);
 
+    /**
+     * Set the job system context used to simulate the emitters, and generate their vertex data, on several threads.
+     * If no context is set, everything is done on the calling thread. The result is the same in both cases,
+     * except that the emitter state changed callbacks are called after all emitters have been simulated.
+     * @param context Particle context
+     * @param job_context Job system context, or 0x0
+     */
+    void SetJobContext(HParticleContext context, dmJobSystem::HContext job_context);
+
+    /**
+     * Generates vertex data for several emitters, with the same result as calling GenerateVertexData for
+     * each emitter in order. The vertex range of each emitter is reserved up front, so the emitters can
+     * be processed in parallel when a job context is set. An emitter must not occur more than once.
+     * @param context Particle context
+     * @param dt Time step.
+     * @param emitters Render data of the emitters, see GetEmitterRenderData
+     * @param emitter_count Number of emitters
+     * @param vertex_buffer Vertex buffer into which to store the particle vertex data. If this is 0x0, no data will be generated.
+     * @param vertex_buffer_size Size in bytes of the supplied vertex buffer.
+     * @param out_vertex_buffer_size Size in bytes of the total data written to vertex buffer.
+     * @param vertex_format Which vertex format to use
+     */
+    void GenerateVertexData(HParticleContext context, float dt, const EmitterRenderData* const* emitters, uint32_t emitter_count, const Vector4& color, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format);
+
 #define DM_PARTICLE_PROTO(ret, name,  ...) \
     \
     ret name(__VA_ARGS__);\
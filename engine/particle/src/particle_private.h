@@ -24,26 +24,18 @@ namespace dmParticle
 {
     /// Number of samples per property (spline => linear segments)
     static const uint32_t PROPERTY_SAMPLE_COUNT     = 64;
+    /// Max number of state changes of an emitter in one update (prespawn -> spawning -> postspawn -> sleeping)
+    static const uint32_t MAX_DEFERRED_STATE_COUNT  = 3;
 
     struct EmitterPrototype;
     struct Prototype;
 
-    /**
-     * Key when sorting particles, based on life time with additional index for stable sort
-     */
-    union SortKey
-    {
-        struct
-        {
-            uint32_t m_Index : 16;  // Index is used to ensure stable sort
-            uint32_t m_LifeTime : 16; // Quantified relative life time
-        };
-        uint32_t     m_Key;
-    };
-
     /**
      * Representation of a particle.
      *
+     * The particles of an emitter are stored per attribute in a ParticleBuffer, this is the
+     * record used when spawning a particle or reading one back.
+     *
      * TODO Separate source state from current (chaining modifiers)
      */
     struct Particle
@@ -64,7 +56,6 @@ namespace dmParticle
         GET_SET(Scale, Vector3)
         GET_SET(SourceColor, Vector4)
         GET_SET(Color, Vector4)
-        GET_SET(SortKey, SortKey)
 #undef GET_SET
 
         /// Position, which is defined in emitter space or world space depending on how the emitter which spawned the particles is tweaked.
@@ -92,8 +83,6 @@ namespace dmParticle
         Vector4     m_Color;
         /// Particle scale
         Vector3     m_Scale;
-        // Sorting
-        SortKey     m_SortKey;
         /// Particle stretch factor
         float       m_StretchFactorX;
         float       m_StretchFactorY;
@@ -101,6 +90,102 @@ namespace dmParticle
         float       m_SourceAngularVelocity;
     };
 
+    /**
+     * The particle attributes, each stored in its own array in a ParticleBuffer.
+     */
+    enum ParticleStream
+    {
+        PARTICLE_STREAM_POSITION_X,
+        PARTICLE_STREAM_POSITION_Y,
+        PARTICLE_STREAM_POSITION_Z,
+        PARTICLE_STREAM_VELOCITY_X,
+        PARTICLE_STREAM_VELOCITY_Y,
+        PARTICLE_STREAM_VELOCITY_Z,
+        PARTICLE_STREAM_SOURCE_ROTATION_X,
+        PARTICLE_STREAM_SOURCE_ROTATION_Y,
+        PARTICLE_STREAM_SOURCE_ROTATION_Z,
+        PARTICLE_STREAM_SOURCE_ROTATION_W,
+        PARTICLE_STREAM_ROTATION_X,
+        PARTICLE_STREAM_ROTATION_Y,
+        PARTICLE_STREAM_ROTATION_Z,
+        PARTICLE_STREAM_ROTATION_W,
+        PARTICLE_STREAM_SCALE_X,
+        PARTICLE_STREAM_SCALE_Y,
+        PARTICLE_STREAM_SCALE_Z,
+        PARTICLE_STREAM_SOURCE_COLOR_R,
+        PARTICLE_STREAM_SOURCE_COLOR_G,
+        PARTICLE_STREAM_SOURCE_COLOR_B,
+        PARTICLE_STREAM_SOURCE_COLOR_A,
+        PARTICLE_STREAM_COLOR_R,
+        PARTICLE_STREAM_COLOR_G,
+        PARTICLE_STREAM_COLOR_B,
+        PARTICLE_STREAM_COLOR_A,
+        PARTICLE_STREAM_TIME_LEFT,
+        PARTICLE_STREAM_MAX_LIFE_TIME,
+        PARTICLE_STREAM_OO_MAX_LIFE_TIME,
+        PARTICLE_STREAM_SPREAD_FACTOR,
+        PARTICLE_STREAM_SOURCE_SIZE,
+        PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_X,
+        PARTICLE_STREAM_SOURCE_STRETCH_FACTOR_Y,
+        PARTICLE_STREAM_STRETCH_FACTOR_X,
+        PARTICLE_STREAM_STRETCH_FACTOR_Y,
+        PARTICLE_STREAM_SOURCE_ANGULAR_VELOCITY,
+        PARTICLE_STREAM_COUNT
+    };
+
+    /**
+     * Particle storage of an emitter, as a structure of arrays.
+     *
+     * The arrays are 16 byte aligned and have room for the capacity rounded up to dmSimd::WIDTH,
+     * so the simulation kernels can process whole vectors past the last particle.
+     * The values past the last particle are undefined and never read back.
+     * A zeroed buffer is empty, the memory is released with SetCapacity(buffer, 0).
+     */
+    struct ParticleBuffer
+    {
+        inline uint32_t Size() const        { return m_Size; }
+        inline uint32_t Capacity() const    { return m_Capacity; }
+        inline uint32_t Remaining() const   { return m_Capacity - m_Size; }
+        inline bool     Empty() const       { return m_Size == 0; }
+
+        inline float*   Stream(ParticleStream stream) const { return m_Streams[stream]; }
+
+#define STREAM(stream, index) m_Streams[PARTICLE_STREAM_##stream][index]
+        inline Point3 GetPosition(uint32_t i) const { return Point3(STREAM(POSITION_X, i), STREAM(POSITION_Y, i), STREAM(POSITION_Z, i)); }
+        inline Vector3 GetVelocity(uint32_t i) const { return Vector3(STREAM(VELOCITY_X, i), STREAM(VELOCITY_Y, i), STREAM(VELOCITY_Z, i)); }
+        inline Vector3 GetScale(uint32_t i) const { return Vector3(STREAM(SCALE_X, i), STREAM(SCALE_Y, i), STREAM(SCALE_Z, i)); }
+        inline Vector4 GetColor(uint32_t i) const { return Vector4(STREAM(COLOR_R, i), STREAM(COLOR_G, i), STREAM(COLOR_B, i), STREAM(COLOR_A, i)); }
+        inline Quat GetSourceRotation(uint32_t i) const { return Quat(STREAM(SOURCE_ROTATION_X, i), STREAM(SOURCE_ROTATION_Y, i), STREAM(SOURCE_ROTATION_Z, i), STREAM(SOURCE_ROTATION_W, i)); }
+        inline Quat GetRotation(uint32_t i) const { return Quat(STREAM(ROTATION_X, i), STREAM(ROTATION_Y, i), STREAM(ROTATION_Z, i), STREAM(ROTATION_W, i)); }
+        inline void SetRotation(uint32_t i, const Quat& q)
+        {
+            STREAM(ROTATION_X, i) = q.getX();
+            STREAM(ROTATION_Y, i) = q.getY();
+            STREAM(ROTATION_Z, i) = q.getZ();
+            STREAM(ROTATION_W, i) = q.getW();
+        }
+#undef STREAM
+
+        /// One array per ParticleStream
+        float*      m_Streams[PARTICLE_STREAM_COUNT];
+        /// Spare array, swapped with the streams when they are reordered
+        float*      m_Scratch;
+        /// Sort keys, relative life time in the upper 32 bits and particle index in the lower
+        uint64_t*   m_SortKeys;
+        void*       m_Memory;
+        uint32_t    m_Size;
+        uint32_t    m_Capacity;
+    };
+
+    /// Change the capacity of the buffer, keeping as many of the existing particles as fit
+    void SetCapacity(ParticleBuffer* buffer, uint32_t capacity);
+    /// Add a particle at the end of the buffer, which must not be full
+    void PushParticle(ParticleBuffer* buffer, const Particle& particle);
+    /// Remove a particle by moving the last particle into its place
+    void EraseSwapParticle(ParticleBuffer* buffer, uint32_t index);
+    /// Read back a particle from the buffer
+    void GetParticle(const ParticleBuffer* buffer, uint32_t index, Particle* particle);
+
     /**
      * Representation of an emitter.
      */
@@ -113,7 +198,7 @@ namespace dmParticle
 
         AnimationData           m_AnimationData;
         /// Particle buffer.
-        dmArray<Particle>       m_Particles;
+        ParticleBuffer          m_Particles;
         dmArray<RenderConstant> m_RenderConstants;
         Vector3                 m_Velocity;
         Point3                  m_LastPosition;
@@ -132,6 +217,9 @@ namespace dmParticle
         uint32_t                m_Seed;
         /// Which state the emitter is currently in
         EmitterState            m_State;
+        /// State changes made while the emitter was updated on a worker thread, reported after the update
+        EmitterState            m_DeferredStates[MAX_DEFERRED_STATE_COUNT];
+        uint32_t                m_DeferredStateCount;
         /// Duration with spread applied, calculated on emitter creation.
         float                   m_Duration;
         /// Start delay with spread applied, calculated on emitter creation.
@@ -147,6 +235,8 @@ namespace dmParticle
         uint16_t                m_Retiring : 1;
         /// If this emitter needs to be rehashed
         uint16_t                m_ReHash : 1;
+        /// If state changes should be stored in m_DeferredStates instead of being reported directly
+        uint16_t                m_DeferStateChanges : 1;
     };
 
     struct Instance
@@ -181,6 +271,18 @@ namespace dmParticle
         uint16_t                m_ScaleAlongZ : 1;
     };
 
+    /**
+     * An emitter of an instance, the unit of work when a context is processed on several threads.
+     */
+    struct EmitterWorkItem
+    {
+        Instance*   m_Instance;
+        HInstance   m_InstanceHandle;
+        uint32_t    m_EmitterIndex;
+        /// First vertex of the emitter when generating vertex data
+        uint32_t    m_VertexIndex;
+    };
+
     /**
      * Representation of a context to hold a set of emitters.
      */
@@ -190,6 +292,7 @@ namespace dmParticle
         : m_MaxParticleCount(max_particle_count)
         , m_NextVersionNumber(1)
         , m_InstanceSeeding(0)
+        , m_JobContext(0)
         {
             memset(&m_Stats, 0, sizeof(m_Stats));
             m_Instances.SetCapacity(max_instance_count);
@@ -218,6 +321,10 @@ namespace dmParticle
         uint16_t            m_InstanceSeeding;
         /// Stats
         Stats               m_Stats;
+        /// Job system used to process the emitters on several threads, may be 0x0
+        dmJobSystem::HContext m_JobContext;
+        /// Scratch buffer for the emitters processed by the jobs
+        dmArray<EmitterWorkItem> m_WorkItems;
     };
 
     struct LinearSegment
@@ -15,8 +15,10 @@
 #include <stdio.h>
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include <dlib/dstrings.h>
+#include <dlib/job_system.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/vmath.h>
@@ -168,6 +170,19 @@ uint32_t ParticleCount(dmParticle::Emitter* emitter)
     return emitter->m_Particles.Size();
 }
 
+dmParticle::Particle ParticleAt(dmParticle::Emitter* emitter, uint32_t index)
+{
+    dmParticle::Particle particle;
+    dmParticle::GetParticle(&emitter->m_Particles, index, &particle);
+    return particle;
+}
+
+float ParticleSize(dmParticle::Emitter* emitter, uint32_t index)
+{
+    dmParticle::Particle particle = ParticleAt(emitter, index);
+    return minElem(particle.GetScale()) * particle.GetSourceSize();
+}
+
 bool LoadPrototype(const char* filename, dmParticle::HPrototype* prototype)
 {
     char path[128];
@@ -703,8 +718,8 @@ TEST_F(ParticleTest, EmissionSpace)
     dmParticle::Update(m_Context, dt, 0x0);
 
     dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
-    dmParticle::Particle* p = &e->m_Particles[0];
-    ASSERT_EQ(10.0f, p->GetPosition().getX());
+    dmParticle::Particle p = ParticleAt(e, 0);
+    ASSERT_EQ(10.0f, p.GetPosition().getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
     dmParticle::Particle_DeletePrototype(m_Prototype);
@@ -720,8 +735,8 @@ TEST_F(ParticleTest, EmissionSpace)
     dmParticle::Update(m_Context, dt, 0x0);
 
     e = GetEmitter(m_Context, instance, 0);
-    p = &e->m_Particles[0];
-    ASSERT_EQ(0.0f, p->GetPosition().getX());
+    p = ParticleAt(e, 0);
+    ASSERT_EQ(0.0f, p.GetPosition().getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -750,7 +765,7 @@ TEST_F(ParticleTest, ParticleLife)
 
     dmParticle::Update(m_Context, dt, 0x0);
 
-    ASSERT_EQ(0.0f, e->m_Particles[0].GetTimeLeft());
+    ASSERT_EQ(0.0f, ParticleAt(e, 0).GetTimeLeft());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -797,10 +812,10 @@ TEST_F(ParticleTest, ParticleVelocityStretch)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(3.5f, e->m_Particles[0].m_Scale[1], EPSILON);
+    ASSERT_NEAR(3.5f, ParticleAt(e, 0).m_Scale[1], EPSILON);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(1.0f, e->m_Particles[0].m_Scale[1], EPSILON);
+    ASSERT_NEAR(1.0f, ParticleAt(e, 0).m_Scale[1], EPSILON);
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -819,12 +834,12 @@ TEST_F(ParticleTest, ParticleStretch)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(2.f, e->m_Particles[0].m_Scale[0], EPSILON);
-    ASSERT_NEAR(4.f, e->m_Particles[0].m_Scale[1], EPSILON);
+    ASSERT_NEAR(2.f, ParticleAt(e, 0).m_Scale[0], EPSILON);
+    ASSERT_NEAR(4.f, ParticleAt(e, 0).m_Scale[1], EPSILON);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(2.f, e->m_Particles[0].m_Scale[0], EPSILON);
-    ASSERT_NEAR(2.f, e->m_Particles[0].m_Scale[1], EPSILON);
+    ASSERT_NEAR(2.f, ParticleAt(e, 0).m_Scale[0], EPSILON);
+    ASSERT_NEAR(2.f, ParticleAt(e, 0).m_Scale[1], EPSILON);
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -844,7 +859,7 @@ TEST_F(ParticleTest, ParticleOrientationMovementDirection)
 
     dmParticle::Update(m_Context, dt, 0x0);
 
-    Quat q = e->m_Particles[0].GetRotation();
+    Quat q = ParticleAt(e, 0).GetRotation();
 
     // Represents an euler rotation of 90 deg around Z
     ASSERT_EQ(0.0f, q.getX());
@@ -871,7 +886,7 @@ TEST_F(ParticleTest, ParticleApplyLifeRotationToMovementDirection)
 
     dmParticle::Update(m_Context, dt, 0x0);
 
-    Quat q = e->m_Particles[0].GetRotation();
+    Quat q = ParticleAt(e, 0).GetRotation();
 
     // Represents an euler rotation of 90deg particle life rotation combined with 90deg rotation along direction
     ASSERT_EQ(0.0f, q.getX());
@@ -904,7 +919,7 @@ TEST_F(ParticleTest, ParticleMovementDirection)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    Quat q = e->m_Particles[0].GetRotation();
+    Quat q = ParticleAt(e, 0).GetRotation();
 
     ASSERT_EQ(0.0f, q.getX());
     ASSERT_EQ(0.0f, q.getY());
@@ -912,7 +927,7 @@ TEST_F(ParticleTest, ParticleMovementDirection)
     ASSERT_NEAR(0.70710677, q.getW(), EPSILON);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    q = e->m_Particles[0].GetRotation();
+    q = ParticleAt(e, 0).GetRotation();
 
     ASSERT_EQ(0.0f, q.getX());
     ASSERT_EQ(0.0f, q.getY());
@@ -937,7 +952,7 @@ TEST_F(ParticleTest, ParticleAngularVelocity)
 
     dmParticle::Update(m_Context, dt, 0x0);
 
-    Quat q = e->m_Particles[0].GetRotation();
+    Quat q = ParticleAt(e, 0).GetRotation();
 
     Vector3 r = dmVMath::QuatToEuler(q.getX(), q.getY(), q.getZ(), q.getW());
     ASSERT_EQ(0.0f, r.getX());
@@ -945,7 +960,7 @@ TEST_F(ParticleTest, ParticleAngularVelocity)
     ASSERT_EQ(90.0f, r.getZ());
 
     dmParticle::Update(m_Context, dt, 0x0);
-    q = e->m_Particles[0].GetRotation();
+    q = ParticleAt(e, 0).GetRotation();
 
     r = dmVMath::QuatToEuler(q.getX(), q.getY(), q.getZ(), q.getW());
     ASSERT_EQ(0.0f, r.getX());
@@ -970,7 +985,7 @@ TEST_F(ParticleTest, ParticleAngularVelocityInitialRotation)
 
     dmParticle::Update(m_Context, dt, 0x0);
 
-    Quat q = e->m_Particles[0].GetRotation();
+    Quat q = ParticleAt(e, 0).GetRotation();
 
     Vector3 r = dmVMath::QuatToEuler(q.getX(), q.getY(), q.getZ(), q.getW());
     ASSERT_EQ(0.0f, r.getX());
@@ -978,7 +993,7 @@ TEST_F(ParticleTest, ParticleAngularVelocityInitialRotation)
     ASSERT_EQ(0.0f, r.getZ());
 
     dmParticle::Update(m_Context, dt, 0x0);
-    q = e->m_Particles[0].GetRotation();
+    q = ParticleAt(e, 0).GetRotation();
 
     r = dmVMath::QuatToEuler(q.getX(), q.getY(), q.getZ(), q.getW());
     ASSERT_EQ(0.0f, r.getX());
@@ -1154,36 +1169,35 @@ TEST_F(ParticleTest, EvaluateEmitterProperty)
 
     // t = 0.125, size < 0
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &e->m_Particles[0];
-    ASSERT_GT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_GT(0.0f, ParticleSize(e, 0));
 
     // t = 0.25, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(0.0f, ParticleSize(e, 0));
 
     // t = 0.375, size > 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_LT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_LT(0.0f, ParticleSize(e, 0));
 
     // t = 0.5, size = 1
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(1.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(1.0f, ParticleSize(e, 0));
 
     // t = 0.625, size > 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_LT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_LT(0.0f, ParticleSize(e, 0));
 
     // t = 0.75, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(0.0f, ParticleSize(e, 0));
 
     // t = 0.875, size < 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_GT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_GT(0.0f, ParticleSize(e, 0));
 
     // t = 1, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize(), EPSILON);
+    ASSERT_NEAR(0.0f, ParticleSize(e, 0), EPSILON);
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1205,10 +1219,9 @@ TEST_F(ParticleTest, EvaluateEmitterPropertySpread)
         dmParticle::StartInstance(m_Context, instance);
 
         dmParticle::Update(m_Context, dt, 0x0);
-        dmParticle::Particle* particle = &emitter->m_Particles[0];
         // NOTE size could potentially be 0, but not likely
-        ASSERT_NE(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
-        ASSERT_GE(1.0f, dmMath::Abs(minElem(particle->GetScale()) * particle->GetSourceSize()));
+        ASSERT_NE(0.0f, ParticleSize(emitter, 0));
+        ASSERT_GE(1.0f, dmMath::Abs(ParticleSize(emitter, 0)));
 
         dmParticle::DestroyInstance(m_Context, instance);
     }
@@ -1237,37 +1250,36 @@ TEST_F(ParticleTest, EvaluateParticleProperty)
 
     // t = 0.125, size < 0
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &e->m_Particles[0];
-    ASSERT_GT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_GT(0.0f, ParticleSize(e, 0));
 
     // t = 0.25, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(0.0f, ParticleSize(e, 0));
 
     // t = 0.375, size > 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_LT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_LT(0.0f, ParticleSize(e, 0));
 
     // t = 0.5, size = 1
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(1.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(1.0f, ParticleSize(e, 0));
 
     // t = 0.625, size > 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_LT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_LT(0.0f, ParticleSize(e, 0));
 
     // t = 0.75, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_EQ(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_EQ(0.0f, ParticleSize(e, 0));
 
     // t = 0.875, size < 0
     // Updating with a full dt here will make the emitter reach its duration
     dmParticle::Update(m_Context, dt - EPSILON, 0x0);
-    ASSERT_GT(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize());
+    ASSERT_GT(0.0f, ParticleSize(e, 0));
 
     // t = 1, size = 0
     dmParticle::Update(m_Context, dt, 0x0);
-    ASSERT_NEAR(0.0f, minElem(particle->GetScale()) * particle->GetSourceSize(), EPSILON);
+    ASSERT_NEAR(0.0f, ParticleSize(e, 0), EPSILON);
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1288,8 +1300,7 @@ TEST_F(ParticleTest, ParticleInstanceScale)
     dmParticle::Update(m_Context, dt, 0x0);
 
     dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
-    dmParticle::Particle* p = &e->m_Particles[0];
-    ASSERT_EQ(2.0f, minElem(p->GetScale()) * p->GetSourceSize());
+    ASSERT_EQ(2.0f, ParticleSize(e, 0));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1475,34 +1486,33 @@ TEST_F(ParticleTest, StableSort)
     ASSERT_EQ(particle_count, i->m_Emitters[0].m_Particles.Size());
 
     float x[particle_count];
-    dmParticle::Particle* p = &i->m_Emitters[0].m_Particles[0];
+    dmParticle::ParticleBuffer& particles = i->m_Emitters[0].m_Particles;
+    float* position_x = particles.Stream(dmParticle::PARTICLE_STREAM_POSITION_X);
+    float* time_left = particles.Stream(dmParticle::PARTICLE_STREAM_TIME_LEFT);
     // Store x-positions
     for (uint32_t pi = 0; pi < particle_count; ++pi)
     {
         float f = (float)pi + 1;
         x[pi] = f;
-        Point3 pos = p[pi].GetPosition();
-        pos.setX(f);
-        p[pi].SetPosition(pos);
+        position_x[pi] = f;
     }
     // Disturb order by altering a few particles
     const uint32_t disturb_count = particle_count / 2;
     for (uint32_t d = 0; d < disturb_count; ++d)
     {
-        p[d].SetTimeLeft(p[d].GetTimeLeft() - dt);
+        time_left[d] -= dt;
         x[d] += particle_count;
-        Point3 pos = p[d].GetPosition();
-        pos.setX(x[d]);
-        p[d].SetPosition(pos);
+        position_x[d] = x[d];
     }
     // Sort
     dmParticle::Update(m_Context, dt, 0x0);
     // Sort verification
     std::sort(x, x+particle_count);
-    // Verify order of undisturbed
+    // Verify order of undisturbed, the streams are swapped when sorted
+    position_x = particles.Stream(dmParticle::PARTICLE_STREAM_POSITION_X);
     for (uint32_t pi = 0; pi < particle_count; ++pi)
     {
-        ASSERT_EQ(x[pi], p[pi].GetPosition().getX());
+        ASSERT_EQ(x[pi], position_x[pi]);
     }
 
     dmParticle::DestroyInstance(m_Context, instance);
@@ -1534,8 +1544,7 @@ TEST_F(ParticleTest, ReloadInstance)
 
     ASSERT_EQ(1u, e->m_Particles.Size());
 
-    dmParticle::Particle original_particle;
-    memcpy(&original_particle, &e->m_Particles[0], sizeof(dmParticle::Particle));
+    dmParticle::Particle original_particle = ParticleAt(e, 0);
 
     uint32_t seed = e->m_Seed;
     float timer = e->m_Timer;
@@ -1546,8 +1555,8 @@ TEST_F(ParticleTest, ReloadInstance)
     ASSERT_EQ(timer, e->m_Timer);
     ASSERT_EQ(seed, e->m_Seed);
     ASSERT_EQ(1u, e->m_Particles.Size());
-    dmParticle::Particle* particle = &e->m_Particles[0];
-    ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    dmParticle::Particle particle = ParticleAt(e, 0);
+    ASSERT_EQ(0, memcmp(&original_particle, &particle, sizeof(dmParticle::Particle)));
 
     dmParticle::Emitter* e1 = GetEmitter(m_Context, instance, 1);
     ASSERT_EQ(1u, e1->m_Particles.Size());
@@ -1557,8 +1566,8 @@ TEST_F(ParticleTest, ReloadInstance)
     e = GetEmitter(m_Context, instance, 0);
 
     ASSERT_EQ(1u, e->m_Particles.Size());
-    particle = &e->m_Particles[0];
-    ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    particle = ParticleAt(e, 0);
+    ASSERT_EQ(0, memcmp(&original_particle, &particle, sizeof(dmParticle::Particle)));
 
     // Test reload with max_particle_count changed
     ASSERT_TRUE(ReloadPrototype("reload3.particlefxc", m_Prototype));
@@ -1566,8 +1575,8 @@ TEST_F(ParticleTest, ReloadInstance)
     e = GetEmitter(m_Context, instance, 0);
 
     ASSERT_EQ(2u, e->m_Particles.Size());
-    particle = &e->m_Particles[0];
-    ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    particle = ParticleAt(e, 0);
+    ASSERT_EQ(0, memcmp(&original_particle, &particle, sizeof(dmParticle::Particle)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1594,8 +1603,7 @@ TEST_F(ParticleTest, ReloadInstanceLoop)
     ASSERT_EQ(1u, e->m_Particles.Size());
     float emitter_timer = e->m_Timer;
 
-    dmParticle::Particle original_particle;
-    memcpy(&original_particle, &e->m_Particles[0], sizeof(dmParticle::Particle));
+    dmParticle::Particle original_particle = ParticleAt(e, 0);
 
     ASSERT_TRUE(ReloadPrototype("reload_loop.particlefxc", m_Prototype));
     dmParticle::ReloadInstance(m_Context, instance, true);
@@ -1604,8 +1612,8 @@ TEST_F(ParticleTest, ReloadInstanceLoop)
     ASSERT_EQ(1u, e->m_Particles.Size());
     ASSERT_EQ(emitter_timer, e->m_Timer);
     ASSERT_EQ(1u, e->m_Particles.Size());
-    dmParticle::Particle* particle = &e->m_Particles[0];
-    ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    dmParticle::Particle particle = ParticleAt(e, 0);
+    ASSERT_EQ(0, memcmp(&original_particle, &particle, sizeof(dmParticle::Particle)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1662,19 +1670,19 @@ TEST_F(ParticleTest, AccelerationWorld)
 
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_EQ(1.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::SetRotation(m_Context, instance, Quat::rotationZ(M_PI * 0.5f));
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_EQ(1.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1698,8 +1706,8 @@ TEST_F(ParticleTest, AccelerationScaledEmitter)
 
         dmParticle::StartInstance(m_Context, instance);
         dmParticle::Update(m_Context, dt, 0x0);
-        dmParticle::Particle* particle = &inst->m_Emitters[0].m_Particles[0];
-        delta[i] = Vector3(particle->GetPosition());
+        dmParticle::Particle particle = ParticleAt(&inst->m_Emitters[0], 0);
+        delta[i] = Vector3(particle.GetPosition());
 
         dmParticle::DestroyInstance(m_Context, instance);
     }
@@ -1729,8 +1737,8 @@ TEST_F(ParticleTest, AccelerationScaledWorld)
 
         dmParticle::StartInstance(m_Context, instance);
         dmParticle::Update(m_Context, dt, 0x0);
-        dmParticle::Particle* particle = &inst->m_Emitters[0].m_Particles[0];
-        delta[i] = Vector3(particle->GetPosition());
+        dmParticle::Particle particle = ParticleAt(&inst->m_Emitters[0], 0);
+        delta[i] = Vector3(particle.GetPosition());
 
         dmParticle::DestroyInstance(m_Context, instance);
     }
@@ -1752,19 +1760,19 @@ TEST_F(ParticleTest, AccelerationEmitter)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_NEAR(1.0f, particle->GetVelocity().getY(), EPSILON);
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_NEAR(1.0f, particle.GetVelocity().getY(), EPSILON);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::SetRotation(m_Context, instance, Quat::rotationZ(M_PI));
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_NEAR(1.0f, particle->GetVelocity().getY(), EPSILON);
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_NEAR(1.0f, particle.GetVelocity().getY(), EPSILON);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1780,22 +1788,22 @@ TEST_F(ParticleTest, AccelerationAnimated)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_LT(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    dmParticle::Particle particle = ParticleAt(emitter, 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_LT(0.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::Update(m_Context, dt, 0x0);
     // New particle at 0 because of sorting
-    particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    particle = ParticleAt(emitter, 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     dmParticle::Update(m_Context, dt, 0x0);
     // New particle at 0 because of sorting
-    particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_GT(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    particle = ParticleAt(emitter, 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_GT(0.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1812,8 +1820,8 @@ TEST_F(ParticleTest, DragNoDir)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1830,8 +1838,8 @@ TEST_F(ParticleTest, DragDir)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    Vector3 velocity = particle->GetVelocity();
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    Vector3 velocity = particle.GetVelocity();
     ASSERT_NEAR(0.0f, velocity.getX(), EPSILON);
     ASSERT_LT(0.0f, velocity.getY());
     ASSERT_EQ(0.0f, velocity.getZ());
@@ -1851,8 +1859,8 @@ TEST_F(ParticleTest, DragBigMagnitude)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0u, lengthSqr(particle->GetVelocity()));
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0u, lengthSqr(particle.GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1869,9 +1877,9 @@ TEST_F(ParticleTest, Radial)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(1.0f, lengthSqr(particle->GetVelocity()));
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getX());
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(1.0f, lengthSqr(particle.GetVelocity()));
+    ASSERT_EQ(-1.0f, particle.GetVelocity().getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1888,16 +1896,16 @@ TEST_F(ParticleTest, RadialMaxDistance)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     // Test with instance scale
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::SetScale(m_Context, instance, 2.0f);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1915,8 +1923,8 @@ TEST_F(ParticleTest, RadialEdgeCase)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(1.0f, lengthSqr(particle->GetVelocity()));
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(1.0f, lengthSqr(particle.GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1933,10 +1941,10 @@ TEST_F(ParticleTest, Vortex)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, particle.GetVelocity().getX());
+    ASSERT_EQ(-1.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1953,16 +1961,16 @@ TEST_F(ParticleTest, VortexMaxDistance)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     // Test with instance scale
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::SetScale(m_Context, instance, 2.0f);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(0.0f, lengthSqr(particle.GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1979,10 +1987,10 @@ TEST_F(ParticleTest, VortexEdgeCase)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    dmParticle::Particle particle = ParticleAt(&i->m_Emitters[0], 0);
+    ASSERT_EQ(-1.0f, particle.GetVelocity().getX());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getY());
+    ASSERT_EQ(0.0f, particle.GetVelocity().getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -2058,8 +2066,8 @@ TEST_F(ParticleTest, InheritVelocity)
     dmParticle::SetPosition(m_Context, instance, Point3(10, 0, 0));
     dmParticle::Update(m_Context, dt, 0x0);
 
-    ASSERT_EQ(0.0f, lengthSqr(e1->m_Particles[0].GetVelocity()));
-    ASSERT_NE(0.0f, lengthSqr(e2->m_Particles[0].GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(ParticleAt(e1, 0).GetVelocity()));
+    ASSERT_NE(0.0f, lengthSqr(ParticleAt(e2, 0).GetVelocity()));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -2092,6 +2100,150 @@ TEST_F(ParticleTest, Stats)
     dmParticle::DestroyInstance(m_Context, instance);
 }
 
+struct EmitterStateChangedLogEntry
+{
+    uint32_t m_Tag;
+    uint32_t m_NumAwakeEmitters;
+    dmhash_t m_EmitterId;
+    dmParticle::EmitterState m_State;
+};
+
+struct EmitterStateChangedLogData
+{
+    std::vector<EmitterStateChangedLogEntry>* m_Log;
+    uint32_t m_Tag;
+};
+
+void EmitterStateChangedLogCallback(uint32_t num_awake_emitters, dmhash_t emitter_id, dmParticle::EmitterState emitter_state, void* user_data)
+{
+    EmitterStateChangedLogData* data = (EmitterStateChangedLogData*) user_data;
+    EmitterStateChangedLogEntry entry;
+    entry.m_Tag = data->m_Tag;
+    entry.m_NumAwakeEmitters = num_awake_emitters;
+    entry.m_EmitterId = emitter_id;
+    entry.m_State = emitter_state;
+    data->m_Log->push_back(entry);
+}
+
+/**
+ * Verify that the simulation, the callbacks and the vertex data are the same when a job context is used
+ */
+TEST_F(ParticleTest, ParallelUpdate)
+{
+    const uint32_t instance_count = 8;
+    const uint32_t emitter_count = 2;
+    float dt = 1.0f / 60.0f;
+
+    dmJobSystem::NewContextParams job_params;
+    job_params.m_WorkerCount = 3;
+    dmJobSystem::HContext job_context = dmJobSystem::NewContext(job_params);
+    dmParticle::HParticleContext parallel_context = dmParticle::CreateContext(64, 1024);
+    dmParticle::SetJobContext(parallel_context, job_context);
+
+    ASSERT_TRUE(LoadPrototype("parallel.particlefxc", &m_Prototype));
+
+    dmParticle::HParticleContext contexts[2] = { m_Context, parallel_context };
+    dmParticle::HInstance instances[2][instance_count];
+    std::vector<EmitterStateChangedLogEntry> logs[2];
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            EmitterStateChangedLogData* data = (EmitterStateChangedLogData*) malloc(sizeof(EmitterStateChangedLogData));
+            data->m_Log = &logs[c];
+            data->m_Tag = i;
+            m_CallbackData.m_StateChangedCallback = EmitterStateChangedLogCallback;
+            m_CallbackData.m_UserData = (void*)data;
+            instances[c][i] = dmParticle::CreateInstance(contexts[c], m_Prototype, &m_CallbackData);
+            dmParticle::SetPosition(contexts[c], instances[c][i], Point3((float)i, 0.0f, 0.0f));
+        }
+    }
+    // The seeds are based on the time of creation, give both contexts the same emitters
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        for (uint32_t e = 0; e < emitter_count; ++e)
+        {
+            dmParticle::Emitter* emitter = GetEmitter(m_Context, instances[0][i], e);
+            dmParticle::Emitter* parallel_emitter = GetEmitter(parallel_context, instances[1][i], e);
+            parallel_emitter->m_OriginalSeed = emitter->m_OriginalSeed;
+            parallel_emitter->m_Duration = emitter->m_Duration;
+            parallel_emitter->m_StartDelay = emitter->m_StartDelay;
+            parallel_emitter->m_SpawnRateSpread = emitter->m_SpawnRateSpread;
+        }
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            dmParticle::ResetInstance(contexts[c], instances[c][i]);
+            dmParticle::StartInstance(contexts[c], instances[c][i]);
+        }
+    }
+
+    // More particles than fit in the vertex buffer, to also compare the truncation
+    uint8_t* parallel_vertex_buffer = new uint8_t[m_VertexBufferSize];
+    const dmParticle::EmitterRenderData* render_data[instance_count * emitter_count];
+    uint32_t max_vertex_buffer_size = 0;
+    for (uint32_t frame = 0; frame < 60; ++frame)
+    {
+        dmParticle::Update(m_Context, dt, 0x0);
+        dmParticle::Update(parallel_context, dt, 0x0);
+
+        ASSERT_EQ(logs[0].size(), logs[1].size());
+        for (uint32_t i = 0; i < logs[0].size(); ++i)
+        {
+            ASSERT_EQ(logs[0][i].m_Tag, logs[1][i].m_Tag);
+            ASSERT_EQ(logs[0][i].m_NumAwakeEmitters, logs[1][i].m_NumAwakeEmitters);
+            ASSERT_EQ(logs[0][i].m_EmitterId, logs[1][i].m_EmitterId);
+            ASSERT_EQ(logs[0][i].m_State, logs[1][i].m_State);
+        }
+
+        uint32_t vertex_buffer_size = 0;
+        uint32_t parallel_vertex_buffer_size = 0;
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            for (uint32_t e = 0; e < emitter_count; ++e)
+            {
+                dmParticle::GenerateVertexData(m_Context, dt, instances[0][i], e, Vector4(1,1,1,1), (void*)m_VertexBuffer, m_VertexBufferSize, &vertex_buffer_size, dmParticle::PARTICLE_GO);
+                dmParticle::EmitterRenderData* data;
+                dmParticle::GetEmitterRenderData(parallel_context, instances[1][i], e, &data);
+                render_data[i * emitter_count + e] = data;
+            }
+        }
+        dmParticle::GenerateVertexData(parallel_context, dt, render_data, instance_count * emitter_count, Vector4(1,1,1,1), (void*)parallel_vertex_buffer, m_VertexBufferSize, &parallel_vertex_buffer_size, dmParticle::PARTICLE_GO);
+        ASSERT_EQ(vertex_buffer_size, parallel_vertex_buffer_size);
+        ASSERT_EQ(0, memcmp(m_VertexBuffer, parallel_vertex_buffer, vertex_buffer_size));
+        max_vertex_buffer_size = dmMath::Max(max_vertex_buffer_size, vertex_buffer_size);
+
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            for (uint32_t e = 0; e < emitter_count; ++e)
+            {
+                dmParticle::Emitter* emitter = GetEmitter(m_Context, instances[0][i], e);
+                dmParticle::Emitter* parallel_emitter = GetEmitter(parallel_context, instances[1][i], e);
+                ASSERT_EQ(emitter->m_State, parallel_emitter->m_State);
+                ASSERT_EQ(emitter->m_Seed, parallel_emitter->m_Seed);
+                ASSERT_EQ(emitter->m_VertexIndex, parallel_emitter->m_VertexIndex);
+                ASSERT_EQ(emitter->m_VertexCount, parallel_emitter->m_VertexCount);
+                uint32_t particle_count = ParticleCount(emitter);
+                ASSERT_EQ(particle_count, ParticleCount(parallel_emitter));
+                for (uint32_t s = 0; s < dmParticle::PARTICLE_STREAM_COUNT; ++s)
+                {
+                    ASSERT_EQ(0, memcmp(emitter->m_Particles.Stream((dmParticle::ParticleStream)s), parallel_emitter->m_Particles.Stream((dmParticle::ParticleStream)s), particle_count * sizeof(float)));
+                }
+            }
+        }
+    }
+    ASSERT_EQ(m_VertexBufferSize, max_vertex_buffer_size);
+    ASSERT_TRUE(dmParticle::IsSleeping(m_Context, instances[0][0]));
+
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        dmParticle::DestroyInstance(m_Context, instances[0][i]);
+        dmParticle::DestroyInstance(parallel_context, instances[1][i]);
+    }
+    delete [] parallel_vertex_buffer;
+    dmParticle::DestroyContext(parallel_context);
+    dmJobSystem::DeleteContext(job_context);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -15,9 +15,10 @@
 
 #include <stdint.h>
 #include <dmsdk/physics/physics.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h> // TODO: Use dmsdk/dlib/vmath.h
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
+#include <dlib/job_system.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -237,9 +238,21 @@ namespace dmPhysics
         uint32_t m_RayCastLimit3D;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
+        /// Frequency (Hz) of the fixed physics step. 0 steps the worlds with the frame time.
+        uint32_t m_UpdateFrequency;
+        /// Maximum number of fixed steps taken per world update, remaining time is dropped
+        uint32_t m_MaxFixedTimesteps;
+        /// Number of velocity iterations of the constraint solver
+        uint32_t m_VelocityIterations;
+        /// Number of position iterations of the constraint solver (2D only)
+        uint32_t m_PositionIterations;
+        /// Job system context used to spread batched ray casts over worker threads, may be 0x0
+        dmJobSystem::HContext m_JobContext;
         /// If true, the collision objects will retrieve the position of its game object
         uint8_t m_AllowDynamicTransforms:1;
-        uint8_t :7;
+        /// If true, transforms reported through SetWorldTransformCallback are interpolated between the last two fixed steps
+        uint8_t m_Interpolate:1;
+        uint8_t :6;
     };
 
     /**
@@ -299,6 +312,10 @@ namespace dmPhysics
         GetWorldTransformCallback m_GetWorldTransformCallback;
         /// param set_world_transform Callback for copying the transform from the collision object to the corresponding user data
         SetWorldTransformCallback m_SetWorldTransformCallback;
+        /// If true, the transforms of the collision objects are only read through the get_world_transform callback
+        /// after being marked with SetWorldTransformChanged2D (2D only)
+        uint8_t m_TrackTransformChanges:1;
+        uint8_t :7;
     };
 
     /**
@@ -926,6 +943,16 @@ namespace dmPhysics
      */
     void Wakeup2D(HCollisionObject2D collision_object);
 
+    /**
+     * Mark the world transform of the collision object's user data as changed.
+     * The transform is read through the GetWorldTransformCallback before the next step of the world.
+     * Only needed for worlds created with NewWorldParams::m_TrackTransformChanges set.
+     *
+     * @param world World of the collision object
+     * @param collision_object Collision object
+     */
+    void SetWorldTransformChanged2D(HWorld2D world, HCollisionObject2D collision_object);
+
     /**
      * Set whether the 3D collision object has locked rotation or not, which means that the angular velocity will always be 0.
      *
@@ -1146,6 +1173,30 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Perform several synchronous ray casts, reporting the closest hit of each ray.
+     * The rays are spread over the worker threads of the context's job system, if any.
+     * The world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests, m_ReturnAllResults is ignored
+     * @param request_count Number of requests
+     * @param responses Array of request_count responses receiving the closest hit of the corresponding request
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses);
+
+    /**
+     * Perform several synchronous ray casts, reporting the closest hit of each ray.
+     * The rays are spread over the worker threads of the context's job system, if any.
+     * The world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests, m_ReturnAllResults is ignored
+     * @param request_count Number of requests
+     * @param responses Array of request_count responses receiving the closest hit of the corresponding request
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses);
+
     /**
      * Set the gravity for a 2D physics world.
      *
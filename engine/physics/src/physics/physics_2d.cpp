@@ -38,7 +38,13 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_FixedTimeStep(0.0f)
+    , m_MaxFixedTimesteps(0)
+    , m_VelocityIterations(10)
+    , m_PositionIterations(10)
+    , m_JobContext(0x0)
     , m_AllowDynamicTransforms(0)
+    , m_Interpolate(0)
     {
 
     }
@@ -52,9 +58,12 @@ namespace dmPhysics
     , m_ContactListener(this)
     , m_GetWorldTransformCallback(params.m_GetWorldTransformCallback)
     , m_SetWorldTransformCallback(params.m_SetWorldTransformCallback)
+    , m_Accumulator(0.0f)
     , m_AllowDynamicTransforms(context->m_AllowDynamicTransforms)
+    , m_TrackTransformChanges(params.m_TrackTransformChanges)
     {
     	m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
+        m_RayCastResponses.SetCapacity(context->m_RayCastLimit);
         OverlapCacheInit(&m_TriggerOverlaps);
     }
 
@@ -128,6 +137,41 @@ namespace dmPhysics
             return -1.f;
     }
 
+    /// Minimum number of rays cast by one job
+    static const uint32_t RAY_CAST_BATCH_SIZE = 32;
+
+    struct RayCastBatchContext2D
+    {
+        HWorld2D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    // Only reads from the world, so several ranges can be cast at the same time
+    static void RayCastRange2D(void* _context, void* data, uint32_t start, uint32_t end)
+    {
+        RayCastBatchContext2D* context = (RayCastBatchContext2D*)_context;
+        HWorld2D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+        ProcessRayCastResultCallback2D callback;
+        callback.m_Context = world->m_Context;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            const RayCastRequest& request = context->m_Requests[i];
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            callback.m_IgnoredUserData = request.m_IgnoredUserData;
+            callback.m_CollisionMask = request.m_Mask;
+            callback.m_Response = RayCastResponse();
+            // Box2D asserts on rays without length
+            if ((to - from).LengthSquared() > 0.0f)
+                world->m_World.RayCast(&callback, from, to);
+            context->m_Responses[i] = callback.m_Response;
+        }
+    }
+
     ContactListener::ContactListener(HWorld2D world)
     : m_World(world)
     {
@@ -215,7 +259,13 @@ namespace dmPhysics
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit2D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
+        context->m_FixedTimeStep = params.m_UpdateFrequency > 0 ? 1.0f / params.m_UpdateFrequency : 0.0f;
+        context->m_MaxFixedTimesteps = dmMath::Max(params.m_MaxFixedTimesteps, 1u);
+        context->m_VelocityIterations = params.m_VelocityIterations;
+        context->m_PositionIterations = params.m_PositionIterations;
+        context->m_JobContext = params.m_JobContext;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
+        context->m_Interpolate = params.m_Interpolate;
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
         {
@@ -395,6 +445,145 @@ namespace dmPhysics
         }
     }
 
+    static void StorePreviousTransforms2D(HWorld2D world)
+    {
+        dmHashTable<uintptr_t, PreviousTransform2D>& transforms = world->m_PreviousTransforms;
+        transforms.Clear();
+        uint32_t body_count = (uint32_t)world->m_World.GetBodyCount();
+        if (body_count > transforms.Capacity())
+        {
+            uint32_t capacity = body_count + 32;
+            transforms.SetCapacity(3 * capacity / 4, capacity);
+        }
+        for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+        {
+            if (body->GetType() == b2_dynamicBody && body->IsActive())
+            {
+                PreviousTransform2D transform;
+                transform.m_Position = body->GetPosition();
+                transform.m_Angle = body->GetAngle();
+                transforms.Put((uintptr_t)body, transform);
+            }
+        }
+    }
+
+    /**
+     * Step the box2d world, either with the frame time or in fixed steps from the accumulated time.
+     * Returns the interpolation factor between the previous and current body transforms.
+     */
+    static float StepSimulation2D(HWorld2D world, float dt)
+    {
+        HContext2D context = world->m_Context;
+        int velocity_iterations = (int)context->m_VelocityIterations;
+        int position_iterations = (int)context->m_PositionIterations;
+        float step = context->m_FixedTimeStep;
+        if (step == 0.0f)
+        {
+            world->m_World.Step(dt, velocity_iterations, position_iterations);
+            return 1.0f;
+        }
+
+        world->m_Accumulator += dt;
+        // The tolerance keeps a frame time equal to the step from occasionally rounding down to zero steps
+        uint32_t steps = (uint32_t)(world->m_Accumulator / step + 0.001f);
+        if (steps > context->m_MaxFixedTimesteps)
+        {
+            // Drop the time we can't catch up with instead of spiraling
+            steps = context->m_MaxFixedTimesteps;
+            world->m_Accumulator = steps * step;
+        }
+        for (uint32_t i = 0; i < steps; ++i)
+        {
+            if (context->m_Interpolate && i == steps - 1)
+                StorePreviousTransforms2D(world);
+            world->m_World.Step(step, velocity_iterations, position_iterations);
+        }
+        world->m_Accumulator = dmMath::Max(world->m_Accumulator - steps * step, 0.0f);
+        return context->m_Interpolate ? world->m_Accumulator / step : 1.0f;
+    }
+
+    static inline float GetAngleZ(const Vectormath::Aos::Quat& rotation)
+    {
+        return atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
+    }
+
+    /**
+     * Read the game world transform of a body through the transform callback.
+     * Bodies that are moved are kept awake until the next step, and are added to world->m_MovedBodies.
+     */
+    static void RetrieveGameWorldTransform2D(HWorld2D world, b2Body* body, bool interpolate, float pos_epsilon, float rot_epsilon)
+    {
+        float scale = world->m_Context->m_Scale;
+        bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+        // Interpolated game object transforms lag behind the simulation and must not be fed back
+        bool retrieve_gameworld_translation = retrieve_gameworld_transform && !(interpolate && body->GetType() == b2_dynamicBody);
+
+        // translate & rotation
+        if (retrieve_gameworld_translation || body->GetType() == b2_kinematicBody)
+        {
+            Vectormath::Aos::Point3 old_position = GetWorldPosition2D(world->m_Context, body);
+            dmTransform::Transform world_transform;
+            (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
+            Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+            // Ignore z-component
+            position.setZ(0.0f);
+            float angle = GetAngleZ(world_transform.GetRotation());
+            float dp = distSqr(old_position, position);
+            float da = body->GetAngle() - angle;
+
+            if (dp > pos_epsilon || fabsf(da) > rot_epsilon)
+            {
+                b2Vec2 b2_position;
+                ToB2(position, b2_position, scale);
+                body->SetTransform(b2_position, angle);
+                body->SetSleepingAllowed(false);
+                if (world->m_MovedBodies.Full())
+                    world->m_MovedBodies.OffsetCapacity(32);
+                world->m_MovedBodies.Push(body);
+            }
+        }
+
+        // Scaling
+        if (retrieve_gameworld_transform)
+        {
+            UpdateScale(world, body);
+        }
+    }
+
+    static void SyncWorldTransform2D(HWorld2D world, b2Body* body, float alpha, bool interpolate)
+    {
+        b2Vec2 b2_position = body->GetPosition();
+        float angle = body->GetAngle();
+        const PreviousTransform2D* previous = interpolate ? world->m_PreviousTransforms.Get((uintptr_t)body) : 0x0;
+        if (previous)
+        {
+            b2_position = previous->m_Position + alpha * (b2_position - previous->m_Position);
+            angle = previous->m_Angle + alpha * (angle - previous->m_Angle);
+        }
+        Vectormath::Aos::Point3 position;
+        FromB2(b2_position, position, world->m_Context->m_InvScale);
+        Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(angle);
+        (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+    }
+
+    static inline void RemoveBody(dmArray<b2Body*>& bodies, b2Body* body)
+    {
+        for (uint32_t i = 0; i < bodies.Size();)
+        {
+            if (bodies[i] == body)
+                bodies.EraseSwap(i);
+            else
+                ++i;
+        }
+    }
+
+    void SetWorldTransformChanged2D(HWorld2D world, HCollisionObject2D collision_object)
+    {
+        if (world->m_ChangedBodies.Full())
+            world->m_ChangedBodies.OffsetCapacity(dmMath::Max(32U, world->m_ChangedBodies.Capacity()));
+        world->m_ChangedBodies.Push((b2Body*)collision_object);
+    }
+
     void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
@@ -404,65 +593,83 @@ namespace dmPhysics
         // Values are picked by inspection, current rot value is roughly equivalent to 1 degree
         const float POS_EPSILON = 0.00005f * scale;
         const float ROT_EPSILON = 0.00007f;
+        bool interpolate = context->m_FixedTimeStep > 0.0f && context->m_Interpolate;
         // Update transforms of kinematic bodies
         if (world->m_GetWorldTransformCallback)
         {
             DM_PROFILE(Physics, "UpdateKinematic");
-            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+            // Bodies moved in the last step may sleep again, unless they are moved once more below
+            for (uint32_t i = 0; i < world->m_MovedBodies.Size(); ++i)
             {
-                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+                world->m_MovedBodies[i]->SetSleepingAllowed(true);
+            }
+            world->m_MovedBodies.SetSize(0);
 
-                // translate & rotation
-                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+            if (world->m_TrackTransformChanges)
+            {
+                for (uint32_t i = 0; i < world->m_ChangedBodies.Size(); ++i)
                 {
-                    Vectormath::Aos::Point3 old_position = GetWorldPosition2D(context, body);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    // Ignore z-component
-                    position.setZ(0.0f);
-                    Vectormath::Aos::Quat rotation = world_transform.GetRotation();
-                    float dp = distSqr(old_position, position);
-                    float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
-                    float old_angle = body->GetAngle();
-                    float da = old_angle - angle;
-
-                    if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
-                    {
-                        b2Vec2 b2_position;
-                        ToB2(position, b2_position, scale);
-                        body->SetTransform(b2_position, angle);
-                        body->SetSleepingAllowed(false);
-                    }
-                    else
+                    b2Body* body = world->m_ChangedBodies[i];
+                    RetrieveGameWorldTransform2D(world, body, interpolate, POS_EPSILON, ROT_EPSILON);
+                    // Sleeping bodies are not synced after the step, make sure the game object gets the body transform back
+                    if (body->GetType() == b2_dynamicBody && !body->IsAwake())
                     {
-                        body->SetSleepingAllowed(true);
+                        if (world->m_AwakeBodies.Full())
+                            world->m_AwakeBodies.OffsetCapacity(32);
+                        world->m_AwakeBodies.Push(body);
                     }
                 }
-
-                // Scaling
-                if(retrieve_gameworld_transform)
+            }
+            else
+            {
+                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
                 {
-                    UpdateScale(world, body);
+                    RetrieveGameWorldTransform2D(world, body, interpolate, POS_EPSILON, ROT_EPSILON);
                 }
             }
         }
+        world->m_ChangedBodies.SetSize(0);
         {
             DM_PROFILE(Physics, "StepSimulation");
             world->m_ContactListener.SetStepWorldContext(&step_context);
-            world->m_World.Step(dt, 10, 10);
-            float inv_scale = world->m_Context->m_InvScale;
+            float alpha = StepSimulation2D(world, dt);
             // Update transforms of dynamic bodies
             if (world->m_SetWorldTransformCallback)
             {
-                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+                if (world->m_TrackTransformChanges)
                 {
-                    if (body->GetType() == b2_dynamicBody && body->IsActive())
+                    // Only awake bodies move. The ones that fell asleep since the last step are synced one last time,
+                    // without interpolation since they will not be synced again once the interpolation catches up.
+                    dmArray<b2Body*>& awake_bodies = world->m_AwakeBodiesScratch;
+                    awake_bodies.SetSize(0);
+                    for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
                     {
-                        Vectormath::Aos::Point3 position;
-                        FromB2(body->GetPosition(), position, inv_scale);
-                        Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(body->GetAngle());
-                        (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+                        if (body->GetType() == b2_dynamicBody && body->IsActive() && body->IsAwake())
+                        {
+                            SyncWorldTransform2D(world, body, alpha, interpolate);
+                            if (awake_bodies.Full())
+                                awake_bodies.OffsetCapacity(dmMath::Max(32U, awake_bodies.Capacity()));
+                            awake_bodies.Push(body);
+                        }
+                    }
+                    for (uint32_t i = 0; i < world->m_AwakeBodies.Size(); ++i)
+                    {
+                        b2Body* body = world->m_AwakeBodies[i];
+                        if (body->IsActive() && !body->IsAwake())
+                        {
+                            SyncWorldTransform2D(world, body, 1.0f, false);
+                        }
+                    }
+                    world->m_AwakeBodies.Swap(awake_bodies);
+                }
+                else
+                {
+                    for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+                    {
+                        if (body->GetType() == b2_dynamicBody && body->IsActive())
+                        {
+                            SyncWorldTransform2D(world, body, alpha, interpolate);
+                        }
                     }
                 }
             }
@@ -472,20 +679,11 @@ namespace dmPhysics
         if (size > 0)
         {
             DM_PROFILE(Physics, "RayCasts");
-            ProcessRayCastResultCallback2D callback;
-            callback.m_Context = world->m_Context;
+            world->m_RayCastResponses.SetSize(size);
+            RayCastBatch2D(world, world->m_RayCastRequests.Begin(), size, world->m_RayCastResponses.Begin());
             for (uint32_t i = 0; i < size; ++i)
             {
-                RayCastRequest& request = world->m_RayCastRequests[i];
-                b2Vec2 from;
-                ToB2(request.m_From, from, scale);
-                b2Vec2 to;
-                ToB2(request.m_To, to, scale);
-                callback.m_IgnoredUserData = request.m_IgnoredUserData;
-                callback.m_CollisionMask = request.m_Mask;
-                callback.m_Response.m_Hit = 0;
-                world->m_World.RayCast(&callback, from, to);
-                (*step_context.m_RayCastCallback)(callback.m_Response, request, step_context.m_RayCastUserData);
+                (*step_context.m_RayCastCallback)(world->m_RayCastResponses[i], world->m_RayCastRequests[i], step_context.m_RayCastUserData);
             }
             world->m_RayCastRequests.SetSize(0);
         }
@@ -965,7 +1163,12 @@ namespace dmPhysics
         // See comment above about shapes and transforms
 
         OverlapCacheRemove(&world->m_TriggerOverlaps, collision_object);
+        if (world->m_PreviousTransforms.Get((uintptr_t)collision_object))
+            world->m_PreviousTransforms.Erase((uintptr_t)collision_object);
         b2Body* body = (b2Body*)collision_object;
+        RemoveBody(world->m_ChangedBodies, body);
+        RemoveBody(world->m_MovedBodies, body);
+        RemoveBody(world->m_AwakeBodies, body);
         b2Fixture* fixture = body->GetFixtureList();
         while (fixture)
         {
@@ -1082,8 +1285,7 @@ namespace dmPhysics
                 dmTransform::Transform world_transform;
                 (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
                 Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat(world_transform.GetRotation());
-                float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
+                float angle = GetAngleZ(world_transform.GetRotation());
                 b2Vec2 b2_position;
                 ToB2(position, b2_position, world->m_Context->m_Scale);
                 body->SetTransform(b2_position, angle);
@@ -1224,6 +1426,16 @@ namespace dmPhysics
         }
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+        RayCastBatchContext2D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Responses = responses;
+        dmJobSystem::ParallelFor(world->m_Context->m_JobContext, RayCastRange2D, &context, 0x0, request_count, RAY_CAST_BATCH_SIZE);
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
         b2Vec2 gravity_b;
@@ -37,20 +37,39 @@ namespace dmPhysics
         const StepWorldContext* m_TempStepWorldContext;
     };
 
+    /// Body transform before the last fixed step, used for interpolation
+    struct PreviousTransform2D
+    {
+        b2Vec2                      m_Position;
+        float                       m_Angle;
+    };
+
     struct World2D
     {
         World2D(HContext2D context, const NewWorldParams& params);
 
         OverlapCache                m_TriggerOverlaps;
+        dmHashTable<uintptr_t, PreviousTransform2D> m_PreviousTransforms;
         HContext2D                  m_Context;
         b2World                     m_World;
         dmArray<RayCastRequest>     m_RayCastRequests;
+        dmArray<RayCastResponse>    m_RayCastResponses;
+        /// Bodies whose game world transform changed since the last step, see SetWorldTransformChanged2D
+        dmArray<b2Body*>            m_ChangedBodies;
+        /// Bodies moved to their game world transform in the last step, sleeping is allowed again once they stop moving
+        dmArray<b2Body*>            m_MovedBodies;
+        /// Dynamic bodies that were awake after the last step, used to sync the ones that fall asleep one last time
+        dmArray<b2Body*>            m_AwakeBodies;
+        dmArray<b2Body*>            m_AwakeBodiesScratch;
         DebugDraw2D                 m_DebugDraw;
         ContactListener             m_ContactListener;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
         SetWorldTransformCallback   m_SetWorldTransformCallback;
+        /// Time not yet simulated when using a fixed step
+        float                       m_Accumulator;
         uint8_t                     m_AllowDynamicTransforms:1;
-        uint8_t                     :7;
+        uint8_t                     m_TrackTransformChanges:1;
+        uint8_t                     :6;
     };
 
     struct Context2D
@@ -67,8 +86,15 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        /// Fixed step in seconds, 0 when stepping with the frame time
+        float                       m_FixedTimeStep;
+        uint32_t                    m_MaxFixedTimesteps;
+        uint32_t                    m_VelocityIterations;
+        uint32_t                    m_PositionIterations;
+        dmJobSystem::HContext       m_JobContext;
         uint8_t                     m_AllowDynamicTransforms:1;
-        uint8_t                     :7;
+        uint8_t                     m_Interpolate:1;
+        uint8_t                     :6;
     };
 
     inline void ToB2(const Vectormath::Aos::Point3& p0, b2Vec2& p1, float scale)
@@ -11,7 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
 #include <dlib/message.h>
@@ -195,6 +195,10 @@ namespace dmPhysics
     {
     }
 
+    void SetWorldTransformChanged2D(HWorld2D world, HCollisionObject2D collision_object)
+    {
+    }
+
     void SetLockedRotation2D(HCollisionObject2D collision_object, bool locked_rotation)
     {
     }
@@ -238,6 +242,12 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < request_count; ++i)
+            responses[i].m_Hit = 0;
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
@@ -120,6 +120,10 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_FixedTimeStep(0.0f)
+    , m_MaxFixedTimesteps(0)
+    , m_VelocityIterations(10)
+    , m_JobContext(0x0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -148,11 +152,13 @@ namespace dmPhysics
         m_DynamicsWorld = new btDiscreteDynamicsWorld(m_Dispatcher, m_OverlappingPairCache, m_Solver, m_CollisionConfiguration);
         m_DynamicsWorld->setGravity(btVector3(context->m_Gravity.getX(), context->m_Gravity.getY(), context->m_Gravity.getZ()));
         m_DynamicsWorld->setDebugDrawer(&m_DebugDraw);
+        m_DynamicsWorld->getSolverInfo().m_numIterations = (int)context->m_VelocityIterations;
 
         m_GetWorldTransform = params.m_GetWorldTransformCallback;
         m_SetWorldTransform = params.m_SetWorldTransformCallback;
 
         m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
+        m_RayCastResponses.SetCapacity(context->m_RayCastLimit);
         OverlapCacheInit(&m_TriggerOverlaps);
     }
 
@@ -205,6 +211,41 @@ namespace dmPhysics
         RayCastResponse m_Response;
     };
 
+    /// Minimum number of rays cast by one job
+    static const uint32_t RAY_CAST_BATCH_SIZE = 32;
+
+    struct RayCastBatchContext3D
+    {
+        HWorld3D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    // Only reads from the world, so several ranges can be cast at the same time
+    static void RayCastRange3D(void* _context, void* data, uint32_t start, uint32_t end)
+    {
+        RayCastBatchContext3D* context = (RayCastBatchContext3D*)_context;
+        HWorld3D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            const RayCastRequest& request = context->m_Requests[i];
+            RayCastResponse& response = context->m_Responses[i];
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+            response = RayCastResponse();
+            if (result_callback.hasHit())
+            {
+                ResponseFromRayCastResult(response, inv_scale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_collisionObject);
+            }
+        }
+    }
+
     // Grabbed from a more recent Bullet version for now
     /// BULLET (do not modify) ->
     struct AllHitsRayResultCallback : public btCollisionWorld::RayResultCallback
@@ -283,6 +324,10 @@ namespace dmPhysics
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit3D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
+        context->m_FixedTimeStep = params.m_UpdateFrequency > 0 ? 1.0f / params.m_UpdateFrequency : 0.0f;
+        context->m_MaxFixedTimesteps = dmMath::Max(params.m_MaxFixedTimesteps, 1u);
+        context->m_VelocityIterations = params.m_VelocityIterations;
+        context->m_JobContext = params.m_JobContext;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
@@ -421,8 +466,12 @@ namespace dmPhysics
         {
             DM_PROFILE(Physics, "StepSimulation");
             // Step simulation
-            // TODO: Max substeps = 1 for now...
-            world->m_DynamicsWorld->stepSimulation(dt, 1);
+            // Bullet accumulates the time and takes the fixed steps itself. The motion states, and
+            // thereby the SetWorldTransform callback, receive transforms interpolated over the remainder.
+            if (context->m_FixedTimeStep > 0.0f)
+                world->m_DynamicsWorld->stepSimulation(dt, (int)context->m_MaxFixedTimesteps, context->m_FixedTimeStep);
+            else
+                world->m_DynamicsWorld->stepSimulation(dt, 1);
         }
 
         // Handle ray cast requests
@@ -430,33 +479,18 @@ namespace dmPhysics
         if (size > 0)
         {
             DM_PROFILE(Physics, "RayCasts");
-            for (uint32_t i = 0; i < size; ++i)
+            if (step_context.m_RayCastCallback == 0x0)
             {
-                const RayCastRequest& request = world->m_RayCastRequests[i];
-                if (step_context.m_RayCastCallback == 0x0)
-                {
-                    dmLogWarning("Ray cast requested without any response callback, skipped.");
-                    continue;
-                }
-                float scale = world->m_Context->m_Scale;
-                btVector3 from;
-                ToBt(request.m_From, from, scale);
-                btVector3 to;
-                ToBt(request.m_To, to, scale);
-                RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
-                world->m_DynamicsWorld->rayTest(from, to, result_callback);
-                RayCastResponse response;
-                response.m_Hit = result_callback.hasHit() ? 1 : 0;
-                response.m_Fraction = result_callback.m_closestHitFraction;
-                float inv_scale = world->m_Context->m_InvScale;
-                FromBt(result_callback.m_hitPointWorld, response.m_Position, inv_scale);
-                FromBt(result_callback.m_hitNormalWorld, response.m_Normal, 1.0f); // don't scale normal
-                if (result_callback.m_collisionObject != 0x0)
+                dmLogWarning("Ray cast requested without any response callback, skipped.");
+            }
+            else
+            {
+                world->m_RayCastResponses.SetSize(size);
+                RayCastBatch3D(world, world->m_RayCastRequests.Begin(), size, world->m_RayCastResponses.Begin());
+                for (uint32_t i = 0; i < size; ++i)
                 {
-                    response.m_CollisionObjectUserData = result_callback.m_collisionObject->getUserPointer();
-                    response.m_CollisionObjectGroup = result_callback.m_collisionObject->getBroadphaseHandle()->m_collisionFilterGroup;
+                    step_context.m_RayCastCallback(world->m_RayCastResponses[i], world->m_RayCastRequests[i], step_context.m_RayCastUserData);
                 }
-                step_context.m_RayCastCallback(response, request, step_context.m_RayCastUserData);
             }
             world->m_RayCastRequests.SetSize(0);
         }
@@ -1162,6 +1196,16 @@ namespace dmPhysics
         }
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+        RayCastBatchContext3D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Responses = responses;
+        dmJobSystem::ParallelFor(world->m_Context->m_JobContext, RayCastRange3D, &context, 0x0, request_count, RAY_CAST_BATCH_SIZE);
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
         HContext3D context = world->m_Context;
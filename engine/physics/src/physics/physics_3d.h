@@ -28,6 +28,7 @@ namespace dmPhysics
 
         OverlapCache                            m_TriggerOverlaps;
         dmArray<RayCastRequest>                 m_RayCastRequests;
+        dmArray<RayCastResponse>                m_RayCastResponses;
         DebugDraw3D                             m_DebugDraw;
         HContext3D                              m_Context;
         btDefaultCollisionConfiguration*        m_CollisionConfiguration;
@@ -55,6 +56,11 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        /// Fixed step in seconds, 0 when stepping with the frame time
+        float                       m_FixedTimeStep;
+        uint32_t                    m_MaxFixedTimesteps;
+        uint32_t                    m_VelocityIterations;
+        dmJobSystem::HContext       m_JobContext;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -11,7 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
 #include <dlib/message.h>
@@ -198,6 +198,12 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t request_count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < request_count; ++i)
+            responses[i].m_Hit = 0;
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
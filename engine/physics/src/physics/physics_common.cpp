@@ -30,7 +30,13 @@ namespace dmPhysics
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
     , m_TriggerOverlapCapacity(0)
+    , m_UpdateFrequency(0)
+    , m_MaxFixedTimesteps(2)
+    , m_VelocityIterations(10)
+    , m_PositionIterations(10)
+    , m_JobContext(0x0)
     , m_AllowDynamicTransforms(0)
+    , m_Interpolate(0)
     {
 
     }
@@ -42,6 +48,7 @@ namespace dmPhysics
     , m_WorldMax(WORLD_EXTENT, WORLD_EXTENT, WORLD_EXTENT)
     , m_GetWorldTransformCallback(0x0)
     , m_SetWorldTransformCallback(0x0)
+    , m_TrackTransformChanges(0)
     {
 
     }
@@ -126,6 +126,7 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
@@ -184,6 +185,7 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
@@ -1228,6 +1230,83 @@ TYPED_TEST(PhysicsTest, SynchronousRayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, BatchRayCasting)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+
+    dmPhysics::CollisionObjectData data;
+    data.m_Group = 1;
+    data.m_Mass = 0.0f;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_UserData = &vo_a;
+    typename TypeParam::CollisionObjectType box_co_a = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    data.m_Group = 2;
+    data.m_UserData = &vo_b;
+    typename TypeParam::CollisionObjectType box_co_b = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // Every fourth ray misses, the others hit the box of their group
+    const uint32_t count = 1000;
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(count);
+    requests.SetSize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float y = (i % 4) == 3 ? 2.0f : 0.4f * ((i % 5) / 4.0f - 0.5f);
+        requests[i].m_From = Vectormath::Aos::Point3(-1.0f, y, 0.0f);
+        requests[i].m_To = Vectormath::Aos::Point3(5.0f, y, 0.0f);
+        requests[i].m_Mask = (i % 2) ? 2 : 1;
+    }
+
+    dmArray<dmPhysics::RayCastResponse> serial;
+    serial.SetCapacity(count);
+    serial.SetSize(count);
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests.Begin(), count, serial.Begin());
+
+    dmJobSystem::NewContextParams job_params;
+    job_params.m_WorkerCount = 3;
+    dmJobSystem::HContext job_context = dmJobSystem::NewContext(job_params);
+    TestFixture::m_Context->m_JobContext = job_context;
+
+    dmArray<dmPhysics::RayCastResponse> parallel;
+    parallel.SetCapacity(count);
+    parallel.SetSize(count);
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests.Begin(), count, parallel.Begin());
+
+    TestFixture::m_Context->m_JobContext = 0x0;
+    dmJobSystem::DeleteContext(job_context);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if ((i % 4) == 3)
+        {
+            ASSERT_EQ(0u, serial[i].m_Hit);
+        }
+        else
+        {
+            ASSERT_EQ(1u, serial[i].m_Hit);
+            ASSERT_NEAR((i % 2) ? 0.5f : 0.25f, serial[i].m_Fraction, 0.00001f);
+            ASSERT_EQ((i % 2) ? (void*)&vo_b : (void*)&vo_a, serial[i].m_CollisionObjectUserData);
+        }
+        ASSERT_EQ(serial[i].m_Hit, parallel[i].m_Hit);
+        ASSERT_EQ(serial[i].m_Fraction, parallel[i].m_Fraction);
+        ASSERT_EQ(serial[i].m_CollisionObjectUserData, parallel[i].m_CollisionObjectUserData);
+        ASSERT_EQ(serial[i].m_CollisionObjectGroup, parallel[i].m_CollisionObjectGroup);
+    }
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_a);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_b);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 enum Groups
 {
     GROUP_A = 1 << 0,
@@ -177,6 +177,137 @@ TYPED_TEST(PhysicsTest, MultipleGroups)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shapes[1]);
 }
 
+// Replace the fixture context and world with ones stepping at a fixed rate
+static void SetupFixedTimestep(dmPhysics::HContext2D& context, dmPhysics::HWorld2D& world, uint32_t frequency, bool interpolate)
+{
+    dmPhysics::DeleteWorld2D(context, world);
+    dmPhysics::DeleteContext2D(context);
+
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    context_params.m_UpdateFrequency = frequency;
+    context_params.m_MaxFixedTimesteps = 2;
+    context_params.m_Interpolate = interpolate ? 1 : 0;
+    context = dmPhysics::NewContext2D(context_params);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world = dmPhysics::NewWorld2D(context, world_params);
+}
+
+TYPED_TEST(PhysicsTest, FixedTimestep)
+{
+    SetupFixedTimestep(TestFixture::m_Context, TestFixture::m_World, 64, false);
+
+    VisualObject vo;
+    vo.m_Position = Point3(0.0f, 10.0f, 0.0f);
+    dmPhysics::CollisionObjectData data;
+    data.m_UserData = &vo;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // Half a step is accumulated but not simulated
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 128.0f;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(10.0f, vo.m_Position.getY(), 0.000001f);
+    ASSERT_NEAR(0.0f, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(TestFixture::m_Context, co).getY(), 0.000001f);
+
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_GT(10.0f, vo.m_Position.getY());
+    ASSERT_NEAR(-10.0f / 64.0f, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(TestFixture::m_Context, co).getY(), 0.0001f);
+
+    // Long frames are capped to the max number of steps
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 8.0f;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(-30.0f / 64.0f, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(TestFixture::m_Context, co).getY(), 0.0001f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, FixedTimestepInterpolation)
+{
+    SetupFixedTimestep(TestFixture::m_Context, TestFixture::m_World, 64, true);
+
+    VisualObject vo;
+    vo.m_Position = Point3(0.0f, 10.0f, 0.0f);
+    dmPhysics::CollisionObjectData data;
+    data.m_UserData = &vo;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // A whole step leaves nothing to interpolate over, the reported transform is the one before the step
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 64.0f;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    float y = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, co).getY();
+    ASSERT_GT(10.0f, y);
+    ASSERT_NEAR(10.0f, vo.m_Position.getY(), 0.0001f);
+
+    // Half a step later the reported transform is halfway to the simulated one
+    TestFixture::m_StepWorldContext.m_DT = 1.0f / 128.0f;
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(y, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, co).getY(), 0.000001f);
+    ASSERT_NEAR(0.5f * (10.0f + y), vo.m_Position.getY(), 0.0001f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, TrackTransformChanges)
+{
+    dmPhysics::DeleteWorld2D(TestFixture::m_Context, TestFixture::m_World);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world_params.m_TrackTransformChanges = 1;
+    TestFixture::m_World = dmPhysics::NewWorld2D(TestFixture::m_Context, world_params);
+
+    VisualObject kinematic_vo;
+    kinematic_vo.m_Position = Point3(0.0f, 5.0f, 0.0f);
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &kinematic_vo;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(0.5f, 0.5f, 0.0f));
+    typename TypeParam::CollisionObjectType kinematic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // Transforms that are not marked as changed are not read
+    kinematic_vo.m_Position = Point3(1.0f, 5.0f, 0.0f);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(0.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, kinematic_co).getX(), 0.000001f);
+
+    dmPhysics::SetWorldTransformChanged2D(TestFixture::m_World, kinematic_co);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(1.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, kinematic_co).getX(), 0.000001f);
+
+    VisualObject dynamic_vo;
+    dynamic_vo.m_Position = Point3(1.0f, 6.0f, 0.0f);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+    data.m_Mass = 1.0f;
+    data.m_UserData = &dynamic_vo;
+    typename TypeParam::CollisionObjectType dynamic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    const float sleep_time = 2.1f;
+    int steps = (int)(sleep_time / TestFixture::m_StepWorldContext.m_DT);
+    for (int i = 0; i < steps; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    }
+    ASSERT_TRUE(dmPhysics::IsSleeping2D(dynamic_co));
+    float y = (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, dynamic_co).getY();
+    ASSERT_NEAR(y, dynamic_vo.m_Position.getY(), 0.000001f);
+
+    // A changed transform of a sleeping dynamic body is synced back from the body
+    dynamic_vo.m_Position = Point3(1.0f, 10.0f, 0.0f);
+    dmPhysics::SetWorldTransformChanged2D(TestFixture::m_World, dynamic_co);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(y, dynamic_vo.m_Position.getY(), 0.000001f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, dynamic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, kinematic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 TYPED_TEST(PhysicsTest, UseBullet)
 {
     VisualObject vo_b;
@@ -17,7 +17,7 @@
 #include <dlib/log.h>
 #include <extension/extension.h>
 #include <render/render.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include "profiler_private.h"
 #include "profile_render.h"
@@ -70,7 +70,7 @@ void RenderProfiler(dmProfile::HProfile profile, dmGraphics::HContext graphics_c
         dmRender::RenderListEnd(render_context);
         dmRender::SetViewMatrix(render_context, Vectormath::Aos::Matrix4::identity());
         dmRender::SetProjectionMatrix(render_context, Vectormath::Aos::Matrix4::orthographic(0.0f, dmGraphics::GetWindowWidth(graphics_context), 0.0f, dmGraphics::GetWindowHeight(graphics_context), 1.0f, -1.0f));
-        dmRender::DrawRenderList(render_context, 0, 0);
+        dmRender::DrawRenderList(render_context, 0, 0, 0);
         dmRender::ClearRenderObjects(render_context);
 
         dmProfile::Pause(false);
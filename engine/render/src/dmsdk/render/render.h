@@ -220,6 +220,8 @@ namespace dmRender
      * @param m_MajorOrder [type: uint32_t:2] If RENDER_ORDER_WORLD, then sorting is done based on the world position.
                                               Otherwise the sorting uses the m_Order value directly.
      * @param m_Dispatch [type: uint32_t:8] The dispatch function callback (dmRender::HRenderListDispatch)
+     * @param m_HasBounds [type: uint32_t:1] If set, m_BoundingRadius is valid and the entry is culled against the view frustum
+     * @param m_BoundingRadius [type: float] radius of the world space bounding sphere centered at m_WorldPosition
      */
     struct RenderListEntry
     {
@@ -231,6 +233,8 @@ namespace dmRender
         uint32_t m_MinorOrder:4;
         uint32_t m_MajorOrder:2;
         uint32_t m_Dispatch:8;
+        uint32_t m_HasBounds:1;
+        float    m_BoundingRadius;
     };
 
     /*#
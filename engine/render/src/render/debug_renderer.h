@@ -13,7 +13,7 @@
 #ifndef DM_RENDER_DEBUG_RENDERER_H
 #define DM_RENDER_DEBUG_RENDERER_H
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include "render.h"
 
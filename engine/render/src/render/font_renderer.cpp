@@ -13,7 +13,7 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/align.h>
 #include <dlib/memory.h>
@@ -129,6 +129,10 @@ namespace dmRender
         context->m_View = Matrix4::identity();
         context->m_Projection = Matrix4::identity();
         context->m_ViewProj = context->m_Projection * context->m_View;
+        context->m_RenderListDepthsViewProj = context->m_ViewProj;
+        context->m_RenderListDepthsCount = 0;
+        context->m_RenderListVisibleFrustum = context->m_ViewProj;
+        context->m_RenderListVisibleCount = 0;
 
         context->m_ScriptContext = params.m_ScriptContext;
         InitializeRenderScriptContext(context->m_RenderScriptContext, params.m_ScriptContext, params.m_CommandBufferSize);
@@ -179,6 +183,8 @@ namespace dmRender
         render_context->m_RenderListSortIndices.SetSize(0);
         render_context->m_RenderListDispatch.SetSize(0);
         render_context->m_RenderListRanges.SetSize(0);
+        render_context->m_RenderListDepthsCount = 0;
+        render_context->m_RenderListVisibleCount = 0;
     }
 
     HRenderListDispatch RenderListMakeDispatch(HRenderContext render_context, RenderListDispatchFn fn, void *user_data)
@@ -215,7 +221,11 @@ namespace dmRender
 
         uint32_t size = render_list.Size();
         render_list.SetSize(size + entries);
-        return (render_list.Begin() + size);
+        RenderListEntry* result = render_list.Begin() + size;
+        // The bounds are optional, and most callers don't write them
+        for (uint32_t i = 0; i < entries; ++i)
+            result[i].m_HasBounds = 0;
+        return result;
     }
 
     // Submit a range of entries (pointers must be from a range allocated by RenderListAlloc, and not between two alloc calls).
@@ -237,21 +247,14 @@ namespace dmRender
 
         render_context->m_RenderListSortIndices.SetSize(render_context->m_RenderListSortIndices.Size() + (end - begin));
 
+        // The entries may have been written after their depth was calculated
+        render_context->m_RenderListDepthsCount = dmMath::Min<uint32_t>(render_context->m_RenderListDepthsCount, begin - base);
+        render_context->m_RenderListVisibleCount = dmMath::Min<uint32_t>(render_context->m_RenderListVisibleCount, begin - base);
+
         // invalidate the ranges if this is a call to the debug rendering (happening in the middle of the frame)
         render_context->m_RenderListRanges.SetSize(0);
     }
 
-    struct RenderListSorter
-    {
-        bool operator()(uint32_t a, uint32_t b) const
-        {
-            const RenderListSortValue& u = values[a];
-            const RenderListSortValue& v = values[b];
-            return u.m_SortKey < v.m_SortKey;
-        }
-        RenderListSortValue* values;
-    };
-
     void RenderListEnd(HRenderContext render_context)
     {
         // Unflushed leftovers are assumed to be the debug rendering
@@ -398,22 +401,140 @@ namespace dmRender
         return false;
     }
 
-    // Compute new sort values for everything that matches tag_mask
-    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags)
+    void MakeFrustumPlanes(const Matrix4& view_proj, FrustumPlanes& planes)
     {
-        DM_PROFILE(Render, "MakeSortBuffer");
+        const Vector4 r0 = view_proj.getRow(0);
+        const Vector4 r1 = view_proj.getRow(1);
+        const Vector4 r2 = view_proj.getRow(2);
+        const Vector4 r3 = view_proj.getRow(3);
+
+        // left, right, bottom, top, near, far + two planes that contain everything
+        Vector4 p[8] = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2, Vector4(0, 0, 0, 1), Vector4(0, 0, 0, 1) };
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            float l = length(p[i].getXYZ());
+            p[i] = l > 0.0f ? p[i] / l : Vector4(0, 0, 0, 1);
+        }
 
-        const uint32_t required_capacity = context->m_RenderListSortIndices.Capacity();
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            const Vector4* g = &p[i*4];
+            planes.m_X[i] = Vector4(g[0].getX(), g[1].getX(), g[2].getX(), g[3].getX());
+            planes.m_Y[i] = Vector4(g[0].getY(), g[1].getY(), g[2].getY(), g[3].getY());
+            planes.m_Z[i] = Vector4(g[0].getZ(), g[1].getZ(), g[2].getZ(), g[3].getZ());
+            planes.m_W[i] = Vector4(g[0].getW(), g[1].getW(), g[2].getW(), g[3].getW());
+        }
+    }
+
+    bool IsSphereInFrustum(const FrustumPlanes& planes, const Point3& center, float radius)
+    {
+        const Vector4 x(center.getX());
+        const Vector4 y(center.getY());
+        const Vector4 z(center.getZ());
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            // Signed distance to four planes at once
+            const Vector4 d = mulPerElem(planes.m_X[i], x) + mulPerElem(planes.m_Y[i], y) + mulPerElem(planes.m_Z[i], z) + planes.m_W[i];
+            if (minElem(d) < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    // Calculate the projected depth of all world entries not yet calculated for the current view projection.
+    // The results are kept for the rest of the frame, so that several draw calls with the same view only do this once.
+    static void UpdateRenderListDepths(HRenderContext context)
+    {
+        DM_PROFILE(Render, "UpdateRenderListDepths");
+
+        const Matrix4& transform = context->m_ViewProj;
+        if (context->m_RenderListDepthsCount > 0 && memcmp(&context->m_RenderListDepthsViewProj, &transform, sizeof(Matrix4)) != 0)
+        {
+            context->m_RenderListDepthsCount = 0;
+        }
+        context->m_RenderListDepthsViewProj = transform;
+
+        uint32_t count = context->m_RenderList.Size();
+        if (context->m_RenderListDepths.Capacity() < count)
+        {
+            context->m_RenderListDepths.SetCapacity(context->m_RenderList.Capacity());
+        }
+        context->m_RenderListDepths.SetSize(count);
+
+        RenderListEntry* entries = context->m_RenderList.Begin();
+        float* depths = context->m_RenderListDepths.Begin();
+        for (uint32_t i = context->m_RenderListDepthsCount; i < count; ++i)
+        {
+            const RenderListEntry* entry = &entries[i];
+            if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
+                continue;
+            const Vector4 res = transform * entry->m_WorldPosition;
+            depths[i] = res.getZ() / res.getW();
+        }
+        context->m_RenderListDepthsCount = count;
+    }
+
+    // Frustum test all entries with bounds, not yet tested against the frustum matrix.
+    // Like the depths, the results are kept for the rest of the frame.
+    static void UpdateRenderListVisibility(HRenderContext context, const Matrix4& frustum_matrix)
+    {
+        DM_PROFILE(Render, "UpdateRenderListVisibility");
+
+        if (context->m_RenderListVisibleCount > 0 && memcmp(&context->m_RenderListVisibleFrustum, &frustum_matrix, sizeof(Matrix4)) != 0)
+        {
+            context->m_RenderListVisibleCount = 0;
+        }
+        context->m_RenderListVisibleFrustum = frustum_matrix;
+
+        uint32_t count = context->m_RenderList.Size();
+        if (context->m_RenderListVisible.Capacity() < count)
+        {
+            context->m_RenderListVisible.SetCapacity(context->m_RenderList.Capacity());
+        }
+        context->m_RenderListVisible.SetSize(count);
+
+        FrustumPlanes planes;
+        MakeFrustumPlanes(frustum_matrix, planes);
+
+        RenderListEntry* entries = context->m_RenderList.Begin();
+        uint8_t* visible = context->m_RenderListVisible.Begin();
+        for (uint32_t i = context->m_RenderListVisibleCount; i < count; ++i)
+        {
+            const RenderListEntry* entry = &entries[i];
+            visible[i] = !entry->m_HasBounds || IsSphereInFrustum(planes, entry->m_WorldPosition, entry->m_BoundingRadius);
+        }
+        context->m_RenderListVisibleCount = count;
+    }
+
+    static void EnsureSortBufferCapacity(HRenderContext context, uint32_t capacity)
+    {
         // SetCapacity does early out if they are the same, so just call anyway.
-        context->m_RenderListSortBuffer.SetCapacity(required_capacity);
+        context->m_RenderListSortBuffer.SetCapacity(capacity);
+        context->m_RenderListSortBufferTmp.SetCapacity(capacity);
+        context->m_RenderListSortKeys.SetCapacity(capacity);
+        context->m_RenderListSortKeysTmp.SetCapacity(capacity);
+    }
+
+    // Compute new sort keys for everything that matches tag_mask, and is inside the frustum (if any)
+    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags, const Matrix4* frustum_matrix)
+    {
+        DM_PROFILE(Render, "MakeSortBuffer");
+
+        EnsureSortBufferCapacity(context, context->m_RenderListSortIndices.Capacity());
         context->m_RenderListSortBuffer.SetSize(0);
-        context->m_RenderListSortValues.SetCapacity(required_capacity);
-        context->m_RenderListSortValues.SetSize(context->m_RenderListSortIndices.Size());
+        context->m_RenderListSortKeys.SetSize(0);
 
-        RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
-        RenderListEntry* entries = context->m_RenderList.Begin();
+        UpdateRenderListDepths(context);
 
-        const Matrix4& transform = context->m_ViewProj;
+        const uint8_t* visible = 0x0;
+        if (frustum_matrix)
+        {
+            UpdateRenderListVisibility(context, *frustum_matrix);
+            visible = context->m_RenderListVisible.Begin();
+        }
+
+        RenderListEntry* entries = context->m_RenderList.Begin();
+        const float* depths = context->m_RenderListDepths.Begin();
 
         float minZW = FLT_MAX;
         float maxZW = -FLT_MAX;
@@ -434,17 +555,14 @@ namespace dmRender
                 continue;
             }
 
-            // Write z values...
+            // Find the depth range...
             for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
             {
                 uint32_t idx = context->m_RenderListSortIndices[i];
-                RenderListEntry* entry = &entries[idx];
-                if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
-                    continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
+                if (entries[idx].m_MajorOrder != RENDER_ORDER_WORLD || (visible && !visible[idx]))
+                    continue;
 
-                const Vector4 res = transform * entry->m_WorldPosition;
-                const float zw = res.getZ() / res.getW();
-                sort_values[idx].m_ZW = zw;
+                const float zw = depths[idx];
                 if (zw < minZW) minZW = zw;
                 if (zw > maxZW) maxZW = zw;
             }
@@ -455,6 +573,7 @@ namespace dmRender
         if (maxZW > minZW)
             rc = 1.0f / (maxZW - minZW);
 
+        uint32_t culled = 0;
         for( uint32_t i = 0; i < num_ranges; ++i)
         {
             const RenderListRange& range = ranges[i];
@@ -464,24 +583,91 @@ namespace dmRender
             for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
             {
                 uint32_t idx = context->m_RenderListSortIndices[i];
+                if (visible && !visible[idx])
+                {
+                    ++culled;
+                    continue;
+                }
                 RenderListEntry* entry = &entries[idx];
 
-                sort_values[idx].m_MajorOrder = entry->m_MajorOrder;
+                RenderListSortValue sort_value;
+                sort_value.m_MajorOrder = entry->m_MajorOrder;
                 if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
                 {
-                    const float z = sort_values[idx].m_ZW;
-                    sort_values[idx].m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
+                    const float z = depths[idx];
+                    sort_value.m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
                 }
                 else
                 {
                     // use the integer value provided.
-                    sort_values[idx].m_Order = entry->m_Order;
+                    sort_value.m_Order = entry->m_Order;
                 }
-                sort_values[idx].m_MinorOrder = entry->m_MinorOrder;
-                sort_values[idx].m_BatchKey = entry->m_BatchKey & 0x00ffffff;
-                sort_values[idx].m_Dispatch = entry->m_Dispatch;
+                sort_value.m_MinorOrder = entry->m_MinorOrder;
+                sort_value.m_BatchKey = entry->m_BatchKey & 0x00ffffff;
+                sort_value.m_Dispatch = entry->m_Dispatch;
                 context->m_RenderListSortBuffer.Push(idx);
+                context->m_RenderListSortKeys.Push(sort_value.m_SortKey);
+            }
+        }
+
+        DM_COUNTER("RenderListCulled", culled);
+        DM_COUNTER("RenderListVisible", context->m_RenderListSortBuffer.Size());
+    }
+
+    void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values, uint32_t count)
+    {
+        if (count < 2)
+            return;
+
+        // Build the histograms for all bytes in one go
+        uint32_t histograms[8][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t key = keys[i];
+            for (uint32_t b = 0; b < 8; ++b)
+            {
+                histograms[b][(key >> (b * 8)) & 0xff]++;
+            }
+        }
+
+        uint64_t* src_keys = keys;
+        uint32_t* src_values = values;
+        uint64_t* dst_keys = tmp_keys;
+        uint32_t* dst_values = tmp_values;
+        for (uint32_t b = 0; b < 8; ++b)
+        {
+            uint32_t* histogram = histograms[b];
+            const uint32_t shift = b * 8;
+
+            // All keys have the same value for this byte, the pass wouldn't change the order
+            if (histogram[(src_keys[0] >> shift) & 0xff] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t n = histogram[i];
+                histogram[i] = offset;
+                offset += n;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint64_t key = src_keys[i];
+                uint32_t dst = histogram[(key >> shift) & 0xff]++;
+                dst_keys[dst] = key;
+                dst_values[dst] = src_values[i];
             }
+
+            uint64_t* swap_keys = src_keys; src_keys = dst_keys; dst_keys = swap_keys;
+            uint32_t* swap_values = src_values; src_values = dst_values; dst_values = swap_values;
+        }
+
+        if (src_keys != keys)
+        {
+            memcpy(keys, src_keys, sizeof(uint64_t) * count);
+            memcpy(values, src_values, sizeof(uint32_t) * count);
         }
     }
 
@@ -529,9 +715,20 @@ namespace dmRender
 
         // First sort on the tag masks
         {
-            RenderListEntrySorter sort;
-            sort.m_Base = context->m_RenderList.Begin();
-            std::stable_sort(context->m_RenderListSortIndices.Begin(), context->m_RenderListSortIndices.End(), sort);
+            uint32_t count = context->m_RenderListSortIndices.Size();
+            EnsureSortBufferCapacity(context, context->m_RenderListSortIndices.Capacity());
+            context->m_RenderListSortKeys.SetSize(count);
+            context->m_RenderListSortKeysTmp.SetSize(count);
+            context->m_RenderListSortBufferTmp.SetSize(count);
+
+            const RenderListEntry* entries = context->m_RenderList.Begin();
+            uint32_t* indices = context->m_RenderListSortIndices.Begin();
+            uint64_t* keys = context->m_RenderListSortKeys.Begin();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                keys[i] = entries[indices[i]].m_TagListKey;
+            }
+            RadixSort(keys, indices, context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortBufferTmp.Begin(), count);
         }
         // Now find the ranges of tag masks
         {
@@ -542,7 +739,7 @@ namespace dmRender
         }
     }
 
-    Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer)
+    Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const Matrix4* frustum_matrix)
     {
         DM_PROFILE(Render, "DrawRenderList");
 
@@ -557,16 +754,18 @@ namespace dmRender
             SortRenderList(context);
         }
 
-        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0);
+        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0, frustum_matrix);
 
         if (context->m_RenderListSortBuffer.Empty())
             return RESULT_OK;
 
         {
             DM_PROFILE(Render, "DrawRenderList_SORT");
-            RenderListSorter sort;
-            sort.values = context->m_RenderListSortValues.Begin();
-            std::stable_sort(context->m_RenderListSortBuffer.Begin(), context->m_RenderListSortBuffer.End(), sort);
+            uint32_t count = context->m_RenderListSortBuffer.Size();
+            context->m_RenderListSortKeysTmp.SetSize(count);
+            context->m_RenderListSortBufferTmp.SetSize(count);
+            RadixSort(context->m_RenderListSortKeys.Begin(), context->m_RenderListSortBuffer.Begin(),
+                      context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortBufferTmp.Begin(), count);
         }
 
         // Construct render objects
@@ -726,7 +925,7 @@ namespace dmRender
         if (!context->m_DebugRenderer.m_RenderContext) {
             return RESULT_INVALID_CONTEXT;
         }
-        return DrawRenderList(context, &context->m_DebugRenderer.m_3dPredicate, 0);
+        return DrawRenderList(context, &context->m_DebugRenderer.m_3dPredicate, 0, 0);
     }
 
     Result DrawDebug2d(HRenderContext context)
@@ -734,7 +933,7 @@ namespace dmRender
         if (!context->m_DebugRenderer.m_RenderContext) {
             return RESULT_INVALID_CONTEXT;
         }
-        return DrawRenderList(context, &context->m_DebugRenderer.m_2dPredicate, 0);
+        return DrawRenderList(context, &context->m_DebugRenderer.m_2dPredicate, 0, 0);
     }
 
     void EnableRenderObjectConstant(RenderObject* ro, dmhash_t name_hash, const Vector4& value)
@@ -165,7 +165,9 @@ namespace dmRender
                 }
                 case COMMAND_TYPE_DRAW:
                 {
-                    dmRender::DrawRenderList(render_context, (dmRender::Predicate*)c->m_Operands[0], (dmRender::HNamedConstantBuffer)c->m_Operands[1]);
+                    Vectormath::Aos::Matrix4* frustum_matrix = (Vectormath::Aos::Matrix4*)c->m_Operands[2];
+                    dmRender::DrawRenderList(render_context, (dmRender::Predicate*)c->m_Operands[0], (dmRender::HNamedConstantBuffer)c->m_Operands[1], frustum_matrix);
+                    delete frustum_matrix;
                     break;
                 }
                 case COMMAND_TYPE_DRAW_DEBUG3D:
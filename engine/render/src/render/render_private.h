@@ -13,7 +13,7 @@
 #ifndef RENDERINTERNAL_H
 #define RENDERINTERNAL_H
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/array.h>
 #include <dlib/message.h>
@@ -187,13 +187,21 @@ namespace dmRender
                 uint32_t m_MajorOrder:4;        // currently only 2 bits used (dmRender::RenderOrder)
                 uint32_t m_MinorOrder:4;
             };
-            // only temporarily used
-            float m_ZW;
             // final sort value
             uint64_t m_SortKey;
         };
     };
 
+    // The six clip planes of a view projection, transposed into two groups of four planes
+    // (the last two are padding that never culls), so that one sphere is tested against four planes at a time.
+    struct FrustumPlanes
+    {
+        Vector4 m_X[2];
+        Vector4 m_Y[2];
+        Vector4 m_Z[2];
+        Vector4 m_W[2];
+    };
+
     struct RenderListRange
     {
         uint32_t m_TagListKey;
@@ -220,10 +228,18 @@ namespace dmRender
 
         dmArray<RenderListEntry>    m_RenderList;
         dmArray<RenderListDispatch> m_RenderListDispatch;
-        dmArray<RenderListSortValue>m_RenderListSortValues;
+        dmArray<uint64_t>           m_RenderListSortKeys;       // Sort keys (RenderListSortValue::m_SortKey), parallel to m_RenderListSortBuffer
+        dmArray<uint64_t>           m_RenderListSortKeysTmp;    // Scratch buffers for the radix sort
+        dmArray<uint32_t>           m_RenderListSortBufferTmp;
         dmArray<uint32_t>           m_RenderListSortBuffer;
         dmArray<uint32_t>           m_RenderListSortIndices;
         dmArray<RenderListRange>    m_RenderListRanges;         // Maps tagmask to a range in the (sorted) render list
+        dmArray<float>              m_RenderListDepths;         // Projected z/w per render list entry, for m_RenderListDepthsViewProj
+        Matrix4                     m_RenderListDepthsViewProj;
+        uint32_t                    m_RenderListDepthsCount;    // Number of entries in m_RenderListDepths that are up to date
+        dmArray<uint8_t>            m_RenderListVisible;        // Frustum test result per render list entry, for m_RenderListVisibleFrustum
+        Matrix4                     m_RenderListVisibleFrustum;
+        uint32_t                    m_RenderListVisibleCount;   // Number of entries in m_RenderListVisible that are up to date
 
         dmHashTable32<MaterialTagList>  m_MaterialTagLists;
 
@@ -287,6 +303,16 @@ namespace dmRender
     void FindRenderListRanges(uint32_t* first, size_t offset, size_t size, RenderListEntry* entries, FindRangeComparator& comp, void* ctx, RangeCallback callback );
 
     bool FindTagListRange(RenderListRange* ranges, uint32_t num_ranges, uint32_t tag_list_key, RenderListRange& range);
+
+    // Stable LSD radix sort of the values by their 64-bit keys. Byte positions where all keys are equal are skipped.
+    // The tmp buffers must have room for count elements. The result is written back to keys and values.
+    void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values, uint32_t count);
+
+    // Extract the normalized clip planes from a view projection matrix (OpenGL clip space)
+    void MakeFrustumPlanes(const Matrix4& view_proj, FrustumPlanes& planes);
+
+    // Returns false if the sphere is completely outside of any of the planes
+    bool IsSphereInFrustum(const FrustumPlanes& planes, const Point3& center, float radius);
 }
 
 #endif
@@ -1315,7 +1315,15 @@ namespace dmRender
      *
      * @name render.draw
      * @param predicate [type:predicate] predicate to draw for
-     * @param [constants] [type:constant_buffer] optional constants to use while rendering
+     * @param [options] [type:table|constant_buffer] optional table with properties, or a constant buffer:
+     *
+     * `frustum`
+     * : [type:vmath.matrix4] A frustum matrix used to cull renderable items that have bounds. (E.g. `proj * view`)
+     *   If omitted, nothing is culled.
+     *
+     * `constants`
+     * : [type:constant_buffer] optional constants to use while rendering
+     *
      * @examples
      *
      * ```lua
@@ -1335,7 +1343,15 @@ namespace dmRender
      * ```lua
      * local constants = render.constant_buffer()
      * constants.tint = vmath.vector4(1, 1, 1, 1)
-     * render.draw(self.my_pred, constants)
+     * render.draw(self.my_pred, {constants = constants})
+     * ```
+     *
+     * Draw predicate, culling anything outside of the current view:
+     *
+     * ```lua
+     * render.set_view(self.view)
+     * render.set_projection(self.proj)
+     * render.draw(self.my_pred, {frustum = self.proj * self.view})
      * ```
 
      */
@@ -1354,16 +1370,38 @@ namespace dmRender
         }
 
         HNamedConstantBuffer constant_buffer = 0;
+        Vectormath::Aos::Matrix4* frustum_matrix = 0;
         if (lua_isuserdata(L, 2))
         {
             HNamedConstantBuffer* tmp = RenderScriptConstantBuffer_Check(L, 2);
             constant_buffer = *tmp;
         }
+        else if (lua_istable(L, 2))
+        {
+            lua_getfield(L, 2, "constants");
+            if (!lua_isnil(L, -1))
+            {
+                HNamedConstantBuffer* tmp = RenderScriptConstantBuffer_Check(L, -1);
+                constant_buffer = *tmp;
+            }
+            lua_pop(L, 1);
 
-        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uintptr_t)predicate, (uintptr_t) constant_buffer)))
+            lua_getfield(L, 2, "frustum");
+            if (!lua_isnil(L, -1))
+            {
+                frustum_matrix = new Vectormath::Aos::Matrix4;
+                *frustum_matrix = *dmScript::CheckMatrix4(L, -1);
+            }
+            lua_pop(L, 1);
+        }
+
+        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uintptr_t)predicate, (uintptr_t) constant_buffer, (uintptr_t) frustum_matrix)))
             return 0;
         else
+        {
+            delete frustum_matrix;
             return luaL_error(L, "Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
+        }
     }
 
     /*# draws all 3d debug graphics
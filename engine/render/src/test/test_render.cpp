@@ -13,7 +13,7 @@
 #include <stdint.h>
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
 #include <dlib/math.h>
@@ -308,7 +308,7 @@ TEST_F(dmRenderTest, TestRenderListDraw)
     dmRender::RenderListSubmit(m_Context, out, out + n);
     dmRender::RenderListEnd(m_Context);
 
-    dmRender::DrawRenderList(m_Context, 0, 0);
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
 
     ASSERT_EQ(ctx.m_BeginCalls, 1);
     ASSERT_GT(ctx.m_BatchCalls, 1);
@@ -403,7 +403,7 @@ TEST_F(dmRenderTest, TestRenderListOrder)
     }
     dmRender::RenderListSubmit(m_Context, out, out + n);
     dmRender::RenderListEnd(m_Context);
-    dmRender::DrawRenderList(m_Context, 0, 0);
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
     ASSERT_EQ(ctx.m_BeginCalls, 1);
     ASSERT_EQ(ctx.m_BatchCalls, 1);
     ASSERT_EQ(ctx.m_EntriesRendered, 1);
@@ -429,7 +429,7 @@ TEST_F(dmRenderTest, TestRenderListOrder)
     }
     dmRender::RenderListSubmit(m_Context, out, out + n);
     dmRender::RenderListEnd(m_Context);
-    dmRender::DrawRenderList(m_Context, 0, 0);
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
     ASSERT_EQ(ctx.m_BeginCalls, 1);
     ASSERT_EQ(ctx.m_BatchCalls, 2);
     ASSERT_EQ(ctx.m_EntriesRendered, 2);
@@ -438,6 +438,89 @@ TEST_F(dmRenderTest, TestRenderListOrder)
     ASSERT_EQ(ctx.m_Z, orders[2]);
 }
 
+static void TestCullingDispatch(dmRender::RenderListDispatchParams const & params)
+{
+    if (params.m_Operation == dmRender::RENDER_LIST_OPERATION_BATCH)
+    {
+        uint32_t* rendered = (uint32_t*) params.m_UserData;
+        for (uint32_t* i = params.m_Begin; i != params.m_End; ++i)
+        {
+            *rendered |= 1 << params.m_Buf[*i].m_Order;
+        }
+    }
+}
+
+TEST_F(dmRenderTest, TestRenderListCulling)
+{
+    Vectormath::Aos::Matrix4 view = Vectormath::Aos::Matrix4::identity();
+    Vectormath::Aos::Matrix4 proj = Vectormath::Aos::Matrix4::orthographic(0.0f, WIDTH, 0.0f, HEIGHT, 0.1f, 1.0f);
+    dmRender::SetViewMatrix(m_Context, view);
+    dmRender::SetProjectionMatrix(m_Context, proj);
+
+    dmRender::FrustumPlanes planes;
+    dmRender::MakeFrustumPlanes(proj * view, planes);
+    ASSERT_TRUE(dmRender::IsSphereInFrustum(planes, Point3(WIDTH/2, HEIGHT/2, -0.5f), 1.0f));
+    ASSERT_TRUE(dmRender::IsSphereInFrustum(planes, Point3(-5.0f, HEIGHT/2, -0.5f), 10.0f));
+    ASSERT_TRUE(dmRender::IsSphereInFrustum(planes, Point3(WIDTH/2, HEIGHT/2, -2.0f), 1.5f));
+    ASSERT_FALSE(dmRender::IsSphereInFrustum(planes, Point3(-20.0f, HEIGHT/2, -0.5f), 10.0f));
+    ASSERT_FALSE(dmRender::IsSphereInFrustum(planes, Point3(WIDTH/2, HEIGHT + 20.0f, -0.5f), 10.0f));
+    ASSERT_FALSE(dmRender::IsSphereInFrustum(planes, Point3(WIDTH/2, HEIGHT/2, 1.0f), 0.5f));
+    ASSERT_FALSE(dmRender::IsSphereInFrustum(planes, Point3(WIDTH/2, HEIGHT/2, -2.0f), 0.5f));
+
+    uint32_t rendered = 0;
+    dmRender::RenderListBegin(m_Context);
+    uint8_t dispatch = dmRender::RenderListMakeDispatch(m_Context, TestCullingDispatch, &rendered);
+
+    const uint32_t n = 5;
+    const Point3 positions[n] = {
+        Point3(WIDTH/2, HEIGHT/2, -0.5f),   // inside
+        Point3(-5.0f, HEIGHT/2, -0.5f),     // intersecting
+        Point3(-100.0f, HEIGHT/2, -0.5f),   // outside
+        Point3(-100.0f, HEIGHT/2, -0.5f),   // outside, but no bounds
+        Point3(WIDTH/2, -100.0f, -0.5f),    // outside
+    };
+    const bool has_bounds[n] = { true, true, true, false, true };
+
+    dmRender::RenderListEntry* out = dmRender::RenderListAlloc(m_Context, n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        dmRender::RenderListEntry& entry = out[i];
+        entry.m_WorldPosition = positions[i];
+        entry.m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+        entry.m_MinorOrder = 0;
+        entry.m_TagListKey = 0;
+        entry.m_Order = i;
+        entry.m_BatchKey = 0;
+        entry.m_Dispatch = dispatch;
+        entry.m_UserData = 0;
+        entry.m_HasBounds = has_bounds[i];
+        entry.m_BoundingRadius = 10.0f;
+    }
+    dmRender::RenderListSubmit(m_Context, out, out + n);
+    dmRender::RenderListEnd(m_Context);
+
+    // Without a frustum, nothing is culled
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(0x1fu, rendered);
+
+    rendered = 0;
+    Vectormath::Aos::Matrix4 frustum_matrix = proj * view;
+    dmRender::DrawRenderList(m_Context, 0, 0, &frustum_matrix);
+    ASSERT_EQ(0x1u | 0x2u | 0x8u, rendered);
+
+    // Moving the frustum changes what is culled
+    rendered = 0;
+    frustum_matrix = proj * Vectormath::Aos::Matrix4::translation(Vectormath::Aos::Vector3(0.0f, 300.0f, 0.0f));
+    dmRender::DrawRenderList(m_Context, 0, 0, &frustum_matrix);
+    ASSERT_EQ(0x8u | 0x10u, rendered);
+
+    // The frustum is independent of the view projection
+    rendered = 0;
+    dmRender::SetViewMatrix(m_Context, Vectormath::Aos::Matrix4::translation(Vectormath::Aos::Vector3(0.0f, 300.0f, 0.0f)));
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(0x1fu, rendered);
+}
+
 TEST_F(dmRenderTest, TestRenderListDebug)
 {
     // Test submitting debug drawing when there is no other drawing going on
@@ -456,7 +539,7 @@ TEST_F(dmRenderTest, TestRenderListDebug)
     dmRender::Square2d(m_Context, 0, 0, 100, 100, Vector4(0,0,0,0));
     dmRender::RenderListEnd(m_Context);
 
-    dmRender::DrawRenderList(m_Context, 0, 0);
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
     dmRender::DrawDebug2d(m_Context);
     dmRender::DrawDebug3d(m_Context);
 }
@@ -781,6 +864,37 @@ TEST_F(dmRenderTest, FindRanges)
     ASSERT_EQ(6, range.m_Count);
 }
 
+TEST_F(dmRenderTest, RadixSort)
+{
+    const uint32_t count = 1000;
+    uint64_t keys[count];
+    uint32_t values[count];
+    uint64_t tmp_keys[count];
+    uint32_t tmp_values[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Few distinct keys, spread over the low and high bytes, to verify that the sort is stable
+        keys[i] = ((uint64_t)(i % 3) << 60) | ((i * 7919) % 5);
+        values[i] = i;
+    }
+
+    dmRender::RadixSort(keys, values, tmp_keys, tmp_values, count);
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        ASSERT_LE(keys[i-1], keys[i]);
+        if (keys[i-1] == keys[i])
+        {
+            ASSERT_LT(values[i-1], values[i]);
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t v = values[i];
+        ASSERT_EQ(((uint64_t)(v % 3) << 60) | ((v * 7919) % 5), keys[i]);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -13,7 +13,7 @@
 #include <stdint.h>
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 #include "render/render.h"
 #include "render/font_renderer.h"
@@ -793,6 +793,51 @@ TEST_F(dmRenderScriptTest, TestLuaDraw_HashPredicate)
     dmRender::DeleteRenderScript(m_Context, render_script);
 }
 
+TEST_F(dmRenderScriptTest, TestLuaDraw_Options)
+{
+    const char* script =
+    "function init(self)\n"
+    "    self.test_pred = render.predicate({\"one\"})\n"
+    "    local constants = render.constant_buffer()\n"
+    "    render.draw(self.test_pred)\n"
+    "    render.draw(self.test_pred, constants)\n"
+    "    render.draw(self.test_pred, {constants = constants, frustum = vmath.matrix4_translation(vmath.vector3(1, 2, 3))})\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+
+    dmArray<dmRender::Command>& commands = render_script_instance->m_CommandBuffer;
+    ASSERT_EQ(3u, commands.Size());
+
+    // No frustum culling unless a frustum is given
+    dmRender::Command* command = &commands[0];
+    ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW, command->m_Type);
+    ASSERT_EQ(0u, command->m_Operands[1]);
+    ASSERT_EQ(0u, command->m_Operands[2]);
+
+    command = &commands[1];
+    ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW, command->m_Type);
+    ASSERT_NE(0u, command->m_Operands[1]);
+    ASSERT_EQ(0u, command->m_Operands[2]);
+
+    command = &commands[2];
+    ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW, command->m_Type);
+    ASSERT_EQ(commands[1].m_Operands[1], command->m_Operands[1]);
+    Matrix4* m = (Matrix4*)command->m_Operands[2];
+    ASSERT_NE((void*)0, m);
+    Matrix4 expected = Matrix4::translation(Vector3(1, 2, 3));
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            ASSERT_EQ(expected.getElem(i, j), m->getElem(i, j));
+
+    dmRender::ParseCommands(m_Context, &commands[0], commands.Size());
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
 TEST_F(dmRenderScriptTest, TestLuaDraw_NoPredicate)
 {
     const char* script =
@@ -42,6 +42,8 @@ namespace dmLoadQueue
         dmResource::Result m_LoadResult;
         dmResource::Result m_PreloadResult;
         void* m_PreloadData;
+        // The buffer points into a memory mapped archive, and stays valid after FreeLoad
+        bool m_IsBufferMapped;
     };
 
     HQueue CreateQueue(dmResource::HFactory factory);
@@ -70,7 +70,7 @@ namespace dmLoadQueue
             return RESULT_INVALID_PARAM;
         }
 
-        load_result->m_LoadResult    = dmResource::LoadResource(queue->m_Factory, request->m_CanonicalPath, request->m_Name, buf, size);
+        load_result->m_LoadResult    = dmResource::LoadResource(queue->m_Factory, request->m_CanonicalPath, request->m_Name, buf, size, &load_result->m_IsBufferMapped);
         load_result->m_PreloadResult = dmResource::RESULT_PENDING;
         load_result->m_PreloadData   = 0;
 
@@ -81,6 +81,7 @@ namespace dmLoadQueue
             params.m_Context             = request->m_PreloadInfo.m_Context;
             params.m_Buffer              = *buf;
             params.m_BufferSize          = *size;
+            params.m_IsBufferMapped      = load_result->m_IsBufferMapped;
             params.m_HintInfo            = &request->m_PreloadInfo.m_HintInfo;
             params.m_PreloadData         = &load_result->m_PreloadData;
             load_result->m_PreloadResult = request->m_PreloadInfo.m_Function(params);
@@ -21,10 +21,23 @@
 #include <dlib/mutex.h>
 #include <dlib/time.h>
 #include <dlib/condition_variable.h>
+#include <dlib/math.h>
 
 namespace dmLoadQueue
 {
-    // Implementation of dmLoadQueue with a thread that loads items in the order they are supplied,
+    // Implementation of dmLoadQueue with a pool of threads that start loading items in the order
+    // they are supplied, but may complete them in any order.
+    //
+    // Each request is processed in two stages:
+    //   1. I/O: DoLoadResource() reads the data. Only the reading is serialized by the factory load mutex,
+    //      since the archive, manifest and http state are shared. Compressed and encrypted archive entries
+    //      are decrypted and decompressed into the request buffer after the mutex is released.
+    //   2. CPU: the preload function of the resource type parses the loaded data. This stage runs
+    //      without any locks held, so one worker reading the next entry overlaps with another worker
+    //      decoding or parsing the current one.
+    //
+    // Preload functions are thus called concurrently from the workers, also for the same resource type.
+    // They must be reentrant (see FResourcePreload).
 
     // Default to small buffers since a lot of what is loaded are just small objects anyway.
     // That way we can have more in flight, but throttle when max pending data grows too large anyway
@@ -34,14 +47,30 @@ namespace dmLoadQueue
     // This sets the bandwidth of the loader.
     const uint64_t MAX_PENDING_DATA = 4 * 1024 * 1024;
     const uint32_t QUEUE_SLOTS      = 16;
+    const uint32_t MAX_WORKER_COUNT = 4;
+
+    // The thread name must outlive the thread
+    static const char* THREAD_NAMES[MAX_WORKER_COUNT] = { "AsyncLoad", "AsyncLoad1", "AsyncLoad2", "AsyncLoad3" };
+
+    enum RequestState
+    {
+        REQUEST_STATE_FREE    = 0,
+        REQUEST_STATE_QUEUED  = 1,
+        REQUEST_STATE_LOADING = 2,
+        REQUEST_STATE_LOADED  = 3,
+    };
 
     struct Request
     {
         const char* m_Name;
         const char* m_CanonicalPath;
         dmResource::LoadBufferType m_Buffer;
+        // Set if the data was found in a memory mapped archive, in which case m_Buffer is unused
+        const void* m_MappedData;
+        uint32_t m_MappedSize;
         PreloadInfo m_PreloadInfo;
         LoadResult m_Result;
+        RequestState m_State;
     };
 
     struct Queue
@@ -49,17 +78,14 @@ namespace dmLoadQueue
         dmResource::HFactory m_Factory;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_WakeupCond;
-        dmThread::Thread m_Thread;
+        dmThread::Thread m_Threads[MAX_WORKER_COUNT];
+        uint32_t m_ThreadCount;
         Request m_Request[QUEUE_SLOTS];
-        uint32_t m_Front, m_Back, m_Loaded;
+        // Circular fifo of queued request indices, so that loading starts in the order requested
+        uint8_t m_Pending[QUEUE_SLOTS];
+        uint32_t m_PendingFront, m_PendingBack;
         uint64_t m_BytesWaiting;
         bool m_Shutdown;
-
-        // Circular queue with indexing as follow (exclusive end)
-        //
-        //          m_Back           m_Loaded   m_Front
-        // [N/A]   [loaded] [loaded] [to-load]  [N/A]
-        //
     };
 
     static Request* GetNextRequest(Queue* queue)
@@ -73,12 +99,15 @@ namespace dmLoadQueue
             return 0x0;
         }
 
-        if (queue->m_Loaded == queue->m_Front)
+        if (queue->m_PendingBack == queue->m_PendingFront)
         {
             return 0x0;
         }
 
-        return &queue->m_Request[queue->m_Loaded % QUEUE_SLOTS];
+        Request* request = &queue->m_Request[queue->m_Pending[(queue->m_PendingBack++) % QUEUE_SLOTS]];
+        assert(request->m_State == REQUEST_STATE_QUEUED);
+        request->m_State = REQUEST_STATE_LOADING;
+        return request;
     }
 
     static void LoadThread(void* arg)
@@ -92,70 +121,68 @@ namespace dmLoadQueue
                 dmMutex::ScopedLock lk(queue->m_Mutex);
                 if (current != 0)
                 {
-                    // Just finished one (from previous iteratino)
+                    // Just finished one (from previous iteration)
                     queue->m_BytesWaiting += current->m_Buffer.Capacity();
-                    queue->m_Loaded++;
                     current->m_Result = result;
+                    current->m_State  = REQUEST_STATE_LOADED;
                     current           = 0;
                 }
-                if (queue->m_Shutdown)
-                {
-                    return;
-                }
 
-                current = GetNextRequest(queue);
-                if (current == 0x0)
+                while (!queue->m_Shutdown && (current = GetNextRequest(queue)) == 0x0)
                 {
                     // Nothing to do, reset any buffers of inactive requests that are not at default capacity
                     for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
                     {
                         Request* r = &queue->m_Request[i];
-                        if (r->m_Buffer.Size() == 0)
+                        if (r->m_State == REQUEST_STATE_FREE && r->m_Buffer.Capacity() > DEFAULT_CAPACITY)
                         {
-                            if (r->m_Buffer.Capacity() > DEFAULT_CAPACITY)
-                            {
-                                // Just free the memory here, no need to allocate while holding the mutex
-                                r->m_Buffer.SetCapacity(0);
-                            }
+                            // Just free the memory here, no need to allocate while holding the mutex
+                            r->m_Buffer.SetCapacity(0);
                         }
                     }
                     dmConditionVariable::Wait(queue->m_WakeupCond, queue->m_Mutex);
-                    current = GetNextRequest(queue);
+                }
+
+                if (queue->m_Shutdown)
+                {
+                    return;
                 }
             }
 
-            if (current)
-            {
-                // We use the temporary result object here to fill in the data so it can be written with the mutex held.
-                uint32_t size;
+            // We use the temporary result object here to fill in the data so it can be written with the mutex held.
+            uint32_t size;
+            const void* mapped_data;
 
-                assert(current->m_Buffer.Size() == 0);
-                if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
+            assert(current->m_Buffer.Size() == 0);
+            if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
+            {
+                current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
+            }
+            result.m_LoadResult     = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer, &mapped_data);
+            result.m_PreloadResult  = dmResource::RESULT_PENDING;
+            result.m_PreloadData    = 0;
+            result.m_IsBufferMapped = mapped_data != 0;
+            current->m_MappedData   = mapped_data;
+            current->m_MappedSize   = mapped_data ? size : 0;
+
+            if (result.m_LoadResult == dmResource::RESULT_OK)
+            {
+                assert(mapped_data || current->m_Buffer.Size() == size);
+                if (current->m_PreloadInfo.m_Function)
                 {
-                    current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
+                    dmResource::ResourcePreloadParams params;
+                    params.m_Factory        = queue->m_Factory;
+                    params.m_Context        = current->m_PreloadInfo.m_Context;
+                    params.m_Buffer         = mapped_data ? mapped_data : current->m_Buffer.Begin();
+                    params.m_BufferSize     = size;
+                    params.m_IsBufferMapped = result.m_IsBufferMapped;
+                    params.m_HintInfo       = &current->m_PreloadInfo.m_HintInfo;
+                    params.m_PreloadData    = &result.m_PreloadData;
+                    result.m_PreloadResult = current->m_PreloadInfo.m_Function(params);
                 }
-                result.m_LoadResult    = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer);
-                result.m_PreloadResult = dmResource::RESULT_PENDING;
-                result.m_PreloadData   = 0;
-
-                if (result.m_LoadResult == dmResource::RESULT_OK)
+                else
                 {
-                    assert(current->m_Buffer.Size() == size);
-                    if (current->m_PreloadInfo.m_Function)
-                    {
-                        dmResource::ResourcePreloadParams params;
-                        params.m_Factory       = queue->m_Factory;
-                        params.m_Context       = current->m_PreloadInfo.m_Context;
-                        params.m_Buffer        = current->m_Buffer.Begin();
-                        params.m_BufferSize    = current->m_Buffer.Size();
-                        params.m_HintInfo      = &current->m_PreloadInfo.m_HintInfo;
-                        params.m_PreloadData   = &result.m_PreloadData;
-                        result.m_PreloadResult = current->m_PreloadInfo.m_Function(params);
-                    }
-                    else
-                    {
-                        result.m_PreloadResult = dmResource::RESULT_OK;
-                    }
+                    result.m_PreloadResult = dmResource::RESULT_OK;
                 }
             }
         }
@@ -165,14 +192,23 @@ namespace dmLoadQueue
     {
         Queue* q          = new Queue();
         q->m_Factory      = factory;
-        q->m_Front        = 0;
-        q->m_Back         = 0;
-        q->m_Loaded       = 0;
+        q->m_PendingFront = 0;
+        q->m_PendingBack  = 0;
         q->m_Shutdown     = false;
         q->m_BytesWaiting = 0;
         q->m_Mutex        = dmMutex::New();
         q->m_WakeupCond   = dmConditionVariable::New();
-        q->m_Thread       = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
+        {
+            q->m_Request[i].m_State = REQUEST_STATE_FREE;
+        }
+
+        uint32_t thread_count = dmMath::Clamp(dmResource::GetLoadWorkerCount(factory), 1u, MAX_WORKER_COUNT);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            q->m_Threads[i] = dmThread::New(&LoadThread, 65536, q, THREAD_NAMES[i]);
+        }
+        q->m_ThreadCount = thread_count;
 
         return q;
     }
@@ -182,10 +218,13 @@ namespace dmLoadQueue
         {
             dmMutex::ScopedLock lk(queue->m_Mutex);
             queue->m_Shutdown = true;
-            // Wake up the worker so it can exit and allow us to join
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up the workers so they can exit and allow us to join
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        for (uint32_t i = 0; i < queue->m_ThreadCount; ++i)
+        {
+            dmThread::Join(queue->m_Threads[i]);
         }
-        dmThread::Join(queue->m_Thread);
         dmConditionVariable::Delete(queue->m_WakeupCond);
         dmMutex::Delete(queue->m_Mutex);
         delete queue;
@@ -201,33 +240,46 @@ namespace dmLoadQueue
         dmMutex::ScopedLock lk(queue->m_Mutex);
 
         // Refuse more if full.
-        if ((queue->m_Front - queue->m_Back) == QUEUE_SLOTS)
-            return 0;
-
-        if (queue->m_Loaded == queue->m_Front)
+        uint32_t index = 0;
+        while (index < QUEUE_SLOTS && queue->m_Request[index].m_State != REQUEST_STATE_FREE)
         {
-            // The worker is sleeping waiting for request, wake it up
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            ++index;
         }
+        if (index == QUEUE_SLOTS)
+            return 0;
 
-        Request* req         = &queue->m_Request[(queue->m_Front++) % QUEUE_SLOTS];
+        Request* req         = &queue->m_Request[index];
         req->m_Name          = name;
         req->m_CanonicalPath = canonical_path;
+        req->m_State         = REQUEST_STATE_QUEUED;
 
         req->m_PreloadInfo         = *info;
         req->m_Result.m_LoadResult = dmResource::RESULT_PENDING;
 
+        queue->m_Pending[(queue->m_PendingFront++) % QUEUE_SLOTS] = (uint8_t) index;
+
+        // Wake up a sleeping worker, if any
+        dmConditionVariable::Signal(queue->m_WakeupCond);
+
         return req;
     }
 
     Result EndLoad(HQueue queue, HRequest request, void** buf, uint32_t* size, LoadResult* load_result)
     {
         dmMutex::ScopedLock lk(queue->m_Mutex);
-        if (request->m_Result.m_LoadResult == dmResource::RESULT_PENDING)
+        if (request->m_State != REQUEST_STATE_LOADED)
             return RESULT_PENDING;
 
-        *buf         = request->m_Buffer.Begin();
-        *size        = request->m_Buffer.Size();
+        if (request->m_MappedData)
+        {
+            *buf  = (void*) request->m_MappedData;
+            *size = request->m_MappedSize;
+        }
+        else
+        {
+            *buf  = request->m_Buffer.Begin();
+            *size = request->m_Buffer.Size();
+        }
         *load_result = request->m_Result;
 
         return RESULT_OK;
@@ -236,29 +288,30 @@ namespace dmLoadQueue
     void FreeLoad(HQueue queue, HRequest request)
     {
         dmMutex::ScopedLock lk(queue->m_Mutex);
+        assert(request->m_State == REQUEST_STATE_LOADED);
 
-        uint32_t old_bytes_waiting = queue->m_BytesWaiting;
+        uint64_t old_bytes_waiting = queue->m_BytesWaiting;
 
         // Make sure we don't copy any data if we reallocate the buffer
         request->m_Buffer.SetSize(0);
 
         uint32_t buffer_capacity = request->m_Buffer.Capacity();
         queue->m_BytesWaiting -= buffer_capacity;
-        // If we either have blocked further processing by exceeding MAX_PENDING_DATA or
-        // the buffer has a non-default capacity, we want to wake up the worker
-        if (buffer_capacity != DEFAULT_CAPACITY || (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA))
+        // If we have blocked further processing by exceeding MAX_PENDING_DATA, all workers may be waiting.
+        // If the buffer has a non-default capacity, we want to wake up a worker to trim it.
+        if (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA)
+        {
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        else if (buffer_capacity != DEFAULT_CAPACITY)
         {
-            // Wake up thread, we can now fit a new request
             dmConditionVariable::Signal(queue->m_WakeupCond);
         }
 
         // Clean up picked up requests
         request->m_Name          = 0x0;
         request->m_CanonicalPath = 0x0;
-
-        while (queue->m_Back != queue->m_Loaded && queue->m_Request[queue->m_Back % QUEUE_SLOTS].m_Name == 0x0)
-        {
-            queue->m_Back++;
-        }
+        request->m_MappedData    = 0x0;
+        request->m_State         = REQUEST_STATE_FREE;
     }
 } // namespace dmLoadQueue
@@ -109,6 +109,8 @@ namespace dmResource
         const void* m_Buffer;
         /// Size of data buffer
         uint32_t m_BufferSize;
+        /// True if the buffer points into a memory mapped archive. The data is then valid until the factory is deleted, and may be referenced instead of copied
+        bool m_IsBufferMapped;
         /// Hinter info. Use this when calling PreloadHint
         HPreloadHintInfo m_HintInfo;
         /// Writable user data that will be passed on to ResourceCreate function
@@ -145,6 +147,9 @@ namespace dmResource
      * Resource preloading function. This may be called from a separate loading thread
      * but will not keep any mutexes held while executing the call. During this call
      * PreloadHint can be called with the supplied hint_info handle.
+     * There may be several loading threads, calling the function concurrently (also for the same
+     * resource type), so it must be reentrant: it may read the context and write to its own
+     * preload data, but any other shared state must be synchronized by the function itself.
      * If RESULT_OK is returned, the resource Create function is guaranteed to be called
      * with the preload_data value supplied.
      * @param param Resource preloading parameters
@@ -167,6 +172,8 @@ namespace dmResource
         const void* m_Buffer;
         /// Size of the data buffer
         uint32_t m_BufferSize;
+        /// True if the buffer points into a memory mapped archive. The data is then valid until the factory is deleted, and may be referenced instead of copied
+        bool m_IsBufferMapped;
         /// Preloaded data from Preload phase
         void* m_PreloadData;
         /// Resource descriptor to fill in
@@ -47,6 +47,7 @@
 #include <dlib/sys.h>
 #include <dlib/time.h>
 #include <dlib/mutex.h>
+#include <dlib/spinlock.h>
 
 #include "resource.h"
 #include "resource_private.h"
@@ -78,6 +79,7 @@ const char* BUNDLE_DATA_FILENAME                = "game.arcd";
 
 
 const char* MAX_RESOURCES_KEY = "resource.max_resources";
+const char* LOAD_WORKER_COUNT_KEY = "resource.load_worker_count";
 
 struct ResourceReloadedCallbackPair
 {
@@ -102,6 +104,12 @@ struct SResourceFactory
     // with GetRaw (used for async threaded loading). Liveupdate, HttpClient, m_Buffer
     // m_BuiltinsManifest, m_Manifest
     dmMutex::HMutex                              m_LoadMutex;
+    // Guard for the reads from the archive files. Taken by ReadResourceFile without m_LoadMutex,
+    // since the sound thread streams from the archive while the main thread holds m_LoadMutex
+    dmMutex::HMutex                              m_IOMutex;
+    // Guard for m_Resources, m_ResourceToHash and the reference counts, so that IncRef/Release
+    // from worker threads never wait for a load. Never held during I/O or resource callbacks.
+    dmSpinlock::lock_t                           m_ResourceTableLock;
 
     // dmResource::Get recursion depth
     uint32_t                                     m_RecursionDepth;
@@ -131,6 +139,9 @@ struct SResourceFactory
     Manifest*                                    m_Manifest;
     void*                                        m_ArchiveMountInfo;
 
+    // Number of async load queue threads
+    uint32_t                                     m_LoadWorkerCount;
+
     uint8_t                                      m_UseLiveUpdate : 1;
 };
 
@@ -192,6 +203,7 @@ void SetDefaultNewFactoryParams(struct NewFactoryParams* params)
 {
     params->m_MaxResources = 1024;
     params->m_Flags = RESOURCE_FACTORY_FLAGS_EMPTY;
+    params->m_LoadWorkerCount = 2;
 
     params->m_ArchiveManifest.m_Data = 0;
     params->m_ArchiveManifest.m_Size = 0;
@@ -262,6 +274,8 @@ void SetManifest(HFactory factory, Manifest* manifest)
         factory->m_Manifest->m_ArchiveIndex = 0;
     }
 
+    DM_MUTEX_SCOPED_LOCK(factory->m_IOMutex);
+
     if (manifest != factory->m_Manifest)
         DeleteManifest(factory->m_Manifest);
 
@@ -456,6 +470,7 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     memset(factory, 0, sizeof(*factory));
     factory->m_Socket = socket;
     factory->m_UseLiveUpdate = params->m_Flags & RESOURCE_FACTORY_FLAGS_LIVE_UPDATE ? 1 : 0;
+    factory->m_LoadWorkerCount = params->m_LoadWorkerCount;
 
     dmURI::Result uri_result = dmURI::Parse(uri, &factory->m_UriParts);
     if (uri_result != dmURI::RESULT_OK)
@@ -654,6 +669,8 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     }
 
     factory->m_LoadMutex = dmMutex::New();
+    factory->m_IOMutex = dmMutex::New();
+    dmSpinlock::Init(&factory->m_ResourceTableLock);
     return factory;
 }
 
@@ -680,6 +697,10 @@ void DeleteFactory(HFactory factory)
     {
         dmMutex::Delete(factory->m_LoadMutex);
     }
+    if (factory->m_IOMutex)
+    {
+        dmMutex::Delete(factory->m_IOMutex);
+    }
 
     if (factory->m_Manifest)
     {
@@ -847,7 +868,7 @@ Result VerifyResourcesBundled(dmResourceArchive::HArchiveIndexContainer base_arc
     return VerifyResourcesBundled(entries, entry_count, hash_len, base_archive);
 }
 
-static Result LoadFromManifest(const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer)
+static Result FindEntryFromManifest(const Manifest* manifest, const char* path, dmResourceArchive::HArchiveIndexContainer* archive, dmResourceArchive::EntryData* entry, const uint8_t** hash, uint32_t* hash_len)
 {
     dmhash_t path_hash = dmHashString64(path);
 
@@ -858,47 +879,261 @@ static Result LoadFromManifest(const Manifest* manifest, const char* path, uint3
 
     dmLiveUpdateDDF::HashAlgorithm algorithm = manifest->m_DDFData->m_Header.m_ResourceHashAlgorithm;
     dmLiveUpdateDDF::ResourceEntry* entries = manifest->m_DDFData->m_Resources.m_Data;
+    *hash = entries[index].m_Hash.m_Data.m_Data;
+    *hash_len = dmResource::HashLength(algorithm);
+    dmResourceArchive::Result res = dmResourceArchive::FindEntry(manifest->m_ArchiveIndex, *hash, *hash_len, archive, entry);
+    if (res == dmResourceArchive::RESULT_OK)
+    {
+        return RESULT_OK;
+    }
+    else if (res == dmResourceArchive::RESULT_NOT_FOUND)
+    {
+        // Resource was found in manifest, but not in archive
+        return RESULT_RESOURCE_NOT_FOUND;
+    }
+
+    return RESULT_IO_ERROR;
+}
+
+// The bytes of a compressed or encrypted archive entry, read with the load mutex held, to be decoded once it is released
+struct StoredEntry
+{
+    dmResourceArchive::EntryData    m_Entry;
+    // The load buffer if the entry is uncompressed, else allocated or in a memory mapped archive.
+    // 0 if the resource was loaded completely
+    void*                           m_Data;
+    // True if m_Data is allocated and has to be freed once decoded
+    bool                            m_Owned;
+};
+
+// If 'stored' is set, compressed and encrypted entries of the default reader are only read, see DoLoadResource
+static Result LoadFromManifest(HFactory factory, const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer, const void** mapped_data, StoredEntry* stored)
+{
     dmResourceArchive::EntryData ed;
     dmResourceArchive::HArchiveIndexContainer archive;
-    uint8_t* hash = entries[index].m_Hash.m_Data.m_Data;
-    uint32_t hash_len = dmResource::HashLength(algorithm);
-    dmResourceArchive::Result res = dmResourceArchive::FindEntry(manifest->m_ArchiveIndex, hash, hash_len, &archive, &ed);
-    if (res == dmResourceArchive::RESULT_OK)
+    const uint8_t* hash;
+    uint32_t hash_len;
+    Result r = FindEntryFromManifest(manifest, path, &archive, &ed, &hash, &hash_len);
+    if (r != RESULT_OK)
     {
-        uint32_t file_size = ed.m_ResourceSize;
-        if (buffer->Capacity() < file_size)
+        return r;
+    }
+
+    uint32_t file_size = ed.m_ResourceSize;
+    buffer->SetSize(0);
+    if (mapped_data && dmResourceArchive::MapEntryFromArchive(archive, &ed, mapped_data) == dmResourceArchive::RESULT_OK)
+    {
+        // Use the data in place, no need to copy it
+        *resource_size = file_size;
+        return RESULT_OK;
+    }
+
+    if (buffer->Capacity() < file_size)
+    {
+        buffer->SetCapacity(file_size);
+    }
+
+    dmResourceArchive::Result read_result;
+    if (stored && dmResourceArchive::IsEntryStoredEncoded(archive, &ed))
+    {
+        // Unencrypted entries are decompressed directly from a memory mapped archive
+        const void* mapped_stored = 0;
+        if (dmResourceArchive::MapEntryStoredFromArchive(archive, &ed, &mapped_stored) == dmResourceArchive::RESULT_OK)
         {
-            buffer->SetCapacity(file_size);
+            stored->m_Entry = ed;
+            stored->m_Data  = (void*) mapped_stored;
+            stored->m_Owned = false;
+            *resource_size  = file_size;
+            return RESULT_OK;
         }
 
-        buffer->SetSize(0);
-        dmResourceArchive::Result read_result = dmResourceArchive::Read(archive, hash, hash_len, &ed, buffer->Begin());
+        // Decompression needs a separate source buffer, decryption is done in place
+        bool compressed = ed.m_ResourceCompressedSize != 0xFFFFFFFF;
+        void* data = compressed ? malloc(dmResourceArchive::GetEntryStoredSize(&ed)) : buffer->Begin();
+        {
+            DM_MUTEX_SCOPED_LOCK(factory->m_IOMutex);
+            read_result = dmResourceArchive::ReadEntryStoredFromArchive(archive, &ed, data);
+        }
         if (read_result != dmResourceArchive::RESULT_OK)
         {
+            if (compressed)
+                free(data);
             return RESULT_IO_ERROR;
         }
 
-        buffer->SetSize(file_size);
-        *resource_size = file_size;
+        // The buffer size is set once the data is decoded
+        stored->m_Entry = ed;
+        stored->m_Data  = data;
+        stored->m_Owned = compressed;
+        *resource_size  = file_size;
+        return RESULT_OK;
+    }
+
+    {
+        DM_MUTEX_SCOPED_LOCK(factory->m_IOMutex);
+        read_result = dmResourceArchive::Read(archive, hash, hash_len, &ed, buffer->Begin());
+    }
+    if (read_result != dmResourceArchive::RESULT_OK)
+    {
+        return RESULT_IO_ERROR;
+    }
 
+    buffer->SetSize(file_size);
+    *resource_size = file_size;
+
+    return RESULT_OK;
+}
+
+struct ResourceFile
+{
+    HFactory                                    m_Factory;
+    // The entry, if the file is in an archive
+    dmResourceArchive::HArchiveIndexContainer   m_Archive;
+    dmResourceArchive::EntryData                m_Entry;
+    // The path, if the file is in the file system
+    char                                        m_Path[RESOURCE_PATH_MAX];
+    uint32_t                                    m_Size;
+};
+
+// Assumes m_LoadMutex is already held
+// Finds the data of a resource in the same order as DoLoadResourceLocked, if it can be read in parts
+static Result FindResourceFileLocked(HFactory factory, const char* path, const char* original_name, ResourceFile* file)
+{
+    memset(file, 0, sizeof(*file));
+    file->m_Factory = factory;
+
+    const uint8_t* hash;
+    uint32_t hash_len;
+    Result r = RESULT_RESOURCE_NOT_FOUND;
+    if (factory->m_BuiltinsManifest)
+    {
+        r = FindEntryFromManifest(factory->m_BuiltinsManifest, original_name, &file->m_Archive, &file->m_Entry, &hash, &hash_len);
+    }
+
+    if (r != RESULT_OK)
+    {
+        if (factory->m_HttpClient)
+        {
+            return RESULT_NOT_SUPPORTED;
+        }
+        else if (factory->m_Manifest)
+        {
+            r = FindEntryFromManifest(factory->m_Manifest, original_name, &file->m_Archive, &file->m_Entry, &hash, &hash_len);
+            if (r != RESULT_OK)
+            {
+                return r;
+            }
+        }
+        else
+        {
+            char factory_path[RESOURCE_PATH_MAX];
+            GetCanonicalPathFromBase(factory->m_UriParts.m_Path, path, factory_path);
+            if (dmSys::RESULT_OK != dmSys::ResolveMountFileName(file->m_Path, sizeof(file->m_Path), factory_path))
+            {
+                return RESULT_RESOURCE_NOT_FOUND;
+            }
+
+            dmSys::Result sr = dmSys::ResourceSize(file->m_Path, &file->m_Size);
+            if (sr != dmSys::RESULT_OK)
+            {
+                return sr == dmSys::RESULT_NOENT ? RESULT_RESOURCE_NOT_FOUND : RESULT_IO_ERROR;
+            }
+            return RESULT_OK;
+        }
+    }
+
+    // Compressed and encrypted entries can only be read as a whole
+    if (!dmResourceArchive::IsEntryStoredUncompressed(file->m_Archive, &file->m_Entry))
+    {
+        return RESULT_NOT_SUPPORTED;
+    }
+    file->m_Size = file->m_Entry.m_ResourceSize;
+    return RESULT_OK;
+}
+
+static Result DoReadResourceFile(ResourceFile* file, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread)
+{
+    if (file->m_Archive)
+    {
+        DM_MUTEX_SCOPED_LOCK(file->m_Factory->m_IOMutex);
+        dmResourceArchive::Result r = dmResourceArchive::ReadEntryPartialFromArchive(file->m_Archive, &file->m_Entry, offset, size, buffer, nread);
+        return r == dmResourceArchive::RESULT_OK ? RESULT_OK : RESULT_IO_ERROR;
+    }
+
+    dmSys::Result r = dmSys::LoadResourcePartial(file->m_Path, offset, buffer, size, nread);
+    if (r == dmSys::RESULT_OK)
         return RESULT_OK;
+    return r == dmSys::RESULT_NOENT ? RESULT_RESOURCE_NOT_FOUND : RESULT_IO_ERROR;
+}
+
+// Assumes m_LoadMutex is already held
+// Loads the first part of a resource of a type with a preload size. Returns RESULT_NOT_SUPPORTED if the resource is loaded as a whole
+static Result LoadResourcePartLocked(HFactory factory, const char* path, const char* original_name, uint32_t preload_size, uint32_t* resource_size, LoadBufferType* buffer)
+{
+    ResourceFile file;
+    Result r = FindResourceFileLocked(factory, path, original_name, &file);
+    if (r != RESULT_OK)
+    {
+        return r;
     }
-    else if (res == dmResourceArchive::RESULT_NOT_FOUND)
+
+    // Entries in a memory mapped archive are used in place instead
+    const void* mapped_data;
+    if (file.m_Size <= preload_size || (file.m_Archive && dmResourceArchive::MapEntryFromArchive(file.m_Archive, &file.m_Entry, &mapped_data) == dmResourceArchive::RESULT_OK))
     {
-        // Resource was found in manifest, but not in archive
-        return RESULT_RESOURCE_NOT_FOUND;
+        return RESULT_NOT_SUPPORTED;
     }
 
-    return RESULT_IO_ERROR;
+    if (buffer->Capacity() < preload_size)
+    {
+        buffer->SetCapacity(preload_size);
+    }
+    buffer->SetSize(0);
+
+    uint32_t nread = 0;
+    r = DoReadResourceFile(&file, 0, preload_size, buffer->Begin(), &nread);
+    if (r != RESULT_OK)
+    {
+        return r;
+    }
+    buffer->SetSize(nread);
+    *resource_size = nread;
+    return RESULT_OK;
+}
+
+static uint32_t GetPreloadSize(HFactory factory, const char* path)
+{
+    const char* ext = strrchr(path, '.');
+    if (!ext)
+        return 0;
+    SResourceType* resource_type = FindResourceType(factory, ext + 1);
+    return resource_type ? resource_type->m_PreloadSize : 0;
 }
 
 // Assumes m_LoadMutex is already held
-static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
+// If 'stored' is set, the data of compressed and encrypted archive entries might be returned in it, still to be decoded
+static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** mapped_data, StoredEntry* stored)
 {
     DM_PROFILE(Resource, "LoadResource");
+    if (mapped_data)
+    {
+        *mapped_data = 0;
+
+        // The resource is loaded to be created, which only needs the first part of it for some types
+        uint32_t preload_size = GetPreloadSize(factory, path);
+        if (preload_size > 0)
+        {
+            Result r = LoadResourcePartLocked(factory, path, original_name, preload_size, resource_size, buffer);
+            if (r != RESULT_NOT_SUPPORTED)
+            {
+                return r;
+            }
+        }
+    }
+
     if (factory->m_BuiltinsManifest)
     {
-        if (LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer) == RESULT_OK)
+        if (LoadFromManifest(factory, factory->m_BuiltinsManifest, original_name, resource_size, buffer, mapped_data, stored) == RESULT_OK)
         {
             return RESULT_OK;
         }
@@ -952,7 +1187,7 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
     }
     else if (factory->m_Manifest)
     {
-        Result r = LoadFromManifest(factory->m_Manifest, original_name, resource_size, buffer);
+        Result r = LoadFromManifest(factory, factory->m_Manifest, original_name, resource_size, buffer, mapped_data, stored);
         return r;
     }
     else
@@ -996,26 +1231,55 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
     }
 }
 
-// Takes the lock.
-Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
+// Takes the lock, but only while the data is read. Compressed and encrypted archive entries are
+// decoded after it is released, so that the loader threads can decode in parallel.
+Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** mapped_data)
 {
-    // Called from async queue so we wrap around a lock
-    dmMutex::ScopedLock lk(factory->m_LoadMutex);
-    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer);
+    StoredEntry stored;
+    stored.m_Data = 0;
+    stored.m_Owned = false;
+    Result r;
+    {
+        // Called from async queue so we wrap around a lock
+        dmMutex::ScopedLock lk(factory->m_LoadMutex);
+        r = DoLoadResourceLocked(factory, path, original_name, resource_size, buffer, mapped_data, &stored);
+    }
+
+    if (stored.m_Data)
+    {
+        DM_PROFILE(Resource, "DecodeResource");
+        assert(r == RESULT_OK);
+        dmResourceArchive::Result decode_result = dmResourceArchive::DecodeEntry(&stored.m_Entry, stored.m_Data, buffer->Begin());
+        if (stored.m_Owned)
+        {
+            free(stored.m_Data);
+        }
+        if (decode_result != dmResourceArchive::RESULT_OK)
+        {
+            return RESULT_IO_ERROR;
+        }
+        buffer->SetSize(*resource_size);
+    }
+    return r;
 }
 
 // Assumes m_LoadMutex is already held
-Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size)
+Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size, bool* is_mapped)
 {
     if (factory->m_Buffer.Capacity() != DEFAULT_BUFFER_SIZE) {
         factory->m_Buffer.SetCapacity(DEFAULT_BUFFER_SIZE);
     }
     factory->m_Buffer.SetSize(0);
-    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer);
-    if (r == RESULT_OK)
-        *buffer = factory->m_Buffer.Begin();
-    else
+    const void* mapped_data = 0;
+    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer, is_mapped ? &mapped_data : 0, 0);
+    if (is_mapped)
+        *is_mapped = mapped_data != 0;
+    if (r != RESULT_OK)
         *buffer = 0;
+    else if (mapped_data)
+        *buffer = (void*) mapped_data;
+    else
+        *buffer = factory->m_Buffer.Begin();
     return r;
 }
 
@@ -1050,13 +1314,16 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
     uint64_t canonical_path_hash = dmHashBuffer64(canonical_path, strlen(canonical_path));
 
     // Try to get from already loaded resources
-    SResourceDescriptor* rd = factory->m_Resources->Get(canonical_path_hash);
-    if (rd)
     {
-        assert(factory->m_ResourceToHash->Get((uintptr_t) rd->m_Resource));
-        rd->m_ReferenceCount++;
-        *resource = rd->m_Resource;
-        return RESULT_OK;
+        DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
+        SResourceDescriptor* rd = factory->m_Resources->Get(canonical_path_hash);
+        if (rd)
+        {
+            assert(factory->m_ResourceToHash->Get((uintptr_t) rd->m_Resource));
+            rd->m_ReferenceCount++;
+            *resource = rd->m_Resource;
+            return RESULT_OK;
+        }
     }
 
     if (factory->m_Resources->Full())
@@ -1080,7 +1347,8 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
 
         void *buffer;
         uint32_t file_size;
-        Result result = LoadResource(factory, canonical_path, name, &buffer, &file_size);
+        bool is_mapped;
+        Result result = LoadResource(factory, canonical_path, name, &buffer, &file_size, &is_mapped);
         if (result != RESULT_OK) {
             if (result == RESULT_RESOURCE_NOT_FOUND) {
                 dmLogWarning("Resource not found: %s", name);
@@ -1088,7 +1356,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             return result;
         }
 
-        assert(buffer == factory->m_Buffer.Begin());
+        assert(is_mapped || buffer == factory->m_Buffer.Begin());
 
         // TODO: We should *NOT* allocate SResource dynamically...
         SResourceDescriptor tmp_resource;
@@ -1107,6 +1375,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             params.m_Context = resource_type->m_Context;
             params.m_Buffer = buffer;
             params.m_BufferSize = file_size;
+            params.m_IsBufferMapped = is_mapped;
             params.m_PreloadData = &preload_data;
             params.m_Filename = name;
             params.m_HintInfo = 0; // No hinting now
@@ -1123,6 +1392,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             params.m_Context = resource_type->m_Context;
             params.m_Buffer = buffer;
             params.m_BufferSize = file_size;
+            params.m_IsBufferMapped = is_mapped;
             params.m_PreloadData = preload_data;
             params.m_Resource = &tmp_resource;
             params.m_Filename = name;
@@ -1232,6 +1502,7 @@ Result Get(HFactory factory, const char* name, void** resource)
 
 SResourceDescriptor* FindByHash(HFactory factory, uint64_t canonical_path_hash)
 {
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     return factory->m_Resources->Get(canonical_path_hash);
 }
 
@@ -1246,8 +1517,11 @@ Result InsertResource(HFactory factory, const char* path, uint64_t canonical_pat
     assert(descriptor->m_Resource);
     assert(descriptor->m_ReferenceCount == 1);
 
-    factory->m_Resources->Put(canonical_path_hash, *descriptor);
-    factory->m_ResourceToHash->Put((uintptr_t) descriptor->m_Resource, canonical_path_hash);
+    {
+        DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
+        factory->m_Resources->Put(canonical_path_hash, *descriptor);
+        factory->m_ResourceToHash->Put((uintptr_t) descriptor->m_Resource, canonical_path_hash);
+    }
     if (factory->m_ResourceHashToFilename)
     {
         char canonical_path[RESOURCE_PATH_MAX];
@@ -1511,6 +1785,7 @@ Result GetType(HFactory factory, void* resource, ResourceType* type)
 {
     assert(type);
 
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t) resource);
     if (!resource_hash)
     {
@@ -1541,6 +1816,50 @@ Result GetTypeFromExtension(HFactory factory, const char* extension, ResourceTyp
     }
 }
 
+Result SetTypePreloadSize(HFactory factory, const char* extension, uint32_t preload_size)
+{
+    SResourceType* resource_type = FindResourceType(factory, extension);
+    if (resource_type == 0)
+    {
+        return RESULT_UNKNOWN_RESOURCE_TYPE;
+    }
+    resource_type->m_PreloadSize = preload_size;
+    return RESULT_OK;
+}
+
+Result OpenResourceFile(HFactory factory, const char* name, HResourceFile* file, uint32_t* file_size)
+{
+    char canonical_path[RESOURCE_PATH_MAX];
+    GetCanonicalPath(name, canonical_path);
+
+    ResourceFile tmp;
+    Result r;
+    {
+        dmMutex::ScopedLock lk(factory->m_LoadMutex);
+        r = FindResourceFileLocked(factory, canonical_path, name, &tmp);
+    }
+    if (r != RESULT_OK)
+    {
+        *file = 0;
+        return r;
+    }
+
+    *file = new ResourceFile(tmp);
+    *file_size = tmp.m_Size;
+    return RESULT_OK;
+}
+
+Result ReadResourceFile(HResourceFile file, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread)
+{
+    DM_PROFILE(Resource, "ReadResourceFile");
+    return DoReadResourceFile(file, offset, size, buffer, nread);
+}
+
+void CloseResourceFile(HResourceFile file)
+{
+    delete file;
+}
+
 Result GetExtensionFromType(HFactory factory, ResourceType type, const char** extension)
 {
     for (uint32_t i = 0; i < factory->m_ResourceTypesCount; ++i)
@@ -1565,6 +1884,7 @@ Result GetDescriptor(HFactory factory, const char* name, SResourceDescriptor* de
 
     uint64_t canonical_path_hash = dmHashBuffer64(canonical_path, strlen(canonical_path));
 
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     SResourceDescriptor* tmp_descriptor = factory->m_Resources->Get(canonical_path_hash);
     if (tmp_descriptor)
     {
@@ -1579,6 +1899,7 @@ Result GetDescriptor(HFactory factory, const char* name, SResourceDescriptor* de
 
 Result GetDescriptorWithExt(HFactory factory, uint64_t hashed_name, const uint64_t* exts, uint32_t ext_count, SResourceDescriptor* descriptor)
 {
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     SResourceDescriptor* tmp_descriptor = factory->m_Resources->Get(hashed_name);
     if (!tmp_descriptor) {
         return RESULT_NOT_LOADED;
@@ -1604,6 +1925,8 @@ Result GetDescriptorWithExt(HFactory factory, uint64_t hashed_name, const uint64
 
 void IncRef(HFactory factory, void* resource)
 {
+    // Component types may update on worker threads (see dmGameObject::ComponentTypeSetParallelUpdate)
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t) resource);
     assert(resource_hash);
 
@@ -1616,6 +1939,7 @@ void IncRef(HFactory factory, void* resource)
 // For unit testing
 uint32_t GetRefCount(HFactory factory, void* resource)
 {
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t) resource);
     if(!resource_hash)
         return 0;
@@ -1626,26 +1950,49 @@ uint32_t GetRefCount(HFactory factory, void* resource)
 
 uint32_t GetRefCount(HFactory factory, dmhash_t identifier)
 {
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     SResourceDescriptor* rd = factory->m_Resources->Get(identifier);
     if(!rd)
         return 0;
     return rd->m_ReferenceCount;
 }
 
-void Release(HFactory factory, void* resource)
+enum DecRefResult
 {
-    DM_PROFILE(Resource, "Release");
+    DECREF_RESULT_DECREMENTED   = 0, // Other references remain
+    DECREF_RESULT_LAST_REF      = 1, // Not decremented, the last reference must be released under the load mutex
+    DECREF_RESULT_ZERO          = 2, // The last reference was released
+};
 
+static DecRefResult DecRef(HFactory factory, void* resource, bool release_last)
+{
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t) resource);
     assert(resource_hash);
 
     SResourceDescriptor* rd = factory->m_Resources->Get(*resource_hash);
     assert(rd);
     assert(rd->m_ReferenceCount > 0);
+    if (rd->m_ReferenceCount == 1 && !release_last)
+        return DECREF_RESULT_LAST_REF;
     rd->m_ReferenceCount--;
+    return rd->m_ReferenceCount == 0 ? DECREF_RESULT_ZERO : DECREF_RESULT_DECREMENTED;
+}
+
+void Release(HFactory factory, void* resource)
+{
+    DM_PROFILE(Resource, "Release");
+
+    // Component types may release on worker threads, only the last reference needs the load mutex
+    if (DecRef(factory, resource, false) == DECREF_RESULT_DECREMENTED)
+        return;
 
-    if (rd->m_ReferenceCount == 0)
+    // Another thread may have taken a reference while we waited for the load mutex
+    dmMutex::ScopedLock lk(factory->m_LoadMutex);
+    if (DecRef(factory, resource, true) == DECREF_RESULT_ZERO)
     {
+        uint64_t resource_hash = *factory->m_ResourceToHash->Get((uintptr_t) resource);
+        SResourceDescriptor* rd = factory->m_Resources->Get(resource_hash);
         SResourceType* resource_type = (SResourceType*) rd->m_ResourceType;
 
         DM_PROFILE_DYN(ResourceRelease, resource_type->m_Extension, resource_type->m_ExtensionHash);
@@ -1656,12 +2003,15 @@ void Release(HFactory factory, void* resource)
         params.m_Resource = rd;
         resource_type->m_DestroyFunction(params);
 
-        factory->m_ResourceToHash->Erase((uintptr_t) resource);
-        factory->m_Resources->Erase(*resource_hash);
+        {
+            DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
+            factory->m_ResourceToHash->Erase((uintptr_t) resource);
+            factory->m_Resources->Erase(resource_hash);
+        }
         if (factory->m_ResourceHashToFilename)
         {
-            const char** s = factory->m_ResourceHashToFilename->Get(*resource_hash);
-            factory->m_ResourceHashToFilename->Erase(*resource_hash);
+            const char** s = factory->m_ResourceHashToFilename->Get(resource_hash);
+            factory->m_ResourceHashToFilename->Erase(resource_hash);
             assert(s);
             free((void*) *s);
         }
@@ -1707,6 +2057,7 @@ void UnregisterResourceReloadedCallback(HFactory factory, ResourceReloadedCallba
 
 Result GetPath(HFactory factory, const void* resource, uint64_t* hash)
 {
+    DM_SPINLOCK_SCOPED_LOCK(factory->m_ResourceTableLock);
     uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t)resource);
     if( resource_hash ) {
         *hash = *resource_hash;
@@ -1721,6 +2072,11 @@ dmMutex::HMutex GetLoadMutex(const dmResource::HFactory factory)
     return factory->m_LoadMutex;
 }
 
+uint32_t GetLoadWorkerCount(const dmResource::HFactory factory)
+{
+    return factory->m_LoadWorkerCount;
+}
+
 void ReleaseBuiltinsManifest(HFactory factory)
 {
     if (factory->m_BuiltinsManifest)
@@ -1734,6 +2090,7 @@ void ReleaseBuiltinsManifest(HFactory factory)
 
 struct ResourceIteratorCallbackInfo
 {
+    HFactory            m_Factory;
     FResourceIterator   m_Callback;
     void*               m_Context;
     bool                m_ShouldContinue;
@@ -1745,7 +2102,11 @@ static void ResourceIteratorCallback(ResourceIteratorCallbackInfo* callback, con
     info.m_Id           = resource->m_NameHash;
     info.m_SizeOnDisc   = resource->m_ResourceSizeOnDisc;
     info.m_Size         = resource->m_ResourceSize ? resource->m_ResourceSize : resource->m_ResourceSizeOnDisc; // default to the size on disc if no in memory size was specified
-    info.m_RefCount     = resource->m_ReferenceCount;
+    {
+        // Reference counts may change on worker threads without the load mutex
+        DM_SPINLOCK_SCOPED_LOCK(callback->m_Factory->m_ResourceTableLock);
+        info.m_RefCount = resource->m_ReferenceCount;
+    }
 
     if (callback->m_ShouldContinue)
     {
@@ -1756,7 +2117,7 @@ static void ResourceIteratorCallback(ResourceIteratorCallbackInfo* callback, con
 void IterateResources(HFactory factory, FResourceIterator callback, void* user_ctx)
 {
     DM_MUTEX_SCOPED_LOCK(factory->m_LoadMutex);
-    ResourceIteratorCallbackInfo callback_info = {callback, user_ctx, true};
+    ResourceIteratorCallbackInfo callback_info = {factory, callback, user_ctx, true};
     factory->m_Resources->Iterate<>(&ResourceIteratorCallback, &callback_info);
 }
 
@@ -35,6 +35,11 @@ namespace dmResource
      */
     extern const char* MAX_RESOURCES_KEY;
 
+    /**
+     * Configuration key used to tweak the number of async resource loader threads.
+     */
+    extern const char* LOAD_WORKER_COUNT_KEY;
+
     extern const char* BUNDLE_MANIFEST_FILENAME;
     extern const char* BUNDLE_INDEX_FILENAME;
     extern const char* BUNDLE_DATA_FILENAME;
@@ -131,7 +136,11 @@ namespace dmResource
         EmbeddedResource m_ArchiveData;
         EmbeddedResource m_ArchiveManifest;
 
-        uint32_t m_Reserved[5];
+        /// Number of threads loading resources asynchronously. Default is 2
+        /// The resource preload functions are called concurrently from these threads
+        uint32_t m_LoadWorkerCount;
+
+        uint32_t m_Reserved[4];
 
         NewFactoryParams()
         {
@@ -224,6 +233,48 @@ namespace dmResource
      */
     Result GetTypeFromExtension(HFactory factory, const char* extension, ResourceType* type);
 
+    /**
+     * Only load the first preload_size bytes of the resources of a type when creating them.
+     * The create function reads the rest itself, with OpenResourceFile(), when the resource is larger.
+     * Resources that can't be read in parts (over http or compressed or encrypted in the archive) are loaded as a whole.
+     * @param factory Factory handle
+     * @param extension File extension of the type
+     * @param preload_size Number of bytes to load, 0 to load the whole resource
+     * @return RESULT_OK on success
+     */
+    Result SetTypePreloadSize(HFactory factory, const char* extension, uint32_t preload_size);
+
+    /// Handle to the data of a resource, for reading it in parts
+    typedef struct ResourceFile* HResourceFile;
+
+    /**
+     * Open the data of a resource for reading it in parts
+     * @param factory Factory handle
+     * @param name Resource name
+     * @param file Returned file handle
+     * @param file_size Returned size of the resource data
+     * @return RESULT_OK on success, RESULT_NOT_SUPPORTED if the resource can only be loaded as a whole
+     */
+    Result OpenResourceFile(HFactory factory, const char* name, HResourceFile* file, uint32_t* file_size);
+
+    /**
+     * Read a part of the data of a resource. Doesn't take the load mutex, so it can be called from
+     * other threads while resources are being loaded. The file must be closed before the factory is deleted
+     * @param file File handle
+     * @param offset Offset in the resource data
+     * @param size Number of bytes to read
+     * @param buffer Buffer to read to
+     * @param nread Returned number of bytes read, less than size at the end of the data
+     * @return RESULT_OK on success
+     */
+    Result ReadResourceFile(HResourceFile file, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread);
+
+    /**
+     * Close a file opened with OpenResourceFile
+     * @param file File handle
+     */
+    void CloseResourceFile(HResourceFile file);
+
     /**
      * Get extension from type
      * @param factory Factory handle
@@ -349,6 +400,13 @@ namespace dmResource
     */
     dmMutex::HMutex GetLoadMutex(const dmResource::HFactory factory);
 
+    /**
+     * Returns the number of threads loading resources asynchronously
+     * @param factory Factory handle
+     * @return Number of threads
+    */
+    uint32_t GetLoadWorkerCount(const dmResource::HFactory factory);
+
     /**
      * Releases the builtins manifest
      * Use when it's no longer needed, e.g. the user project loaded properly
@@ -528,6 +528,155 @@ namespace dmResourceArchive
         return RESULT_OK;
     }
 
+    bool IsEntryStoredUncompressed(HArchiveIndexContainer archive, const EntryData* entry)
+    {
+        // Only the default reader is known to store the entries as is in the archive data
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (archive->m_Loader.m_Read != ReadEntryFromArchive || afi == 0)
+        {
+            return false;
+        }
+
+        // Live update data may be remapped when new resources are stored
+        bool encrypted = (entry->m_Flags & ENTRY_FLAG_ENCRYPTED);
+        bool compressed = entry->m_ResourceCompressedSize != 0xFFFFFFFF;
+        if (encrypted || compressed || (entry->m_Flags & ENTRY_FLAG_LIVEUPDATE_DATA))
+        {
+            return false;
+        }
+        return !afi->m_IsMemMapped || (uint64_t) entry->m_ResourceDataOffset + entry->m_ResourceSize <= afi->m_ResourceSize;
+    }
+
+    Result MapEntryFromArchive(HArchiveIndexContainer archive, const EntryData* entry, const void** data)
+    {
+        if (!IsEntryStoredUncompressed(archive, entry) || !archive->m_ArchiveFileIndex->m_IsMemMapped)
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        *data = (const void*) (archive->m_ArchiveFileIndex->m_ResourceData + entry->m_ResourceDataOffset);
+        return RESULT_OK;
+    }
+
+    Result ReadEntryPartialFromArchive(HArchiveIndexContainer archive, const EntryData* entry, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread)
+    {
+        if (!IsEntryStoredUncompressed(archive, entry))
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        *nread = 0;
+        if (offset >= entry->m_ResourceSize)
+        {
+            return RESULT_OK;
+        }
+        if (size > entry->m_ResourceSize - offset)
+        {
+            size = entry->m_ResourceSize - offset;
+        }
+
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (afi->m_IsMemMapped)
+        {
+            memcpy(buffer, afi->m_ResourceData + entry->m_ResourceDataOffset + offset, size);
+        }
+        else
+        {
+            FILE* resource_file = afi->m_FileResourceData;
+            if (fseek(resource_file, entry->m_ResourceDataOffset + offset, SEEK_SET) != 0 || fread(buffer, 1, size, resource_file) != size)
+            {
+                return RESULT_IO_ERROR;
+            }
+        }
+
+        *nread = size;
+        return RESULT_OK;
+    }
+
+    bool IsEntryStoredEncoded(HArchiveIndexContainer archive, const EntryData* entry)
+    {
+        // Only the default reader is known to store the entries as is in the archive data
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (archive->m_Loader.m_Read != ReadEntryFromArchive || afi == 0)
+        {
+            return false;
+        }
+
+        bool encrypted = (entry->m_Flags & ENTRY_FLAG_ENCRYPTED);
+        bool compressed = entry->m_ResourceCompressedSize != 0xFFFFFFFF;
+        return encrypted || compressed;
+    }
+
+    uint32_t GetEntryStoredSize(const EntryData* entry)
+    {
+        return entry->m_ResourceCompressedSize != 0xFFFFFFFF ? entry->m_ResourceCompressedSize : entry->m_ResourceSize;
+    }
+
+    Result ReadEntryStoredFromArchive(HArchiveIndexContainer archive, const EntryData* entry, void* stored)
+    {
+        if (!IsEntryStoredEncoded(archive, entry))
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        uint32_t stored_size = GetEntryStoredSize(entry);
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (afi->m_IsMemMapped)
+        {
+            memcpy(stored, afi->m_ResourceData + entry->m_ResourceDataOffset, stored_size);
+        }
+        else
+        {
+            FILE* resource_file = afi->m_FileResourceData;
+            if (fseek(resource_file, entry->m_ResourceDataOffset, SEEK_SET) != 0 || fread(stored, 1, stored_size, resource_file) != stored_size)
+            {
+                return RESULT_IO_ERROR;
+            }
+        }
+        return RESULT_OK;
+    }
+
+    Result MapEntryStoredFromArchive(HArchiveIndexContainer archive, const EntryData* entry, const void** stored)
+    {
+        // Encrypted entries are decrypted in place, and live update data may be remapped when new resources are stored
+        if (!IsEntryStoredEncoded(archive, entry) || (entry->m_Flags & (ENTRY_FLAG_ENCRYPTED | ENTRY_FLAG_LIVEUPDATE_DATA)))
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (!afi->m_IsMemMapped || (uint64_t) entry->m_ResourceDataOffset + GetEntryStoredSize(entry) > afi->m_ResourceSize)
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        *stored = (const void*) (afi->m_ResourceData + entry->m_ResourceDataOffset);
+        return RESULT_OK;
+    }
+
+    Result DecodeEntry(const EntryData* entry, void* stored, void* buffer)
+    {
+        uint32_t stored_size = GetEntryStoredSize(entry);
+        if (entry->m_Flags & ENTRY_FLAG_ENCRYPTED)
+        {
+            Result r = DecryptBuffer(stored, stored_size);
+            if (r != RESULT_OK)
+            {
+                return r;
+            }
+        }
+
+        if (entry->m_ResourceCompressedSize != 0xFFFFFFFF)
+        {
+            return DecompressBuffer(stored, stored_size, buffer, entry->m_ResourceSize);
+        }
+        if (stored != buffer)
+        {
+            memcpy(buffer, stored, entry->m_ResourceSize);
+        }
+        return RESULT_OK;
+    }
+
     void RegisterDefaultArchiveLoader()
     {
         dmResourceArchive::ArchiveLoader loader;
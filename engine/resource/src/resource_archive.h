@@ -213,6 +213,38 @@ namespace dmResourceArchive
     // Reads an entry from a single archive
     Result ReadEntryFromArchive(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, const EntryData* entry, void* buffer);
 
+    // Gets a read only pointer to an entry in a memory mapped archive, if the entry is stored uncompressed and unencrypted.
+    // The data is valid until the archive is unloaded. Returns RESULT_NOT_FOUND if the entry has to be read with Read()
+    Result MapEntryFromArchive(HArchiveIndexContainer archive, const EntryData* entry, const void** data);
+
+    // True if the entry is stored as is, uncompressed and unencrypted, in the data of a base archive
+    bool IsEntryStoredUncompressed(HArchiveIndexContainer archive, const EntryData* entry);
+
+    // Reads size bytes at offset of an entry that is stored uncompressed and unencrypted. Reads less at the end of the entry.
+    // Returns RESULT_NOT_FOUND if the entry has to be read as a whole with Read()
+    Result ReadEntryPartialFromArchive(HArchiveIndexContainer archive, const EntryData* entry, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread);
+
+    // True if the entry is compressed or encrypted in the data of a base archive, in which case the stored bytes
+    // can be read with ReadEntryStoredFromArchive() and decoded separately with DecodeEntry()
+    bool IsEntryStoredEncoded(HArchiveIndexContainer archive, const EntryData* entry);
+
+    // The size of an entry as stored in the archive data
+    uint32_t GetEntryStoredSize(const EntryData* entry);
+
+    // Reads the GetEntryStoredSize() bytes of an entry as they are stored, without decrypting or decompressing them.
+    // Returns RESULT_NOT_FOUND if the entry has to be read as a whole with Read()
+    Result ReadEntryStoredFromArchive(HArchiveIndexContainer archive, const EntryData* entry, void* stored);
+
+    // Gets a read only pointer to the stored bytes of an entry in a memory mapped archive, if the entry is compressed
+    // but not encrypted, so that it can be decompressed with DecodeEntry() without a copy. Returns RESULT_NOT_FOUND
+    // if the entry has to be read with ReadEntryStoredFromArchive()
+    Result MapEntryStoredFromArchive(HArchiveIndexContainer archive, const EntryData* entry, const void** stored);
+
+    // Decrypts (in place) and decompresses the stored bytes of an entry into a buffer of m_ResourceSize bytes.
+    // The stored bytes may be the buffer itself if the entry is uncompressed, and are only read if it isn't encrypted.
+    // Needs no access to the archive.
+    Result DecodeEntry(const EntryData* entry, void* stored, void* buffer);
+
     // Calls each loader in sequence
 
     /*# Loads the archives, calling each registered loader in sequence
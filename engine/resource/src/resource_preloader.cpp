@@ -100,6 +100,8 @@ namespace dmResource
         // Set for items that are pending and waiting for children to complete
         void* m_Buffer;
         uint32_t m_BufferSize;
+        // The buffer points into a memory mapped archive and isn't owned by the request
+        bool m_IsBufferMapped;
 
         // Set once preload function has run
         void* m_PreloadData;
@@ -511,7 +513,7 @@ namespace dmResource
     //   2) Having failed, (or created and destroyed), leaving => RESULT_SOME_ERROR + everything free:d
     //
     // If buffer is null it means to use the items internal buffer
-    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size)
+    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size, bool is_buffer_mapped)
     {
         assert(req->m_LoadResult == RESULT_PENDING);
         assert(req->m_PendingChildCount == 0);
@@ -541,17 +543,23 @@ namespace dmResource
             tmp_resource.m_ResourceSizeOnDisc = req->m_BufferSize;
             params.m_Buffer                   = req->m_Buffer;
             params.m_BufferSize               = req->m_BufferSize;
+            params.m_IsBufferMapped           = req->m_IsBufferMapped;
             req->m_LoadResult                 = resource_type->m_CreateFunction(params);
 
-            dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            if (!req->m_IsBufferMapped)
+            {
+                dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            }
 
             req->m_Buffer = 0;
+            req->m_IsBufferMapped = false;
         }
         else
         {
             tmp_resource.m_ResourceSizeOnDisc = buffer_size;
             params.m_Buffer                   = buffer;
             params.m_BufferSize               = buffer_size;
+            params.m_IsBufferMapped           = is_buffer_mapped;
             req->m_LoadResult                 = resource_type->m_CreateFunction(params);
         }
 
@@ -600,7 +608,7 @@ namespace dmResource
         if (rd)
         {
             // Use already loaded resource
-            rd->m_ReferenceCount++;
+            IncRef(preloader->m_Factory, rd->m_Resource);
             req->m_Resource = rd->m_Resource;
             destroy         = true;
         }
@@ -680,7 +688,7 @@ namespace dmResource
         {
             return false;
         }
-        CreateResource(preloader, parent_req, 0, 0);
+        CreateResource(preloader, parent_req, 0, 0, false);
         UnmarkPathInProgress(preloader, &parent_req->m_PathDescriptor);
         PreloaderTryPruneParent(preloader, parent_req);
         return true;
@@ -723,7 +731,7 @@ namespace dmResource
             if (req->m_LoadResult == RESULT_PENDING)
             {
                 // Create the resource using the loading buffer directly.
-                CreateResource(preloader, req, buffer, buffer_size);
+                CreateResource(preloader, req, buffer, buffer_size, load_result.m_IsBufferMapped);
                 created_resource = true;
             }
             UnmarkPathInProgress(preloader, &req->m_PathDescriptor);
@@ -732,6 +740,15 @@ namespace dmResource
 
             PreloaderTryPruneParent(preloader, req);
         }
+        else if (load_result.m_IsBufferMapped)
+        {
+            // The mapped data outlives the load request, no need to copy it
+            req->m_Buffer = buffer;
+            req->m_BufferSize = buffer_size;
+            req->m_IsBufferMapped = true;
+            dmLoadQueue::FreeLoad(preloader->m_LoadQueue, req->m_LoadRequest);
+            req->m_LoadRequest = 0;
+        }
         else
         {
             // Keep the loaded bytes until we have loaded all children
@@ -831,7 +848,7 @@ namespace dmResource
         SResourceDescriptor* rd = FindByHash(preloader->m_Factory, req->m_PathDescriptor.m_CanonicalPathHash);
         if (rd)
         {
-            rd->m_ReferenceCount++;
+            IncRef(preloader->m_Factory, rd->m_Resource);
             req->m_Resource   = rd->m_Resource;
             req->m_LoadResult = RESULT_OK;
             RemoveChildren(preloader, req);
@@ -40,6 +40,8 @@ namespace dmResource
         FResourcePostCreate m_PostCreateFunction;
         FResourceDestroy    m_DestroyFunction;
         FResourceRecreate   m_RecreateFunction;
+        // If set, only this many bytes of larger resources are loaded for creating them (see SetTypePreloadSize)
+        uint32_t            m_PreloadSize;
     };
 
     typedef dmArray<char> LoadBufferType;
@@ -49,9 +51,12 @@ namespace dmResource
     Result CheckSuppliedResourcePath(const char* name);
 
     // load with default internal buffer and its management, returns buffer ptr in 'buffer'
-    Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size);
+    // if 'is_mapped' is supplied, the data may be returned as a read-only pointer into a memory mapped archive instead
+    Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size, bool* is_mapped = 0);
     // load with own buffer
-    Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer);
+    // if 'mapped_data' is supplied, it's set to point into a memory mapped archive when possible, and the buffer is left empty.
+    // It also means the data is for creating the resource, so only the first part of it is loaded if the type has a preload size
+    Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** mapped_data);
 
     Result InsertResource(HFactory factory, const char* path, uint64_t canonical_path_hash, SResourceDescriptor* descriptor);
     uint32_t GetCanonicalPath(const char* relative_dir, char* buf);
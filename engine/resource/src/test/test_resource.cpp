@@ -12,6 +12,7 @@
 
 #include <dlib/log.h>
 
+#include <dlib/atomic.h>
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
@@ -51,6 +52,12 @@ extern unsigned char RESOURCES_ARCD[];
 extern uint32_t RESOURCES_ARCD_SIZE;
 extern unsigned char RESOURCES_DMANIFEST[];
 extern uint32_t RESOURCES_DMANIFEST_SIZE;
+extern unsigned char RESOURCES_COMPRESSED_ARCI[];
+extern uint32_t RESOURCES_COMPRESSED_ARCI_SIZE;
+extern unsigned char RESOURCES_COMPRESSED_ARCD[];
+extern uint32_t RESOURCES_COMPRESSED_ARCD_SIZE;
+extern unsigned char RESOURCES_COMPRESSED_DMANIFEST[];
+extern uint32_t RESOURCES_COMPRESSED_DMANIFEST_SIZE;
 
 #define EXT_CONSTANTS(prefix, ext)\
     static const dmhash_t prefix##_EXT_HASH = dmHashString64(ext);\
@@ -640,6 +647,39 @@ TEST_P(GetResourceTest, ReferenceCountSimple)
     ASSERT_EQ(dmResource::RESULT_NOT_LOADED, e);
 }
 
+TEST_P(GetResourceTest, ReleaseLastReference)
+{
+    dmResource::Result e;
+
+    TestResourceContainer* resource = 0;
+    e = dmResource::Get(m_Factory, m_ResourceName, (void**) &resource);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+    ASSERT_NE((void*) 0, resource);
+    const uint32_t sub_resource_count = resource->m_Resources.size();
+
+    dmResource::IncRef(m_Factory, resource);
+    dmResource::IncRef(m_Factory, resource);
+    ASSERT_EQ(3U, dmResource::GetRefCount(m_Factory, resource));
+
+    // Releases that leave other references never destroy the resource
+    dmResource::Release(m_Factory, resource);
+    ASSERT_EQ(2U, dmResource::GetRefCount(m_Factory, resource));
+    dmResource::Release(m_Factory, resource);
+    ASSERT_EQ(1U, dmResource::GetRefCount(m_Factory, resource));
+    ASSERT_EQ(0U, m_ResourceContainerDestroyCallCount);
+    ASSERT_EQ(0U, m_FooResourceDestroyCallCount);
+
+    // The final release destroys the resource and its sub resources
+    dmResource::Release(m_Factory, resource);
+    ASSERT_EQ(0U, dmResource::GetRefCount(m_Factory, resource));
+    ASSERT_EQ(1U, m_ResourceContainerDestroyCallCount);
+    ASSERT_EQ(sub_resource_count, m_FooResourceDestroyCallCount);
+
+    dmResource::SResourceDescriptor descriptor;
+    e = dmResource::GetDescriptor(m_Factory, m_ResourceName, &descriptor);
+    ASSERT_EQ(dmResource::RESULT_NOT_LOADED, e);
+}
+
 
 static bool PreloaderCompleteCallback(const dmResource::PreloaderCompleteCallbackParams* params)
 {
@@ -972,6 +1012,91 @@ TEST(dmResource, Builtins)
     dmResource::DeleteFactory(factory);
 }
 
+// Called concurrently from the loader threads
+static dmResource::Result AdResourcePreload(const dmResource::ResourcePreloadParams& params)
+{
+    dmAtomicIncrement32((int32_atomic_t*) params.m_Context);
+    char* duplicate = (char*)malloc((params.m_BufferSize + 1) * sizeof(char));
+    memcpy(duplicate, params.m_Buffer, params.m_BufferSize);
+    duplicate[params.m_BufferSize] = '\0';
+    *params.m_PreloadData = duplicate;
+    return dmResource::RESULT_OK;
+}
+
+static dmResource::Result AdResourcePreloadedCreate(const dmResource::ResourceCreateParams& params)
+{
+    params.m_Resource->m_Resource = params.m_PreloadData;
+    return dmResource::RESULT_OK;
+}
+
+TEST(dmResource, PreloadMultipleWorkers)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = 16;
+    params.m_LoadWorkerCount = 4;
+
+    // The compressed and encrypted entries are decoded by the loader threads, without the load mutex held
+    params.m_ArchiveIndex.m_Data    = (const void*) RESOURCES_COMPRESSED_ARCI;
+    params.m_ArchiveIndex.m_Size    = RESOURCES_COMPRESSED_ARCI_SIZE;
+
+    params.m_ArchiveData.m_Data     = (const void*) RESOURCES_COMPRESSED_ARCD;
+    params.m_ArchiveData.m_Size     = RESOURCES_COMPRESSED_ARCD_SIZE;
+
+    params.m_ArchiveManifest.m_Data = (const void*) RESOURCES_COMPRESSED_DMANIFEST;
+    params.m_ArchiveManifest.m_Size = RESOURCES_COMPRESSED_DMANIFEST_SIZE;
+
+    dmResource::HFactory factory = dmResource::NewFactory(&params, ".");
+    ASSERT_NE((void*) 0, factory);
+    ASSERT_EQ(4U, dmResource::GetLoadWorkerCount(factory));
+
+    int32_atomic_t preload_count = 0;
+    dmResource::RegisterType(factory, "adc", &preload_count, AdResourcePreload, AdResourcePreloadedCreate, 0, AdResourceDestroy, 0);
+    dmResource::RegisterType(factory, "scriptc", &preload_count, AdResourcePreload, AdResourcePreloadedCreate, 0, AdResourceDestroy, 0);
+
+    const char* path_name[]     = { "/archive_data/file4.adc", "/archive_data/file1.adc", "/archive_data/file3.adc", "/archive_data/file2.adc", "/archive_data/file5.scriptc" };
+    const char* content[]       = {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "file1_datafile1_datafile1_data",
+        "file3_data",
+        "file2_datafile2_datafile2_data",
+        "stuff to test encryption"
+    };
+    const uint32_t count = sizeof(path_name) / sizeof(path_name[0]);
+
+    for (uint32_t iteration = 0; iteration < 10; ++iteration)
+    {
+        dmAtomicStore32(&preload_count, 0);
+
+        dmArray<const char*> names(path_name, count, count);
+        dmResource::HPreloader pr = dmResource::NewPreloader(factory, names);
+
+        dmResource::Result r;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            r = dmResource::UpdatePreloader(pr, 0, 0, 30*1000);
+            if (r == dmResource::RESULT_PENDING)
+                dmTime::Sleep(1000);
+            else
+                break;
+        }
+        ASSERT_EQ(dmResource::RESULT_OK, r);
+        ASSERT_EQ((int32_t) count, dmAtomicAdd32(&preload_count, 0));
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            void* resource;
+            dmResource::Result result = dmResource::Get(factory, path_name[i], &resource);
+            ASSERT_EQ(dmResource::RESULT_OK, result);
+            ASSERT_STREQ(content[i], (const char*) resource);
+            dmResource::Release(factory, resource);
+        }
+
+        dmResource::DeletePreloader(pr);
+    }
+
+    dmResource::DeleteFactory(factory);
+}
+
 struct ReloadData {
     ReloadData(): m_Old(0), m_New(0) {}
     int m_Old;
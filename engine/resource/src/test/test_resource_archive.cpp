@@ -762,6 +762,122 @@ TEST(dmResourceArchive, Wrap_Compressed)
     dmResourceArchive::Delete(archive);
 }
 
+TEST(dmResourceArchive, MapEntry)
+{
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_ARCI, RESOURCES_ARCI_SIZE, true, RESOURCES_ARCD, RESOURCES_ARCD_SIZE, true, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    dmResourceArchive::HArchiveIndexContainer entryarchive;
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < (sizeof(path_hash) / sizeof(path_hash[0])); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, content_hash[i], sizeof(content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        const void* data = 0;
+        result = dmResourceArchive::MapEntryFromArchive(entryarchive, &entry, &data);
+        if (entry.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED)
+        {
+            ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+            continue;
+        }
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_GE((uintptr_t) data, (uintptr_t) RESOURCES_ARCD);
+        ASSERT_LE((uintptr_t) data + entry.m_ResourceSize, (uintptr_t) RESOURCES_ARCD + RESOURCES_ARCD_SIZE);
+        ASSERT_LE(strlen(content[i]), entry.m_ResourceSize);
+        ASSERT_EQ(0, memcmp(content[i], data, strlen(content[i])));
+    }
+
+    dmResourceArchive::Delete(archive);
+
+    // Compressed entries can't be used in place
+    result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_COMPRESSED_ARCI, RESOURCES_COMPRESSED_ARCI_SIZE, true, (void*) RESOURCES_COMPRESSED_ARCD, RESOURCES_COMPRESSED_ARCD_SIZE, true, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    for (uint32_t i = 0; i < (sizeof(path_hash) / sizeof(path_hash[0])); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, compressed_content_hash[i], sizeof(compressed_content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        const void* data = 0;
+        result = dmResourceArchive::MapEntryFromArchive(entryarchive, &entry, &data);
+        bool in_place = entry.m_ResourceCompressedSize == 0xFFFFFFFF && !(entry.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED);
+        ASSERT_EQ(in_place ? dmResourceArchive::RESULT_OK : dmResourceArchive::RESULT_NOT_FOUND, result);
+    }
+
+    dmResourceArchive::Delete(archive);
+}
+
+TEST(dmResourceArchive, ReadStoredAndDecode)
+{
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_COMPRESSED_ARCI, RESOURCES_COMPRESSED_ARCI_SIZE, true, (void*) RESOURCES_COMPRESSED_ARCD, RESOURCES_COMPRESSED_ARCD_SIZE, true, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    dmResourceArchive::HArchiveIndexContainer entryarchive;
+    dmResourceArchive::EntryData entry;
+    uint32_t decoded_count = 0;
+    uint32_t mapped_count = 0;
+    for (uint32_t i = 0; i < (sizeof(path_hash) / sizeof(path_hash[0])); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, compressed_content_hash[i], sizeof(compressed_content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        char stored[1024] = { 0 };
+        result = dmResourceArchive::ReadEntryStoredFromArchive(entryarchive, &entry, stored);
+        if (!dmResourceArchive::IsEntryStoredEncoded(entryarchive, &entry))
+        {
+            ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+            continue;
+        }
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_GE(sizeof(stored), dmResourceArchive::GetEntryStoredSize(&entry));
+
+        // Decoding needs no access to the archive
+        char buffer[1024] = { 0 };
+        bool compressed = entry.m_ResourceCompressedSize != 0xFFFFFFFF;
+        result = dmResourceArchive::DecodeEntry(&entry, stored, compressed ? buffer : stored);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_STREQ(content[i], compressed ? buffer : stored);
+        ++decoded_count;
+
+        // Compressed entries that aren't encrypted are decoded straight from the mapped archive
+        const void* mapped_stored = 0;
+        result = dmResourceArchive::MapEntryStoredFromArchive(entryarchive, &entry, &mapped_stored);
+        if (!compressed || (entry.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED))
+        {
+            ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+            continue;
+        }
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_GE((uintptr_t) mapped_stored, (uintptr_t) RESOURCES_COMPRESSED_ARCD);
+        ASSERT_LE((uintptr_t) mapped_stored + entry.m_ResourceCompressedSize, (uintptr_t) RESOURCES_COMPRESSED_ARCD + RESOURCES_COMPRESSED_ARCD_SIZE);
+
+        memset(buffer, 0, sizeof(buffer));
+        result = dmResourceArchive::DecodeEntry(&entry, (void*) mapped_stored, buffer);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_STREQ(content[i], buffer);
+        ++mapped_count;
+    }
+    ASSERT_LT(0U, decoded_count);
+    ASSERT_LT(0U, mapped_count);
+
+    dmResourceArchive::Delete(archive);
+}
+
 TEST(dmResourceArchive, LoadFromDisk)
 {
     dmResourceArchive::HArchiveIndexContainer archive = 0;
@@ -797,6 +913,50 @@ TEST(dmResourceArchive, LoadFromDisk)
     dmResourceArchive::Delete(archive);
 }
 
+TEST(dmResourceArchive, ReadEntryPartialFromDisk)
+{
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    const char* archive_path = MOUNTFS "build/default/src/test/resources.arci";
+    const char* resource_path = MOUNTFS "build/default/src/test/resources.arcd";
+    dmResourceArchive::Result result = dmResourceArchive::LoadArchiveFromFile(archive_path, resource_path, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    dmResourceArchive::HArchiveIndexContainer entryarchive;
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < sizeof(path_name)/sizeof(path_name[0]); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, content_hash[i], sizeof(content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        char buffer[1024] = { 0 };
+        uint32_t nread = 0;
+        result = dmResourceArchive::ReadEntryPartialFromArchive(entryarchive, &entry, 1, 3, buffer, &nread);
+        if (entry.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED)
+        {
+            ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+            continue;
+        }
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_EQ(3u, nread);
+        ASSERT_EQ(0, memcmp(content[i] + 1, buffer, nread));
+
+        // Reading past the end of the entry stops at the end
+        result = dmResourceArchive::ReadEntryPartialFromArchive(entryarchive, &entry, entry.m_ResourceSize - 2, sizeof(buffer), buffer, &nread);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_EQ(2u, nread);
+
+        result = dmResourceArchive::ReadEntryPartialFromArchive(entryarchive, &entry, entry.m_ResourceSize, sizeof(buffer), buffer, &nread);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_EQ(0u, nread);
+    }
+
+    dmResourceArchive::Delete(archive);
+}
+
 TEST(dmResourceArchive, LoadFromDisk_MissingArchive)
 {
     dmResourceArchive::HArchiveIndexContainer archive = 0;
@@ -23,6 +23,7 @@
 
 #include <dmsdk/dlib/align.h>
 #include <dmsdk/dlib/hash.h>
+#include <dmsdk/dlib/hashtable.h>
 #include <dmsdk/dlib/object_pool.h>
 #include <dmsdk/dlib/transform.h>
 #include <dmsdk/dlib/vmath.h>
@@ -34,6 +35,11 @@
 
 using namespace Vectormath::Aos;
 
+namespace dmJobSystem
+{
+    typedef struct Context* HContext;
+}
+
 namespace dmRig
 {
     using namespace dmRigDDF;
@@ -208,18 +214,50 @@ namespace dmRig
         float nz;
     };
 
+    // A sampled local pose that other instances playing the same animation
+    // at the same time can copy instead of sampling it again.
+    struct PoseCacheEntry
+    {
+        const dmRigDDF::RigAnimation* m_Animation;
+        const dmArray<RigBone>*       m_BindPose;
+        const dmArray<uint32_t>*      m_TrackIdxToPose;
+        float                         m_Time;
+        // Range in RigContext::m_PoseCacheTransforms
+        uint32_t                      m_Offset;
+        uint32_t                      m_BoneCount;
+    };
+
+    // Temporary scratch buffers used when generating the vertex data of an instance.
+    struct RigScratchBuffers
+    {
+        // Pose as transform and matrices
+        // (avoids modifying the real pose transform data during rendering).
+        dmArray<dmTransform::Transform> m_PoseTransformBuffer;
+        dmArray<Matrix4>                m_InfluenceMatrixBuffer;
+        dmArray<Matrix4>                m_PoseMatrixBuffer;
+        // Influence matrices with the model and normal matrix folded in, used for skinning.
+        dmArray<Matrix4>                m_SkinMatrixBuffer;
+        dmArray<Matrix4>                m_SkinNormalMatrixBuffer;
+        // Used when transforming the vertex buffer, used to creating primitives from indices.
+        dmArray<Vector3>                m_PositionBuffer;
+        dmArray<Vector3>                m_NormalBuffer;
+    };
+
     struct RigContext
     {
         dmObjectPool<HRigInstance>      m_Instances;
-        // Temporary scratch buffers used for store pose as transform and matrices
-        // (avoids modifying the real pose transform data during rendering).
-        dmArray<dmTransform::Transform> m_ScratchPoseTransformBuffer;
-        dmArray<Matrix4>                m_ScratchInfluenceMatrixBuffer;
-        dmArray<Matrix4>                m_ScratchPoseMatrixBuffer;
-        // Temporary scratch buffers used when transforming the vertex buffer,
-        // used to creating primitives from indices.
-        dmArray<Vector3>                m_ScratchPositionBuffer;
-        dmArray<Vector3>                m_ScratchNormalBuffer;
+        // Poses sampled during the current update, indexed by PoseCacheEntry key hash.
+        dmHashTable64<uint32_t>         m_PoseCache;
+        dmArray<PoseCacheEntry>         m_PoseCacheEntries;
+        dmArray<dmTransform::Transform> m_PoseCacheTransforms;
+        // Scratch buffers used when generating vertex data on the calling thread.
+        RigScratchBuffers               m_ScratchBuffers;
+        // Scratch buffers for each batch of instances when generating vertex data on the job system.
+        dmArray<RigScratchBuffers*>     m_JobScratchBuffers;
+        // First vertex of each instance when generating vertex data for several instances.
+        dmArray<uint32_t>               m_ScratchVertexOffsets;
+        // Job system used to generate vertex data for several instances concurrently, may be 0x0
+        dmJobSystem::HContext           m_JobContext;
         // Temporary scratch buffers to handle draw order changes.
         dmArray<int32_t>                m_ScratchDrawOrderDeltas;
         dmArray<int32_t>                m_ScratchDrawOrderUnchanged;
@@ -230,6 +268,15 @@ namespace dmRig
         uint32_t     m_MaxRigInstanceCount;
     };
 
+    // An instance to generate vertex data for, and the transforms and color to generate it with.
+    struct RigInstanceVertexData
+    {
+        HRigInstance m_Instance;
+        Matrix4      m_ModelMatrix;
+        Matrix4      m_NormalMatrix;
+        Vector4      m_Color;
+    };
+
     typedef void (*RigEventCallback)(RigEventType, void*, void*, void*);
     typedef void (*RigPoseCallback)(void*, void*);
 
@@ -312,6 +359,8 @@ namespace dmRig
 
     Result NewContext(const NewContextParams& params);
     void DeleteContext(HRigContext context);
+    // Set the job system used to generate vertex data for several instances concurrently, or 0x0 to use the calling thread.
+    void SetJobContext(HRigContext context, dmJobSystem::HContext job_context);
     Result Update(HRigContext context, float dt);
 
     Result InstanceCreate(const InstanceCreateParams& params);
@@ -322,6 +371,8 @@ namespace dmRig
     dmhash_t GetAnimation(HRigInstance instance);
 
     void* GenerateVertexData(HRigContext context, HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out);
+    // Generate the vertex data of several instances, written back to back in the order they are given.
+    void* GenerateVertexData(HRigContext context, const RigInstanceVertexData* instances, uint32_t instance_count, RigVertexFormat vertex_format, void* vertex_data_out);
     uint32_t GetVertexCount(HRigInstance instance);
 
     Result SetMesh(HRigInstance instance, dmhash_t mesh_id);
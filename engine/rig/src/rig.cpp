@@ -12,6 +12,7 @@
 
 #include "rig.h"
 
+#include <dlib/job_system.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/vmath.h>
@@ -26,6 +27,8 @@ namespace dmRig
     static const float CURSOR_EPSILON = 0.0001f;
     static const int SIGNAL_DELTA_UNCHANGED = 0x10cced; // Used to indicate if a draw order was unchanged for a certain slot
     static const uint32_t INVALID_ATTACHMENT_INDEX = 0xffffffffu;
+    // Below this number of vertices, the vertex data of several instances is generated on the calling thread
+    static const uint32_t PARALLEL_MIN_VERTEX_COUNT = 2048;
 
     static const float white[] = {1.0f, 1.0f, 1.0, 1.0f};
 
@@ -42,8 +45,11 @@ namespace dmRig
         }
 
         context->m_Instances.SetCapacity(params.m_MaxRigInstanceCount);
-        context->m_ScratchPoseTransformBuffer.SetCapacity(0);
-        context->m_ScratchPoseMatrixBuffer.SetCapacity(0);
+        context->m_PoseCache.SetCapacity(dmMath::Max(1U, params.m_MaxRigInstanceCount/3), dmMath::Max(1U, params.m_MaxRigInstanceCount));
+        context->m_PoseCacheEntries.SetCapacity(dmMath::Max(1U, params.m_MaxRigInstanceCount));
+        context->m_ScratchBuffers.m_PoseTransformBuffer.SetCapacity(0);
+        context->m_ScratchBuffers.m_PoseMatrixBuffer.SetCapacity(0);
+        context->m_JobContext = 0x0;
 
         return dmRig::RESULT_OK;
     }
@@ -51,10 +57,19 @@ namespace dmRig
     void DeleteContext(HRigContext context)
     {
         if (context) {
+            for (uint32_t i = 0; i < context->m_JobScratchBuffers.Size(); ++i)
+            {
+                delete context->m_JobScratchBuffers[i];
+            }
             delete context;
         }
     }
 
+    void SetJobContext(HRigContext context, dmJobSystem::HContext job_context)
+    {
+        context->m_JobContext = job_context;
+    }
+
     static const dmRigDDF::RigAnimation* FindAnimation(const dmRigDDF::AnimationSet* anim_set, dmhash_t animation_id)
     {
         if(anim_set == 0x0)
@@ -258,7 +273,7 @@ namespace dmRig
         }
     }
 
-    static float GetCursorDuration(RigPlayer* player, const dmRigDDF::RigAnimation* animation)
+    static float GetCursorDuration(const RigPlayer* player, const dmRigDDF::RigAnimation* animation)
     {
         if (!animation)
         {
@@ -438,6 +453,61 @@ namespace dmRig
         return slerp(frac, Quat(data[i+0], data[i+1], data[i+2], data[i+3]), Quat(data[i+0+4], data[i+1+4], data[i+2+4], data[i+3+4]));
     }
 
+    static inline uint32_t ReadUint16(const uint8_t* data)
+    {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+    }
+
+    static inline Vector3 DecodeVec3(uint32_t sample, const uint8_t* data, const float* range)
+    {
+        const uint8_t* p = &data[sample*6];
+        return Vector3(range[0] + ReadUint16(p+0) * range[3],
+                       range[1] + ReadUint16(p+2) * range[4],
+                       range[2] + ReadUint16(p+4) * range[5]);
+    }
+
+    // See AnimationTrack in rig_ddf.proto for the smallest three encoding
+    static inline Quat DecodeQuat(uint32_t sample, const uint8_t* data)
+    {
+        const float scale = (float)M_SQRT2 / 32767.0f;
+        const float offset = (float)M_SQRT1_2;
+        const uint8_t* p = &data[sample*6];
+        uint32_t v0 = ReadUint16(p+0);
+        uint32_t v1 = ReadUint16(p+2);
+        uint32_t v2 = ReadUint16(p+4);
+        uint32_t largest = ((v0 >> 15) << 1) | (v1 >> 15);
+        float a = (v0 & 0x7fff) * scale - offset;
+        float b = (v1 & 0x7fff) * scale - offset;
+        float c = (v2 & 0x7fff) * scale - offset;
+        float d = sqrtf(dmMath::Max(0.0f, 1.0f - a*a - b*b - c*c));
+        switch (largest)
+        {
+            case 0:  return Quat(d, a, b, c);
+            case 1:  return Quat(a, d, b, c);
+            case 2:  return Quat(a, b, d, c);
+            default: return Quat(a, b, c, d);
+        }
+    }
+
+    // Position and scale tracks are either raw (with a single sample if constant) or quantized.
+    static Vector3 SampleVec3Track(uint32_t sample, float frac, float* data, uint32_t count, const uint8_t* compressed, const float* range)
+    {
+        if (compressed)
+            return lerp(frac, DecodeVec3(sample, compressed, range), DecodeVec3(sample+1, compressed, range));
+        if (count == 3)
+            return Vector3(data[0], data[1], data[2]);
+        return SampleVec3(sample, frac, data);
+    }
+
+    static Quat SampleQuatTrack(uint32_t sample, float frac, float* data, uint32_t count, const uint8_t* compressed)
+    {
+        if (compressed)
+            return slerp(frac, DecodeQuat(sample, compressed), DecodeQuat(sample+1, compressed));
+        if (count == 4)
+            return Quat(data[0], data[1], data[2], data[3]);
+        return SampleQuat(sample, frac, data);
+    }
+
     static float CursorToTime(float cursor, float duration, bool backwards, bool once_pingpong)
     {
         float t = cursor;
@@ -514,20 +584,25 @@ namespace dmRig
         child_t.SetRotation( dmVMath::QuatFromAngle(2, childRotation) );
     }
 
-    static void ApplyAnimation(RigPlayer* player, dmArray<dmTransform::Transform>& pose, const dmArray<uint32_t>& track_idx_to_pose, dmArray<IKAnimation>& ik_animation, dmArray<MeshSlotPose>& mesh_slot_pose, bool update_draw_order, dmArray<int32_t>& draw_order, int& slot_changed, float blend_weight)
+    static float GetPlayerTime(const RigPlayer* player)
+    {
+        float duration = GetCursorDuration(player, player->m_Animation);
+        return CursorToTime(player->m_Cursor, duration, player->m_Backwards, player->m_Playback == dmRig::PLAYBACK_ONCE_PINGPONG);
+    }
+
+    static void ApplyAnimation(RigPlayer* player, dmArray<dmTransform::Transform>& pose, const dmArray<uint32_t>& track_idx_to_pose, dmArray<IKAnimation>& ik_animation, dmArray<MeshSlotPose>& mesh_slot_pose, bool update_draw_order, dmArray<int32_t>& draw_order, int& slot_changed, float blend_weight, bool sample_bones)
     {
         const dmRigDDF::RigAnimation* animation = player->m_Animation;
         if (animation == 0x0)
             return;
-        float duration = GetCursorDuration(player, animation);
-        float t = CursorToTime(player->m_Cursor, duration, player->m_Backwards, player->m_Playback == dmRig::PLAYBACK_ONCE_PINGPONG);
+        float t = GetPlayerTime(player);
 
         float fraction = t * animation->m_SampleRate;
         uint32_t sample = (uint32_t)fraction;
         uint32_t rounded_sample = (uint32_t)(fraction + 0.5f);
         fraction -= sample;
-        // Sample animation tracks
-        uint32_t track_count = animation->m_Tracks.m_Count;
+        // Sample animation tracks, unless the bone pose has already been copied from the pose cache
+        uint32_t track_count = sample_bones ? animation->m_Tracks.m_Count : 0;
         for (uint32_t ti = 0; ti < track_count; ++ti)
         {
             const dmRigDDF::AnimationTrack* track = &animation->m_Tracks[ti];
@@ -537,17 +612,23 @@ namespace dmRig
             }
             uint32_t pose_index = track_idx_to_pose[bone_index];
             dmTransform::Transform& transform = pose[pose_index];
-            if (track->m_Positions.m_Count > 0)
+            if (track->m_Positions.m_Count > 0 || track->m_CompressedPositions.m_Count > 0)
             {
-                transform.SetTranslation(lerp(blend_weight, transform.GetTranslation(), SampleVec3(sample, fraction, track->m_Positions.m_Data)));
+                const uint8_t* compressed = track->m_CompressedPositions.m_Count > 0 ? track->m_CompressedPositions.m_Data : 0x0;
+                Vector3 position = SampleVec3Track(sample, fraction, track->m_Positions.m_Data, track->m_Positions.m_Count, compressed, track->m_PositionsRange.m_Data);
+                transform.SetTranslation(lerp(blend_weight, transform.GetTranslation(), position));
             }
-            if (track->m_Rotations.m_Count > 0)
+            if (track->m_Rotations.m_Count > 0 || track->m_CompressedRotations.m_Count > 0)
             {
-                transform.SetRotation(slerp(blend_weight, transform.GetRotation(), SampleQuat(sample, fraction, track->m_Rotations.m_Data)));
+                const uint8_t* compressed = track->m_CompressedRotations.m_Count > 0 ? track->m_CompressedRotations.m_Data : 0x0;
+                Quat rotation = SampleQuatTrack(sample, fraction, track->m_Rotations.m_Data, track->m_Rotations.m_Count, compressed);
+                transform.SetRotation(slerp(blend_weight, transform.GetRotation(), rotation));
             }
-            if (track->m_Scale.m_Count > 0)
+            if (track->m_Scale.m_Count > 0 || track->m_CompressedScale.m_Count > 0)
             {
-                transform.SetScale(lerp(blend_weight, transform.GetScale(), SampleVec3(sample, fraction, track->m_Scale.m_Data)));
+                const uint8_t* compressed = track->m_CompressedScale.m_Count > 0 ? track->m_CompressedScale.m_Data : 0x0;
+                Vector3 scale = SampleVec3Track(sample, fraction, track->m_Scale.m_Data, track->m_Scale.m_Count, compressed, track->m_ScaleRange.m_Data);
+                transform.SetScale(lerp(blend_weight, transform.GetScale(), scale));
             }
         }
 
@@ -601,10 +682,58 @@ namespace dmRig
         }
     }
 
+    static void InitPoseCacheEntry(const RigInstance* instance, const RigPlayer* player, PoseCacheEntry* entry, uint64_t* key)
+    {
+        // Clear the padding as well, since the key is hashed from the raw bytes
+        memset(entry, 0, sizeof(PoseCacheEntry));
+        entry->m_Animation = player->m_Animation;
+        entry->m_BindPose = instance->m_BindPose;
+        entry->m_TrackIdxToPose = instance->m_TrackIdxToPose;
+        entry->m_Time = GetPlayerTime(player);
+        entry->m_BoneCount = instance->m_Pose.Size();
+        *key = dmHashBuffer64(entry, sizeof(PoseCacheEntry));
+    }
+
+    static bool GetCachedPose(HRigContext context, const PoseCacheEntry& key_entry, uint64_t key, dmArray<dmTransform::Transform>& pose)
+    {
+        uint32_t* index = context->m_PoseCache.Get(key);
+        if (!index)
+            return false;
+        // Guard against hash collisions
+        const PoseCacheEntry& entry = context->m_PoseCacheEntries[*index];
+        if (entry.m_Animation != key_entry.m_Animation || entry.m_BindPose != key_entry.m_BindPose ||
+            entry.m_TrackIdxToPose != key_entry.m_TrackIdxToPose || entry.m_Time != key_entry.m_Time ||
+            entry.m_BoneCount != pose.Size())
+            return false;
+        memcpy(pose.Begin(), &context->m_PoseCacheTransforms[entry.m_Offset], sizeof(dmTransform::Transform) * entry.m_BoneCount);
+        return true;
+    }
+
+    static void StoreCachedPose(HRigContext context, const PoseCacheEntry& key_entry, uint64_t key, const dmArray<dmTransform::Transform>& pose)
+    {
+        if (context->m_PoseCache.Full() || context->m_PoseCacheEntries.Full() || context->m_PoseCache.Get(key))
+            return;
+        dmArray<dmTransform::Transform>& transforms = context->m_PoseCacheTransforms;
+        uint32_t bone_count = pose.Size();
+        if (transforms.Remaining() < bone_count) {
+            transforms.OffsetCapacity(dmMath::Max(bone_count, 256U));
+        }
+        PoseCacheEntry entry = key_entry;
+        entry.m_Offset = transforms.Size();
+        transforms.PushArray(&pose.Front(), bone_count);
+        context->m_PoseCache.Put(key, context->m_PoseCacheEntries.Size());
+        context->m_PoseCacheEntries.Push(entry);
+    }
+
     static void Animate(HRigContext context, float dt)
     {
         DM_PROFILE(Rig, "Animate");
 
+        // Poses are only shared within one update
+        context->m_PoseCache.Clear();
+        context->m_PoseCacheEntries.SetSize(0);
+        context->m_PoseCacheTransforms.SetSize(0);
+
         const dmArray<RigInstance*>& instances = context->m_Instances.m_Objects;
         uint32_t n = instances.Size();
         for (uint32_t i = 0; i < n; ++i)
@@ -664,6 +793,10 @@ namespace dmRig
                 context->m_ScratchDrawOrderDeltas[i] = SIGNAL_DELTA_UNCHANGED;
             }
 
+            PoseCacheEntry pose_cache_entry;
+            uint64_t pose_cache_key = 0;
+            bool pose_cached = false;
+            bool store_pose = false;
             if (instance->m_Blending)
             {
                 float fade_rate = instance->m_BlendTimer / instance->m_BlendDuration;
@@ -688,7 +821,7 @@ namespace dmRig
 
                     UpdatePlayer(instance, p, dt, blend_weight);
                     bool draw_order = player == p ? fade_rate >= 0.5f : fade_rate < 0.5f;
-                    ApplyAnimation(p, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, draw_order, context->m_ScratchDrawOrderDeltas, slot_changed, alpha);
+                    ApplyAnimation(p, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, draw_order, context->m_ScratchDrawOrderDeltas, slot_changed, alpha, true);
                     if (player == p)
                     {
                         alpha = 1.0f - fade_rate;
@@ -702,7 +835,15 @@ namespace dmRig
             else
             {
                 UpdatePlayer(instance, player, dt, 1.0f);
-                ApplyAnimation(player, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, true, context->m_ScratchDrawOrderDeltas, slot_changed, 1.0f);
+                // Instances that play the same animation at the same time end up with the same local
+                // pose (before IK), so only the first one needs to sample the bone tracks.
+                if (player->m_Animation)
+                {
+                    InitPoseCacheEntry(instance, player, &pose_cache_entry, &pose_cache_key);
+                    pose_cached = GetCachedPose(context, pose_cache_entry, pose_cache_key, pose);
+                    store_pose = !pose_cached;
+                }
+                ApplyAnimation(player, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, true, context->m_ScratchDrawOrderDeltas, slot_changed, 1.0f, !pose_cached);
             }
 
             // Update draw order after animation
@@ -710,7 +851,7 @@ namespace dmRig
                 UpdateSlotDrawOrder(instance->m_DrawOrder, context->m_ScratchDrawOrderDeltas, slot_changed, context->m_ScratchDrawOrderUnchanged);
             }
 
-            for (uint32_t bi = 0; bi < bone_count; ++bi)
+            for (uint32_t bi = 0; bi < bone_count && !pose_cached; ++bi)
             {
                 dmTransform::Transform& t = pose[bi];
                 // Normalize quaternions while we blend
@@ -727,6 +868,10 @@ namespace dmRig
                 t.SetScale(mulPerElem(bind_t.GetScale(), t.GetScale()));
             }
 
+            if (store_pose) {
+                StoreCachedPose(context, pose_cache_entry, pose_cache_key, pose);
+            }
+
             if (skeleton->m_Iks.m_Count > 0) {
                 DM_PROFILE(Rig, "IK");
                 const uint32_t count = skeleton->m_Iks.m_Count;
@@ -1042,14 +1187,15 @@ namespace dmRig
         return vertex_count;
     }
 
-    static float* GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<Matrix4>& pose_matrices, float* out_buffer)
+    // skin_matrices are the influence matrices premultiplied with the normal matrix
+    static float* GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<Matrix4>& skin_matrices, float* out_buffer)
     {
         const float* normals_in = mesh->m_Normals.m_Data;
         const uint32_t* normal_indices = mesh->m_NormalsIndices.m_Data;
         uint32_t index_count = mesh->m_PositionIndices.m_Count;
         Vector4 v;
 
-        if (!mesh->m_BoneIndices.m_Count || pose_matrices.Size() == 0)
+        if (!mesh->m_BoneIndices.m_Count || skin_matrices.Size() == 0)
         {
             for (uint32_t ii = 0; ii < index_count; ++ii)
             {
@@ -1073,7 +1219,7 @@ namespace dmRig
         {
             const uint32_t ni = normal_indices[ii]*3;
             const Vector3 normal_in(normals_in[ni+0], normals_in[ni+1], normals_in[ni+2]);
-            Vector4 normal_out(0.0f, 0.0f, 0.0f, 0.0f);
+            v = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
 
             const uint32_t bi_offset = vertex_indices[ii] << 2;
             const uint32_t* bone_indices = &indices[bi_offset];
@@ -1081,22 +1227,21 @@ namespace dmRig
 
             if (bone_weights[0])
             {
-                normal_out += (pose_matrices[bone_indices[0]] * normal_in) * bone_weights[0];
+                v += (skin_matrices[bone_indices[0]] * normal_in) * bone_weights[0];
                 if (bone_weights[1])
                 {
-                    normal_out += (pose_matrices[bone_indices[1]] * normal_in) * bone_weights[1];
+                    v += (skin_matrices[bone_indices[1]] * normal_in) * bone_weights[1];
                     if (bone_weights[2])
                     {
-                        normal_out += (pose_matrices[bone_indices[2]] * normal_in) * bone_weights[2];
+                        v += (skin_matrices[bone_indices[2]] * normal_in) * bone_weights[2];
                         if (bone_weights[3])
                         {
-                            normal_out += (pose_matrices[bone_indices[3]] * normal_in) * bone_weights[3];
+                            v += (skin_matrices[bone_indices[3]] * normal_in) * bone_weights[3];
                         }
                     }
                 }
             }
 
-            v = normal_matrix * Vector3(normal_out.getX(), normal_out.getY(), normal_out.getZ());
             if (lengthSqr(v) > 0.0f) {
                 normalize(v);
             }
@@ -1108,13 +1253,14 @@ namespace dmRig
         return out_buffer;
     }
 
-    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<Matrix4>& pose_matrices, float* out_buffer)
+    // skin_matrices are the influence matrices premultiplied with the model matrix
+    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<Matrix4>& skin_matrices, float* out_buffer)
     {
         const float *positions = mesh->m_Positions.m_Data;
         const size_t vertex_count = mesh->m_Positions.m_Count / 3;
         Point3 in_p;
         Vector4 v;
-        if(!mesh->m_BoneIndices.m_Count || pose_matrices.Size() == 0)
+        if(!mesh->m_BoneIndices.m_Count || skin_matrices.Size() == 0)
         {
             for (uint32_t i = 0; i < vertex_count; ++i)
             {
@@ -1129,39 +1275,45 @@ namespace dmRig
             return out_buffer;
         }
 
+        // The skin matrices scale the model translation by the sum of the weights,
+        // the remainder is added back so vertices keep the same placement as before folding.
+        const Vector4 model_translation = model_matrix.getCol3();
         const uint32_t* indices = mesh->m_BoneIndices.m_Data;
         const float* weights = mesh->m_Weights.m_Data;
         for (uint32_t i = 0; i < vertex_count; ++i)
         {
-            Vector4 in_v;
-            in_v.setX(*positions++);
-            in_v.setY(*positions++);
-            in_v.setZ(*positions++);
-            in_v.setW(1.0f);
+            in_p[0] = *positions++;
+            in_p[1] = *positions++;
+            in_p[2] = *positions++;
 
-            Vector4 out_p(0.0f, 0.0f, 0.0f, 0.0f);
+            v = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+            float weight_sum = 0.0f;
             const uint32_t bi_offset = i << 2;
             const uint32_t* bone_indices = &indices[bi_offset];
             const float* bone_weights = &weights[bi_offset];
 
             if(bone_weights[0])
             {
-                out_p += pose_matrices[bone_indices[0]] * in_v * bone_weights[0];
+                v += skin_matrices[bone_indices[0]] * in_p * bone_weights[0];
+                weight_sum += bone_weights[0];
                 if(bone_weights[1])
                 {
-                    out_p += pose_matrices[bone_indices[1]] * in_v * bone_weights[1];
+                    v += skin_matrices[bone_indices[1]] * in_p * bone_weights[1];
+                    weight_sum += bone_weights[1];
                     if(bone_weights[2])
                     {
-                        out_p += pose_matrices[bone_indices[2]] * in_v * bone_weights[2];
+                        v += skin_matrices[bone_indices[2]] * in_p * bone_weights[2];
+                        weight_sum += bone_weights[2];
                         if(bone_weights[3])
                         {
-                            out_p += pose_matrices[bone_indices[3]] * in_v * bone_weights[3];
+                            v += skin_matrices[bone_indices[3]] * in_p * bone_weights[3];
+                            weight_sum += bone_weights[3];
                         }
                     }
                 }
             }
 
-            v = model_matrix * Point3(out_p.getX(), out_p.getY(), out_p.getZ());
+            v += model_translation * (1.0f - weight_sum);
             *out_buffer++ = v[0];
             *out_buffer++ = v[1];
             *out_buffer++ = v[2];
@@ -1316,7 +1468,7 @@ namespace dmRig
         return out_write_ptr;
     }
 
-    void* GenerateVertexData(dmRig::HRigContext context, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
+    static void* DoGenerateVertexData(RigScratchBuffers& scratch, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
     {
         const dmRigDDF::MeshEntry* mesh_entry = instance->m_MeshEntry;
         if (!instance->m_MeshEntry || !instance->m_DoRender) {
@@ -1335,14 +1487,18 @@ namespace dmRig
             }
         }
 
-        dmArray<Matrix4>& pose_matrices      = context->m_ScratchPoseMatrixBuffer;
-        dmArray<Matrix4>& influence_matrices = context->m_ScratchInfluenceMatrixBuffer;
-        dmArray<Vector3>& positions          = context->m_ScratchPositionBuffer;
-        dmArray<Vector3>& normals            = context->m_ScratchNormalBuffer;
+        dmArray<Matrix4>& pose_matrices      = scratch.m_PoseMatrixBuffer;
+        dmArray<Matrix4>& influence_matrices = scratch.m_InfluenceMatrixBuffer;
+        dmArray<Matrix4>& skin_matrices      = scratch.m_SkinMatrixBuffer;
+        dmArray<Matrix4>& skin_normal_matrices = scratch.m_SkinNormalMatrixBuffer;
+        dmArray<Vector3>& positions          = scratch.m_PositionBuffer;
+        dmArray<Vector3>& normals            = scratch.m_NormalBuffer;
 
         // If the rig has bones, update the pose to be local-to-model
         uint32_t bone_count = GetBoneCount(instance);
         influence_matrices.SetSize(0);
+        skin_matrices.SetSize(0);
+        skin_normal_matrices.SetSize(0);
         if (bone_count && instance->m_PoseIdxToInfluence->Size() > 0) {
 
             // Make sure pose scratch buffers have enough space
@@ -1368,7 +1524,7 @@ namespace dmRig
             const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
             if (skeleton->m_LocalBoneScaling) {
 
-                dmArray<dmTransform::Transform>& pose_transforms = context->m_ScratchPoseTransformBuffer;
+                dmArray<dmTransform::Transform>& pose_transforms = scratch.m_PoseTransformBuffer;
                 if (pose_transforms.Capacity() < bone_count) {
                     pose_transforms.OffsetCapacity(bone_count - pose_transforms.Capacity());
                 }
@@ -1392,6 +1548,27 @@ namespace dmRig
 
             // Rearrange pose matrices to indices that the mesh vertices understand.
             PoseToInfluence(*instance->m_PoseIdxToInfluence, pose_matrices, influence_matrices);
+
+            // Fold the model (and normal) matrix into the influence matrices once per instance,
+            // instead of transforming every skinned vertex by it afterwards.
+            if (skin_matrices.Capacity() < max_bone_count) {
+                skin_matrices.OffsetCapacity(max_bone_count - skin_matrices.Capacity());
+            }
+            skin_matrices.SetSize(max_bone_count);
+            for (uint32_t bi = 0; bi < max_bone_count; ++bi)
+            {
+                skin_matrices[bi] = model_matrix * influence_matrices[bi];
+            }
+            if (vertex_format == RIG_VERTEX_FORMAT_MODEL) {
+                if (skin_normal_matrices.Capacity() < max_bone_count) {
+                    skin_normal_matrices.OffsetCapacity(max_bone_count - skin_normal_matrices.Capacity());
+                }
+                skin_normal_matrices.SetSize(max_bone_count);
+                for (uint32_t bi = 0; bi < max_bone_count; ++bi)
+                {
+                    skin_normal_matrices[bi] = normal_matrix * influence_matrices[bi];
+                }
+            }
         }
 
         // Loop that generates actual vertex data for current mesh entry.
@@ -1435,9 +1612,9 @@ namespace dmRig
                     // Fill scratch buffers for positions, and normals if applicable, using pose matrices.
                     float* positions_buffer = (float*)positions.Begin();
                     float* normals_buffer = (float*)normals.Begin();
-                    dmRig::GeneratePositionData(mesh_attachment, model_matrix, influence_matrices, positions_buffer);
+                    dmRig::GeneratePositionData(mesh_attachment, model_matrix, skin_matrices, positions_buffer);
                     if (vertex_format == RIG_VERTEX_FORMAT_MODEL && mesh_attachment->m_NormalsIndices.m_Count) {
-                        dmRig::GenerateNormalData(mesh_attachment, normal_matrix, influence_matrices, normals_buffer);
+                        dmRig::GenerateNormalData(mesh_attachment, normal_matrix, skin_normal_matrices, normals_buffer);
                     }
 
                     // NOTE: We expose two different vertex format that GenerateVertexData can output.
@@ -1477,6 +1654,97 @@ namespace dmRig
         return vertex_data_out;
     }
 
+    void* GenerateVertexData(dmRig::HRigContext context, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
+    {
+        return DoGenerateVertexData(context->m_ScratchBuffers, instance, model_matrix, normal_matrix, color, vertex_format, vertex_data_out);
+    }
+
+    struct GenerateVertexDataContext
+    {
+        RigContext*                     m_Context;
+        const RigInstanceVertexData*    m_Instances;
+        uint32_t                        m_InstanceCount;
+        uint32_t                        m_BatchSize;
+        uint32_t                        m_VertexSize;
+        RigVertexFormat                 m_VertexFormat;
+        uint8_t*                        m_VertexData;
+    };
+
+    static void GenerateVertexDataJob(void* context, void* data, uint32_t start, uint32_t end)
+    {
+        GenerateVertexDataContext* ctx = (GenerateVertexDataContext*) context;
+        const uint32_t* vertex_offsets = ctx->m_Context->m_ScratchVertexOffsets.Begin();
+        for (uint32_t batch = start; batch < end; ++batch)
+        {
+            // Each batch has its own scratch buffers, and is processed by a single job
+            RigScratchBuffers& scratch = *ctx->m_Context->m_JobScratchBuffers[batch];
+            uint32_t first = batch * ctx->m_BatchSize;
+            uint32_t last = dmMath::Min(first + ctx->m_BatchSize, ctx->m_InstanceCount);
+            for (uint32_t i = first; i < last; ++i)
+            {
+                const RigInstanceVertexData& item = ctx->m_Instances[i];
+                DoGenerateVertexData(scratch, item.m_Instance, item.m_ModelMatrix, item.m_NormalMatrix, item.m_Color, ctx->m_VertexFormat, ctx->m_VertexData + vertex_offsets[i] * ctx->m_VertexSize);
+            }
+        }
+    }
+
+    void* GenerateVertexData(HRigContext context, const RigInstanceVertexData* instances, uint32_t instance_count, RigVertexFormat vertex_format, void* vertex_data_out)
+    {
+        DM_PROFILE(Rig, "GenerateVertexData");
+
+        // Reserve the vertices of each instance before any are written, so the instances can be written in any order.
+        dmArray<uint32_t>& vertex_offsets = context->m_ScratchVertexOffsets;
+        if (vertex_offsets.Capacity() < instance_count) {
+            vertex_offsets.OffsetCapacity(instance_count - vertex_offsets.Capacity());
+        }
+        vertex_offsets.SetSize(instance_count);
+        uint32_t vertex_count = 0;
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            vertex_offsets[i] = vertex_count;
+            vertex_count += GetVertexCount(instances[i].m_Instance);
+        }
+
+        uint32_t vertex_size = vertex_format == RIG_VERTEX_FORMAT_MODEL ? sizeof(RigModelVertex) : sizeof(RigSpineModelVertex);
+        if (!context->m_JobContext || vertex_count < PARALLEL_MIN_VERTEX_COUNT)
+        {
+            for (uint32_t i = 0; i < instance_count; ++i)
+            {
+                const RigInstanceVertexData& item = instances[i];
+                DoGenerateVertexData(context->m_ScratchBuffers, item.m_Instance, item.m_ModelMatrix, item.m_NormalMatrix, item.m_Color, vertex_format, (uint8_t*)vertex_data_out + vertex_offsets[i] * vertex_size);
+            }
+            return (uint8_t*)vertex_data_out + vertex_count * vertex_size;
+        }
+
+        // A few batches per thread evens out the load when the instances differ in size
+        uint32_t max_batch_count = (dmJobSystem::GetWorkerCount(context->m_JobContext) + 1) * 4;
+        uint32_t batch_size = (instance_count + max_batch_count - 1) / max_batch_count;
+        uint32_t batch_count = (instance_count + batch_size - 1) / batch_size;
+
+        dmArray<RigScratchBuffers*>& job_scratch = context->m_JobScratchBuffers;
+        if (job_scratch.Size() < batch_count)
+        {
+            if (job_scratch.Capacity() < batch_count) {
+                job_scratch.OffsetCapacity(batch_count - job_scratch.Capacity());
+            }
+            while (job_scratch.Size() < batch_count) {
+                job_scratch.Push(new RigScratchBuffers());
+            }
+        }
+
+        GenerateVertexDataContext ctx;
+        ctx.m_Context = context;
+        ctx.m_Instances = instances;
+        ctx.m_InstanceCount = instance_count;
+        ctx.m_BatchSize = batch_size;
+        ctx.m_VertexSize = vertex_size;
+        ctx.m_VertexFormat = vertex_format;
+        ctx.m_VertexData = (uint8_t*)vertex_data_out;
+        dmJobSystem::ParallelFor(context->m_JobContext, GenerateVertexDataJob, &ctx, 0x0, batch_count, 1);
+
+        return (uint8_t*)vertex_data_out + vertex_count * vertex_size;
+    }
+
     static uint32_t FindIKIndex(HRigInstance instance, dmhash_t ik_constraint_id)
     {
         const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
@@ -12,9 +12,11 @@
 
 #define _USE_MATH_DEFINES // for C
 #include <math.h>
+#include <string.h>
 
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
+#include <dlib/job_system.h>
 #include <dlib/log.h>
 
 #include <../rig.h>
@@ -37,6 +39,17 @@ static void DeleteRigAnimation(dmRigDDF::RigAnimation& anim)
         if (anim_track.m_Scale.m_Count) {
             delete [] anim_track.m_Scale.m_Data;
         }
+        if (anim_track.m_CompressedPositions.m_Count) {
+            delete [] anim_track.m_CompressedPositions.m_Data;
+            delete [] anim_track.m_PositionsRange.m_Data;
+        }
+        if (anim_track.m_CompressedRotations.m_Count) {
+            delete [] anim_track.m_CompressedRotations.m_Data;
+        }
+        if (anim_track.m_CompressedScale.m_Count) {
+            delete [] anim_track.m_CompressedScale.m_Data;
+            delete [] anim_track.m_ScaleRange.m_Data;
+        }
     }
 
     for (uint32_t t = 0; t < anim.m_IkTracks.m_Count; ++t) {
@@ -640,7 +653,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         // Animation 0: "valid"
         {
             uint32_t track_count = 2;
-            anim0.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim0.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim0.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track0 = anim0.m_Tracks.m_Data[0];
             dmRigDDF::AnimationTrack& anim_track1 = anim0.m_Tracks.m_Data[1];
@@ -695,7 +708,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         // Animation 2: "scaling"
         {
             uint32_t track_count = 3; // 2x rotation, 1x scale
-            anim2.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim2.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim2.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track_b0_rot   = anim2.m_Tracks.m_Data[0];
             dmRigDDF::AnimationTrack& anim_track_b0_scale = anim2.m_Tracks.m_Data[1];
@@ -742,7 +755,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         // Animation 3: "invalid_bones"
         {
             uint32_t track_count = 1;
-            anim3.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim3.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim3.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track0 = anim3.m_Tracks.m_Data[0];
 
@@ -762,7 +775,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         // Animation 4: "rot_blend1"
         {
             uint32_t track_count = 1;
-            anim4.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim4.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim4.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track0 = anim4.m_Tracks.m_Data[0];
 
@@ -781,7 +794,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
         // Animation 5: "rot_blend2"
         {
             uint32_t track_count = 1;
-            anim5.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim5.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim5.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track0 = anim5.m_Tracks.m_Data[0];
 
@@ -802,7 +815,7 @@ void SetUpSimpleRig(dmArray<dmRig::RigBone>& bind_pose, dmRigDDF::Skeleton* skel
             uint32_t track_count = 2;
             uint32_t samples = 2;
 
-            anim6.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count];
+            anim6.m_Tracks.m_Data = new dmRigDDF::AnimationTrack[track_count]();
             anim6.m_Tracks.m_Count = track_count;
             dmRigDDF::AnimationTrack& anim_track0 = anim6.m_Tracks.m_Data[0];
             dmRigDDF::AnimationTrack& anim_track1 = anim6.m_Tracks.m_Data[1];
@@ -1455,11 +1468,11 @@ TEST_F(RigInstanceTest, MaxBoneCount)
 
     // m_ScratchInfluenceMatrixBuffer should be able to contain the instance max bone count, which is the max of the used skeleton and meshset
     // MaxBoneCount is set to BoneCount + 1 for testing.
-    ASSERT_EQ(m_Context->m_ScratchInfluenceMatrixBuffer.Size(), dmRig::GetMaxBoneCount(m_Instance));
-    ASSERT_EQ(m_Context->m_ScratchInfluenceMatrixBuffer.Size(), dmRig::GetBoneCount(m_Instance) + 1);
+    ASSERT_EQ(m_Context->m_ScratchBuffers.m_InfluenceMatrixBuffer.Size(), dmRig::GetMaxBoneCount(m_Instance));
+    ASSERT_EQ(m_Context->m_ScratchBuffers.m_InfluenceMatrixBuffer.Size(), dmRig::GetBoneCount(m_Instance) + 1);
 
     // Setting the m_ScratchInfluenceMatrixBuffer to zero ensures it have to be resized to max bone count
-    m_Context->m_ScratchInfluenceMatrixBuffer.SetCapacity(0);
+    m_Context->m_ScratchBuffers.m_InfluenceMatrixBuffer.SetCapacity(0);
     // If this isn't done correctly, it'll assert out of bounds
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0/60.0));
 }
@@ -1541,6 +1554,120 @@ TEST_F(RigInstanceTest, PoseAnim)
     ASSERT_VEC4(Quat::identity(), pose[1].GetRotation());
 }
 
+// Two instances playing the same animation in sync share the sampled pose,
+// while an instance at another time samples its own.
+TEST_F(RigInstanceTest, PoseAnimShared)
+{
+    dmRig::HRigInstance instance = 0x0;
+    dmRig::InstanceCreateParams create_params = {0};
+    create_params.m_Context            = m_Context;
+    create_params.m_Instance           = &instance;
+    create_params.m_BindPose           = &m_BindPose;
+    create_params.m_Skeleton           = m_Skeleton;
+    create_params.m_MeshSet            = m_MeshSet;
+    create_params.m_AnimationSet       = m_AnimationSet;
+    create_params.m_TrackIdxToPose     = &m_TrackIdxToPose;
+    create_params.m_PoseIdxToInfluence = &m_PoseIdxToInfluence;
+    create_params.m_MeshId             = dmHashString64((const char*)"test");
+    create_params.m_DefaultAnimation   = dmHashString64((const char*)"");
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceCreate(create_params));
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+
+    dmArray<dmTransform::Transform>& pose_a = *dmRig::GetPose(m_Instance);
+    dmArray<dmTransform::Transform>& pose_b = *dmRig::GetPose(instance);
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // sample 1
+    ASSERT_VEC4(Quat::identity(), pose_a[0].GetRotation());
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose_a[1].GetRotation());
+    ASSERT_VEC4(Quat::identity(), pose_b[0].GetRotation());
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose_b[1].GetRotation());
+    ASSERT_VEC3(Vector3(1.0f, 0.0f, 0.0f), pose_b[1].GetTranslation());
+
+    // Move the second instance to sample 0 again
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::SetCursor(instance, 2.0f, false));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // sample 2 and sample 0 (looped)
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose_a[0].GetRotation());
+    ASSERT_VEC4(Quat::identity(), pose_a[1].GetRotation());
+    ASSERT_VEC4(Quat::identity(), pose_b[0].GetRotation());
+    ASSERT_VEC4(Quat::identity(), pose_b[1].GetRotation());
+
+    dmRig::InstanceDestroyParams destroy_params = {0};
+    destroy_params.m_Context = m_Context;
+    destroy_params.m_Instance = instance;
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceDestroy(destroy_params));
+}
+
+// Same as PoseAnim, but with the "valid" animation stored as compressed and constant tracks
+TEST_F(RigInstanceTest, PoseAnimCompressed)
+{
+    dmRigDDF::RigAnimation& anim = m_AnimationSet->m_Animations.m_Data[0];
+    dmRigDDF::AnimationTrack& track0 = anim.m_Tracks.m_Data[0];
+    dmRigDDF::AnimationTrack& track1 = anim.m_Tracks.m_Data[1];
+
+    // Smallest three rotations: identity, identity, z 90, z 90, z 90
+    const uint8_t rotations[] = {
+        0x00, 0xc0, 0x00, 0xc0, 0x00, 0x40,
+        0x00, 0xc0, 0x00, 0xc0, 0x00, 0x40,
+        0x00, 0xc0, 0x00, 0x40, 0xff, 0x7f,
+        0x00, 0xc0, 0x00, 0x40, 0xff, 0x7f,
+        0x00, 0xc0, 0x00, 0x40, 0xff, 0x7f,
+    };
+    delete [] track0.m_Rotations.m_Data;
+    track0.m_Rotations.m_Data = 0x0;
+    track0.m_Rotations.m_Count = 0;
+    track0.m_CompressedRotations.m_Data = new uint8_t[sizeof(rotations)];
+    track0.m_CompressedRotations.m_Count = sizeof(rotations);
+    memcpy(track0.m_CompressedRotations.m_Data, rotations, sizeof(rotations));
+
+    // Constant rotation, z 90
+    delete [] track1.m_Rotations.m_Data;
+    track1.m_Rotations.m_Data = new float[4];
+    track1.m_Rotations.m_Count = 4;
+    *(Quat*)track1.m_Rotations.m_Data = Quat::rotationZ((float)M_PI / 2.0f);
+
+    // Quantized positions with a step of 0.5 along x: 0, 1, 2, 2, 2
+    const uint8_t positions[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    track1.m_CompressedPositions.m_Data = new uint8_t[sizeof(positions)];
+    track1.m_CompressedPositions.m_Count = sizeof(positions);
+    memcpy(track1.m_CompressedPositions.m_Data, positions, sizeof(positions));
+    track1.m_PositionsRange.m_Data = new float[6];
+    track1.m_PositionsRange.m_Count = 6;
+    const float range[] = {0.0f, 0.0f, 0.0f, 0.5f, 0.0f, 0.0f};
+    memcpy(track1.m_PositionsRange.m_Data, range, sizeof(range));
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+
+    dmArray<dmTransform::Transform>& pose = *dmRig::GetPose(m_Instance);
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // sample 1
+    ASSERT_VEC3(Vector3(0.0f), pose[0].GetTranslation());
+    ASSERT_VEC3(Vector3(2.0f, 0.0f, 0.0f), pose[1].GetTranslation());
+    ASSERT_VEC4(Quat::identity(), pose[0].GetRotation());
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose[1].GetRotation());
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // sample 2
+    ASSERT_VEC3(Vector3(0.0f), pose[0].GetTranslation());
+    ASSERT_VEC3(Vector3(3.0f, 0.0f, 0.0f), pose[1].GetTranslation());
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose[0].GetRotation());
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), pose[1].GetRotation());
+}
+
 TEST_F(RigInstanceTest, PoseAnimCancel)
 {
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
@@ -1659,6 +1786,58 @@ TEST_F(RigInstanceTest, GenerateVertexData)
     ASSERT_VERT_POS(Vector3(0.0f, 2.0f, 0.0), data[2]); // v2
 }
 
+TEST_F(RigInstanceTest, GenerateVertexDataParallel)
+{
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // Enough instances (4 vertices each) for the vertex data to be generated on the job system
+    const uint32_t instance_count = 1024;
+    const uint32_t vertex_count = instance_count * 4;
+    dmArray<dmRig::RigInstanceVertexData> instances;
+    instances.SetCapacity(instance_count);
+    instances.SetSize(instance_count);
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        dmRig::RigInstanceVertexData& item = instances[i];
+        item.m_Instance = m_Instance;
+        item.m_ModelMatrix = Matrix4::translation(Vector3((float)i, 0.0f, 0.0f)) * Matrix4::rotationZ(i * 0.01f);
+        item.m_NormalMatrix = Matrix4::rotationZ(i * 0.01f);
+        item.m_Color = Vector4(1.0f);
+    }
+
+    dmRig::RigModelVertex* expected = new dmRig::RigModelVertex[vertex_count];
+    dmRig::RigModelVertex* serial = new dmRig::RigModelVertex[vertex_count];
+    dmRig::RigModelVertex* parallel = new dmRig::RigModelVertex[vertex_count];
+    memset(parallel, 0, vertex_count * sizeof(dmRig::RigModelVertex));
+
+    dmRig::RigModelVertex* write_ptr = expected;
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        write_ptr = (dmRig::RigModelVertex*)dmRig::GenerateVertexData(m_Context, m_Instance, instances[i].m_ModelMatrix, instances[i].m_NormalMatrix, Vector4(1.0f), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)write_ptr);
+    }
+    ASSERT_EQ(expected + vertex_count, write_ptr);
+
+    ASSERT_EQ(serial + vertex_count, dmRig::GenerateVertexData(m_Context, instances.Begin(), instance_count, dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)serial));
+    ASSERT_EQ(0, memcmp(expected, serial, vertex_count * sizeof(dmRig::RigModelVertex)));
+
+    dmJobSystem::NewContextParams job_params;
+    job_params.m_WorkerCount = 3;
+    dmJobSystem::HContext job_context = dmJobSystem::NewContext(job_params);
+    dmRig::SetJobContext(m_Context, job_context);
+
+    ASSERT_EQ(parallel + vertex_count, dmRig::GenerateVertexData(m_Context, instances.Begin(), instance_count, dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)parallel));
+    ASSERT_EQ(0, memcmp(expected, parallel, vertex_count * sizeof(dmRig::RigModelVertex)));
+
+    dmRig::SetJobContext(m_Context, 0x0);
+    dmJobSystem::DeleteContext(job_context);
+
+    delete [] expected;
+    delete [] serial;
+    delete [] parallel;
+}
+
 TEST_F(RigInstanceTest, GenerateNormalData)
 {
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
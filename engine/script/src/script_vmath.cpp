@@ -12,7 +12,7 @@
 
 #include "script.h"
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
@@ -27,6 +27,13 @@ namespace dmSoundCodec
         struct DecodeStreamInfo {
             Info m_Info;
             stb_vorbis *m_StbVorbis;
+
+            // Streamed decoding, using the pushdata api
+            StreamBuffer* m_Input;
+            float** m_Outputs;
+            uint32_t m_OutputStart;
+            uint32_t m_OutputEnd;
+            bool m_EndOfStream;
         };
     }
 
@@ -37,13 +44,15 @@ namespace dmSoundCodec
 
         if (vorbis) {
             stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+            uint64_t size = (uint64_t) stb_vorbis_stream_length_in_samples(vorbis) * info.channels * 2;
 
             DecodeStreamInfo *streamInfo = new DecodeStreamInfo;
             streamInfo->m_Info.m_Rate = info.sample_rate;
-            streamInfo->m_Info.m_Size = 0;
+            streamInfo->m_Info.m_Size = size < 0xffffffff ? (uint32_t) size : 0;
             streamInfo->m_Info.m_Channels = info.channels;
             streamInfo->m_Info.m_BitsPerSample = 16;
             streamInfo->m_StbVorbis = vorbis;
+            streamInfo->m_Input = 0;
 
             *stream = streamInfo;
             return RESULT_OK;
@@ -82,9 +91,168 @@ namespace dmSoundCodec
         return RESULT_OK;
     }
 
+    // Same conversion as stb_vorbis_get_samples_short_interleaved() does, so that streamed and
+    // in memory sounds decode to the same samples
+    static inline int16_t FloatToShort(float x)
+    {
+        union { float f; int32_t i; } temp;
+        temp.f = x + (1.5f * (1 << 8) + 0.5f / (1 << 15));
+        int32_t v = temp.i - ((135 << 23) + (1 << 22));
+        if ((uint32_t) (v + 32768) > 65535)
+            v = v < 0 ? -32768 : 32767;
+        return (int16_t) v;
+    }
+
+    static Result StbVorbisOpenPushData(DecodeStreamInfo* streamInfo)
+    {
+        StreamBuffer* input = streamInfo->m_Input;
+
+        // The headers must be in memory as a whole, read more until they are
+        uint32_t size = 1;
+        for (;;)
+        {
+            Result r = StreamFill(input, size);
+            if (r != RESULT_OK) {
+                return r;
+            }
+
+            int used, error;
+            stb_vorbis* vorbis = stb_vorbis_open_pushdata(input->m_Data + input->m_Start, StreamAvailable(input), &used, &error, NULL);
+            if (vorbis) {
+                StreamConsume(input, used);
+                streamInfo->m_StbVorbis = vorbis;
+                streamInfo->m_OutputStart = 0;
+                streamInfo->m_OutputEnd = 0;
+                streamInfo->m_EndOfStream = false;
+                return RESULT_OK;
+            }
+
+            if (error != VORBIS_need_more_data || StreamIsComplete(input)) {
+                return RESULT_INVALID_FORMAT;
+            }
+            size = StreamAvailable(input) * 2;
+        }
+    }
+
+    static Result StbVorbisOpenStreamBuffer(StreamBuffer* input, HDecodeStream* stream)
+    {
+        DecodeStreamInfo *streamInfo = new DecodeStreamInfo;
+        streamInfo->m_Input = input;
+
+        Result r = StbVorbisOpenPushData(streamInfo);
+        if (r != RESULT_OK) {
+            delete streamInfo;
+            return r;
+        }
+
+        stb_vorbis_info info = stb_vorbis_get_info(streamInfo->m_StbVorbis);
+        streamInfo->m_Info.m_Rate = info.sample_rate;
+        streamInfo->m_Info.m_Size = 0;
+        streamInfo->m_Info.m_Channels = info.channels;
+        streamInfo->m_Info.m_BitsPerSample = 16;
+
+        *stream = streamInfo;
+        return RESULT_OK;
+    }
+
+    // Decodes the next frame into m_Outputs, reading more data as needed
+    static Result StbVorbisDecodeFrame(DecodeStreamInfo* streamInfo)
+    {
+        StreamBuffer* input = streamInfo->m_Input;
+        if (!streamInfo->m_StbVorbis) {
+            // Failed to open again on reset
+            return RESULT_DECODE_ERROR;
+        }
+
+        for (;;)
+        {
+            int channels, samples;
+            float** outputs;
+            int used = stb_vorbis_decode_frame_pushdata(streamInfo->m_StbVorbis, input->m_Data + input->m_Start, StreamAvailable(input), &channels, &outputs, &samples);
+            if (used == 0 && samples == 0) {
+                // The next packet isn't complete
+                if (StreamIsComplete(input)) {
+                    streamInfo->m_EndOfStream = true;
+                    return RESULT_OK;
+                }
+                Result r = StreamFill(input, StreamAvailable(input) + 1);
+                if (r != RESULT_OK) {
+                    return r;
+                }
+                continue;
+            }
+
+            StreamConsume(input, used);
+            if (samples > 0) {
+                streamInfo->m_Outputs = outputs;
+                streamInfo->m_OutputStart = 0;
+                streamInfo->m_OutputEnd = samples;
+                return RESULT_OK;
+            }
+        }
+    }
+
+    static Result StbVorbisDecodeStreamBuffer(HDecodeStream stream, char* buffer, uint32_t buffer_size, uint32_t* decoded)
+    {
+        DecodeStreamInfo *streamInfo = (DecodeStreamInfo *) stream;
+
+        DM_PROFILE(SoundCodec, "StbVorbis")
+
+        const uint32_t channels = streamInfo->m_Info.m_Channels;
+        const uint32_t frame_count = buffer_size / (channels * sizeof(int16_t));
+        int16_t* out = (int16_t*) buffer;
+
+        uint32_t n = 0;
+        while (n < frame_count)
+        {
+            if (streamInfo->m_OutputStart == streamInfo->m_OutputEnd) {
+                if (streamInfo->m_EndOfStream) {
+                    break;
+                }
+                Result r = StbVorbisDecodeFrame(streamInfo);
+                if (r != RESULT_OK) {
+                    return r;
+                }
+                continue;
+            }
+
+            uint32_t k = dmMath::Min(frame_count - n, streamInfo->m_OutputEnd - streamInfo->m_OutputStart);
+            if (out) {
+                for (uint32_t c = 0; c < channels; ++c) {
+                    const float* src = streamInfo->m_Outputs[c] + streamInfo->m_OutputStart;
+                    int16_t* dst = out + n * channels + c;
+                    for (uint32_t i = 0; i < k; ++i) {
+                        dst[i * channels] = FloatToShort(src[i]);
+                    }
+                }
+            }
+            streamInfo->m_OutputStart += k;
+            n += k;
+        }
+
+        *decoded = n * channels * sizeof(int16_t);
+        return RESULT_OK;
+    }
+
+    static Result StbVorbisDecodeAny(HDecodeStream stream, char* buffer, uint32_t buffer_size, uint32_t* decoded)
+    {
+        if (((DecodeStreamInfo*) stream)->m_Input) {
+            return StbVorbisDecodeStreamBuffer(stream, buffer, buffer_size, decoded);
+        }
+        return StbVorbisDecode(stream, buffer, buffer_size, decoded);
+    }
+
     Result StbVorbisResetStream(HDecodeStream stream)
     {
-        stb_vorbis_seek_start(((DecodeStreamInfo*)stream)->m_StbVorbis);
+        DecodeStreamInfo *streamInfo = (DecodeStreamInfo*) stream;
+        if (streamInfo->m_Input) {
+            // Seeking needs the whole file with pushdata, open the stream again instead
+            stb_vorbis_close(streamInfo->m_StbVorbis);
+            streamInfo->m_StbVorbis = 0;
+            StreamSeek(streamInfo->m_Input, 0);
+            return StbVorbisOpenPushData(streamInfo);
+        }
+        stb_vorbis_seek_start(streamInfo->m_StbVorbis);
         return RESULT_OK;
     }
 
@@ -93,14 +261,15 @@ namespace dmSoundCodec
         // Decode with buffer = null corresponding number of bytes.
         // stb_vorbis has a special case for this skipping a lot of
         // decoding work.
-        Result r = StbVorbisDecode(stream, 0, bytes, skipped);
+        Result r = StbVorbisDecodeAny(stream, 0, bytes, skipped);
         return r;
     }
 
     void StbVorbisCloseStream(HDecodeStream stream)
     {
         DecodeStreamInfo *streamInfo = (DecodeStreamInfo*) stream;
-        stb_vorbis_close(streamInfo->m_StbVorbis);
+        if (streamInfo->m_StbVorbis)
+            stb_vorbis_close(streamInfo->m_StbVorbis);
         delete streamInfo;
     }
 
@@ -111,5 +280,6 @@ namespace dmSoundCodec
 
     DM_DECLARE_SOUND_DECODER(AudioDecoderStbVorbis, "VorbisDecoderStb", FORMAT_VORBIS,
                              5, // baseline score (1-10)
-                             StbVorbisOpenStream, StbVorbisCloseStream, StbVorbisDecode, StbVorbisResetStream, StbVorbisSkipInStream, StbVorbisGetInfo);
+                             StbVorbisOpenStream, StbVorbisCloseStream, StbVorbisDecodeAny, StbVorbisResetStream, StbVorbisSkipInStream, StbVorbisGetInfo,
+                             StbVorbisOpenStreamBuffer);
 }
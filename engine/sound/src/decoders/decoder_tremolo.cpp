@@ -33,6 +33,8 @@ namespace dmSoundCodec
             const char *m_Buffer;
             ogg_int64_t m_SeekTo;
             ogg_int64_t m_PcmLength;
+            // Set for streamed decoding, instead of m_Buffer
+            StreamBuffer* m_Input;
         };
     }
 
@@ -43,6 +45,14 @@ namespace dmSoundCodec
         DecodeStreamInfo *info = (DecodeStreamInfo*) datasource;
 
         size_t tot = nmemb * size;
+        if (info->m_Input) {
+            uint32_t nread;
+            if (StreamRead(info->m_Input, ptr, (uint32_t) tot, &nread) != RESULT_OK) {
+                return 0;
+            }
+            return nread;
+        }
+
         if (tot > (info->m_Size - info->m_Cursor)) {
             tot = info->m_Size - info->m_Cursor;
         }
@@ -78,20 +88,34 @@ namespace dmSoundCodec
         return info->m_Cursor;
     }
 
-    static Result TremoloOpenStream(const void* buffer, uint32_t buffer_size, HDecodeStream* stream)
+    // A streamed file is read from start to end, the -1 tells the decoder that it can't seek
+    static int OggSeekStreamed(void *datasource, long long offset, int whence)
     {
-        DecodeStreamInfo *tmp = new DecodeStreamInfo();
-        tmp->m_Buffer = (const char*) buffer;
-        tmp->m_Size = buffer_size;
-        tmp->m_Cursor = 0;
+        (void)datasource;
+        (void)offset;
+        (void)whence;
+        return -1;
+    }
 
+    static long OggTellStreamed(void *datasource)
+    {
+        DecodeStreamInfo *info = (DecodeStreamInfo*) datasource;
+        return info->m_Input->m_Offset;
+    }
+
+    static int TremoloOpen(DecodeStreamInfo* info)
+    {
         ov_callbacks cb;
         cb.read_func = OggRead;
         cb.close_func = OggClose;
-        cb.seek_func = OggSeek;
-        cb.tell_func = OggTell;
+        cb.seek_func = info->m_Input ? OggSeekStreamed : OggSeek;
+        cb.tell_func = info->m_Input ? OggTellStreamed : OggTell;
+        return ov_open_callbacks(info, &info->m_File, 0, 0, cb);
+    }
 
-        int res = ov_open_callbacks(tmp, &tmp->m_File, 0, 0, cb);
+    static Result TremoloOpenInfo(DecodeStreamInfo* tmp, HDecodeStream* stream)
+    {
+        int res = TremoloOpen(tmp);
         if (res)
         {
             delete tmp;
@@ -107,11 +131,37 @@ namespace dmSoundCodec
 
         tmp->m_PcmLength = ov_pcm_total(&tmp->m_File, -1);
         tmp->m_SeekTo = -1;
+        // The length is unknown for a streamed (unseekable) file
+        if (tmp->m_PcmLength > 0)
+        {
+            ogg_int64_t size = tmp->m_PcmLength * info->channels * 2;
+            tmp->m_Info.m_Size = size < 0xffffffff ? (uint32_t) size : 0;
+        }
 
         *stream = tmp;
         return RESULT_OK;
     }
 
+    static Result TremoloOpenStream(const void* buffer, uint32_t buffer_size, HDecodeStream* stream)
+    {
+        DecodeStreamInfo *tmp = new DecodeStreamInfo();
+        tmp->m_Buffer = (const char*) buffer;
+        tmp->m_Size = buffer_size;
+        tmp->m_Cursor = 0;
+        tmp->m_Input = 0;
+        return TremoloOpenInfo(tmp, stream);
+    }
+
+    static Result TremoloOpenStreamBuffer(StreamBuffer* input, HDecodeStream* stream)
+    {
+        DecodeStreamInfo *tmp = new DecodeStreamInfo();
+        tmp->m_Buffer = 0;
+        tmp->m_Size = 0;
+        tmp->m_Cursor = 0;
+        tmp->m_Input = input;
+        return TremoloOpenInfo(tmp, stream);
+    }
+
     static Result TremoloDecode(HDecodeStream stream, char* buffer, uint32_t buffer_size, uint32_t* decoded)
     {
         DM_PROFILE(SoundCodec, "Tremolo")
@@ -161,8 +211,15 @@ namespace dmSoundCodec
     static Result TremoloResetStream(HDecodeStream stream)
     {
         DecodeStreamInfo *streamInfo = (DecodeStreamInfo*) stream;
-        ov_raw_seek(&streamInfo->m_File, 0);
         streamInfo->m_SeekTo = -1;
+        if (streamInfo->m_Input)
+        {
+            // Can't seek in a streamed file, open it again instead
+            ov_clear(&streamInfo->m_File);
+            StreamSeek(streamInfo->m_Input, 0);
+            return TremoloOpen(streamInfo) ? RESULT_INVALID_FORMAT : RESULT_OK;
+        }
+        ov_raw_seek(&streamInfo->m_File, 0);
         return RESULT_OK;
     }
 
@@ -186,6 +243,24 @@ namespace dmSoundCodec
             *skipped = (uint32_t)((newpos - pos) * stride);
             return RESULT_OK;
         }
+        else if (streamInfo->m_Input)
+        {
+            // A streamed file is unseekable, decode and throw away the samples
+            char tmp[4096];
+            uint32_t total = 0;
+            while (total < bytes)
+            {
+                uint32_t decoded;
+                Result r = TremoloDecode(stream, tmp, dmMath::Min(bytes - total, (uint32_t) sizeof(tmp)), &decoded);
+                if (r != RESULT_OK)
+                    return r;
+                if (decoded == 0)
+                    break;
+                total += decoded;
+            }
+            *skipped = total;
+            return RESULT_OK;
+        }
         else
         {
             // unseekable stream.
@@ -207,5 +282,6 @@ namespace dmSoundCodec
     }
 
     DM_DECLARE_SOUND_DECODER(AudioDecoderTremolo, "VorbisDecoderTremolo", FORMAT_VORBIS, 8,
-                             TremoloOpenStream, TremoloCloseStream, TremoloDecode, TremoloResetStream, TremoloSkipInStream, TremoloGetInfo);
+                             TremoloOpenStream, TremoloCloseStream, TremoloDecode, TremoloResetStream, TremoloSkipInStream, TremoloGetInfo,
+                             TremoloOpenStreamBuffer);
 }
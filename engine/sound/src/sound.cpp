@@ -11,12 +11,14 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
+#include <dlib/align.h>
 #include <dlib/hashtable.h>
 #include <dlib/index_pool.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/mutex.h>
 #include <dlib/profile.h>
+#include <dlib/simd.h>
 #include <dlib/thread.h>
 #include <dlib/time.h>
 
@@ -26,6 +28,7 @@
 
 #include <math.h>
 #include <cfloat>
+#include <algorithm>
 
 /**
  * Defold simple sound system
@@ -46,6 +49,28 @@ namespace dmSound
     const dmhash_t MASTER_GROUP_HASH = dmHashString64("master");
     const uint32_t GROUP_MEMORY_BUFFER_COUNT = 64;
 
+    // Band limited resampling, see ResampleFilter
+    const uint32_t RESAMPLE_FILTER_PHASE_BITS = 6;
+    const uint32_t RESAMPLE_FILTER_PHASES = 1U << RESAMPLE_FILTER_PHASE_BITS;
+    const uint32_t RESAMPLE_FILTER_MAX_HALF_TAPS = 32;
+    const uint32_t RESAMPLE_FILTER_CACHE_SIZE = 16;
+    // Cutoff relative to the Nyquist frequency of the lower of the two rates
+    const float    RESAMPLE_FILTER_CUTOFF = 0.95f;
+    // The step (input frames per mixed frame) is rounded up to 1/16 when selecting a filter,
+    // so that sounds with small pitch changes share filters
+    const uint32_t RESAMPLE_FILTER_STEP_SCALE = 16;
+    // Zero crossings of the filter on each side for RESAMPLE_QUALITY_MEDIUM and RESAMPLE_QUALITY_HIGH
+    const uint32_t RESAMPLE_FILTER_ZERO_CROSSINGS[] = { 0, 8, 16 };
+    // Bytes kept before SoundInstance::m_Frames with already mixed frames, for the filter taps.
+    // Sized for the largest frame (16 bit stereo)
+    const uint32_t RESAMPLE_HISTORY_SIZE = RESAMPLE_FILTER_MAX_HALF_TAPS * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS;
+
+    // Gain bias of the instances that are already mixed when picking the real voices, so that
+    // instances with about the same gain don't swap between real and virtual every update
+    const float    REAL_VOICE_BIAS = 1.25f;
+
+    static const float DM_ALIGNED(16) STEREO_FRAME_OFFSETS[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
     static void SoundThread(void* ctx);
 
     /**
@@ -143,6 +168,28 @@ namespace dmSound
         return ramp;
     }
 
+    /**
+     * Same as Ramp::GetValue() for the four sample indices in index
+     */
+    static inline dmSimd::Vec4f GetRampValues(const Ramp& ramp, dmSimd::Vec4f index)
+    {
+        dmSimd::Vec4f mix = dmSimd::Mul(index, dmSimd::Splat(ramp.m_TotalSamplesRecip));
+        return dmSimd::Add(dmSimd::Splat(ramp.m_From), dmSimd::Mul(mix, dmSimd::Splat(ramp.m_To - ramp.m_From)));
+    }
+
+    /**
+     * Windowed sinc filter for band limited resampling, for one step (input frames per mixed frame).
+     * Holds the taps for RESAMPLE_FILTER_PHASES + 1 evenly spaced positions between two input frames,
+     * the taps for a position in between two phases are interpolated.
+     */
+    struct ResampleFilter
+    {
+        float*   m_Taps;        // (RESAMPLE_FILTER_PHASES + 1) * m_TapCount
+        uint32_t m_Key;         // Step * RESAMPLE_FILTER_STEP_SCALE, 0 if unused
+        uint32_t m_TapCount;    // Multiple of dmSimd::WIDTH
+        uint32_t m_LastUsed;
+    };
+
     struct SoundData
     {
         dmhash_t      m_NameHash;
@@ -150,13 +197,20 @@ namespace dmSound
         int           m_Size;
         // Index in m_SoundData
         uint16_t      m_Index;
+        // False if m_Data references memory owned by someone else
+        bool          m_OwnsData;
         SoundDataType m_Type;
+        // Streamed sound data. m_Data holds the first m_Size of the m_StreamSize bytes, the rest is read with m_StreamRead
+        uint32_t      m_StreamSize;
+        FSoundDataRead m_StreamRead;
+        void*         m_StreamContext;
     };
 
     struct SoundInstance
     {
         dmSoundCodec::HDecoder m_Decoder;
-        void*       m_Frames;
+        void*       m_FrameBuffer;
+        void*       m_Frames;   // RESAMPLE_HISTORY_SIZE bytes into m_FrameBuffer
         dmhash_t    m_Group;
 
         Value       m_Gain;     // default: 1.0f
@@ -164,14 +218,22 @@ namespace dmSound
         float       m_Speed;    // 1.0 = normal speed, 0.5 = half speed, 2.0 = double speed
         uint32_t    m_FrameCount;
         uint64_t    m_FrameFraction;
+        // Frames decoded (or skipped) since the decoder was reset
+        uint32_t    m_Position;
+        // Frames played as a virtual voice that the decoder hasn't skipped yet
+        uint32_t    m_VirtualFrames;
+        // Gain of the instance, including the group gains. Updated when picking the real voices
+        float       m_Audibility;
 
         uint16_t    m_Index;
         uint16_t    m_SoundDataIndex;
         uint8_t     m_Looping : 1;
         uint8_t     m_EndOfStream : 1;
         uint8_t     m_Playing : 1;
-        uint8_t     : 5;
+        uint8_t     m_Virtual : 1;
+        uint8_t     : 4;
         int8_t      m_Loopcounter; // if set to 3, there will be 3 loops effectively playing the sound 4 times.
+        uint8_t     m_Priority;
     };
 
     struct SoundGroup
@@ -179,11 +241,24 @@ namespace dmSound
         dmhash_t m_NameHash;
         Value    m_Gain;
         float*   m_MixBuffer;
+        uint32_t m_MaxVoices; // 0 for no limit
         float    m_SumSquaredMemory[SOUND_MAX_MIX_CHANNELS * GROUP_MEMORY_BUFFER_COUNT];
         float    m_PeakMemorySq[SOUND_MAX_MIX_CHANNELS * GROUP_MEMORY_BUFFER_COUNT];
         int      m_NextMemorySlot;
     };
 
+    // A read ahead of a streamed instance, see PrefetchInstances
+    struct PrefetchRead
+    {
+        dmSoundCodec::PrefetchRequest m_Request;
+        dmSoundCodec::HDecoder        m_Decoder;
+        // Offset of the read bytes in SoundSystem::m_PrefetchBuffer
+        uint32_t                      m_BufferOffset;
+        uint32_t                      m_Read;
+        uint16_t                      m_InstanceIndex;
+        bool                          m_Ok;
+    };
+
     struct SoundSystem
     {
         dmSoundCodec::HCodecContext   m_CodecContext;
@@ -191,6 +266,9 @@ namespace dmSound
         HDevice                       m_Device;
         dmThread::Thread              m_Thread;
         dmMutex::HMutex               m_Mutex;
+        // Keeps the data and read functions of the streamed sound data valid while the sound thread
+        // reads from them without m_Mutex. Always taken before m_Mutex
+        dmMutex::HMutex               m_StreamMutex;
 
         dmArray<SoundInstance>  m_Instances;
         dmIndexPool16           m_InstancesPool;
@@ -206,6 +284,29 @@ namespace dmSound
         uint32_t                m_FrameCount;
         uint32_t                m_PlayCounter;
 
+        ResampleQuality         m_ResampleQuality;
+        ResampleFilter          m_ResampleFilters[RESAMPLE_FILTER_CACHE_SIZE];
+        // Resampled frames of the instance being mixed, interleaved left and right
+        float*                  m_ResampleBuffer;
+        // Input frames of the instance being filtered, one channel after the other
+        float*                  m_ResampleInput;
+        uint32_t                m_ResampleInputCapacity;
+        // Capacity of SoundInstance::m_Frames
+        uint32_t                m_InstanceFrameCapacity;
+        uint32_t                m_MixCounter;
+
+        uint32_t                m_StreamBufferSize;
+        uint32_t                m_StreamPrefetchSize;
+        dmArray<PrefetchRead>   m_PrefetchReads;
+        dmArray<uint8_t>        m_PrefetchBuffer;
+
+        uint32_t                m_MaxVoices;
+        float                   m_VirtualGainThreshold;
+        // Indices of the playing instances, while picking the real voices
+        dmArray<uint16_t>       m_Voices;
+        uint32_t                m_RealVoiceCount;
+        uint32_t                m_VirtualVoiceCount;
+
         int16_t*                m_OutBuffers[SOUND_OUTBUFFER_COUNT];
         uint16_t                m_NextOutBuffer;
 
@@ -246,6 +347,11 @@ namespace dmSound
         params->m_BufferSize = 12 * 4096;
         params->m_FrameCount = 768;
         params->m_MaxInstances = 256;
+        params->m_ResampleQuality = RESAMPLE_QUALITY_MEDIUM;
+        params->m_StreamBufferSize = 32 * 1024;
+        params->m_StreamPrefetchSize = 16 * 1024;
+        params->m_MaxVoices = 0;
+        params->m_VirtualGainThreshold = 0.001f;
         params->m_UseThread = true;
     }
 
@@ -333,6 +439,11 @@ namespace dmSound
         uint32_t max_buffers = params->m_MaxBuffers;
         uint32_t max_sources = params->m_MaxSources;
         uint32_t max_instances = params->m_MaxInstances;
+        int32_t resample_quality = params->m_ResampleQuality;
+        uint32_t stream_buffer_size = params->m_StreamBufferSize;
+        uint32_t stream_prefetch_size = params->m_StreamPrefetchSize;
+        uint32_t max_voices = params->m_MaxVoices;
+        float virtual_gain_threshold = params->m_VirtualGainThreshold;
 
         if (config)
         {
@@ -341,20 +452,31 @@ namespace dmSound
             max_buffers = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_buffers", (int32_t) max_buffers);
             max_sources = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_sources", (int32_t) max_sources);
             max_instances = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_instances", (int32_t) max_instances);
+            resample_quality = dmConfigFile::GetInt(config, "sound.resample_quality", resample_quality);
+            stream_buffer_size = (uint32_t) dmConfigFile::GetInt(config, "sound.stream_buffer_size", (int32_t) stream_buffer_size);
+            stream_prefetch_size = (uint32_t) dmConfigFile::GetInt(config, "sound.stream_prefetch_size", (int32_t) stream_prefetch_size);
+            max_voices = (uint32_t) dmConfigFile::GetInt(config, "sound.max_voices", (int32_t) max_voices);
+            virtual_gain_threshold = dmConfigFile::GetFloat(config, "sound.virtual_gain_threshold", virtual_gain_threshold);
         }
 
+        // NOTE: +1 for "over-fetch" when up-sampling
+        // NOTE: and x SOUND_MAX_SPEED for potential pitch range (including the rate of the sound, see MixInstance)
+        // NOTE: and the look-ahead of the resample filter, and the zeros after the last frame of a sound
+        uint32_t instance_frame_capacity = params->m_FrameCount * SOUND_MAX_SPEED + 1 + 3 * RESAMPLE_FILTER_MAX_HALF_TAPS;
+
         sound->m_Instances.SetCapacity(max_instances);
         sound->m_Instances.SetSize(max_instances);
         sound->m_InstancesPool.SetCapacity(max_instances);
+        sound->m_Voices.SetCapacity(max_instances);
+        sound->m_PrefetchReads.SetCapacity(max_instances);
         for (uint32_t i = 0; i < max_instances; ++i)
         {
             SoundInstance* instance = &sound->m_Instances[i];
             memset(instance, 0, sizeof(*instance));
             instance->m_Index = 0xffff;
             instance->m_SoundDataIndex = 0xffff;
-            // NOTE: +1 for "over-fetch" when up-sampling
-            // NOTE: and x SOUND_MAX_SPEED for potential pitch range
-            instance->m_Frames = malloc((params->m_FrameCount * SOUND_MAX_SPEED + 1) * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS);
+            instance->m_FrameBuffer = malloc(RESAMPLE_HISTORY_SIZE + instance_frame_capacity * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS);
+            instance->m_Frames = (char*) instance->m_FrameBuffer + RESAMPLE_HISTORY_SIZE;
             instance->m_FrameCount = 0;
             instance->m_Speed = 1.0f;
         }
@@ -369,6 +491,21 @@ namespace dmSound
 
         sound->m_MixRate = device_info.m_MixRate;
         sound->m_FrameCount = params->m_FrameCount;
+        sound->m_InstanceFrameCapacity = instance_frame_capacity;
+
+        sound->m_ResampleQuality = (ResampleQuality) dmMath::Clamp(resample_quality, (int32_t) RESAMPLE_QUALITY_LOW, (int32_t) RESAMPLE_QUALITY_HIGH);
+        memset(sound->m_ResampleFilters, 0, sizeof(sound->m_ResampleFilters));
+        sound->m_ResampleBuffer = (float*) malloc(params->m_FrameCount * sizeof(float) * SOUND_MAX_MIX_CHANNELS);
+        // The filter also reads the history before the first frame
+        sound->m_ResampleInputCapacity = instance_frame_capacity + RESAMPLE_FILTER_MAX_HALF_TAPS;
+        sound->m_ResampleInput = (float*) malloc(sound->m_ResampleInputCapacity * sizeof(float) * SOUND_MAX_MIX_CHANNELS);
+        sound->m_MixCounter = 0;
+        sound->m_StreamBufferSize = dmMath::Max(stream_buffer_size, 4096u);
+        sound->m_StreamPrefetchSize = dmMath::Min(stream_prefetch_size, sound->m_StreamBufferSize);
+        sound->m_MaxVoices = max_voices;
+        sound->m_VirtualGainThreshold = virtual_gain_threshold;
+        sound->m_RealVoiceCount = 0;
+        sound->m_VirtualVoiceCount = 0;
         for (int i = 0; i < SOUND_OUTBUFFER_COUNT; ++i) {
             sound->m_OutBuffers[i] = (int16_t*) malloc(params->m_FrameCount * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS);
         }
@@ -389,9 +526,11 @@ namespace dmSound
 
         sound->m_Thread = 0;
         sound->m_Mutex = 0;
+        sound->m_StreamMutex = 0;
         if (params->m_UseThread)
         {
             sound->m_Mutex = dmMutex::New();
+            sound->m_StreamMutex = dmMutex::New();
             sound->m_Thread = dmThread::New((dmThread::ThreadStart)SoundThread, 0x80000, sound, "sound");
         }
 
@@ -409,6 +548,7 @@ namespace dmSound
         {
             dmThread::Join(sound->m_Thread);
             dmMutex::Delete(sound->m_Mutex);
+            dmMutex::Delete(sound->m_StreamMutex);
         }
 
         PlatformFinalize();
@@ -424,10 +564,16 @@ namespace dmSound
                 SoundInstance* instance = &sound->m_Instances[i];
                 instance->m_Index = 0xffff;
                 instance->m_SoundDataIndex = 0xffff;
-                free(instance->m_Frames);
+                free(instance->m_FrameBuffer);
                 memset(instance, 0, sizeof(*instance));
             }
 
+            for (uint32_t i = 0; i < RESAMPLE_FILTER_CACHE_SIZE; ++i) {
+                free(sound->m_ResampleFilters[i].m_Taps);
+            }
+            free(sound->m_ResampleBuffer);
+            free(sound->m_ResampleInput);
+
             for (int i = 0; i < SOUND_OUTBUFFER_COUNT; ++i) {
                 free((void*) sound->m_OutBuffers[i]);
             }
@@ -457,14 +603,64 @@ namespace dmSound
 
     static Result SetSoundDataNoLock(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
     {
-        free(sound_data->m_Data);
+        if (sound_data->m_OwnsData)
+            free(sound_data->m_Data);
         sound_data->m_Data = malloc(sound_buffer_size);
         sound_data->m_Size = sound_buffer_size;
+        sound_data->m_OwnsData = true;
+        sound_data->m_StreamSize = 0;
+        sound_data->m_StreamRead = 0;
+        sound_data->m_StreamContext = 0;
         memcpy(sound_data->m_Data, sound_buffer, sound_buffer_size);
         return RESULT_OK;
     }
 
-    Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    static Result SetSoundDataStreamingNoLock(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context)
+    {
+        if (sound_data->m_Type != SOUND_DATA_TYPE_OGG_VORBIS)
+            return RESULT_UNSUPPORTED;
+        if (read == 0 || sound_buffer_size > data_size)
+            return RESULT_INVALID_STREAM_DATA;
+
+        Result result = SetSoundDataNoLock(sound_data, sound_buffer, sound_buffer_size);
+        if (result != RESULT_OK)
+            return result;
+        sound_data->m_StreamSize = data_size;
+        sound_data->m_StreamRead = read;
+        sound_data->m_StreamContext = read_context;
+        return RESULT_OK;
+    }
+
+    // Serves the decoder of a streamed sound, from m_Data as far as it goes and from the read function after that
+    static dmSoundCodec::Result ReadStreamedSoundData(void* context, uint32_t offset, void* buffer, uint32_t size, uint32_t* nread)
+    {
+        SoundData* sound_data = (SoundData*) context;
+        uint32_t n = 0;
+        if (offset < (uint32_t) sound_data->m_Size)
+        {
+            n = dmMath::Min(size, (uint32_t) sound_data->m_Size - offset);
+            memcpy(buffer, (const uint8_t*) sound_data->m_Data + offset, n);
+        }
+
+        if (n < size && sound_data->m_StreamRead)
+        {
+            uint32_t nread_stream = 0;
+            Result r = sound_data->m_StreamRead(sound_data->m_StreamContext, offset + n, size - n, (uint8_t*) buffer + n, &nread_stream);
+            if (r != RESULT_OK)
+            {
+                dmLogError("Failed to read sound data '%s' (%d)", dmHashReverseSafe64(sound_data->m_NameHash), r);
+                return dmSoundCodec::RESULT_DECODE_ERROR;
+            }
+            n += nread_stream;
+        }
+
+        *nread = n;
+        return dmSoundCodec::RESULT_OK;
+    }
+
+    static void DeleteSoundDataNoLock(HSoundData sound_data);
+
+    static Result DoNewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name, bool copy)
     {
         SoundSystem* sound = g_SoundSystem;
 
@@ -484,38 +680,99 @@ namespace dmSound
         sd->m_Index = index;
         sd->m_Data = 0;
         sd->m_Size = 0;
+        sd->m_OwnsData = false;
+        sd->m_StreamSize = 0;
+        sd->m_StreamRead = 0;
+        sd->m_StreamContext = 0;
+
+        Result result = RESULT_OK;
+        if (copy)
+        {
+            result = SetSoundDataNoLock(sd, sound_buffer, sound_buffer_size);
+        }
+        else
+        {
+            sd->m_Data = (void*) sound_buffer;
+            sd->m_Size = sound_buffer_size;
+        }
 
-        Result result = SetSoundDataNoLock(sd, sound_buffer, sound_buffer_size);
         if (result == RESULT_OK)
             *sound_data = sd;
         else
-            DeleteSoundData(sd);
+            DeleteSoundDataNoLock(sd);
 
         return result;
     }
 
+    Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return DoNewSoundData(sound_buffer, sound_buffer_size, type, sound_data, name, true);
+    }
+
+    Result NewSoundDataNoCopy(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return DoNewSoundData(sound_buffer, sound_buffer_size, type, sound_data, name, false);
+    }
+
     Result SetSoundData(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
     {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_StreamMutex);
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
         return SetSoundDataNoLock(sound_data, sound_buffer, sound_buffer_size);
     }
 
-    uint32_t GetSoundResourceSize(HSoundData sound_data)
+    Result NewSoundDataStreaming(const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context, SoundDataType type, HSoundData* sound_data, dmhash_t name)
     {
-        return sound_data->m_Size + sizeof(SoundData);
+        Result result = DoNewSoundData(0, 0, type, sound_data, name, false);
+        if (result != RESULT_OK)
+            return result;
+
+        result = SetSoundDataStreaming(*sound_data, sound_buffer, sound_buffer_size, data_size, read, read_context);
+        if (result != RESULT_OK)
+        {
+            DeleteSoundData(*sound_data);
+            *sound_data = 0;
+        }
+        return result;
     }
 
-    Result DeleteSoundData(HSoundData sound_data)
+    Result SetSoundDataStreaming(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context)
     {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_StreamMutex);
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        return SetSoundDataStreamingNoLock(sound_data, sound_buffer, sound_buffer_size, data_size, read, read_context);
+    }
+
+    void* GetSoundDataReadContext(HSoundData sound_data)
+    {
+        return sound_data->m_StreamContext;
+    }
+
+    uint32_t GetSoundResourceSize(HSoundData sound_data)
+    {
+        return (sound_data->m_OwnsData ? sound_data->m_Size : 0) + sizeof(SoundData);
+    }
 
-        if (sound_data->m_Data != 0x0)
+    static void DeleteSoundDataNoLock(HSoundData sound_data)
+    {
+        if (sound_data->m_Data != 0x0 && sound_data->m_OwnsData)
             free((void*) sound_data->m_Data);
+        sound_data->m_Data = 0;
+        sound_data->m_Size = 0;
+        // Instances still streaming the sound stop at the end of what they have read
+        sound_data->m_StreamRead = 0;
+        sound_data->m_StreamContext = 0;
 
         SoundSystem* sound = g_SoundSystem;
         sound->m_SoundDataPool.Push(sound_data->m_Index);
         sound_data->m_Index = 0xffff;
+    }
 
+    Result DeleteSoundData(HSoundData sound_data)
+    {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_StreamMutex);
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        DeleteSoundDataNoLock(sound_data);
         return RESULT_OK;
     }
 
@@ -545,7 +802,21 @@ namespace dmSound
         {
             DM_MUTEX_OPTIONAL_SCOPED_LOCK(ss->m_Mutex);
 
-            dmSoundCodec::Result r = dmSoundCodec::NewDecoder(ss->m_CodecContext, codec_format, sound_data->m_Data, sound_data->m_Size, &decoder);
+            dmSoundCodec::Result r;
+            if (sound_data->m_StreamRead)
+            {
+                dmSoundCodec::StreamParams stream_params;
+                stream_params.m_Read = ReadStreamedSoundData;
+                stream_params.m_Context = sound_data;
+                stream_params.m_Size = sound_data->m_StreamSize;
+                stream_params.m_BufferSize = ss->m_StreamBufferSize;
+                stream_params.m_PrefetchSize = ss->m_StreamPrefetchSize;
+                r = dmSoundCodec::NewStreamDecoder(ss->m_CodecContext, codec_format, &stream_params, &decoder);
+            }
+            else
+            {
+                r = dmSoundCodec::NewDecoder(ss->m_CodecContext, codec_format, sound_data->m_Data, sound_data->m_Size, &decoder);
+            }
             if (r != dmSoundCodec::RESULT_OK) {
                 dmLogError("Failed to decode sound (%d)", r);
                 return RESULT_INVALID_STREAM_DATA;
@@ -564,8 +835,15 @@ namespace dmSound
         si->m_Looping = 0;
         si->m_EndOfStream = 0;
         si->m_Playing = 0;
+        si->m_Virtual = 0;
+        si->m_Priority = 0;
         si->m_Decoder = decoder;
         si->m_Group = MASTER_GROUP_HASH;
+        si->m_FrameFraction = 0;
+        si->m_Position = 0;
+        si->m_VirtualFrames = 0;
+        // The resample filter reads the frames before the first one
+        memset(si->m_FrameBuffer, 0, RESAMPLE_HISTORY_SIZE);
 
         *sound_instance = si;
 
@@ -688,6 +966,30 @@ namespace dmSound
         return RESULT_OK;
     }
 
+    Result SetGroupMaxVoices(dmhash_t group_hash, uint32_t max_voices)
+    {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        SoundSystem* sound = g_SoundSystem;
+        int* index = sound->m_GroupMap.Get(group_hash);
+        if (!index) {
+            return RESULT_NO_SUCH_GROUP;
+        }
+        sound->m_Groups[*index].m_MaxVoices = max_voices;
+        return RESULT_OK;
+    }
+
+    Result GetGroupMaxVoices(dmhash_t group_hash, uint32_t* max_voices)
+    {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        SoundSystem* sound = g_SoundSystem;
+        int* index = sound->m_GroupMap.Get(group_hash);
+        if (!index) {
+            return RESULT_NO_SUCH_GROUP;
+        }
+        *max_voices = sound->m_Groups[*index].m_MaxVoices;
+        return RESULT_OK;
+    }
+
     Result GetGroupRMS(dmhash_t group_hash, float window, float* rms_left, float* rms_right)
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
@@ -763,6 +1065,9 @@ namespace dmSound
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
         sound_instance->m_Playing = 0;
+        sound_instance->m_Virtual = 0;
+        sound_instance->m_Position = 0;
+        sound_instance->m_VirtualFrames = 0;
         dmSoundCodec::Reset(sound->m_CodecContext, sound_instance->m_Decoder);
     }
 
@@ -796,6 +1101,11 @@ namespace dmSound
         return sound_instance->m_Playing; // && !sound_instance->m_EndOfStream;
     }
 
+    bool IsVirtual(HSoundInstance sound_instance)
+    {
+        return sound_instance->m_Playing && sound_instance->m_Virtual;
+    }
+
     Result SetLooping(HSoundInstance sound_instance, bool looping, int8_t loopcounter)
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
@@ -804,6 +1114,13 @@ namespace dmSound
         return RESULT_OK;
     }
 
+    Result SetPriority(HSoundInstance sound_instance, uint8_t priority)
+    {
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        sound_instance->m_Priority = priority;
+        return RESULT_OK;
+    }
+
     Result SetParameter(HSoundInstance sound_instance, Parameter parameter, const Vector4& value)
     {
         bool reset = !sound_instance->m_Playing;
@@ -837,6 +1154,18 @@ namespace dmSound
         *right_scale = sinf(theta);
     }
 
+    /**
+     * Removes the first count frames of the instance. The frames before the new first frame
+     * are kept (RESAMPLE_HISTORY_SIZE bytes) for the taps of the resample filter.
+     */
+    static void ConsumeFrames(SoundInstance* instance, uint32_t count, uint32_t stride)
+    {
+        assert(instance->m_FrameCount >= count);
+        char* frames = (char*) instance->m_Frames;
+        memmove(frames - RESAMPLE_HISTORY_SIZE, frames + count * stride - RESAMPLE_HISTORY_SIZE, (instance->m_FrameCount - count) * stride + RESAMPLE_HISTORY_SIZE);
+        instance->m_FrameCount -= count;
+    }
+
     /*
      *
      * Template parameters
@@ -846,16 +1175,56 @@ namespace dmSound
      * scale: changes the scale of the samples when mixed by multiplying their values with the 'scale' template param.
      */
     template <typename T, int offset, int scale>
-    static void MixResampleUpMono(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
+    static inline void ConvertSamples(const T* samples, float* out, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            out[i] = ((float) samples[i] - offset) * scale;
+        }
+    }
+
+    template <>
+    inline void ConvertSamples<int16_t, 0, 1>(const int16_t* samples, float* out, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + dmSimd::WIDTH <= count; i += dmSimd::WIDTH)
+        {
+            dmSimd::StoreU(out + i, dmSimd::LoadInt16(samples + i));
+        }
+        for (; i < count; i++)
+        {
+            out[i] = samples[i];
+        }
+    }
+
+    template <typename T, int offset, int scale>
+    static inline void ConvertSamplesStereo(const T* samples, float* left, float* right, uint32_t count)
     {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            left[i] = ((float) samples[2 * i] - offset) * scale;
+            right[i] = ((float) samples[2 * i + 1] - offset) * scale;
+        }
+    }
+
+    /*
+     * Resamplers
+     *
+     * Read the frames of an instance at the mix rate, and write them as floats to out, interleaved left and right
+     * (mono sounds are written to both channels). The frames read are removed from the instance.
+     *
+     * delta: input frames per mixed frame, including the speed of the instance, in RESAMPLE_FRACTION_BITS fixed point.
+     */
+    template <typename T, int offset, int scale>
+    static void ResampleLinearMono(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
+    {
+        (void)filter;
         const uint32_t mask = (1U << RESAMPLE_FRACTION_BITS) - 1U;
         const float range_recip = 1.0f / mask; // TODO: Divide by (1 << RESAMPLE_FRACTION_BITS) OR (1 << RESAMPLE_FRACTION_BITS) - 1?
 
         uint64_t frac = instance->m_FrameFraction;
         uint32_t prev_index = 0;
         uint32_t index = 0;
-        uint64_t delta = (((uint64_t) rate) << RESAMPLE_FRACTION_BITS) / mix_rate;
-        delta *= instance->m_Speed;
 
         T* frames = (T*) instance->m_Frames;
 
@@ -863,24 +1232,15 @@ namespace dmSound
         // We never overfetch for identity mixing as identity mixing is a special case
         frames[instance->m_FrameCount] = frames[instance->m_FrameCount-1];
 
-        Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
-        Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        for (uint32_t i = 0; i < count; i++)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
             float mix = frac * range_recip; // determines the bias between two consecutive samples in the sound instance. It ranges from 0-1. A mix of 0, makes only the first sample count while a mix of 0.5 will count equally both samples.
-            T s1 = frames[index];
-            T s2 = frames[index + 1];
-            s1 = (s1 - offset) * scale;
-            s2 = (s2 - offset) * scale;
-
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
+            float s1 = ((float) frames[index] - offset) * scale;
+            float s2 = ((float) frames[index + 1] - offset) * scale;
 
             float s = (1.0f - mix) * s1 + mix * s2; // resulting destination sample value is a mix of two source samples since a kind of fractional indexing is used
-            mix_buffer[2 * i] += s * gain * left_scale;
-            mix_buffer[2 * i + 1] += s * gain * right_scale;
+            out[2 * i] = s;
+            out[2 * i + 1] = s;
 
             prev_index = index; // keep old index for assertion
             frac += delta;
@@ -893,23 +1253,20 @@ namespace dmSound
 
         assert(prev_index <= instance->m_FrameCount);
 
-        // copy any remaining frames not mixed to the start of m_Frames
-        assert( instance->m_FrameCount >= index);
-        memmove(instance->m_Frames, (char*) instance->m_Frames + index * sizeof(T), (instance->m_FrameCount - index) * sizeof(T));
-        instance->m_FrameCount -= index;
+        // remove the mixed frames, any remaining frames are moved to the start of m_Frames
+        ConsumeFrames(instance, index, sizeof(T));
     }
 
     template <typename T, int offset, int scale>
-    static void MixResampleUpStereo(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
+    static void ResampleLinearStereo(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
     {
+        (void)filter;
         const uint32_t mask = (1U << RESAMPLE_FRACTION_BITS) - 1U;
         const float range_recip = 1.0f / mask; // TODO: Divide by (1 << RESAMPLE_FRACTION_BITS) OR (1 << RESAMPLE_FRACTION_BITS) - 1?
 
         uint64_t frac = instance->m_FrameFraction;
         uint32_t prev_index = 0;
         uint32_t index = 0;
-        uint64_t delta = (((uint64_t) rate) << RESAMPLE_FRACTION_BITS) / mix_rate;
-        delta *= instance->m_Speed;
 
         T* frames = (T*) instance->m_Frames;
 
@@ -918,30 +1275,16 @@ namespace dmSound
         frames[2 * instance->m_FrameCount] = frames[2 * instance->m_FrameCount - 2];
         frames[2 * instance->m_FrameCount + 1] = frames[2 * instance->m_FrameCount - 1];
 
-        Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
-        Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        for (uint32_t i = 0; i < count; i++)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
             float mix = frac * range_recip;
-            T sl1 = frames[2 * index];
-            T sl2 = frames[2 * index + 2];
-            sl1 = (sl1 - offset) * scale;
-            sl2 = (sl2 - offset) * scale;
-
-            T sr1 = frames[2 * index + 1];
-            T sr2 = frames[2 * index + 3];
-            sr1 = (sr1 - offset) * scale;
-            sr2 = (sr2 - offset) * scale;
+            float sl1 = ((float) frames[2 * index] - offset) * scale;
+            float sl2 = ((float) frames[2 * index + 2] - offset) * scale;
+            float sr1 = ((float) frames[2 * index + 1] - offset) * scale;
+            float sr2 = ((float) frames[2 * index + 3] - offset) * scale;
 
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
-
-            float sl = (1.0f - mix) * sl1 + mix * sl2;
-            float sr = (1.0f - mix) * sr1 + mix * sr2;
-            mix_buffer[2 * i]       += sl * gain * left_scale;
-            mix_buffer[2 * i + 1]   += sr * gain * right_scale;
+            out[2 * i]     = (1.0f - mix) * sl1 + mix * sl2;
+            out[2 * i + 1] = (1.0f - mix) * sr1 + mix * sr2;
 
             prev_index = index;
             frac += delta;
@@ -953,63 +1296,128 @@ namespace dmSound
 
         assert(prev_index <= instance->m_FrameCount);
 
-        memmove(instance->m_Frames, (char*) instance->m_Frames + index * sizeof(T) * 2, (instance->m_FrameCount - index) * sizeof(T) * 2);
-        instance->m_FrameCount -= index;
+        ConsumeFrames(instance, index, sizeof(T) * 2);
     }
 
     template <typename T, int offset, int scale>
-    static void MixResampleIdentityMono(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
+    static void ResampleIdentityMono(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
     {
-        (void)rate;
-        (void)mix_rate;
-        assert(instance->m_FrameCount == mix_buffer_count);
-        T* frames = (T*) instance->m_Frames;
-        Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
-        Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
+        (void)filter;
+        (void)delta;
+        assert(instance->m_FrameCount == count);
+        const T* frames = (const T*) instance->m_Frames;
 
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        for (uint32_t i = 0; i < count; i++)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float s = frames[i];
-            s = (s - offset) * scale * gain;
+            float s = ((float) frames[i] - offset) * scale;
+            out[2 * i]     = s;
+            out[2 * i + 1] = s;
+        }
+        ConsumeFrames(instance, count, sizeof(T));
+    }
+
+    template <typename T, int offset, int scale>
+    static void ResampleIdentityStereo(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
+    {
+        (void)filter;
+        (void)delta;
+        assert(instance->m_FrameCount == count);
+        ConvertSamples<T, offset, scale>((const T*) instance->m_Frames, out, 2 * count);
+        ConsumeFrames(instance, count, sizeof(T) * 2);
+    }
 
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
-            mix_buffer[2 * i]       += s * left_scale;
-            mix_buffer[2 * i + 1]   += s * right_scale;
+    /*
+     * The filter taps for an output frame start at the input frame (filter->m_TapCount / 2 - 1) frames before it,
+     * so the resample filter reads the frames before m_Frames (see RESAMPLE_HISTORY_SIZE) and m_TapCount / 2 + 1
+     * frames after the last mixed frame (see Mix()).
+     */
+    static inline const float* GetFilterTaps(const ResampleFilter* filter, uint64_t frac, dmSimd::Vec4f* phase_mix)
+    {
+        const uint32_t shift = RESAMPLE_FRACTION_BITS - RESAMPLE_FILTER_PHASE_BITS;
+        const float phase_recip = 1.0f / (1U << shift);
+        uint32_t phase = (uint32_t) (frac >> shift);
+        *phase_mix = dmSimd::Splat((frac & ((1U << shift) - 1U)) * phase_recip);
+        return filter->m_Taps + phase * filter->m_TapCount;
+    }
+
+    static inline dmSimd::Vec4f GetFilterTap(const float* taps, uint32_t tap_count, dmSimd::Vec4f phase_mix, uint32_t i)
+    {
+        // Interpolate the taps between the two closest phases
+        dmSimd::Vec4f t0 = dmSimd::LoadU(taps + i);
+        dmSimd::Vec4f t1 = dmSimd::LoadU(taps + tap_count + i);
+        return dmSimd::MulAdd(dmSimd::Sub(t1, t0), phase_mix, t0);
+    }
+
+    template <typename T, int offset, int scale>
+    static void ResampleFilterMono(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
+    {
+        const uint32_t tap_count = filter->m_TapCount;
+        uint64_t frac = instance->m_FrameFraction;
+        uint32_t index = 0;
+
+        uint32_t input_count = (uint32_t) ((frac + (count - 1) * delta) >> RESAMPLE_FRACTION_BITS) + tap_count;
+        assert(input_count <= g_SoundSystem->m_ResampleInputCapacity);
+        float* input = g_SoundSystem->m_ResampleInput;
+        ConvertSamples<T, offset, scale>((const T*) instance->m_Frames - (tap_count / 2 - 1), input, input_count);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            dmSimd::Vec4f phase_mix;
+            const float* taps = GetFilterTaps(filter, frac, &phase_mix);
+            dmSimd::Vec4f s = dmSimd::Zero();
+            for (uint32_t j = 0; j < tap_count; j += dmSimd::WIDTH)
+            {
+                s = dmSimd::MulAdd(GetFilterTap(taps, tap_count, phase_mix, j), dmSimd::LoadU(input + index + j), s);
+            }
+            out[2 * i] = out[2 * i + 1] = dmSimd::Sum(s);
+
+            frac += delta;
+            index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
+            frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U);
         }
-        instance->m_FrameCount -= mix_buffer_count;
+        instance->m_FrameFraction = frac;
+
+        ConsumeFrames(instance, index, sizeof(T));
     }
 
     template <typename T, int offset, int scale>
-    static void MixResampleIdentityStereo(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
+    static void ResampleFilterStereo(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count)
     {
-        (void)rate;
-        (void)mix_rate;
-        assert(instance->m_FrameCount == mix_buffer_count);
-        T* frames = (T*) instance->m_Frames;
-        Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
-        Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
+        const uint32_t tap_count = filter->m_TapCount;
+        uint64_t frac = instance->m_FrameFraction;
+        uint32_t index = 0;
+
+        uint32_t input_count = (uint32_t) ((frac + (count - 1) * delta) >> RESAMPLE_FRACTION_BITS) + tap_count;
+        assert(input_count <= g_SoundSystem->m_ResampleInputCapacity);
+        float* left = g_SoundSystem->m_ResampleInput;
+        float* right = left + g_SoundSystem->m_ResampleInputCapacity;
+        ConvertSamplesStereo<T, offset, scale>((const T*) instance->m_Frames - 2 * (tap_count / 2 - 1), left, right, input_count);
 
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        for (uint32_t i = 0; i < count; i++)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float s1 = frames[2 * i];
-            float s2 = frames[2 * i + 1];
-            s1 = (s1 - offset) * scale * gain;
-            s2 = (s2 - offset) * scale * gain;
+            dmSimd::Vec4f phase_mix;
+            const float* taps = GetFilterTaps(filter, frac, &phase_mix);
+            dmSimd::Vec4f sl = dmSimd::Zero();
+            dmSimd::Vec4f sr = dmSimd::Zero();
+            for (uint32_t j = 0; j < tap_count; j += dmSimd::WIDTH)
+            {
+                dmSimd::Vec4f tap = GetFilterTap(taps, tap_count, phase_mix, j);
+                sl = dmSimd::MulAdd(tap, dmSimd::LoadU(left + index + j), sl);
+                sr = dmSimd::MulAdd(tap, dmSimd::LoadU(right + index + j), sr);
+            }
+            out[2 * i]     = dmSimd::Sum(sl);
+            out[2 * i + 1] = dmSimd::Sum(sr);
 
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
-            mix_buffer[2 * i]       += s1 * left_scale;
-            mix_buffer[2 * i + 1]   += s2 * right_scale;
+            frac += delta;
+            index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
+            frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U);
         }
-        instance->m_FrameCount -= mix_buffer_count;
+        instance->m_FrameFraction = frac;
+
+        ConsumeFrames(instance, index, sizeof(T) * 2);
     }
 
-    typedef void (*MixerFunction)(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count);
+    typedef void (*MixerFunction)(SoundInstance* instance, const ResampleFilter* filter, uint64_t delta, float* out, uint32_t count);
 
     struct Mixer
     {
@@ -1025,66 +1433,220 @@ namespace dmSound
     };
 
     Mixer g_Mixers[] = {
-            Mixer(1, 8, MixResampleUpMono<uint8_t, 128, 255>),
-            Mixer(1, 16, MixResampleUpMono<int16_t, 0, 1>),
-            Mixer(2, 8, MixResampleUpStereo<uint8_t, 128, 255>),
-            Mixer(2, 16, MixResampleUpStereo<int16_t, 0, 1>),
+            Mixer(1, 8, ResampleLinearMono<uint8_t, 128, 255>),
+            Mixer(1, 16, ResampleLinearMono<int16_t, 0, 1>),
+            Mixer(2, 8, ResampleLinearStereo<uint8_t, 128, 255>),
+            Mixer(2, 16, ResampleLinearStereo<int16_t, 0, 1>),
     };
 
     Mixer g_IdentityMixers[] = {
-            Mixer(1, 8, MixResampleIdentityMono<uint8_t, 128, 255>),
-            Mixer(1, 16, MixResampleIdentityMono<int16_t, 0, 1>),
-            Mixer(2, 8, MixResampleIdentityStereo<uint8_t, 128, 255>),
-            Mixer(2, 16, MixResampleIdentityStereo<int16_t, 0, 1>),
+            Mixer(1, 8, ResampleIdentityMono<uint8_t, 128, 255>),
+            Mixer(1, 16, ResampleIdentityMono<int16_t, 0, 1>),
+            Mixer(2, 8, ResampleIdentityStereo<uint8_t, 128, 255>),
+            Mixer(2, 16, ResampleIdentityStereo<int16_t, 0, 1>),
+    };
+
+    Mixer g_FilterMixers[] = {
+            Mixer(1, 8, ResampleFilterMono<uint8_t, 128, 255>),
+            Mixer(1, 16, ResampleFilterMono<int16_t, 0, 1>),
+            Mixer(2, 8, ResampleFilterStereo<uint8_t, 128, 255>),
+            Mixer(2, 16, ResampleFilterStereo<int16_t, 0, 1>),
     };
 
-    static void MixResample(const MixContext* mix_context, SoundInstance* instance, const dmSoundCodec::Info* info, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
+    static void BuildResampleFilter(ResampleFilter* filter, uint32_t key, uint32_t zero_crossings)
     {
-        const uint32_t rate = info->m_Rate;
-        assert(rate <= mix_rate);
+        const float step = key / (float) RESAMPLE_FILTER_STEP_SCALE;
+        const float cutoff = RESAMPLE_FILTER_CUTOFF / step;
+        // The filter is stretched by the step when down-sampling. Even number of taps on each side,
+        // so that the tap count is a multiple of the vector width
+        uint32_t half_taps = (uint32_t) ceilf(zero_crossings * step);
+        half_taps = dmMath::Min(RESAMPLE_FILTER_MAX_HALF_TAPS, (half_taps + 1) & ~1U);
+        const uint32_t tap_count = 2 * half_taps;
+
+        if (filter->m_Taps == 0)
+        {
+            filter->m_Taps = (float*) malloc((RESAMPLE_FILTER_PHASES + 1) * 2 * RESAMPLE_FILTER_MAX_HALF_TAPS * sizeof(float));
+        }
+        filter->m_Key = key;
+        filter->m_TapCount = tap_count;
 
-        void (*mixer)(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count) = 0;
+        for (uint32_t phase = 0; phase <= RESAMPLE_FILTER_PHASES; ++phase)
+        {
+            float* taps = filter->m_Taps + phase * tap_count;
+            float frac = phase / (float) RESAMPLE_FILTER_PHASES;
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < tap_count; ++i)
+            {
+                // Distance in input frames from the output frame
+                float x = (float) i - (float) (half_taps - 1) - frac;
+                float t = (float) M_PI * cutoff * x;
+                float sinc = t != 0.0f ? sinf(t) / t : 1.0f;
+                // Blackman window
+                float w = (float) M_PI * x / half_taps;
+                float window = 0.42f + 0.5f * cosf(w) + 0.08f * cosf(2.0f * w);
+                taps[i] = sinc * window;
+                sum += taps[i];
+            }
+            // Unity gain for constant signals
+            for (uint32_t i = 0; i < tap_count; ++i)
+            {
+                taps[i] /= sum;
+            }
+        }
+    }
 
-        bool identity_mixer = rate == mix_rate && instance->m_Speed == 1.0f;
+    /**
+     * Gets the resample filter for a step (input frames per mixed frame). The filters are cached
+     * since the same steps are used by most sounds, and the least recently used one is rebuilt.
+     */
+    static const ResampleFilter* GetResampleFilter(SoundSystem* sound, float step)
+    {
+        uint32_t key = dmMath::Max(RESAMPLE_FILTER_STEP_SCALE, (uint32_t) ceilf(step * RESAMPLE_FILTER_STEP_SCALE));
 
-        if (identity_mixer) {
-            uint32_t n = sizeof(g_IdentityMixers) / sizeof(g_IdentityMixers[0]);
-            for (uint32_t i = 0; i < n; i++) {
-                const Mixer& m = g_IdentityMixers[i];
-                if (m.m_BitsPerSample == info->m_BitsPerSample &&
-                    m.m_Channels == info->m_Channels) {
-                    mixer = m.m_Mixer;
-                    break;
-                }
+        ResampleFilter* filter = &sound->m_ResampleFilters[0];
+        for (uint32_t i = 0; i < RESAMPLE_FILTER_CACHE_SIZE; ++i)
+        {
+            ResampleFilter* f = &sound->m_ResampleFilters[i];
+            if (f->m_Key == key)
+            {
+                filter = f;
+                break;
             }
-        } else {
-            uint32_t n = sizeof(g_Mixers) / sizeof(g_Mixers[0]);
-            for (uint32_t i = 0; i < n; i++) {
-                const Mixer& m = g_Mixers[i];
-                if (m.m_BitsPerSample == info->m_BitsPerSample &&
-                    m.m_Channels == info->m_Channels) {
-                    mixer = m.m_Mixer;
-                    break;
-                }
+            if (f->m_LastUsed < filter->m_LastUsed)
+            {
+                filter = f;
             }
         }
-        mixer(mix_context, instance, rate, mix_rate, mix_buffer, mix_buffer_count);
+
+        if (filter->m_Key != key)
+        {
+            BuildResampleFilter(filter, key, RESAMPLE_FILTER_ZERO_CROSSINGS[sound->m_ResampleQuality]);
+        }
+        filter->m_LastUsed = sound->m_MixCounter;
+        return filter;
+    }
+
+    static bool UseResampleFilter(SoundSystem* sound, uint32_t rate, float speed)
+    {
+        switch (sound->m_ResampleQuality)
+        {
+            case RESAMPLE_QUALITY_HIGH:     return rate != sound->m_MixRate || speed != 1.0f;
+            case RESAMPLE_QUALITY_MEDIUM:   return rate > sound->m_MixRate;
+            default:                        return false;
+        }
     }
 
-    static void Mix(const MixContext* mix_context, SoundInstance* instance, const dmSoundCodec::Info* info)
+    /**
+     * Adds the resampled frames (interleaved left and right) to the mix buffer with the gain and pan of the instance
+     */
+    static void MixFrames(const MixContext* mix_context, SoundInstance* instance, const float* frames, float* mix_buffer, uint32_t mix_buffer_count)
+    {
+        Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
+        Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
+
+        if (pan_ramp.m_From != pan_ramp.m_To)
+        {
+            for (uint32_t i = 0; i < mix_buffer_count; i++)
+            {
+                float gain = gain_ramp.GetValue(i);
+                float left_scale, right_scale;
+                GetPanScale(pan_ramp.GetValue(i), &left_scale, &right_scale);
+                mix_buffer[2 * i]       += frames[2 * i] * (gain * left_scale);
+                mix_buffer[2 * i + 1]   += frames[2 * i + 1] * (gain * right_scale);
+            }
+            return;
+        }
+
+        // The pan is constant, so the pan scale is the same for all frames
+        float left_scale, right_scale;
+        GetPanScale(pan_ramp.m_From, &left_scale, &right_scale);
+        const float DM_ALIGNED(16) pan_scale[4] = { left_scale, right_scale, left_scale, right_scale };
+        dmSimd::Vec4f pan = dmSimd::Load(pan_scale);
+
+        // Two frames per vector
+        dmSimd::Vec4f index = dmSimd::Load(STEREO_FRAME_OFFSETS);
+        dmSimd::Vec4f index_step = dmSimd::Splat(2.0f);
+        uint32_t i = 0;
+        for (; i + 2 <= mix_buffer_count; i += 2)
+        {
+            dmSimd::Vec4f scale = dmSimd::Mul(GetRampValues(gain_ramp, index), pan);
+            dmSimd::StoreU(mix_buffer + 2 * i, dmSimd::MulAdd(dmSimd::LoadU(frames + 2 * i), scale, dmSimd::LoadU(mix_buffer + 2 * i)));
+            index = dmSimd::Add(index, index_step);
+        }
+        for (; i < mix_buffer_count; i++)
+        {
+            float gain = gain_ramp.GetValue(i);
+            mix_buffer[2 * i]       += frames[2 * i] * (gain * left_scale);
+            mix_buffer[2 * i + 1]   += frames[2 * i + 1] * (gain * right_scale);
+        }
+    }
+
+    static MixerFunction FindMixer(const Mixer* mixers, uint32_t mixer_count, const dmSoundCodec::Info* info)
+    {
+        for (uint32_t i = 0; i < mixer_count; i++) {
+            const Mixer& m = mixers[i];
+            if (m.m_BitsPerSample == info->m_BitsPerSample &&
+                m.m_Channels == info->m_Channels) {
+                return m.m_Mixer;
+            }
+        }
+        return 0;
+    }
+
+    static void MixResample(const MixContext* mix_context, SoundInstance* instance, const dmSoundCodec::Info* info, uint64_t delta, const ResampleFilter* filter, float* mix_buffer, uint32_t mix_buffer_count)
+    {
+        SoundSystem* sound = g_SoundSystem;
+
+        MixerFunction mixer = 0;
+
+        bool identity_mixer = info->m_Rate == sound->m_MixRate && instance->m_Speed == 1.0f;
+
+        if (identity_mixer) {
+            mixer = FindMixer(g_IdentityMixers, sizeof(g_IdentityMixers) / sizeof(g_IdentityMixers[0]), info);
+        } else if (filter) {
+            mixer = FindMixer(g_FilterMixers, sizeof(g_FilterMixers) / sizeof(g_FilterMixers[0]), info);
+        } else {
+            mixer = FindMixer(g_Mixers, sizeof(g_Mixers) / sizeof(g_Mixers[0]), info);
+        }
+
+        float* frames = sound->m_ResampleBuffer;
+        mixer(instance, filter, delta, frames, mix_buffer_count);
+        MixFrames(mix_context, instance, frames, mix_buffer, mix_buffer_count);
+    }
+
+    static void Mix(const MixContext* mix_context, SoundInstance* instance, const dmSoundCodec::Info* info, float speed, const ResampleFilter* filter)
     {
         DM_PROFILE(Sound, "Mix")
 
         SoundSystem* sound = g_SoundSystem;
-        uint64_t delta = (uint32_t) ((((uint64_t) info->m_Rate) << RESAMPLE_FRACTION_BITS) / sound->m_MixRate);
-        uint32_t mix_count = ((uint64_t) (instance->m_FrameCount) << RESAMPLE_FRACTION_BITS) / (delta * instance->m_Speed);
+        uint64_t delta = (((uint64_t) info->m_Rate) << RESAMPLE_FRACTION_BITS) / sound->m_MixRate;
+
+        uint32_t frame_count = instance->m_FrameCount;
+        if (filter) {
+            // The filter reads ahead of the mixed frames. Those frames are mixed in the next buffer,
+            // unless there are no more frames coming, in which case they are zeros.
+            const uint32_t stride = info->m_Channels * (info->m_BitsPerSample / 8);
+            const uint32_t lookahead = filter->m_TapCount / 2 + 1;
+            if (instance->m_EndOfStream || !instance->m_Playing) {
+                assert(frame_count + lookahead <= sound->m_InstanceFrameCapacity);
+                memset((char*) instance->m_Frames + frame_count * stride, 0, lookahead * stride);
+            } else {
+                frame_count = frame_count > lookahead ? frame_count - lookahead : 0;
+            }
+        }
+
+        uint32_t mix_count = ((uint64_t) (frame_count) << RESAMPLE_FRACTION_BITS) / (delta * speed);
         mix_count = dmMath::Min(mix_count, sound->m_FrameCount);
         assert(mix_count <= sound->m_FrameCount);
+        if (mix_count == 0)
+            return;
+
+        delta *= speed;
 
         int* index = sound->m_GroupMap.Get(instance->m_Group);
         if (index) {
             SoundGroup* group = &sound->m_Groups[*index];
-            MixResample(mix_context, instance, info, sound->m_MixRate, group->m_MixBuffer, mix_count);
+            MixResample(mix_context, instance, info, delta, filter, group->m_MixBuffer, mix_count);
         } else {
             dmLogError("Sound group not found");
         }
@@ -1120,6 +1682,16 @@ namespace dmSound
         return false;
     }
 
+    // Starts the next loop of a looping instance
+    static void LoopInstance(SoundSystem* sound, SoundInstance* instance)
+    {
+        dmSoundCodec::Reset(sound->m_CodecContext, instance->m_Decoder);
+        instance->m_Position = 0;
+        if ( instance->m_Loopcounter > 0 ) {
+            instance->m_Loopcounter --;
+        }
+    }
+
     static void MixInstance(const MixContext* mix_context, SoundInstance* instance) {
         SoundSystem* sound = g_SoundSystem;
         uint32_t decoded = 0;
@@ -1134,16 +1706,25 @@ namespace dmSound
             return;
         }
 
-        if (info.m_Rate > sound->m_MixRate) {
-            dmLogError("Sounds with rate higher than sample-rate not supported (%d hz > %d hz) (%s)", info.m_Rate, sound->m_MixRate, GetSoundName(sound, instance));
-            instance->m_Playing = 0;
-            return;
+        // Limit the speed of sounds with a rate above the mix rate, so that no more than
+        // SOUND_MAX_SPEED frames are used per mixed frame
+        const float rate_ratio = info.m_Rate / (float) sound->m_MixRate;
+        const float speed = dmMath::Min(instance->m_Speed, SOUND_MAX_SPEED / rate_ratio);
+
+        const ResampleFilter* filter = 0;
+        if (UseResampleFilter(sound, info.m_Rate, speed)) {
+            filter = GetResampleFilter(sound, rate_ratio * speed);
         }
 
         bool is_muted = dmSound::IsMuted(instance);
 
         dmSoundCodec::Result r = dmSoundCodec::RESULT_OK;
-        uint32_t mixed_instance_FrameCount = ceilf(sound->m_FrameCount * dmMath::Max(1.0f, instance->m_Speed));
+        uint32_t mixed_instance_FrameCount = ceilf(sound->m_FrameCount * dmMath::Max(1.0f, speed * dmMath::Max(1.0f, rate_ratio)));
+        if (filter) {
+            // The look-ahead of the filter, see Mix()
+            mixed_instance_FrameCount += filter->m_TapCount / 2 + 1;
+        }
+        assert(mixed_instance_FrameCount < sound->m_InstanceFrameCapacity);
 
         if (instance->m_FrameCount < mixed_instance_FrameCount && instance->m_Playing) {
 
@@ -1166,14 +1747,12 @@ namespace dmSound
 
             assert(decoded % stride == 0);
             instance->m_FrameCount += decoded / stride;
+            instance->m_Position += decoded / stride;
 
             if (instance->m_FrameCount < mixed_instance_FrameCount) {
 
                 if (instance->m_Looping && instance->m_Loopcounter != 0) {
-                    dmSoundCodec::Reset(sound->m_CodecContext, instance->m_Decoder);
-                    if ( instance->m_Loopcounter > 0 ) {
-                        instance->m_Loopcounter --;
-                    }
+                    LoopInstance(sound, instance);
 
                     uint32_t n = mixed_instance_FrameCount - instance->m_FrameCount;
                     if (!is_muted)
@@ -1192,6 +1771,7 @@ namespace dmSound
 
                     assert(decoded % stride == 0);
                     instance->m_FrameCount += decoded / stride;
+                    instance->m_Position += decoded / stride;
 
                 } else {
 
@@ -1212,7 +1792,7 @@ namespace dmSound
         }
 
         if (instance->m_FrameCount > 0)
-            Mix(mix_context, instance, &info);
+            Mix(mix_context, instance, &info, speed, filter);
 
         if (instance->m_FrameCount <= 1 && instance->m_EndOfStream) {
             // NOTE: Due to round-off errors, e.g 32000 -> 44100,
@@ -1222,6 +1802,232 @@ namespace dmSound
         }
     }
 
+    /*
+     * Virtual voices
+     *
+     * When more instances play than there are voices (see UpdateVoices()), the instances that don't
+     * get a voice aren't decoded or mixed. Only their play position advances, and the decoder catches
+     * up with it when the instance gets a voice again. If the length of the sound is known, a virtual
+     * voice loops and ends without touching the decoder at all.
+     */
+
+    // Skips frames in the decoder, looping if the instance loops
+    static dmSoundCodec::Result SkipFrames(SoundSystem* sound, SoundInstance* instance, uint32_t stride, uint32_t frames)
+    {
+        bool looped = false;
+        while (frames > 0)
+        {
+            uint32_t skipped = 0;
+            dmSoundCodec::Result r = dmSoundCodec::Skip(sound->m_CodecContext, instance->m_Decoder, frames * stride, &skipped);
+            if (r != dmSoundCodec::RESULT_OK) {
+                return r;
+            }
+            skipped = dmMath::Min(skipped / stride, frames);
+            instance->m_Position += skipped;
+            frames -= skipped;
+            if (skipped > 0) {
+                looped = false;
+                continue;
+            }
+
+            // A sound without frames would loop forever
+            if (looped || !instance->m_Looping || instance->m_Loopcounter == 0) {
+                instance->m_EndOfStream = 1;
+                break;
+            }
+            LoopInstance(sound, instance);
+            looped = true;
+        }
+        return dmSoundCodec::RESULT_OK;
+    }
+
+    static void SetVirtual(SoundSystem* sound, SoundInstance* instance, bool is_virtual)
+    {
+        if (instance->m_Virtual == is_virtual)
+            return;
+        instance->m_Virtual = is_virtual;
+        if (is_virtual)
+            return;
+
+        dmSoundCodec::Info info;
+        dmSoundCodec::GetInfo(sound->m_CodecContext, instance->m_Decoder, &info);
+        const uint32_t stride = info.m_Channels * (info.m_BitsPerSample / 8);
+        if (stride > 0 && instance->m_VirtualFrames > 0) {
+            dmSoundCodec::Result r = SkipFrames(sound, instance, stride, instance->m_VirtualFrames);
+            if (r != dmSoundCodec::RESULT_OK) {
+                dmLogWarning("Unable to decode file '%s'. Result %d", GetSoundName(sound, instance), r);
+                instance->m_Playing = 0;
+            }
+        }
+        instance->m_VirtualFrames = 0;
+        if (instance->m_FrameCount == 0) {
+            memset(instance->m_FrameBuffer, 0, RESAMPLE_HISTORY_SIZE);
+        }
+        // Fade in, like a new instance
+        instance->m_Gain.m_Prev = 0.0f;
+    }
+
+    // Advances the play position of a virtual voice by one mix buffer
+    static void MixVirtualInstance(SoundInstance* instance)
+    {
+        SoundSystem* sound = g_SoundSystem;
+
+        dmSoundCodec::Info info;
+        dmSoundCodec::GetInfo(sound->m_CodecContext, instance->m_Decoder, &info);
+        const uint32_t stride = info.m_Channels * (info.m_BitsPerSample / 8);
+        if (stride == 0) {
+            instance->m_Playing = 0;
+            return;
+        }
+
+        // Same rate and speed as MixInstance()
+        const float rate_ratio = info.m_Rate / (float) sound->m_MixRate;
+        const float speed = dmMath::Min(instance->m_Speed, SOUND_MAX_SPEED / rate_ratio);
+        uint64_t delta = (((uint64_t) info.m_Rate) << RESAMPLE_FRACTION_BITS) / sound->m_MixRate;
+        delta *= speed;
+
+        uint64_t frac = instance->m_FrameFraction + delta * sound->m_FrameCount;
+        uint32_t frames = (uint32_t) (frac >> RESAMPLE_FRACTION_BITS);
+        instance->m_FrameFraction = frac & ((1U << RESAMPLE_FRACTION_BITS) - 1U);
+
+        // The frames that are already decoded are played first
+        uint32_t buffered = dmMath::Min(frames, instance->m_FrameCount);
+        if (buffered > 0) {
+            ConsumeFrames(instance, buffered, stride);
+            frames -= buffered;
+        }
+
+        if (!instance->m_Playing || instance->m_EndOfStream) {
+            return;
+        }
+        instance->m_VirtualFrames += frames;
+
+        const uint32_t length = info.m_Size / stride;
+        if (length == 0) {
+            // Unknown length (e.g. a streamed sound), keep the decoder in sync
+            dmSoundCodec::Result r = SkipFrames(sound, instance, stride, instance->m_VirtualFrames);
+            instance->m_VirtualFrames = 0;
+            if (r != dmSoundCodec::RESULT_OK) {
+                dmLogWarning("Unable to decode file '%s'. Result %d", GetSoundName(sound, instance), r);
+                instance->m_Playing = 0;
+            }
+            return;
+        }
+
+        while (instance->m_Position + instance->m_VirtualFrames >= length)
+        {
+            if (!instance->m_Looping || instance->m_Loopcounter == 0) {
+                instance->m_VirtualFrames = 0;
+                instance->m_EndOfStream = 1;
+                break;
+            }
+            instance->m_VirtualFrames -= length - dmMath::Min(instance->m_Position, length);
+            LoopInstance(sound, instance);
+            if (instance->m_Loopcounter < 0) {
+                instance->m_VirtualFrames %= length;
+            }
+        }
+    }
+
+    static float GetAudibility(SoundSystem* sound, SoundInstance* instance, float master_gain)
+    {
+        if (instance->m_Speed == 0.0f) {
+            return 0.0f;
+        }
+        const Value& gain = instance->m_Gain;
+        float audibility = dmMath::Max(gain.m_Prev, dmMath::Max(gain.m_Current, gain.m_Next));
+
+        int* group_index = sound->m_GroupMap.Get(instance->m_Group);
+        if (group_index != NULL) {
+            SoundGroup* group = &sound->m_Groups[*group_index];
+            const Value& group_gain = group->m_Gain;
+            audibility *= dmMath::Max(group_gain.m_Prev, dmMath::Max(group_gain.m_Current, group_gain.m_Next));
+            if (group->m_NameHash == MASTER_GROUP_HASH) {
+                return audibility;
+            }
+        }
+        return audibility * master_gain;
+    }
+
+    struct VoiceSorter
+    {
+        VoiceSorter(SoundSystem* sound) : m_Sound(sound) {}
+        bool operator()(uint16_t a, uint16_t b) const
+        {
+            const SoundInstance* ia = &m_Sound->m_Instances[a];
+            const SoundInstance* ib = &m_Sound->m_Instances[b];
+            if (ia->m_Priority != ib->m_Priority) {
+                return ia->m_Priority > ib->m_Priority;
+            }
+            float sa = ia->m_Audibility * (ia->m_Virtual ? 1.0f : REAL_VOICE_BIAS);
+            float sb = ib->m_Audibility * (ib->m_Virtual ? 1.0f : REAL_VOICE_BIAS);
+            return sa > sb;
+        }
+        SoundSystem* m_Sound;
+    };
+
+    /**
+     * Picks the playing instances that are decoded and mixed (the real voices), by priority and then gain,
+     * within the voice limits of the system and the groups. The rest play as virtual voices, as do the
+     * instances that can't be heard.
+     */
+    static void UpdateVoices(SoundSystem* sound)
+    {
+        DM_PROFILE(Sound, "Voices")
+
+        float master_gain = 1.0f;
+        int* master_index = sound->m_GroupMap.Get(MASTER_GROUP_HASH);
+        if (master_index != NULL) {
+            const Value& gain = sound->m_Groups[*master_index].m_Gain;
+            master_gain = dmMath::Max(gain.m_Prev, dmMath::Max(gain.m_Current, gain.m_Next));
+        }
+
+        uint32_t playing = 0;
+        sound->m_Voices.SetSize(0);
+        uint32_t instances = sound->m_Instances.Size();
+        for (uint32_t i = 0; i < instances; ++i) {
+            SoundInstance* instance = &sound->m_Instances[i];
+            if (instance->m_Index == 0xffff || !instance->m_Playing)
+                continue;
+            ++playing;
+
+            instance->m_Audibility = GetAudibility(sound, instance, master_gain);
+            if (instance->m_Audibility <= sound->m_VirtualGainThreshold) {
+                SetVirtual(sound, instance, true);
+                continue;
+            }
+            sound->m_Voices.Push((uint16_t) i);
+        }
+
+        std::sort(sound->m_Voices.Begin(), sound->m_Voices.End(), VoiceSorter(sound));
+
+        uint32_t group_voices[MAX_GROUPS];
+        memset(group_voices, 0, sizeof(group_voices));
+        uint32_t real = 0;
+        uint32_t voices = sound->m_Voices.Size();
+        for (uint32_t i = 0; i < voices; ++i) {
+            SoundInstance* instance = &sound->m_Instances[sound->m_Voices[i]];
+
+            bool is_real = sound->m_MaxVoices == 0 || real < sound->m_MaxVoices;
+            int* group_index = sound->m_GroupMap.Get(instance->m_Group);
+            if (is_real && group_index != NULL) {
+                uint32_t max_group_voices = sound->m_Groups[*group_index].m_MaxVoices;
+                is_real = max_group_voices == 0 || group_voices[*group_index] < max_group_voices;
+            }
+
+            if (is_real) {
+                ++real;
+                if (group_index != NULL) {
+                    group_voices[*group_index]++;
+                }
+            }
+            SetVirtual(sound, instance, !is_real);
+        }
+
+        sound->m_RealVoiceCount = real;
+        sound->m_VirtualVoiceCount = playing - real;
+    }
+
     static void MixInstances(const MixContext* mix_context) {
         DM_PROFILE(Sound, "MixInstances")
         SoundSystem* sound = g_SoundSystem;
@@ -1231,14 +2037,29 @@ namespace dmSound
 
             if (g->m_MixBuffer) {
                 uint32_t frame_count = sound->m_FrameCount;
-                float sum_sq_left = 0;
-                float sum_sq_right = 0;
-                float max_sq_left = 0;
-                float max_sq_right = 0;
-                for (uint32_t j = 0; j < frame_count; j++) {
-
-                    float gain = g->m_Gain.m_Current;
-
+                float gain = g->m_Gain.m_Current;
+
+                // Two frames per vector, i.e. left, right, left, right
+                dmSimd::Vec4f gain4 = dmSimd::Splat(gain);
+                dmSimd::Vec4f sum_sq = dmSimd::Zero();
+                dmSimd::Vec4f max_sq = dmSimd::Zero();
+                uint32_t j = 0;
+                for (; j + 2 <= frame_count; j += 2) {
+                    dmSimd::Vec4f s = dmSimd::Mul(dmSimd::LoadU(g->m_MixBuffer + 2 * j), gain4);
+                    dmSimd::Vec4f s_sq = dmSimd::Mul(s, s);
+                    sum_sq = dmSimd::Add(sum_sq, s_sq);
+                    max_sq = dmSimd::Max(max_sq, s_sq);
+                }
+                float DM_ALIGNED(16) sum_sq_lanes[4];
+                float DM_ALIGNED(16) max_sq_lanes[4];
+                dmSimd::Store(sum_sq_lanes, sum_sq);
+                dmSimd::Store(max_sq_lanes, max_sq);
+
+                float sum_sq_left = sum_sq_lanes[0] + sum_sq_lanes[2];
+                float sum_sq_right = sum_sq_lanes[1] + sum_sq_lanes[3];
+                float max_sq_left = dmMath::Max(max_sq_lanes[0], max_sq_lanes[2]);
+                float max_sq_right = dmMath::Max(max_sq_lanes[1], max_sq_lanes[3]);
+                for (; j < frame_count; j++) {
                     float left = g->m_MixBuffer[2 * j + 0] * gain;
                     float right = g->m_MixBuffer[2 * j + 1] * gain;
                     float left_sq = left * left;
@@ -1263,7 +2084,10 @@ namespace dmSound
             SoundInstance* instance = &sound->m_Instances[i];
             if (instance->m_Playing || instance->m_FrameCount > 0)
             {
-                MixInstance(mix_context, instance);
+                if (instance->m_Virtual)
+                    MixVirtualInstance(instance);
+                else
+                    MixInstance(mix_context, instance);
             }
 
             if (instance->m_EndOfStream && instance->m_FrameCount == 0) {
@@ -1303,19 +2127,47 @@ namespace dmSound
                 continue;
             }
             Ramp ramp = GetRamp(mix_context, &g->m_Gain, n);
-            for (uint32_t i = 0; i < n; i++) {
-                float gain = ramp.GetValue(i);
+
+            // Two frames per vector
+            dmSimd::Vec4f index = dmSimd::Load(STEREO_FRAME_OFFSETS);
+            dmSimd::Vec4f index_step = dmSimd::Splat(2.0f);
+            dmSimd::Vec4f zero = dmSimd::Zero();
+            dmSimd::Vec4f one = dmSimd::Splat(1.0f);
+            uint32_t j = 0;
+            for (; j + 2 <= n; j += 2) {
+                dmSimd::Vec4f gain = dmSimd::Clamp(GetRampValues(ramp, index), zero, one);
+                dmSimd::StoreU(mix_buffer + 2 * j, dmSimd::MulAdd(dmSimd::LoadU(g->m_MixBuffer + 2 * j), gain, dmSimd::LoadU(mix_buffer + 2 * j)));
+                index = dmSimd::Add(index, index_step);
+            }
+            for (; j < n; j++) {
+                float gain = ramp.GetValue(j);
                 gain = dmMath::Clamp(gain, 0.0f, 1.0f);
 
-                float s1 = g->m_MixBuffer[2 * i];
-                float s2 = g->m_MixBuffer[2 * i + 1];
-                mix_buffer[2 * i] += s1 * gain;
-                mix_buffer[2 * i + 1] += s2 * gain;
+                float s1 = g->m_MixBuffer[2 * j];
+                float s2 = g->m_MixBuffer[2 * j + 1];
+                mix_buffer[2 * j] += s1 * gain;
+                mix_buffer[2 * j + 1] += s2 * gain;
             }
         }
 
         Ramp ramp = GetRamp(mix_context, &master->m_Gain, n);
-        for (uint32_t i = 0; i < n; i++) {
+
+        dmSimd::Vec4f index = dmSimd::Load(STEREO_FRAME_OFFSETS);
+        dmSimd::Vec4f index_step = dmSimd::Splat(2.0f);
+        dmSimd::Vec4f out_min = dmSimd::Splat(-32768.0f);
+        dmSimd::Vec4f out_max = dmSimd::Splat(32767.0f);
+        uint32_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            dmSimd::Vec4f s = dmSimd::Mul(dmSimd::LoadU(mix_buffer + 2 * i), GetRampValues(ramp, index));
+            int32_t DM_ALIGNED(16) samples[4];
+            dmSimd::StoreInt(samples, dmSimd::Clamp(s, out_min, out_max));
+            out[2 * i]     = (int16_t) samples[0];
+            out[2 * i + 1] = (int16_t) samples[1];
+            out[2 * i + 2] = (int16_t) samples[2];
+            out[2 * i + 3] = (int16_t) samples[3];
+            index = dmSimd::Add(index, index_step);
+        }
+        for (; i < n; i++) {
             float gain = ramp.GetValue(i);
             float s1 = mix_buffer[2 * i] * gain;
             float s2 = mix_buffer[2 * i + 1] * gain;
@@ -1354,11 +2206,76 @@ namespace dmSound
         }
     }
 
+    // Reads ahead for the streamed instances, after the mix, so that the next mix has the data it needs.
+    // The reads are done without m_Mutex, so that the rest of the sound system isn't blocked by the file I/O
+    static void PrefetchInstances(SoundSystem* sound)
+    {
+        DM_PROFILE(Sound, "Prefetch")
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(sound->m_StreamMutex);
+
+        dmArray<PrefetchRead>& reads = sound->m_PrefetchReads;
+        reads.SetSize(0);
+        uint32_t buffer_size = 0;
+        {
+            DM_MUTEX_OPTIONAL_SCOPED_LOCK(sound->m_Mutex);
+            uint32_t instances = sound->m_Instances.Size();
+            for (uint32_t i = 0; i < instances; ++i) {
+                SoundInstance* instance = &sound->m_Instances[i];
+                if (instance->m_Index == 0xffff || !instance->m_Playing || instance->m_EndOfStream)
+                    continue;
+
+                PrefetchRead read;
+                if (!dmSoundCodec::GetPrefetchRequest(sound->m_CodecContext, instance->m_Decoder, &read.m_Request))
+                    continue;
+                read.m_Decoder = instance->m_Decoder;
+                read.m_InstanceIndex = instance->m_Index;
+                read.m_BufferOffset = buffer_size;
+                read.m_Read = 0;
+                read.m_Ok = false;
+                reads.Push(read);
+                buffer_size += read.m_Request.m_Size;
+            }
+        }
+
+        if (reads.Empty())
+            return;
+
+        if (sound->m_PrefetchBuffer.Capacity() < buffer_size)
+            sound->m_PrefetchBuffer.SetCapacity(buffer_size);
+        sound->m_PrefetchBuffer.SetSize(buffer_size);
+
+        // The stream mutex keeps the sound data from being changed or deleted during the reads
+        for (uint32_t i = 0; i < reads.Size(); ++i) {
+            PrefetchRead& read = reads[i];
+            const dmSoundCodec::PrefetchRequest& request = read.m_Request;
+            dmSoundCodec::Result r = request.m_Read(request.m_Context, request.m_Offset, &sound->m_PrefetchBuffer[read.m_BufferOffset], request.m_Size, &read.m_Read);
+            read.m_Ok = r == dmSoundCodec::RESULT_OK;
+        }
+
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(sound->m_Mutex);
+        for (uint32_t i = 0; i < reads.Size(); ++i) {
+            const PrefetchRead& read = reads[i];
+            // A read error is reported by the next decode, which reads again and stops the instance
+            if (!read.m_Ok)
+                continue;
+            // The instance may have been deleted, or reused, during the read
+            SoundInstance* instance = &sound->m_Instances[read.m_InstanceIndex];
+            if (instance->m_Index != read.m_InstanceIndex || instance->m_Decoder != read.m_Decoder)
+                continue;
+            dmSoundCodec::CompletePrefetch(sound->m_CodecContext, read.m_Decoder, &read.m_Request, &sound->m_PrefetchBuffer[read.m_BufferOffset], read.m_Read);
+        }
+    }
+
     static Result UpdateInternal(SoundSystem* sound)
     {
         DM_PROFILE(Sound, "Update")
 
         uint16_t active_instance_count = sound->m_InstancesPool.Size();
+        if (active_instance_count == 0)
+        {
+            sound->m_RealVoiceCount = 0;
+            sound->m_VirtualVoiceCount = 0;
+        }
 
         bool currentIsPhoneCallActive = IsPhoneCallActive();
         if (!sound->m_IsPhoneCallActive && currentIsPhoneCallActive)
@@ -1417,32 +2334,38 @@ namespace dmSound
             sound->m_IsDeviceStarted = true;
         }
 
-        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        {
+            DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
 
-        uint32_t free_slots = sound->m_DeviceType->m_FreeBufferSlots(sound->m_Device);
-        if (free_slots > 0) {
-            StepGroupValues();
-            StepInstanceValues();
-        }
+            uint32_t free_slots = sound->m_DeviceType->m_FreeBufferSlots(sound->m_Device);
+            if (free_slots > 0) {
+                StepGroupValues();
+                StepInstanceValues();
+                UpdateVoices(sound);
+            }
 
-        uint32_t current_buffer = 0;
-        uint32_t total_buffers = free_slots;
-        while (free_slots > 0) {
-            MixContext mix_context(current_buffer, total_buffers);
-            MixInstances(&mix_context);
+            uint32_t current_buffer = 0;
+            uint32_t total_buffers = free_slots;
+            while (free_slots > 0) {
+                MixContext mix_context(current_buffer, total_buffers);
+                sound->m_MixCounter++;
+                MixInstances(&mix_context);
 
-            Master(&mix_context);
+                Master(&mix_context);
 
-            // DEF-2540: Make sure to keep feeding the sound device if audio is being generated,
-            // if you don't you'll get more slots free, thus updating sound (redundantly) every call,
-            // resulting in a huge performance hit. Also, you'll fast forward the sounds.
-            sound->m_DeviceType->m_Queue(sound->m_Device, (const int16_t*) sound->m_OutBuffers[sound->m_NextOutBuffer], sound->m_FrameCount);
+                // DEF-2540: Make sure to keep feeding the sound device if audio is being generated,
+                // if you don't you'll get more slots free, thus updating sound (redundantly) every call,
+                // resulting in a huge performance hit. Also, you'll fast forward the sounds.
+                sound->m_DeviceType->m_Queue(sound->m_Device, (const int16_t*) sound->m_OutBuffers[sound->m_NextOutBuffer], sound->m_FrameCount);
 
-            sound->m_NextOutBuffer = (sound->m_NextOutBuffer + 1) % SOUND_OUTBUFFER_COUNT;
-            current_buffer++;
-            free_slots--;
+                sound->m_NextOutBuffer = (sound->m_NextOutBuffer + 1) % SOUND_OUTBUFFER_COUNT;
+                current_buffer++;
+                free_slots--;
+            }
         }
 
+        PrefetchInstances(sound);
+
         return RESULT_OK;
     }
 
@@ -1464,6 +2387,9 @@ namespace dmSound
         if (!sound)
             return RESULT_OK;
 
+        DM_COUNTER("Sound.RealVoices", sound->m_RealVoiceCount);
+        DM_COUNTER("Sound.VirtualVoices", sound->m_VirtualVoiceCount);
+
         if (!sound->m_Thread)
             return UpdateInternal(sound);
         return sound->m_Status;
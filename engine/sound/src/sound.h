@@ -16,7 +16,7 @@
 #include <dlib/configfile.h>
 #include <dlib/hash.h>
 
-#include <dmsdk/vectormath/cpp/vectormath_aos.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmSound
 {
@@ -37,6 +37,18 @@ namespace dmSound
         PARAMETER_MAX   = 3
     };
 
+    /**
+     * Quality of the resampling of sounds that don't play at the mix rate.
+     * The band limited filter removes the aliasing that linear interpolation
+     * gives when a sound is played back at a lower rate than it was recorded in.
+     */
+    enum ResampleQuality
+    {
+        RESAMPLE_QUALITY_LOW    = 0, //!< Linear interpolation only
+        RESAMPLE_QUALITY_MEDIUM = 1, //!< Band limited filter for sounds with a rate above the mix rate, linear interpolation otherwise
+        RESAMPLE_QUALITY_HIGH   = 2, //!< Band limited filter (with more taps) for all resampling
+    };
+
     enum Result
     {
         RESULT_OK                 =  0,    //!< RESULT_OK
@@ -65,9 +77,6 @@ namespace dmSound
 
     const uint32_t MAX_GROUPS = 32;
 
-    // TODO:
-    // - Music streaming.
-
     struct InitializeParams;
     void SetDefaultInitializeParams(InitializeParams* params);
 
@@ -81,6 +90,15 @@ namespace dmSound
         uint32_t m_BufferSize;
         uint32_t m_FrameCount;
         uint32_t m_MaxInstances;
+        ResampleQuality m_ResampleQuality;
+        // Size of the read buffer of each streamed sound instance
+        uint32_t m_StreamBufferSize;
+        // Number of bytes to keep buffered ahead of the decoder of a streamed sound instance
+        uint32_t m_StreamPrefetchSize;
+        // Maximum number of instances that are decoded and mixed, 0 for no limit. The rest play as virtual voices
+        uint32_t m_MaxVoices;
+        // Instances with a gain (including the group gain) at or below this play as virtual voices
+        float    m_VirtualGainThreshold;
         bool     m_UseThread;
 
         InitializeParams()
@@ -100,7 +118,20 @@ namespace dmSound
 
     // Thread safe
     Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name);
+    // Like NewSoundData, but references the buffer instead of copying it. The buffer must be valid until the sound data is deleted or set
+    Result NewSoundDataNoCopy(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name);
     Result SetSoundData(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size);
+
+    // Reads size bytes of the sound data at offset. Called from the sound thread, with the sound system locked
+    typedef Result (*FSoundDataRead)(void* context, uint32_t offset, uint32_t size, void* buffer, uint32_t* nread);
+    // Like NewSoundData, but only the first sound_buffer_size bytes of the data_size bytes of data are in memory.
+    // The instances of the sound read the rest with the read function while they play.
+    // Returns RESULT_UNSUPPORTED if the type (only SOUND_DATA_TYPE_OGG_VORBIS can be streamed) or the sound system can't stream
+    Result NewSoundDataStreaming(const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context, SoundDataType type, HSoundData* sound_data, dmhash_t name);
+    Result SetSoundDataStreaming(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context);
+    // The read context of a streamed sound data, 0 otherwise
+    void* GetSoundDataReadContext(HSoundData sound_data);
+
     uint32_t GetSoundResourceSize(HSoundData sound_data);
     Result DeleteSoundData(HSoundData sound_data);
 
@@ -114,6 +145,9 @@ namespace dmSound
     Result SetGroupGain(dmhash_t group_hash, float gain);
     Result GetGroupGain(dmhash_t group_hash, float* gain);
     Result GetGroupHashes(uint32_t* count, dmhash_t* buffer);
+    // Maximum number of instances in the group that are decoded and mixed, 0 for no limit
+    Result SetGroupMaxVoices(dmhash_t group_hash, uint32_t max_voices);
+    Result GetGroupMaxVoices(dmhash_t group_hash, uint32_t* max_voices);
 
     Result GetGroupRMS(dmhash_t group_hash, float window, float* rms_left, float* rms_right);
     Result GetGroupPeak(dmhash_t group_hash, float window, float* peak_left, float* peak_right);
@@ -122,9 +156,13 @@ namespace dmSound
     Result Stop(HSoundInstance sound_instance);
     Result Pause(HSoundInstance sound_instance, bool pause);
     bool IsPlaying(HSoundInstance sound_instance);
+    // True if the instance is playing as a virtual voice, i.e. it isn't decoded or mixed and only its play position advances
+    bool IsVirtual(HSoundInstance sound_instance);
     uint32_t GetAndIncreasePlayCounter();
 
     Result SetLooping(HSoundInstance sound_instance, bool looping, int8_t loopcount);
+    // Instances with a higher priority are mixed before the others when there are more instances playing than voices. Default 0
+    Result SetPriority(HSoundInstance sound_instance, uint8_t priority);
 
     Result SetParameter(HSoundInstance sound_instance, Parameter parameter, const Vectormath::Aos::Vector4& value);
     Result GetParameter(HSoundInstance sound_instance, Parameter parameter, Vectormath::Aos::Vector4& value);
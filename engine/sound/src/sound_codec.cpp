@@ -11,6 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <dlib/array.h>
 #include <dlib/index_pool.h>
 #include <dlib/endian.h>
@@ -28,6 +29,8 @@ namespace dmSoundCodec
         int m_Index;
         HDecodeStream m_Stream;
         const DecoderInfo* m_DecoderInfo;
+        // Set for streamed decoders
+        StreamBuffer* m_StreamBuffer;
 
         void Clear()
         {
@@ -77,6 +80,7 @@ namespace dmSoundCodec
         Decoder* d = &context->m_Decoders[index];
         d->m_Index = index;
         d->m_DecoderInfo = decoderImpl;
+        d->m_StreamBuffer = 0;
 
         Result r = decoderImpl->m_OpenStream(buffer, buffer_size, &d->m_Stream);
         if (r != RESULT_OK) {
@@ -88,6 +92,67 @@ namespace dmSoundCodec
         return RESULT_OK;
     }
 
+    Result NewStreamDecoder(HCodecContext context, Format format, const StreamParams* params, HDecoder* decoder)
+    {
+        if (context->m_DecodersPool.Remaining() == 0) {
+            return RESULT_OUT_OF_RESOURCES;
+        }
+
+        const DecoderInfo* decoderImpl = FindBestDecoder(format);
+        if (!decoderImpl || !decoderImpl->m_OpenStreamBuffer) {
+            return RESULT_UNSUPPORTED;
+        }
+
+        StreamBuffer* input = new StreamBuffer;
+        memset(input, 0, sizeof(*input));
+        input->m_Read = params->m_Read;
+        input->m_Context = params->m_Context;
+        input->m_Size = params->m_Size;
+        input->m_Capacity = params->m_BufferSize;
+        input->m_Data = (uint8_t*) malloc(params->m_BufferSize);
+        input->m_PrefetchSize = dmMath::Min(params->m_PrefetchSize, params->m_BufferSize);
+
+        uint16_t index = context->m_DecodersPool.Pop();
+        Decoder* d = &context->m_Decoders[index];
+        d->m_Index = index;
+        d->m_DecoderInfo = decoderImpl;
+        d->m_StreamBuffer = input;
+
+        Result r = decoderImpl->m_OpenStreamBuffer(input, &d->m_Stream);
+        if (r != RESULT_OK) {
+            context->m_DecodersPool.Push(index);
+            d->Clear();
+            free(input->m_Data);
+            delete input;
+            return r;
+        }
+
+        *decoder = d;
+        return RESULT_OK;
+    }
+
+    bool GetPrefetchRequest(HCodecContext context, HDecoder decoder, PrefetchRequest* request)
+    {
+        assert(decoder);
+        StreamBuffer* input = decoder->m_StreamBuffer;
+        if (!input) {
+            return false;
+        }
+        request->m_Read = input->m_Read;
+        request->m_Context = input->m_Context;
+        return StreamGetFillRange(input, input->m_PrefetchSize, &request->m_Offset, &request->m_Size);
+    }
+
+    Result CompletePrefetch(HCodecContext context, HDecoder decoder, const PrefetchRequest* request, const void* data, uint32_t nread)
+    {
+        assert(decoder);
+        StreamBuffer* input = decoder->m_StreamBuffer;
+        if (!input || input->m_Context != request->m_Context) {
+            return RESULT_OK;
+        }
+        return StreamAppend(input, request->m_Offset, data, nread, request->m_Size);
+    }
+
     void GetInfo(HCodecContext context, HDecoder decoder, Info* info)
     {
         assert(decoder);
@@ -118,6 +183,10 @@ namespace dmSoundCodec
     {
         assert(decoder);
         decoder->m_DecoderInfo->m_CloseStream(decoder->m_Stream);
+        if (decoder->m_StreamBuffer) {
+            free(decoder->m_StreamBuffer->m_Data);
+            delete decoder->m_StreamBuffer;
+        }
         context->m_DecodersPool.Push(decoder->m_Index);
         decoder->Clear();
     }
@@ -52,7 +52,7 @@ namespace dmSoundCodec
     {
         /// Rate
         uint32_t m_Rate;
-        /// Size in bytes for decompressed stream. Might be 0 for ogg streams and similar
+        /// Size in bytes for decompressed stream. 0 if unknown, e.g. for streamed ogg data
         uint32_t m_Size;
         /// Number of channels
         uint8_t  m_Channels;
@@ -74,6 +74,34 @@ namespace dmSoundCodec
         }
     };
 
+    /**
+     * Callback reading the compressed data of a streamed decoder
+     * @param context user context
+     * @param offset offset in bytes from the start of the data
+     * @param buffer buffer to read to
+     * @param size number of bytes to read
+     * @param nread actual number of bytes read. Less than size only at the end of the data
+     * @return RESULT_OK on success
+     */
+    typedef Result (*FStreamRead)(void* context, uint32_t offset, void* buffer, uint32_t size, uint32_t* nread);
+
+    /**
+     * Parameters for a decoder reading its data on demand instead of from memory
+     */
+    struct StreamParams
+    {
+        /// Callback reading the data
+        FStreamRead m_Read;
+        /// User context passed to m_Read
+        void*       m_Context;
+        /// Size of the data in bytes
+        uint32_t    m_Size;
+        /// Size of the read buffer. It grows if a decoder needs more contiguous data than this
+        uint32_t    m_BufferSize;
+        /// Number of bytes that a prefetch (GetPrefetchRequest) keeps buffered ahead of the decoder
+        uint32_t    m_PrefetchSize;
+    };
+
     /**
      * Create a new codec context
      * @param params params
@@ -98,6 +126,53 @@ namespace dmSoundCodec
      */
     Result NewDecoder(HCodecContext context, Format format, const void* buffer, uint32_t buffer_size, HDecoder* decoder);
 
+    /**
+     * Create a new decoder that reads the data in chunks, through a buffer, as it's decoded
+     * @param context context
+     * @param format format
+     * @param params stream parameters
+     * @param decoder decoder (out)
+     * @return RESULT_OK on success. RESULT_UNSUPPORTED if the format can't be streamed
+     */
+    Result NewStreamDecoder(HCodecContext context, Format format, const StreamParams* params, HDecoder* decoder);
+
+    /**
+     * A read ahead of a streamed decoder
+     */
+    struct PrefetchRequest
+    {
+        /// Callback and user context of the decoder, see StreamParams
+        FStreamRead m_Read;
+        void*       m_Context;
+        /// Offset in bytes from the start of the data
+        uint32_t    m_Offset;
+        /// Number of bytes to read
+        uint32_t    m_Size;
+    };
+
+    /**
+     * Get the read that brings a streamed decoder up to its prefetch size. The caller does the read,
+     * so that it can be done without holding the locks that guard the decoder, and hands the bytes
+     * back with CompletePrefetch.
+     * @param context context
+     * @param decoder decoder
+     * @param request the read (out)
+     * @return true if there is anything to read. Always false for decoders reading from memory
+     */
+    bool GetPrefetchRequest(HCodecContext context, HDecoder decoder, PrefetchRequest* request);
+
+    /**
+     * Add the bytes read for a prefetch request to the decoder. They are dropped if the decoder
+     * has moved its read position since the request was made
+     * @param context context
+     * @param decoder decoder
+     * @param request the request from GetPrefetchRequest
+     * @param data the bytes read
+     * @param nread number of bytes read. Less than the request size only at the end of the data
+     * @return RESULT_OK on success
+     */
+    Result CompletePrefetch(HCodecContext context, HDecoder decoder, const PrefetchRequest* request, const void* data, uint32_t nread);
+
     /**
      * Delete decoder
      * @param context context
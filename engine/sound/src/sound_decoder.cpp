@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <assert.h>
+#include <dlib/math.h>
 
 #include "sound_codec.h"
 #include "sound_decoder.h"
@@ -72,4 +73,156 @@ namespace dmSoundCodec
         assert(best != 0);
         return best;
     }
+
+    // Make room for 'size' bytes after the buffered ones, keeping them contiguous at the front of the buffer
+    static Result StreamReserve(StreamBuffer* stream, uint32_t size)
+    {
+        uint32_t available = StreamAvailable(stream);
+        if (available + size > stream->m_Capacity)
+        {
+            uint32_t capacity = dmMath::Max(available + size, stream->m_Capacity * 2);
+            uint8_t* data = (uint8_t*) realloc(stream->m_Data, capacity);
+            if (!data)
+            {
+                return RESULT_OUT_OF_RESOURCES;
+            }
+            stream->m_Data = data;
+            stream->m_Capacity = capacity;
+        }
+
+        if (stream->m_Start > 0)
+        {
+            memmove(stream->m_Data, stream->m_Data + stream->m_Start, available);
+            stream->m_Start = 0;
+            stream->m_End = available;
+        }
+        return RESULT_OK;
+    }
+
+    bool StreamGetFillRange(const StreamBuffer* stream, uint32_t size, uint32_t* offset, uint32_t* count)
+    {
+        uint32_t available = StreamAvailable(stream);
+        if (available >= size || StreamIsComplete(stream))
+        {
+            return false;
+        }
+
+        // Read as much as fits in the buffer, once it has grown to 'size'
+        *offset = stream->m_Offset + available;
+        *count = dmMath::Min(dmMath::Max(size, stream->m_Capacity) - available, stream->m_Size - *offset);
+        return true;
+    }
+
+    Result StreamFill(StreamBuffer* stream, uint32_t size)
+    {
+        uint32_t offset;
+        uint32_t size_to_read;
+        if (!StreamGetFillRange(stream, size, &offset, &size_to_read))
+        {
+            return RESULT_OK;
+        }
+
+        Result r = StreamReserve(stream, size_to_read);
+        if (r != RESULT_OK)
+        {
+            return r;
+        }
+
+        uint32_t nread = 0;
+        r = stream->m_Read(stream->m_Context, offset, stream->m_Data + stream->m_End, size_to_read, &nread);
+        if (r != RESULT_OK)
+        {
+            return r;
+        }
+
+        stream->m_End += nread;
+        if (nread < size_to_read)
+        {
+            // The data ended early
+            stream->m_Size = offset + nread;
+        }
+        return RESULT_OK;
+    }
+
+    Result StreamAppend(StreamBuffer* stream, uint32_t offset, const void* data, uint32_t size, uint32_t requested)
+    {
+        if (offset != stream->m_Offset + StreamAvailable(stream))
+        {
+            return RESULT_OK;
+        }
+
+        Result r = StreamReserve(stream, size);
+        if (r != RESULT_OK)
+        {
+            return r;
+        }
+
+        memcpy(stream->m_Data + stream->m_End, data, size);
+        stream->m_End += size;
+        if (size < requested)
+        {
+            // The data ended early
+            stream->m_Size = offset + size;
+        }
+        return RESULT_OK;
+    }
+
+    void StreamConsume(StreamBuffer* stream, uint32_t size)
+    {
+        assert(size <= StreamAvailable(stream));
+        stream->m_Start += size;
+        stream->m_Offset += size;
+        if (stream->m_Start == stream->m_End)
+        {
+            stream->m_Start = 0;
+            stream->m_End = 0;
+        }
+    }
+
+    void StreamSeek(StreamBuffer* stream, uint32_t offset)
+    {
+        if (offset >= stream->m_Offset && offset <= stream->m_Offset + StreamAvailable(stream))
+        {
+            StreamConsume(stream, offset - stream->m_Offset);
+        }
+        else
+        {
+            stream->m_Start = 0;
+            stream->m_End = 0;
+            stream->m_Offset = dmMath::Min(offset, stream->m_Size);
+        }
+    }
+
+    Result StreamRead(StreamBuffer* stream, void* buffer, uint32_t size, uint32_t* nread)
+    {
+        uint32_t total = 0;
+        while (total < size)
+        {
+            if (StreamAvailable(stream) == 0)
+            {
+                if (StreamIsComplete(stream))
+                {
+                    break;
+                }
+                Result r = StreamFill(stream, 1);
+                if (r != RESULT_OK)
+                {
+                    *nread = total;
+                    return r;
+                }
+                if (StreamAvailable(stream) == 0)
+                {
+                    break;
+                }
+            }
+
+            uint32_t n = dmMath::Min(size - total, StreamAvailable(stream));
+            memcpy((uint8_t*) buffer + total, stream->m_Data + stream->m_Start, n);
+            StreamConsume(stream, n);
+            total += n;
+        }
+
+        *nread = total;
+        return RESULT_OK;
+    }
 }
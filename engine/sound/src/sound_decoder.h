@@ -13,6 +13,7 @@
 #ifndef DM_SOUND_DECODER_H
 #define DM_SOUND_DECODER_H
 
+#include <stdint.h>
 #include "sound_codec.h"
 #include "sound_decoder.h"
 #include "sound.h"
@@ -27,6 +28,64 @@ namespace dmSoundCodec
         DECODER_FIXED_POINT    = 2
     };
 
+    /**
+     * Input of a streamed decoder. Holds the bytes [m_Offset, m_Offset + m_End - m_Start) of the data
+     * in m_Data[m_Start, m_End), and is refilled with m_Read when the decoder needs more. The buffered
+     * bytes are kept contiguous, moved to the front of the buffer on refill, since the decoders parse
+     * whole pages and packets at a time.
+     */
+    struct StreamBuffer
+    {
+        FStreamRead m_Read;
+        void*       m_Context;
+        uint8_t*    m_Data;
+        uint32_t    m_Capacity;
+        uint32_t    m_Start;
+        uint32_t    m_End;
+        // Offset in the data of m_Data[m_Start]
+        uint32_t    m_Offset;
+        uint32_t    m_Size;
+        uint32_t    m_PrefetchSize;
+    };
+
+    /// Number of buffered bytes at the read position
+    inline uint32_t StreamAvailable(const StreamBuffer* stream)
+    {
+        return stream->m_End - stream->m_Start;
+    }
+
+    /// True when the rest of the data is buffered
+    inline bool StreamIsComplete(const StreamBuffer* stream)
+    {
+        return stream->m_Offset + StreamAvailable(stream) == stream->m_Size;
+    }
+
+    /**
+     * Make sure that at least 'size' bytes are buffered at the read position, or the rest of the data
+     * if there is less left. Grows the buffer if it's smaller than 'size'.
+     */
+    Result StreamFill(StreamBuffer* stream, uint32_t size);
+
+    /**
+     * Get the bytes to read for StreamFill(stream, size), without reading them. Returns false if nothing needs to be read
+     */
+    bool StreamGetFillRange(const StreamBuffer* stream, uint32_t size, uint32_t* offset, uint32_t* count);
+
+    /**
+     * Add bytes read for StreamGetFillRange. 'requested' is the count of the range, fewer bytes means that the data ended early.
+     * The bytes are dropped if the read position has moved since the range was taken
+     */
+    Result StreamAppend(StreamBuffer* stream, uint32_t offset, const void* data, uint32_t size, uint32_t requested);
+
+    /// Move the read position forward. The bytes must be buffered
+    void StreamConsume(StreamBuffer* stream, uint32_t size);
+
+    /// Move the read position. Keeps the buffered bytes if the offset is among them
+    void StreamSeek(StreamBuffer* stream, uint32_t offset);
+
+    /// Copy bytes from the read position, refilling the buffer as needed. nread is less than size only at the end of the data
+    Result StreamRead(StreamBuffer* stream, void* buffer, uint32_t size, uint32_t* nread);
+
     struct DecoderInfo
     {
         /**
@@ -75,6 +134,12 @@ namespace dmSoundCodec
          */
         void (*m_GetStreamInfo)(HDecodeStream, struct Info* out);
 
+        /**
+         * Open a stream for decoding data read through a stream buffer. Optional, 0 if the decoder
+         * can only decode from memory. The buffer is owned by the caller and outlives the stream.
+         */
+        Result (*m_OpenStreamBuffer)(StreamBuffer* input, HDecodeStream* out);
+
         DecoderInfo *m_Next;
     };
 
@@ -117,7 +182,7 @@ namespace dmSoundCodec
     /**
      * Declare a new stream decoder
      */
-    #define DM_DECLARE_SOUND_DECODER(symbol, name, format, score, open, close, decode, reset, skip, getinfo) \
+    #define DM_DECLARE_SOUND_DECODER(symbol, name, format, score, open, close, decode, reset, skip, getinfo, open_stream_buffer) \
             dmSoundCodec::DecoderInfo DM_SOUND_PASTE2(symbol, __LINE__) = { \
                     name, \
                     format, \
@@ -128,6 +193,7 @@ namespace dmSoundCodec
                     reset, \
                     skip, \
                     getinfo, \
+                    open_stream_buffer, \
             };\
         DM_REGISTER_SOUND_DECODER(symbol, DM_SOUND_PASTE2(symbol, __LINE__))
 }
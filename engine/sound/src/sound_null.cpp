@@ -69,6 +69,11 @@ namespace dmSound
         return result;
     }
 
+    Result NewSoundDataNoCopy(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return NewSoundData(sound_buffer, sound_buffer_size, type, sound_data, name);
+    }
+
     Result SetSoundData(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
     {
         if (sound_data->m_Buffer != 0x0)
@@ -79,6 +84,21 @@ namespace dmSound
         return RESULT_OK;
     }
 
+    Result NewSoundDataStreaming(const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return RESULT_UNSUPPORTED;
+    }
+
+    Result SetSoundDataStreaming(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size, uint32_t data_size, FSoundDataRead read, void* read_context)
+    {
+        return RESULT_UNSUPPORTED;
+    }
+
+    void* GetSoundDataReadContext(HSoundData sound_data)
+    {
+        return 0;
+    }
+
     uint32_t GetSoundResourceSize(HSoundData sound_data)
     {
         return sizeof(SoundData) + sound_data->m_BufferSize;
@@ -162,6 +182,21 @@ namespace dmSound
         return RESULT_OK;
     }
 
+    Result SetGroupMaxVoices(dmhash_t group_hash, uint32_t max_voices)
+    {
+        // NOTE: Not supported.
+        // sound_null is deprecated and should be replaced by sound2 with null-device
+        return RESULT_OK;
+    }
+
+    Result GetGroupMaxVoices(dmhash_t group_hash, uint32_t* max_voices)
+    {
+        // NOTE: Not supported.
+        // sound_null is deprecated and should be replaced by sound2 with null-device
+        *max_voices = 0;
+        return RESULT_OK;
+    }
+
     Result AddGroup(const char* group)
     {
         // NOTE: Not supported.
@@ -211,6 +246,11 @@ namespace dmSound
         return sound_instance->m_Playing == 1;
     }
 
+    bool IsVirtual(HSoundInstance sound_instance)
+    {
+        return false;
+    }
+
     Result SetLooping(HSoundInstance sound_instance, bool looping, int8_t loopcount)
     {
         sound_instance->m_Looping = looping ? 1 : 0;
@@ -218,6 +258,11 @@ namespace dmSound
         return RESULT_OK;
     }
 
+    Result SetPriority(HSoundInstance sound_instance, uint8_t priority)
+    {
+        return RESULT_OK;
+    }
+
     Result SetParameter(HSoundInstance sound_instance, Parameter parameter, const Vector4& value)
     {
         sound_instance->m_Parameters[parameter] = value;
@@ -34,6 +34,9 @@ DEF_EMBED(EXPLOSION_LOW_MONO_OGG)
 DEF_EMBED(MUSIC_OGG)
 DEF_EMBED(CYMBAL_OGG)
 DEF_EMBED(MUSIC_LOW_OGG)
+DEF_EMBED(MONO_TONE_440_22050_44100_WAV)
+DEF_EMBED(STEREO_TONE_440_44100_88200_WAV)
+DEF_EMBED(STEREO_TONE_440_48000_96000_WAV)
 
 #undef DEF_EMBED
 
@@ -155,6 +158,130 @@ TEST_F(dmSoundTest, MeasureTremoloSkip)
 }
 #endif
 
+// A device that wants one buffer per update, and discards it
+static dmSound::Result DeviceBenchmarkOpen(const dmSound::OpenDeviceParams* params, dmSound::HDevice* device)
+{
+    static int device_data = 0;
+    *device = &device_data;
+    return dmSound::RESULT_OK;
+}
+
+static void DeviceBenchmarkClose(dmSound::HDevice device)
+{
+}
+
+static dmSound::Result DeviceBenchmarkQueue(dmSound::HDevice device, const int16_t* samples, uint32_t sample_count)
+{
+    return dmSound::RESULT_OK;
+}
+
+static uint32_t DeviceBenchmarkFreeBufferSlots(dmSound::HDevice device)
+{
+    return 1;
+}
+
+static void DeviceBenchmarkDeviceInfo(dmSound::HDevice device, dmSound::DeviceInfo* info)
+{
+    info->m_MixRate = 44100;
+}
+
+static void DeviceBenchmarkStart(dmSound::HDevice device)
+{
+}
+
+static void DeviceBenchmarkStop(dmSound::HDevice device)
+{
+}
+
+DM_DECLARE_SOUND_DEVICE(BenchmarkSoundDevice, "benchmark", DeviceBenchmarkOpen, DeviceBenchmarkClose, DeviceBenchmarkQueue, DeviceBenchmarkFreeBufferSlots, DeviceBenchmarkDeviceInfo, DeviceBenchmarkStart, DeviceBenchmarkStop);
+
+// Mixes voice_count looping instances of a sound, one 768 frame buffer per update
+static void MeasureMix(const char* test_name, unsigned char* sound_buffer, uint32_t sound_buffer_size, uint32_t voice_count, float speed, dmSound::ResampleQuality quality)
+{
+    const uint32_t warmup_updates = 16;
+    const uint32_t updates = 256;
+
+    dmSound::InitializeParams params;
+    params.m_OutputDevice = "benchmark";
+    params.m_FrameCount = 768;
+    params.m_ResampleQuality = quality;
+    params.m_UseThread = false;
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Initialize(0, &params));
+
+    dmSound::HSoundData sound_data = 0;
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundData(sound_buffer, sound_buffer_size, dmSound::SOUND_DATA_TYPE_WAV, &sound_data, 1234));
+
+    std::vector<dmSound::HSoundInstance> instances;
+    for (uint32_t i = 0; i < voice_count; ++i)
+    {
+        dmSound::HSoundInstance instance = 0;
+        ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundInstance(sound_data, &instance));
+        dmSound::SetParameter(instance, dmSound::PARAMETER_GAIN, Vectormath::Aos::Vector4(1.0f / voice_count, 0, 0, 0));
+        dmSound::SetParameter(instance, dmSound::PARAMETER_PAN, Vectormath::Aos::Vector4(i / (float) voice_count * 2.0f - 1.0f, 0, 0, 0));
+        dmSound::SetParameter(instance, dmSound::PARAMETER_SPEED, Vectormath::Aos::Vector4(speed, 0, 0, 0));
+        dmSound::SetLooping(instance, true, -1);
+        dmSound::Play(instance);
+        instances.push_back(instance);
+    }
+
+    for (uint32_t i = 0; i < warmup_updates; ++i)
+    {
+        dmSound::Update();
+    }
+
+    const uint64_t time_beg = dmTime::GetTime();
+    for (uint32_t i = 0; i < updates; ++i)
+    {
+        dmSound::Update();
+    }
+    const uint64_t time_end = dmTime::GetTime();
+
+    const float t2ms = 0.001f;
+    const float ms_per_buffer = t2ms * (time_end - time_beg) / updates;
+    printf("[Mix - %s] Voices: %3u, quality: %d | %.3f ms per buffer, %.2f us per voice | %.1f%% of the buffer time\n",
+            test_name, voice_count, (int) quality, ms_per_buffer, 1000.0f * ms_per_buffer / voice_count, 100.0f * ms_per_buffer / (1000.0f * 768 / 44100.0f));
+
+    for (uint32_t i = 0; i < voice_count; ++i)
+    {
+        dmSound::Stop(instances[i]);
+        dmSound::DeleteSoundInstance(instances[i]);
+    }
+    dmSound::DeleteSoundData(sound_data);
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Finalize());
+}
+
+static void MeasureMixSuite(const char* test_name, unsigned char* sound_buffer, uint32_t sound_buffer_size, float speed)
+{
+    const uint32_t voice_counts[] = { 1, 16, 64, 128 };
+    for (uint32_t q = dmSound::RESAMPLE_QUALITY_LOW; q <= dmSound::RESAMPLE_QUALITY_HIGH; ++q)
+    {
+        for (uint32_t i = 0; i < sizeof(voice_counts) / sizeof(voice_counts[0]); ++i)
+        {
+            MeasureMix(test_name, sound_buffer, sound_buffer_size, voice_counts[i], speed, (dmSound::ResampleQuality) q);
+        }
+    }
+}
+
+TEST(dmSoundMix, MeasureIdentity)
+{
+    MeasureMixSuite("Stereo 44100 Hz", STEREO_TONE_440_44100_88200_WAV, STEREO_TONE_440_44100_88200_WAV_SIZE, 1.0f);
+}
+
+TEST(dmSoundMix, MeasureUpsample)
+{
+    MeasureMixSuite("Mono 22050 Hz", MONO_TONE_440_22050_44100_WAV, MONO_TONE_440_22050_44100_WAV_SIZE, 1.0f);
+}
+
+TEST(dmSoundMix, MeasureDownsample)
+{
+    MeasureMixSuite("Stereo 48000 Hz", STEREO_TONE_440_48000_96000_WAV, STEREO_TONE_440_48000_96000_WAV_SIZE, 1.0f);
+}
+
+TEST(dmSoundMix, MeasureSpeed)
+{
+    MeasureMixSuite("Stereo 44100 Hz, speed 1.5", STEREO_TONE_440_44100_88200_WAV, STEREO_TONE_440_44100_88200_WAV_SIZE, 1.5f);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);